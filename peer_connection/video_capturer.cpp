@@ -31,11 +31,17 @@ void TestVideoCapturer::OnFrame(const VideoFrame& frame) {
     rtc::scoped_refptr<I420Buffer> scaled_buffer =
         I420Buffer::Create(out_width, out_height);
     scaled_buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
+    // Keep the update rect, so that encoders can skip unchanged content.
+    const VideoFrame::UpdateRect update_rect =
+        frame.update_rect().ScaleWithFrame(frame.width(), frame.height(), 0, 0,
+                                           frame.width(), frame.height(),
+                                           out_width, out_height);
     broadcaster_.OnFrame(VideoFrame::Builder()
                              .set_video_frame_buffer(scaled_buffer)
                              .set_rotation(kVideoRotation_0)
                              .set_timestamp_us(frame.timestamp_us())
                              .set_id(frame.id())
+                             .set_update_rect(update_rect)
                              .build());
   } else {
     // No adaptations needed, just return the frame as is.
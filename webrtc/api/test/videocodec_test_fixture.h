@@ -88,7 +88,8 @@ class VideoCodecTestFixture {
     // Plain name of YUV file to process without file extension.
     std::string filename;
 
-    // File to process. This must be a video file in the YUV format.
+    // File to process. This must be a video file in the YUV format, or in the
+    // Y4M format if the file name ends with ".y4m".
     std::string filepath;
 
     // Number of frames to process.
@@ -103,6 +104,10 @@ class VideoCodecTestFixture {
     // Force the encoder and decoder to use a single core for processing.
     bool use_single_core = false;
 
+    // Number of cores given to the encoder and decoder. If zero, the number of
+    // cores of the machine is used. Ignored if |use_single_core| is set.
+    size_t num_cores = 0;
+
     // Should cpu usage be measured?
     // If set to true, the encoding will run in real-time.
     bool measure_cpu = false;
@@ -87,6 +87,22 @@ class RTC_EXPORT EncodedImage {
     buffer_ = nullptr;
   }
 
+  // Makes |encoded_data| the owned buffer of this image, e.g. a buffer taken
+  // from a pool. Capacity becomes the size of |encoded_data|, and so does the
+  // size of the image.
+  void SetEncodedData(const rtc::CopyOnWriteBuffer& encoded_data) {
+    encoded_data_ = encoded_data;
+    buffer_ = nullptr;
+    size_ = encoded_data_.size();
+  }
+
+  // Returns the owned buffer, sharing rather than copying the data. Its size
+  // is the capacity of the image, not size(). Requires an owned buffer.
+  rtc::CopyOnWriteBuffer GetEncodedData() const {
+    RTC_DCHECK(!buffer_);
+    return encoded_data_;
+  }
+
   uint8_t* data() { return buffer_ ? buffer_ : encoded_data_.data(); }
   const uint8_t* data() const {
     return buffer_ ? buffer_ : encoded_data_.cdata();
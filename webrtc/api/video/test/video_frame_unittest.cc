@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video/video_frame.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+using UpdateRect = VideoFrame::UpdateRect;
+
+void ExpectRectEq(const UpdateRect& expected, const UpdateRect& actual) {
+  EXPECT_EQ(expected.offset_x, actual.offset_x);
+  EXPECT_EQ(expected.offset_y, actual.offset_y);
+  EXPECT_EQ(expected.width, actual.width);
+  EXPECT_EQ(expected.height, actual.height);
+}
+}  // namespace
+
+TEST(UpdateRectTest, ScaleWithoutCropOrScalingAlignsToEvenSamples) {
+  ExpectRectEq(UpdateRect{10, 10, 20, 20},
+               UpdateRect{10, 10, 20, 20}.ScaleWithFrame(100, 100, 0, 0, 100,
+                                                         100, 100, 100));
+  ExpectRectEq(UpdateRect{10, 12, 6, 6},
+               UpdateRect{11, 13, 5, 5}.ScaleWithFrame(100, 100, 0, 0, 100,
+                                                       100, 100, 100));
+}
+
+TEST(UpdateRectTest, ScaleEmptyRect) {
+  const UpdateRect empty = {0, 0, 0, 0};
+  EXPECT_TRUE(
+      empty.ScaleWithFrame(100, 100, 0, 0, 100, 100, 50, 50).IsEmpty());
+}
+
+TEST(UpdateRectTest, ScaleRectOutsideCrop) {
+  const UpdateRect rect = {0, 0, 10, 10};
+  EXPECT_TRUE(
+      rect.ScaleWithFrame(100, 100, 50, 50, 50, 50, 50, 50).IsEmpty());
+}
+
+TEST(UpdateRectTest, ScaleRectPartlyInsideCrop) {
+  ExpectRectEq(UpdateRect{0, 0, 10, 10},
+               UpdateRect{10, 10, 20, 20}.ScaleWithFrame(100, 100, 20, 20, 60,
+                                                         60, 60, 60));
+}
+
+TEST(UpdateRectTest, DownscaleGrowsRectByFilterReach) {
+  // {20, 20, 20, 20} is {10, 10, 10, 10} at half size, plus two samples on
+  // each side.
+  ExpectRectEq(UpdateRect{8, 8, 14, 14},
+               UpdateRect{20, 20, 20, 20}.ScaleWithFrame(100, 100, 0, 0, 100,
+                                                         100, 50, 50));
+}
+
+TEST(UpdateRectTest, DownscaleFullFrameStaysInsideFrame) {
+  ExpectRectEq(UpdateRect{0, 0, 50, 30},
+               UpdateRect{0, 0, 100, 60}.ScaleWithFrame(100, 60, 0, 0, 100, 60,
+                                                        50, 30));
+}
+
+}  // namespace webrtc
@@ -59,6 +59,56 @@ bool VideoFrame::UpdateRect::IsEmpty() const {
   return width == 0 && height == 0;
 }
 
+VideoFrame::UpdateRect VideoFrame::UpdateRect::ScaleWithFrame(
+    int frame_width,
+    int frame_height,
+    int crop_x,
+    int crop_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) const {
+  RTC_DCHECK_GT(crop_width, 0);
+  RTC_DCHECK_GT(crop_height, 0);
+  RTC_DCHECK_GT(scaled_width, 0);
+  RTC_DCHECK_GT(scaled_height, 0);
+  RTC_DCHECK_LE(crop_x + crop_width, frame_width);
+  RTC_DCHECK_LE(crop_y + crop_height, frame_height);
+
+  UpdateRect cropped = *this;
+  cropped.Intersect(UpdateRect{crop_x, crop_y, crop_width, crop_height});
+  if (cropped.IsEmpty())
+    return UpdateRect{0, 0, 0, 0};
+
+  // Scale the corners relative to the crop area, rounding outwards.
+  int left = (cropped.offset_x - crop_x) * scaled_width / crop_width;
+  int top = (cropped.offset_y - crop_y) * scaled_height / crop_height;
+  int right = ((cropped.offset_x - crop_x + cropped.width) * scaled_width +
+               crop_width - 1) /
+              crop_width;
+  int bottom = ((cropped.offset_y - crop_y + cropped.height) * scaled_height +
+                crop_height - 1) /
+               crop_height;
+
+  // Scaling filters read neighbouring samples, so changes bleed into
+  // adjacent output samples.
+  if (scaled_width != crop_width || scaled_height != crop_height) {
+    left -= 2;
+    top -= 2;
+    right += 2;
+    bottom += 2;
+  }
+
+  // Align to 2x2 blocks because of the chroma subsampling.
+  left = std::max(0, left & ~1);
+  top = std::max(0, top & ~1);
+  right = std::min(scaled_width, (right + 1) & ~1);
+  bottom = std::min(scaled_height, (bottom + 1) & ~1);
+  if (right <= left || bottom <= top)
+    return UpdateRect{0, 0, 0, 0};
+  return UpdateRect{left, top, right - left, bottom - top};
+}
+
 VideoFrame::Builder::Builder() = default;
 
 VideoFrame::Builder::~Builder() = default;
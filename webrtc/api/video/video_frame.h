@@ -42,6 +42,20 @@ class RTC_EXPORT VideoFrame {
     void MakeEmptyUpdate();
 
     bool IsEmpty() const;
+
+    // Returns the rect covering this update after the frame of
+    // |frame_width|x|frame_height| is cropped to the given area and scaled to
+    // |scaled_width|x|scaled_height|. The result is aligned to 2x2 blocks and
+    // grown by the reach of the scaling filter, so it covers every changed
+    // sample of the scaled frame, including its chroma planes.
+    UpdateRect ScaleWithFrame(int frame_width,
+                              int frame_height,
+                              int crop_x,
+                              int crop_y,
+                              int crop_width,
+                              int crop_height,
+                              int scaled_width,
+                              int scaled_height) const;
   };
 
   // Preferred way of building VideoFrame objects.
@@ -159,6 +159,13 @@ class RTC_EXPORT VideoEncoder {
     // thresholds will be used in CPU adaptation.
     bool is_hardware_accelerated;
 
+    // If this field is true, the encoder adapts the effort it spends per frame
+    // to its measured encode time, and has not yet reached its lowest effort.
+    // CPU adaptation should give the encoder the chance to reduce its effort
+    // before lowering the resolution or frame rate, so that the two don't
+    // react to the same overuse. May change on a per-frame basis.
+    bool can_reduce_complexity;
+
     // If this field is true, the encoder uses internal camera sources, meaning
     // that it does not require/expect frames to be delivered via
     // webrtc::VideoEncoder::Encode.
@@ -13,12 +13,16 @@
 #include <stdio.h>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/types/optional.h"
 #include "api/test/simulated_network.h"
 #include "call/call.h"
 #include "call/degraded_call.h"
+#include "call/network_trace.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/string_encode.h"
 #include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
@@ -67,6 +71,47 @@ absl::optional<webrtc::BuiltInNetworkBehaviorConfig> ParseDegradationConfig(
              ? absl::optional<webrtc::BuiltInNetworkBehaviorConfig>(config)
              : absl::nullopt;
 }
+
+// Field trial groups can't contain '/', so it's written as "%2F" in the path
+// of a trace file, e.g. "%2Ftmp%2Ftrace.csv". Any character can be escaped as
+// '%' followed by two hex digits, including '%' itself as "%25".
+absl::optional<std::string> UnescapeTracePath(const std::string& group) {
+  std::string path;
+  for (size_t i = 0; i < group.size(); ++i) {
+    if (group[i] != '%') {
+      path += group[i];
+      continue;
+    }
+    unsigned char high;
+    unsigned char low;
+    if (i + 2 >= group.size() || !rtc::hex_decode(group[i + 1], &high) ||
+        !rtc::hex_decode(group[i + 2], &low)) {
+      return absl::nullopt;
+    }
+    path += static_cast<char>(high << 4 | low);
+    i += 2;
+  }
+  return path;
+}
+
+// The group of the field trial is the escaped path of the trace file.
+std::shared_ptr<const NetworkTrace> LoadDegradationTrace(bool send) {
+  std::string group = field_trial::FindFullName(
+      send ? "WebRTCFakeNetworkSendTraceFile"
+           : "WebRTCFakeNetworkReceiveTraceFile");
+  if (group.empty())
+    return nullptr;
+  absl::optional<std::string> path = UnescapeTracePath(group);
+  if (!path) {
+    RTC_LOG(LS_WARNING) << "Ignoring badly escaped network trace path "
+                        << group;
+    return nullptr;
+  }
+  std::shared_ptr<const NetworkTrace> trace = NetworkTrace::Load(*path);
+  if (!trace)
+    RTC_LOG(LS_WARNING) << "Ignoring invalid network trace " << *path;
+  return trace;
+}
 }  // namespace
 
 Call* CallFactory::CreateCall(const Call::Config& config) {
@@ -74,11 +119,19 @@ Call* CallFactory::CreateCall(const Call::Config& config) {
       ParseDegradationConfig(true);
   absl::optional<webrtc::BuiltInNetworkBehaviorConfig>
       receive_degradation_config = ParseDegradationConfig(false);
+  std::shared_ptr<const NetworkTrace> send_trace = LoadDegradationTrace(true);
+  std::shared_ptr<const NetworkTrace> receive_trace =
+      LoadDegradationTrace(false);
+  if (send_trace && !send_degradation_config)
+    send_degradation_config.emplace();
+  if (receive_trace && !receive_degradation_config)
+    receive_degradation_config.emplace();
 
   if (send_degradation_config || receive_degradation_config) {
     return new DegradedCall(std::unique_ptr<Call>(Call::Create(config)),
                             send_degradation_config,
-                            receive_degradation_config);
+                            receive_degradation_config, std::move(send_trace),
+                            std::move(receive_trace));
   }
 
   return Call::Create(config);
@@ -67,16 +67,21 @@ void FakeNetworkPipeModule::Process() {
 DegradedCall::DegradedCall(
     std::unique_ptr<Call> call,
     absl::optional<BuiltInNetworkBehaviorConfig> send_config,
-    absl::optional<BuiltInNetworkBehaviorConfig> receive_config)
+    absl::optional<BuiltInNetworkBehaviorConfig> receive_config,
+    std::shared_ptr<const NetworkTrace> send_trace,
+    std::shared_ptr<const NetworkTrace> receive_trace)
     : clock_(Clock::GetRealTimeClock()),
       call_(std::move(call)),
       send_config_(send_config),
+      send_trace_(std::move(send_trace)),
       send_process_thread_(
           send_config_ ? ProcessThread::Create("DegradedSendThread") : nullptr),
       num_send_streams_(0),
-      receive_config_(receive_config) {
+      receive_config_(receive_config),
+      receive_trace_(std::move(receive_trace)) {
   if (receive_config_) {
-    auto network = absl::make_unique<SimulatedNetwork>(*receive_config_);
+    auto network =
+        absl::make_unique<SimulatedNetwork>(*receive_config_, receive_trace_);
     receive_simulated_network_ = network.get();
     receive_pipe_ =
         absl::make_unique<webrtc::FakeNetworkPipe>(clock_, std::move(network));
@@ -119,7 +124,8 @@ VideoSendStream* DegradedCall::CreateVideoSendStream(
     VideoSendStream::Config config,
     VideoEncoderConfig encoder_config) {
   if (send_config_ && !send_pipe_) {
-    auto network = absl::make_unique<SimulatedNetwork>(*send_config_);
+    auto network =
+        absl::make_unique<SimulatedNetwork>(*send_config_, send_trace_);
     send_simulated_network_ = network.get();
     send_pipe_ = absl::make_unique<FakeNetworkPipeModule>(
         clock_, std::move(network), config.send_transport);
@@ -136,7 +142,8 @@ VideoSendStream* DegradedCall::CreateVideoSendStream(
     VideoEncoderConfig encoder_config,
     std::unique_ptr<FecController> fec_controller) {
   if (send_config_ && !send_pipe_) {
-    auto network = absl::make_unique<SimulatedNetwork>(*send_config_);
+    auto network =
+        absl::make_unique<SimulatedNetwork>(*send_config_, send_trace_);
     send_simulated_network_ = network.get();
     send_pipe_ = absl::make_unique<FakeNetworkPipeModule>(
         clock_, std::move(network), config.send_transport);
@@ -27,6 +27,7 @@
 #include "call/call.h"
 #include "call/fake_network_pipe.h"
 #include "call/flexfec_receive_stream.h"
+#include "call/network_trace.h"
 #include "call/packet_receiver.h"
 #include "call/rtp_transport_controller_send_interface.h"
 #include "call/simulated_network.h"
@@ -67,10 +68,13 @@ class FakeNetworkPipeModule : public Module {
 
 class DegradedCall : public Call, private Transport, private PacketReceiver {
  public:
-  explicit DegradedCall(
-      std::unique_ptr<Call> call,
-      absl::optional<BuiltInNetworkBehaviorConfig> send_config,
-      absl::optional<BuiltInNetworkBehaviorConfig> receive_config);
+  // The send and receive networks replay |send_trace| and |receive_trace| if
+  // not null, see SimulatedNetwork.
+  DegradedCall(std::unique_ptr<Call> call,
+               absl::optional<BuiltInNetworkBehaviorConfig> send_config,
+               absl::optional<BuiltInNetworkBehaviorConfig> receive_config,
+               std::shared_ptr<const NetworkTrace> send_trace,
+               std::shared_ptr<const NetworkTrace> receive_trace);
   ~DegradedCall() override;
 
   // Implements Call.
@@ -136,12 +140,14 @@ class DegradedCall : public Call, private Transport, private PacketReceiver {
   void SetClientBitratePreferences(
       const webrtc::BitrateSettings& preferences) override {}
   const absl::optional<BuiltInNetworkBehaviorConfig> send_config_;
+  const std::shared_ptr<const NetworkTrace> send_trace_;
   const std::unique_ptr<ProcessThread> send_process_thread_;
   SimulatedNetwork* send_simulated_network_;
   std::unique_ptr<FakeNetworkPipeModule> send_pipe_;
   size_t num_send_streams_;
 
   const absl::optional<BuiltInNetworkBehaviorConfig> receive_config_;
+  const std::shared_ptr<const NetworkTrace> receive_trace_;
   SimulatedNetwork* receive_simulated_network_;
   std::unique_ptr<FakeNetworkPipe> receive_pipe_;
 };
@@ -19,6 +19,7 @@
 #include "api/rtp_headers.h"
 #include "api/rtp_parameters.h"
 #include "call/rtp_packet_sink_interface.h"
+#include "modules/include/module_fec_types.h"
 
 namespace webrtc {
 
@@ -50,6 +51,10 @@ class FlexfecReceiveStream : public RtpPacketSinkInterface {
     // SSRC for FlexFEC stream to be received.
     uint32_t remote_ssrc = 0;
 
+    // Set to kReedSolomon if support for that erasure code has been signaled
+    // to the sender. XOR coded packets are decoded in either case.
+    FlexfecScheme scheme = FlexfecScheme::kXor;
+
     // Vector containing a single element, corresponding to the SSRC of the
     // media stream being protected by this FlexFEC stream. The vector MUST have
     // size 1.
@@ -115,7 +115,7 @@ std::unique_ptr<FlexfecReceiver> MaybeCreateFlexfecReceiver(
   RTC_DCHECK_EQ(1U, config.protected_media_ssrcs.size());
   return std::unique_ptr<FlexfecReceiver>(new FlexfecReceiver(
       clock, config.remote_ssrc, config.protected_media_ssrcs[0],
-      recovered_packet_receiver));
+      config.scheme, recovered_packet_receiver));
 }
 
 std::unique_ptr<RtpRtcp> CreateRtpRtcpModule(
@@ -0,0 +1,251 @@
+/*
+ *  Copyright 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/network_trace.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "absl/types/optional.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/string_encode.h"
+#include "rtc_base/string_to_number.h"
+#include "rtc_base/string_utils.h"
+#include "rtc_base/system/file_wrapper.h"
+
+namespace webrtc {
+namespace {
+constexpr int64_t kMahimahiPacketBits = 1500 * 8;
+// Limits the trace to what |NetworkTrace::bits_index_| can address, about 50
+// days.
+constexpr int64_t kMaxDurationMs = std::numeric_limits<uint32_t>::max();
+
+// Calls |handle_line| with every trimmed line of |trace| that is neither empty
+// nor a comment, stopping at the first one for which it returns false.
+template <typename Handler>
+bool ForEachLine(const std::string& trace, Handler handle_line) {
+  size_t begin = 0;
+  while (begin < trace.size()) {
+    size_t end = trace.find('\n', begin);
+    if (end == std::string::npos)
+      end = trace.size();
+    const std::string line =
+        rtc::string_trim(trace.substr(begin, end - begin));
+    begin = end + 1;
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (!handle_line(line))
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+NetworkTrace::NetworkTrace() = default;
+NetworkTrace::~NetworkTrace() = default;
+
+std::unique_ptr<NetworkTrace> NetworkTrace::ParseMahimahi(
+    const std::string& trace) {
+  std::vector<int64_t> opportunity_times_ms;
+  bool valid = ForEachLine(trace, [&](const std::string& line) {
+    absl::optional<int64_t> time_ms = rtc::StringToNumber<int64_t>(line);
+    if (!time_ms || *time_ms < 0 || *time_ms > kMaxDurationMs ||
+        (!opportunity_times_ms.empty() &&
+         *time_ms < opportunity_times_ms.back())) {
+      RTC_LOG(LS_WARNING) << "Invalid Mahimahi trace line: " << line;
+      return false;
+    }
+    opportunity_times_ms.push_back(*time_ms);
+    return true;
+  });
+  if (!valid || opportunity_times_ms.empty() ||
+      opportunity_times_ms.back() == 0) {
+    return nullptr;
+  }
+
+  std::unique_ptr<NetworkTrace> network_trace(new NetworkTrace());
+  // An opportunity at time t delivers its packet during the ms ending at t.
+  // The trace repeats after the last opportunity, so one at time 0 belongs to
+  // the first ms as well.
+  std::vector<int64_t>& bits = network_trace->capacity_bits_;
+  bits.resize(opportunity_times_ms.back() + 1, 0);
+  for (int64_t time_ms : opportunity_times_ms)
+    bits[std::max<int64_t>(time_ms - 1, 0) + 1] += kMahimahiPacketBits;
+  for (size_t i = 1; i < bits.size(); ++i)
+    bits[i] += bits[i - 1];
+  return network_trace->Finalize() ? std::move(network_trace) : nullptr;
+}
+
+std::unique_ptr<NetworkTrace> NetworkTrace::ParseCsv(
+    const std::string& trace) {
+  struct Row {
+    int64_t time_ms;
+    int capacity_kbps;
+    int delay_ms;
+    double loss_percent;
+  };
+  std::vector<Row> rows;
+  size_t num_fields = 0;
+  bool valid = ForEachLine(trace, [&](const std::string& line) {
+    std::vector<std::string> fields;
+    rtc::split(line, ',', &fields);
+    if (num_fields == 0)
+      num_fields = fields.size();
+    Row row = {0, 0, 0, 0};
+    bool valid_row = fields.size() >= 2 && fields.size() <= 4 &&
+                     fields.size() == num_fields;
+    if (valid_row) {
+      absl::optional<int64_t> time_ms =
+          rtc::StringToNumber<int64_t>(rtc::string_trim(fields[0]));
+      absl::optional<int> capacity_kbps =
+          rtc::StringToNumber<int>(rtc::string_trim(fields[1]));
+      absl::optional<int> delay_ms =
+          fields.size() > 2
+              ? rtc::StringToNumber<int>(rtc::string_trim(fields[2]))
+              : 0;
+      absl::optional<double> loss_percent =
+          fields.size() > 3
+              ? rtc::StringToNumber<double>(rtc::string_trim(fields[3]))
+              : 0.0;
+      const int64_t min_time_ms = rows.empty() ? 0 : rows.back().time_ms + 1;
+      const int64_t max_time_ms = rows.empty() ? 0 : kMaxDurationMs - 1;
+      valid_row = time_ms && capacity_kbps && delay_ms && loss_percent &&
+                  *time_ms >= min_time_ms && *time_ms <= max_time_ms &&
+                  *capacity_kbps >= 0 && *delay_ms >= 0 &&
+                  *delay_ms <= std::numeric_limits<uint16_t>::max() &&
+                  *loss_percent >= 0 && *loss_percent <= 100;
+      if (valid_row)
+        row = {*time_ms, *capacity_kbps, *delay_ms, *loss_percent};
+    }
+    if (!valid_row) {
+      RTC_LOG(LS_WARNING) << "Invalid network trace line: " << line;
+      return false;
+    }
+    rows.push_back(row);
+    return true;
+  });
+  if (!valid || rows.empty())
+    return nullptr;
+
+  std::unique_ptr<NetworkTrace> network_trace(new NetworkTrace());
+  const size_t duration_ms = rows.back().time_ms + 1;
+  std::vector<int64_t>& bits = network_trace->capacity_bits_;
+  bits.resize(duration_ms + 1, 0);
+  if (num_fields > 2)
+    network_trace->delay_ms_.resize(duration_ms);
+  if (num_fields > 3)
+    network_trace->loss_probability_.resize(duration_ms);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const Row& row = rows[i];
+    const size_t end_ms =
+        i + 1 < rows.size() ? rows[i + 1].time_ms : duration_ms;
+    for (size_t ms = row.time_ms; ms < end_ms; ++ms) {
+      // A kbps is a bit per ms.
+      bits[ms + 1] = bits[ms] + row.capacity_kbps;
+      if (network_trace->has_delay())
+        network_trace->delay_ms_[ms] = row.delay_ms;
+      if (network_trace->has_loss())
+        network_trace->loss_probability_[ms] = row.loss_percent / 100;
+    }
+  }
+  return network_trace->Finalize() ? std::move(network_trace) : nullptr;
+}
+
+std::unique_ptr<NetworkTrace> NetworkTrace::Load(const std::string& path) {
+  FileWrapper file = FileWrapper::OpenReadOnly(path);
+  if (!file.is_open()) {
+    RTC_LOG(LS_WARNING) << "Could not open network trace " << path;
+    return nullptr;
+  }
+  std::string trace;
+  char buffer[4096];
+  size_t read;
+  while ((read = file.Read(buffer, sizeof(buffer))) > 0)
+    trace.append(buffer, read);
+  file.Close();
+
+  const std::string kCsvExtension = ".csv";
+  if (path.size() >= kCsvExtension.size() &&
+      path.compare(path.size() - kCsvExtension.size(), kCsvExtension.size(),
+                   kCsvExtension) == 0) {
+    return ParseCsv(trace);
+  }
+  return ParseMahimahi(trace);
+}
+
+bool NetworkTrace::Finalize() {
+  const int64_t total_bits = capacity_bits_.back();
+  if (total_bits == 0) {
+    RTC_LOG(LS_WARNING) << "Network trace without capacity.";
+    return false;
+  }
+  // About one ms per index step, so that finding the ms in which a number of
+  // bits is reached takes a couple of steps on average.
+  bits_per_index_step_ = (total_bits + duration_ms() - 1) / duration_ms();
+  bits_index_.resize(total_bits / bits_per_index_step_ + 1);
+  uint32_t ms = 0;
+  for (size_t i = 0; i < bits_index_.size(); ++i) {
+    while (capacity_bits_[ms + 1] <
+           static_cast<int64_t>(i) * bits_per_index_step_) {
+      ++ms;
+    }
+    bits_index_[i] = ms;
+  }
+  return true;
+}
+
+size_t NetworkTrace::MsIndex(int64_t time_us) const {
+  return std::max<int64_t>(time_us, 0) / 1000 % duration_ms();
+}
+
+int64_t NetworkTrace::DeliverableBits(int64_t time_us) const {
+  if (time_us <= 0)
+    return 0;
+  const int64_t time_ms = time_us / 1000;
+  const int64_t periods = time_ms / duration_ms();
+  const size_t ms = time_ms % duration_ms();
+  const int64_t bits_in_ms = capacity_bits_[ms + 1] - capacity_bits_[ms];
+  return periods * capacity_bits_.back() + capacity_bits_[ms] +
+         bits_in_ms * (time_us % 1000) / 1000;
+}
+
+int64_t NetworkTrace::DeliveryTimeUs(int64_t bits) const {
+  if (bits <= 0)
+    return 0;
+  const int64_t total_bits = capacity_bits_.back();
+  // |remaining_bits| is in (0, total_bits], so that the time is found in the
+  // period in which the bits are reached rather than at the start of the next.
+  const int64_t periods = (bits - 1) / total_bits;
+  const int64_t remaining_bits = bits - periods * total_bits;
+  size_t ms = bits_index_[remaining_bits / bits_per_index_step_];
+  while (capacity_bits_[ms + 1] < remaining_bits)
+    ++ms;
+  const int64_t needed_bits = remaining_bits - capacity_bits_[ms];
+  const int64_t bits_in_ms = capacity_bits_[ms + 1] - capacity_bits_[ms];
+  RTC_DCHECK_GT(needed_bits, 0);
+  RTC_DCHECK_GE(bits_in_ms, needed_bits);
+  // Rounded up, so that DeliverableBits() of the result is at least |bits|.
+  return (periods * duration_ms() + ms) * 1000 +
+         (needed_bits * 1000 + bits_in_ms - 1) / bits_in_ms;
+}
+
+int NetworkTrace::DelayMs(int64_t time_us) const {
+  RTC_DCHECK(has_delay());
+  return delay_ms_[MsIndex(time_us)];
+}
+
+double NetworkTrace::LossProbability(int64_t time_us) const {
+  RTC_DCHECK(has_loss());
+  return loss_probability_[MsIndex(time_us)];
+}
+
+}  // namespace webrtc
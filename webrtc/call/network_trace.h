@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef CALL_NETWORK_TRACE_H_
+#define CALL_NETWORK_TRACE_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace webrtc {
+
+// Link capacity, and optionally delay and loss, of every millisecond of a
+// captured network trace. The trace repeats once it reaches its end. Lookups
+// by time are constant time so that long traces can be replayed per packet.
+class NetworkTrace {
+ public:
+  // Parses a Mahimahi link trace: one line per opportunity to deliver a 1500
+  // byte packet, holding its time in ms. The trace repeats after the time of
+  // the last line. Returns null if the trace is invalid or has no capacity.
+  static std::unique_ptr<NetworkTrace> ParseMahimahi(const std::string& trace);
+  // Parses rows of "time_ms,capacity_kbps[,delay_ms[,loss_percent]]" with
+  // increasing times, starting at 0. Each row holds until the next one and the
+  // last one for a single ms, so a row per ms gives a trace of one ms per row.
+  // Delay and loss must be given either in every row or in none. Returns null
+  // if the trace is invalid or has no capacity.
+  static std::unique_ptr<NetworkTrace> ParseCsv(const std::string& trace);
+  // Reads |path| as CSV if it ends with ".csv" and as Mahimahi otherwise.
+  static std::unique_ptr<NetworkTrace> Load(const std::string& path);
+
+  ~NetworkTrace();
+
+  int64_t duration_ms() const { return capacity_bits_.size() - 1; }
+  bool has_delay() const { return !delay_ms_.empty(); }
+  bool has_loss() const { return !loss_probability_.empty(); }
+
+  // Bits the link can deliver from the start of the trace until |time_us|.
+  // The capacity of a ms is spread evenly over it.
+  int64_t DeliverableBits(int64_t time_us) const;
+  // Earliest time at which DeliverableBits() reaches |bits|.
+  int64_t DeliveryTimeUs(int64_t bits) const;
+  // Only valid if has_delay() or has_loss() respectively.
+  int DelayMs(int64_t time_us) const;
+  double LossProbability(int64_t time_us) const;
+
+ private:
+  NetworkTrace();
+  // Sets up |bits_index_|, returns false if the trace has no capacity.
+  bool Finalize();
+  size_t MsIndex(int64_t time_us) const;
+
+  // Bits deliverable before the start of every ms, and over the whole trace
+  // as the last element.
+  std::vector<int64_t> capacity_bits_;
+  // First ms by the end of which |bits_per_index_step_| * i bits have been
+  // delivered, to find the ms in which a number of bits is reached without
+  // searching the trace.
+  std::vector<uint32_t> bits_index_;
+  int64_t bits_per_index_step_ = 1;
+  std::vector<uint16_t> delay_ms_;
+  std::vector<float> loss_probability_;
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_NETWORK_TRACE_H_
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "call/network_trace.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(NetworkTraceTest, ParsesMahimahiDeliveryOpportunities) {
+  // Two packets in the first ms, none in the second and one in the third.
+  std::unique_ptr<NetworkTrace> trace =
+      NetworkTrace::ParseMahimahi("1\n1\n3\n");
+  ASSERT_TRUE(trace);
+  EXPECT_EQ(3, trace->duration_ms());
+  EXPECT_FALSE(trace->has_delay());
+  EXPECT_FALSE(trace->has_loss());
+
+  EXPECT_EQ(0, trace->DeliverableBits(0));
+  EXPECT_EQ(12000, trace->DeliverableBits(500));
+  EXPECT_EQ(24000, trace->DeliverableBits(1500));
+  EXPECT_EQ(30000, trace->DeliverableBits(2500));
+  // Repeats after the last opportunity.
+  EXPECT_EQ(36000 + 12000, trace->DeliverableBits(3500));
+}
+
+TEST(NetworkTraceTest, FindsDeliveryTime) {
+  std::unique_ptr<NetworkTrace> trace =
+      NetworkTrace::ParseMahimahi("1\n1\n3\n");
+  ASSERT_TRUE(trace);
+  EXPECT_EQ(0, trace->DeliveryTimeUs(0));
+  EXPECT_EQ(500, trace->DeliveryTimeUs(12000));
+  EXPECT_EQ(1000, trace->DeliveryTimeUs(24000));
+  // Nothing is delivered in the second ms.
+  EXPECT_EQ(2001, trace->DeliveryTimeUs(24001));
+  EXPECT_EQ(3000, trace->DeliveryTimeUs(36000));
+  EXPECT_EQ(3001, trace->DeliveryTimeUs(36001));
+  EXPECT_EQ(30 * 3000, trace->DeliveryTimeUs(30 * 36000));
+
+  for (int64_t bits = 1; bits < 100000; bits += 997) {
+    const int64_t time_us = trace->DeliveryTimeUs(bits);
+    EXPECT_GE(trace->DeliverableBits(time_us), bits);
+    EXPECT_LT(trace->DeliverableBits(time_us - 1), bits);
+  }
+}
+
+TEST(NetworkTraceTest, ParsesCsvRows) {
+  std::unique_ptr<NetworkTrace> trace = NetworkTrace::ParseCsv(
+      "# time_ms,capacity_kbps,delay_ms,loss_percent\n"
+      "0,1000,20,0\n"
+      "10, 500, 40, 5.5\r\n"
+      "\n"
+      "15,0,100,100\n");
+  ASSERT_TRUE(trace);
+  EXPECT_EQ(16, trace->duration_ms());
+  ASSERT_TRUE(trace->has_delay());
+  ASSERT_TRUE(trace->has_loss());
+
+  EXPECT_EQ(1000 * 10 + 500 * 5, trace->DeliverableBits(16000));
+  EXPECT_EQ(20, trace->DelayMs(9999));
+  EXPECT_EQ(40, trace->DelayMs(10000));
+  EXPECT_EQ(100, trace->DelayMs(15000));
+  EXPECT_EQ(20, trace->DelayMs(16000));
+  EXPECT_DOUBLE_EQ(0.0, trace->LossProbability(0));
+  EXPECT_FLOAT_EQ(0.055, trace->LossProbability(12000));
+  EXPECT_DOUBLE_EQ(1.0, trace->LossProbability(15500));
+}
+
+TEST(NetworkTraceTest, ParsesCsvWithCapacityOnly) {
+  std::unique_ptr<NetworkTrace> trace = NetworkTrace::ParseCsv("0,300\n1,0\n");
+  ASSERT_TRUE(trace);
+  EXPECT_EQ(2, trace->duration_ms());
+  EXPECT_FALSE(trace->has_delay());
+  EXPECT_FALSE(trace->has_loss());
+  EXPECT_EQ(1000, trace->DeliveryTimeUs(300));
+  EXPECT_EQ(2000 + 4, trace->DeliveryTimeUs(301));
+}
+
+TEST(NetworkTraceTest, RejectsInvalidTraces) {
+  EXPECT_FALSE(NetworkTrace::ParseMahimahi(""));
+  EXPECT_FALSE(NetworkTrace::ParseMahimahi("0\n"));
+  EXPECT_FALSE(NetworkTrace::ParseMahimahi("5\n3\n"));
+  EXPECT_FALSE(NetworkTrace::ParseMahimahi("1\nx\n"));
+
+  EXPECT_FALSE(NetworkTrace::ParseCsv(""));
+  EXPECT_FALSE(NetworkTrace::ParseCsv("0,0\n10,0\n"));
+  EXPECT_FALSE(NetworkTrace::ParseCsv("1,100\n"));
+  EXPECT_FALSE(NetworkTrace::ParseCsv("0,100\n0,100\n"));
+  EXPECT_FALSE(NetworkTrace::ParseCsv("0,100,10\n5,100\n"));
+  EXPECT_FALSE(NetworkTrace::ParseCsv("0,100,10,101\n"));
+  EXPECT_FALSE(NetworkTrace::ParseCsv("0,-100\n"));
+}
+
+}  // namespace webrtc
@@ -18,6 +18,7 @@
 
 #include "api/rtp_headers.h"
 #include "api/rtp_parameters.h"
+#include "modules/include/module_fec_types.h"
 
 namespace webrtc {
 // Currently only VP8/VP9 specific.
@@ -116,6 +117,10 @@ struct RtpConfig {
     // SSRC of FlexFEC stream.
     uint32_t ssrc = 0;
 
+    // Erasure code of the FEC packets. Only set to kReedSolomon if the
+    // receiver has signaled support for it.
+    FlexfecScheme scheme = FlexfecScheme::kXor;
+
     // Vector containing a single element, corresponding to the SSRC of the
     // media stream being protected by this FlexFEC stream.
     // The vector MUST have size 1.
@@ -185,7 +185,7 @@ std::unique_ptr<FlexfecSender> MaybeCreateFlexfecSender(
   return absl::make_unique<FlexfecSender>(
       rtp.flexfec.payload_type, rtp.flexfec.ssrc,
       rtp.flexfec.protected_media_ssrcs[0], rtp.mid, rtp.extensions,
-      RTPSender::FecExtensionSizes(), rtp_state, clock);
+      RTPSender::FecExtensionSizes(), rtp_state, clock, rtp.flexfec.scheme);
 }
 
 uint32_t CalculateOverheadRateBps(int packets_per_second,
@@ -81,7 +81,12 @@ bool CoDelSimulation::DropDequeuedPacket(Timestamp now,
 
 SimulatedNetwork::SimulatedNetwork(SimulatedNetwork::Config config,
                                    uint64_t random_seed)
-    : random_(random_seed), bursting_(false) {
+    : SimulatedNetwork(config, nullptr, random_seed) {}
+
+SimulatedNetwork::SimulatedNetwork(SimulatedNetwork::Config config,
+                                   std::shared_ptr<const NetworkTrace> trace,
+                                   uint64_t random_seed)
+    : random_(random_seed), trace_(std::move(trace)), bursting_(false) {
   SetConfig(config);
 }
 
@@ -120,6 +125,8 @@ bool SimulatedNetwork::EnqueuePacket(PacketInFlightInfo packet) {
   RTC_DCHECK_RUNS_SERIALIZED(&process_checker_);
   ConfigState state = GetConfigState();
 
+  if (trace_ && !trace_start_us_)
+    trace_start_us_ = packet.send_time_us;
   UpdateCapacityQueue(state, packet.send_time_us);
 
   packet.size += state.config.packet_overhead;
@@ -156,28 +163,25 @@ void SimulatedNetwork::UpdateCapacityQueue(ConfigState state,
 
   int64_t time_us = last_capacity_link_visit_us_.value_or(time_now_us);
   // Check the capacity link first.
+  const bool finite_capacity = trace_ || state.config.link_capacity_kbps > 0;
   while (!capacity_link_.empty()) {
     int64_t time_until_front_exits_us = 0;
-    if (state.config.link_capacity_kbps > 0) {
+    if (finite_capacity) {
       int64_t remaining_bits =
           capacity_link_.front().packet.size * 8 - pending_drain_bits_;
       RTC_DCHECK(remaining_bits > 0);
-      // Division rounded up - packet not delivered until its last bit is.
-      time_until_front_exits_us =
-          (1000 * remaining_bits + state.config.link_capacity_kbps - 1) /
-          state.config.link_capacity_kbps;
+      time_until_front_exits_us = DrainTimeUs(state, time_us, remaining_bits);
     }
 
     if (time_us + time_until_front_exits_us > time_now_us) {
       // Packet at front will not exit yet. Will not enter here on infinite
       // capacity(=0) so no special handling needed.
-      pending_drain_bits_ +=
-          ((time_now_us - time_us) * state.config.link_capacity_kbps) / 1000;
+      pending_drain_bits_ += DrainedBits(state, time_us, time_now_us);
       break;
     }
-    if (state.config.link_capacity_kbps > 0) {
-      pending_drain_bits_ +=
-          (time_until_front_exits_us * state.config.link_capacity_kbps) / 1000;
+    if (finite_capacity) {
+      pending_drain_bits_ += DrainedBits(state, time_us,
+                                         time_us + time_until_front_exits_us);
     } else {
       // Enough to drain the whole queue.
       pending_drain_bits_ = queue_size_bytes_ * 8;
@@ -209,16 +213,25 @@ void SimulatedNetwork::UpdateCapacityQueue(ConfigState state,
     pending_drain_bits_ -= packet.packet.size * 8;
     RTC_DCHECK(pending_drain_bits_ >= 0);
 
-    // Drop packets at an average rate of |state.config.loss_percent| with
-    // and average loss burst length of |state.config.avg_burst_loss_length|.
-    if ((bursting_ && random_.Rand<double>() < state.prob_loss_bursting) ||
-        (!bursting_ && random_.Rand<double>() < state.prob_start_bursting)) {
-      bursting_ = true;
+    const int64_t trace_time_us = trace_ ? time_us - *trace_start_us_ : 0;
+    if (trace_ && trace_->has_loss()) {
+      bursting_ =
+          random_.Rand<double>() < trace_->LossProbability(trace_time_us);
+    } else {
+      // Drop packets at an average rate of |state.config.loss_percent| with
+      // and average loss burst length of |state.config.avg_burst_loss_length|.
+      bursting_ =
+          (bursting_ && random_.Rand<double>() < state.prob_loss_bursting) ||
+          (!bursting_ && random_.Rand<double>() < state.prob_start_bursting);
+    }
+    if (bursting_) {
       packet.arrival_time_us = PacketDeliveryInfo::kNotReceived;
     } else {
-      bursting_ = false;
+      const int queue_delay_ms = trace_ && trace_->has_delay()
+                                     ? trace_->DelayMs(trace_time_us)
+                                     : state.config.queue_delay_ms;
       int64_t arrival_time_jitter_us = std::max(
-          random_.Gaussian(state.config.queue_delay_ms * 1000,
+          random_.Gaussian(queue_delay_ms * 1000,
                            state.config.delay_standard_deviation_ms * 1000),
           0.0);
 
@@ -258,6 +271,32 @@ SimulatedNetwork::ConfigState SimulatedNetwork::GetConfigState() const {
   return config_state_;
 }
 
+int64_t SimulatedNetwork::DrainTimeUs(const ConfigState& state,
+                                      int64_t time_us,
+                                      int64_t bits) const {
+  if (trace_) {
+    const int64_t trace_time_us = time_us - *trace_start_us_;
+    return trace_->DeliveryTimeUs(trace_->DeliverableBits(trace_time_us) +
+                                  bits) -
+           trace_time_us;
+  }
+  if (state.config.link_capacity_kbps <= 0)
+    return 0;
+  // Division rounded up - packet not delivered until its last bit is.
+  return (1000 * bits + state.config.link_capacity_kbps - 1) /
+         state.config.link_capacity_kbps;
+}
+
+int64_t SimulatedNetwork::DrainedBits(const ConfigState& state,
+                                      int64_t from_us,
+                                      int64_t to_us) const {
+  if (trace_) {
+    return trace_->DeliverableBits(to_us - *trace_start_us_) -
+           trace_->DeliverableBits(from_us - *trace_start_us_);
+  }
+  return ((to_us - from_us) * state.config.link_capacity_kbps) / 1000;
+}
+
 std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
     int64_t receive_time_us) {
   RTC_DCHECK_RUNS_SERIALIZED(&process_checker_);
@@ -12,6 +12,7 @@
 
 #include <stdint.h>
 #include <deque>
+#include <memory>
 #include <queue>
 #include <vector>
 
@@ -19,6 +20,7 @@
 #include "api/test/simulated_network.h"
 #include "api/units/data_size.h"
 #include "api/units/timestamp.h"
+#include "call/network_trace.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/race_checker.h"
 #include "rtc_base/random.h"
@@ -57,6 +59,12 @@ class SimulatedNetwork : public NetworkBehaviorInterface {
  public:
   using Config = BuiltInNetworkBehaviorConfig;
   explicit SimulatedNetwork(Config config, uint64_t random_seed = 1);
+  // Replays |trace| from the first packet on. The capacity of the trace
+  // replaces |config.link_capacity_kbps|, and its delay and loss, if any,
+  // replace |config.queue_delay_ms| and the loss of |config|.
+  SimulatedNetwork(Config config,
+                   std::shared_ptr<const NetworkTrace> trace,
+                   uint64_t random_seed = 1);
   ~SimulatedNetwork() override;
 
   // Sets a new configuration. This won't affect packets already in the pipe.
@@ -92,6 +100,13 @@ class SimulatedNetwork : public NetworkBehaviorInterface {
   void UpdateCapacityQueue(ConfigState state, int64_t time_now_us)
       RTC_RUN_ON(&process_checker_);
   ConfigState GetConfigState() const;
+  // Time to drain |bits| from the capacity link starting at |time_us|, 0 if
+  // the capacity is infinite.
+  int64_t DrainTimeUs(const ConfigState& state, int64_t time_us, int64_t bits)
+      const RTC_RUN_ON(&process_checker_);
+  // Bits drained from the capacity link between |from_us| and |to_us|.
+  int64_t DrainedBits(const ConfigState& state, int64_t from_us, int64_t to_us)
+      const RTC_RUN_ON(&process_checker_);
 
   rtc::CriticalSection config_lock_;
 
@@ -101,6 +116,9 @@ class SimulatedNetwork : public NetworkBehaviorInterface {
   CoDelSimulation codel_controller_ RTC_GUARDED_BY(process_checker_);
   std::queue<PacketInfo> capacity_link_ RTC_GUARDED_BY(process_checker_);
   Random random_;
+  const std::shared_ptr<const NetworkTrace> trace_;
+  // Time at which |trace_| was started.
+  absl::optional<int64_t> trace_start_us_ RTC_GUARDED_BY(process_checker_);
 
   std::deque<PacketInfo> delay_link_ RTC_GUARDED_BY(process_checker_);
 
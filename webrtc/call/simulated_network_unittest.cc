@@ -8,12 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 
 #include <algorithm>
 #include "absl/algorithm/container.h"
 #include "api/units/data_rate.h"
+#include "call/network_trace.h"
 #include "call/simulated_network.h"
 #include "test/gtest.h"
 
@@ -144,4 +146,58 @@ TEST(SimulatedNetworkTest, CodelLimitsDelayAndDropsPacketsOnOverload) {
   }
   EXPECT_EQ(send_times_us.size(), 0u);
 }
+
+TEST(SimulatedNetworkTest, ReplaysTraceCapacityAndDelay) {
+  // 1000 kbps and 20 ms delay for 100 ms, then no capacity and 50 ms delay
+  // for 100 ms, repeated.
+  std::shared_ptr<const NetworkTrace> trace =
+      NetworkTrace::ParseCsv("0,1000,20\n100,0,50\n199,0,50\n");
+  ASSERT_TRUE(trace);
+  SimulatedNetwork::Config config;
+  // Replaced by the trace.
+  config.link_capacity_kbps = 10;
+  config.queue_delay_ms = 500;
+  SimulatedNetwork network(config, trace);
+
+  const int64_t kStartUs = 1000000;
+  // 8000 bits take 8 ms at 1000 kbps.
+  EXPECT_TRUE(network.EnqueuePacket(PacketInFlightInfo(1000, kStartUs, 1)));
+  // 5000 bits before the capacity stops and 3000 bits once it resumes.
+  EXPECT_TRUE(
+      network.EnqueuePacket(PacketInFlightInfo(1000, kStartUs + 95000, 2)));
+
+  std::map<uint64_t, int64_t> receive_times_us;
+  while (network.NextDeliveryTimeUs()) {
+    for (PacketDeliveryInfo packet :
+         network.DequeueDeliverablePackets(*network.NextDeliveryTimeUs())) {
+      receive_times_us[packet.packet_id] = packet.receive_time_us;
+    }
+  }
+  EXPECT_EQ(kStartUs + 8000 + 20000, receive_times_us[1]);
+  EXPECT_EQ(kStartUs + 203000 + 20000, receive_times_us[2]);
+}
+
+TEST(SimulatedNetworkTest, ReplaysTraceLoss) {
+  // Everything is lost during the second half of the trace.
+  std::shared_ptr<const NetworkTrace> trace =
+      NetworkTrace::ParseCsv("0,1000,0,0\n50,1000,0,100\n99,1000,0,100\n");
+  ASSERT_TRUE(trace);
+  SimulatedNetwork network(SimulatedNetwork::Config(), trace);
+
+  for (uint64_t id = 0; id < 20; ++id) {
+    EXPECT_TRUE(
+        network.EnqueuePacket(PacketInFlightInfo(100, id * 10000, id)));
+  }
+  int lost = 0;
+  while (network.NextDeliveryTimeUs()) {
+    for (PacketDeliveryInfo packet :
+         network.DequeueDeliverablePackets(*network.NextDeliveryTimeUs())) {
+      // Packets take 0.8 ms to leave the link.
+      const bool in_lossy_half = packet.packet_id % 10 >= 5;
+      EXPECT_EQ(in_lossy_half, packet.receive_time_us == kNotReceived);
+      lost += packet.receive_time_us == kNotReceived;
+    }
+  }
+  EXPECT_EQ(10, lost);
+}
 }  // namespace webrtc
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/controller_replay.h"
+
+#include <fstream>  // no-presubmit-check TODO(webrtc:8982)
+#include <utility>
+
+#include "logging/rtc_event_log/rtc_event_log_parser.h"
+#include "logging/rtc_event_log/rtc_event_processor.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+namespace {
+struct ReplayTask {
+  const std::string* log_file;
+  NetworkControllerFactoryInterface* factory;
+  ControllerReplayConfig config;
+  ControllerTimeline timeline;
+  bool success = false;
+};
+
+void RunReplayTask(void* obj) {
+  ReplayTask* task = static_cast<ReplayTask*>(obj);
+  std::ifstream log(*task->log_file,  // no-presubmit-check TODO(webrtc:8982)
+                    std::ios_base::in | std::ios_base::binary);
+  if (!log.is_open()) {
+    RTC_LOG(LS_WARNING) << "Could not open " << *task->log_file;
+    return;
+  }
+  ControllerReplay replay(task->factory, task->config);
+  task->success = replay.Replay(log);
+  task->timeline = replay.timeline();
+}
+}  // namespace
+
+ControllerTimeline::ControllerTimeline() = default;
+ControllerTimeline::ControllerTimeline(const ControllerTimeline&) = default;
+ControllerTimeline::~ControllerTimeline() = default;
+
+ControllerReplay::ControllerReplay(NetworkControllerFactoryInterface* factory,
+                                   ControllerReplayConfig config)
+    : factory_(factory),
+      config_(config),
+      process_interval_(factory->GetProcessInterval()) {}
+
+ControllerReplay::~ControllerReplay() = default;
+
+bool ControllerReplay::Replay(
+    std::istream& log) {  // no-presubmit-check TODO(webrtc:8982)
+  ParsedRtcEventLog parsed_log(
+      ParsedRtcEventLog::UnconfiguredHeaderExtensions::
+          kAttemptWebrtcDefaultConfig);
+  do {
+    if (!parsed_log.ParseStreamChunk(log, config_.chunk_bytes))
+      return false;
+    RtcEventProcessor processor;
+    for (const auto& stream : parsed_log.outgoing_rtp_packets_by_ssrc()) {
+      processor.AddEvents(stream.outgoing_packets,
+                          [this](const LoggedRtpPacketOutgoing& packet) {
+                            OnPacketSent(packet);
+                          });
+    }
+    processor.AddEvents(
+        parsed_log.transport_feedbacks(kIncomingPacket),
+        [this](const LoggedRtcpPacketTransportFeedback& feedback) {
+          OnTransportFeedback(feedback);
+        });
+    processor.AddEvents(
+        parsed_log.receiver_reports(kIncomingPacket),
+        [this](const LoggedRtcpPacketReceiverReport& report) {
+          OnReportBlocks(Timestamp::us(report.log_time_us()),
+                         report.rr.report_blocks());
+        });
+    processor.AddEvents(
+        parsed_log.sender_reports(kIncomingPacket),
+        [this](const LoggedRtcpPacketSenderReport& report) {
+          OnReportBlocks(Timestamp::us(report.log_time_us()),
+                         report.sr.report_blocks());
+        });
+    processor.ProcessEventsInOrder();
+  } while (!log.eof());
+  return true;
+}
+
+void ControllerReplay::ProcessUntil(Timestamp at_time) {
+  // Events of consecutive chunks may overlap slightly in time, never let the
+  // controller see time going backwards.
+  if (at_time < current_time_)
+    return;
+  while (controller_ && next_process_time_ <= at_time) {
+    ProcessInterval msg;
+    msg.at_time = next_process_time_;
+    HandleUpdate(msg.at_time, controller_->OnProcessInterval(msg));
+    next_process_time_ += process_interval_;
+  }
+  current_time_ = at_time;
+}
+
+void ControllerReplay::OnPacketSent(const LoggedRtpPacketOutgoing& packet) {
+  if (!packet.rtp.header.extension.hasTransportSequenceNumber)
+    return;
+  const Timestamp send_time = Timestamp::us(packet.log_time_us());
+  if (!controller_) {
+    NetworkControllerConfig controller_config;
+    controller_config.constraints.at_time = send_time;
+    controller_config.constraints.starting_rate = config_.start_rate;
+    controller_config.constraints.min_data_rate = config_.min_rate;
+    controller_config.constraints.max_data_rate = config_.max_rate;
+    controller_ = factory_->Create(controller_config);
+    NetworkAvailability msg;
+    msg.at_time = send_time;
+    msg.network_available = true;
+    HandleUpdate(send_time, controller_->OnNetworkAvailability(msg));
+    current_time_ = send_time;
+    next_process_time_ = send_time + process_interval_;
+  }
+  ProcessUntil(send_time);
+
+  const uint16_t sequence_number =
+      packet.rtp.header.extension.transportSequenceNumber;
+  feedback_adapter_.AddPacket(packet.rtp.header.ssrc, sequence_number,
+                              packet.rtp.total_length, PacedPacketInfo(),
+                              send_time);
+  rtc::SentPacket sent_packet(sequence_number, packet.log_time_ms());
+  sent_packet.info.included_in_feedback = true;
+  sent_packet.info.packet_size_bytes = packet.rtp.total_length;
+  absl::optional<SentPacket> msg =
+      feedback_adapter_.ProcessSentPacket(sent_packet);
+  if (msg)
+    HandleUpdate(send_time, controller_->OnSentPacket(*msg));
+}
+
+void ControllerReplay::OnTransportFeedback(
+    const LoggedRtcpPacketTransportFeedback& feedback) {
+  if (!controller_)
+    return;
+  const Timestamp feedback_time = Timestamp::us(feedback.log_time_us());
+  ProcessUntil(feedback_time);
+  absl::optional<TransportPacketsFeedback> msg =
+      feedback_adapter_.ProcessTransportFeedback(feedback.transport_feedback,
+                                                 feedback_time);
+  if (msg && !msg->packet_feedbacks.empty())
+    HandleUpdate(feedback_time, controller_->OnTransportPacketsFeedback(*msg));
+}
+
+void ControllerReplay::OnReportBlocks(
+    Timestamp receive_time,
+    const std::vector<rtcp::ReportBlock>& report_blocks) {
+  if (!controller_ || report_blocks.empty())
+    return;
+  ProcessUntil(receive_time);
+  // Same as RtpTransportControllerSend::OnReceivedRtcpReceiverReportBlocks().
+  int64_t packets_lost_delta = 0;
+  int64_t packets_delta = 0;
+  for (const rtcp::ReportBlock& report_block : report_blocks) {
+    auto it = last_report_blocks_.find(report_block.source_ssrc());
+    if (it != last_report_blocks_.end()) {
+      packets_delta += report_block.extended_high_seq_num() -
+                       it->second.extended_high_seq_num();
+      packets_lost_delta += report_block.cumulative_lost_signed() -
+                            it->second.cumulative_lost_signed();
+    }
+    last_report_blocks_[report_block.source_ssrc()] = report_block;
+  }
+  // The first report only sets the starting point of the deltas.
+  if (last_report_block_time_.IsInfinite())
+    last_report_block_time_ = receive_time;
+  const int64_t packets_received_delta = packets_delta - packets_lost_delta;
+  if (packets_delta == 0 || packets_received_delta < 1)
+    return;
+  TransportLossReport msg;
+  msg.packets_lost_delta = packets_lost_delta;
+  msg.packets_received_delta = packets_received_delta;
+  msg.receive_time = receive_time;
+  msg.start_time = last_report_block_time_;
+  msg.end_time = receive_time;
+  HandleUpdate(receive_time, controller_->OnTransportLossReport(msg));
+  last_report_block_time_ = receive_time;
+}
+
+void ControllerReplay::HandleUpdate(Timestamp at_time,
+                                    const NetworkControlUpdate& update) {
+  bool changed = false;
+  if (update.target_rate && update.target_rate->target_rate != target_rate_) {
+    target_rate_ = update.target_rate->target_rate;
+    changed = true;
+  }
+  if (update.pacer_config &&
+      (update.pacer_config->data_rate() != pacing_rate_ ||
+       update.pacer_config->pad_rate() != padding_rate_)) {
+    pacing_rate_ = update.pacer_config->data_rate();
+    padding_rate_ = update.pacer_config->pad_rate();
+    changed = true;
+  }
+  if (changed) {
+    timeline_.rate_updates.push_back(
+        {at_time, target_rate_, pacing_rate_, padding_rate_});
+  }
+  for (const ProbeClusterConfig& probe : update.probe_cluster_configs) {
+    timeline_.probe_clusters.push_back(
+        {at_time, probe.id, probe.target_data_rate});
+  }
+}
+
+bool ReplayInParallel(
+    const std::string& log_file,
+    const std::vector<NetworkControllerFactoryInterface*>& factories,
+    ControllerReplayConfig config,
+    std::vector<ControllerTimeline>* timelines) {
+  std::vector<ReplayTask> tasks(factories.size());
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < factories.size(); ++i) {
+    tasks[i].log_file = &log_file;
+    tasks[i].factory = factories[i];
+    tasks[i].config = config;
+    threads.emplace_back(new rtc::PlatformThread(&RunReplayTask, &tasks[i],
+                                                 "ControllerReplay"));
+    threads.back()->Start();
+  }
+  bool success = true;
+  timelines->clear();
+  for (size_t i = 0; i < factories.size(); ++i) {
+    threads[i]->Stop();
+    success &= tasks[i].success;
+    timelines->push_back(std::move(tasks[i].timeline));
+  }
+  return success;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef LOGGING_RTC_EVENT_LOG_CONTROLLER_REPLAY_H_
+#define LOGGING_RTC_EVENT_LOG_CONTROLLER_REPLAY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <istream>  // no-presubmit-check TODO(webrtc:8982)
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/network_control.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "logging/rtc_event_log/logged_events.h"
+#include "modules/congestion_controller/rtp/transport_feedback_adapter.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+
+namespace webrtc {
+
+struct ControllerReplayConfig {
+  DataRate start_rate = DataRate::kbps(300);
+  DataRate min_rate = DataRate::kbps(30);
+  DataRate max_rate = DataRate::kbps(5000);
+  // Amount of the log parsed at a time.
+  size_t chunk_bytes = 10000000;
+};
+
+// Rate decisions of a network controller over a replayed log.
+struct ControllerTimeline {
+  struct RateUpdate {
+    Timestamp at_time;
+    DataRate target_rate;
+    DataRate pacing_rate;
+    DataRate padding_rate;
+  };
+  struct ProbeCluster {
+    Timestamp at_time;
+    int32_t id;
+    DataRate target_rate;
+  };
+
+  ControllerTimeline();
+  ControllerTimeline(const ControllerTimeline&);
+  ~ControllerTimeline();
+
+  // Added whenever the target or pacing rate changes.
+  std::vector<RateUpdate> rate_updates;
+  std::vector<ProbeCluster> probe_clusters;
+};
+
+// Feeds the packets sent in an RtcEventLog, and the transport feedback and
+// receiver reports received for them, to a network controller and records
+// its rate decisions. The controller doesn't change what was sent, so this
+// shows how it would have estimated the logged network rather than how it
+// would have behaved in the call.
+class ControllerReplay {
+ public:
+  ControllerReplay(NetworkControllerFactoryInterface* factory,
+                   ControllerReplayConfig config);
+  ~ControllerReplay();
+
+  // Parses |log| a chunk at a time, so that logs of any length can be
+  // replayed. Returns false if the log is invalid.
+  bool Replay(std::istream& log);  // no-presubmit-check TODO(webrtc:8982)
+
+  const ControllerTimeline& timeline() const { return timeline_; }
+
+ private:
+  // Runs the process intervals of the controller up to |at_time|.
+  void ProcessUntil(Timestamp at_time);
+  void OnPacketSent(const LoggedRtpPacketOutgoing& packet);
+  void OnTransportFeedback(const LoggedRtcpPacketTransportFeedback& feedback);
+  void OnReportBlocks(Timestamp receive_time,
+                      const std::vector<rtcp::ReportBlock>& report_blocks);
+  void HandleUpdate(Timestamp at_time, const NetworkControlUpdate& update);
+
+  NetworkControllerFactoryInterface* const factory_;
+  const ControllerReplayConfig config_;
+  const TimeDelta process_interval_;
+  // Created at the first sent packet.
+  std::unique_ptr<NetworkControllerInterface> controller_;
+  TransportFeedbackAdapter feedback_adapter_;
+  Timestamp current_time_ = Timestamp::MinusInfinity();
+  Timestamp next_process_time_ = Timestamp::PlusInfinity();
+  std::map<uint32_t, rtcp::ReportBlock> last_report_blocks_;
+  Timestamp last_report_block_time_ = Timestamp::MinusInfinity();
+  DataRate target_rate_ = DataRate::Zero();
+  DataRate pacing_rate_ = DataRate::Zero();
+  DataRate padding_rate_ = DataRate::Zero();
+  ControllerTimeline timeline_;
+};
+
+// Replays |log_file| through each of |factories| in a thread of its own, each
+// reading the file by itself so that memory use doesn't grow with the log.
+// Fills |timelines| in the order of |factories|. Returns false if the log is
+// invalid.
+bool ReplayInParallel(
+    const std::string& log_file,
+    const std::vector<NetworkControllerFactoryInterface*>& factories,
+    ControllerReplayConfig config,
+    std::vector<ControllerTimeline>* timelines);
+
+}  // namespace webrtc
+
+#endif  // LOGGING_RTC_EVENT_LOG_CONTROLLER_REPLAY_H_
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/goog_cc_factory.h"
+#include "logging/rtc_event_log/controller_replay.h"
+#include "modules/congestion_controller/bbr/bbr_factory.h"
+#include "modules/congestion_controller/pcc/pcc_factory.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/string_encode.h"
+
+WEBRTC_DEFINE_string(controllers,
+                     "goog_cc,bbr,pcc",
+                     "Comma separated network controllers to replay the log "
+                     "through, out of goog_cc, bbr and pcc.");
+WEBRTC_DEFINE_int(start_kbps, 300, "Start rate of the controllers.");
+WEBRTC_DEFINE_int(min_kbps, 30, "Minimum rate of the controllers.");
+WEBRTC_DEFINE_int(max_kbps, 5000, "Maximum rate of the controllers.");
+WEBRTC_DEFINE_int(chunk_mb,
+                  10,
+                  "Megabytes of the log to parse at a time per controller.");
+WEBRTC_DEFINE_bool(help, false, "Prints this message.");
+
+namespace {
+std::unique_ptr<webrtc::NetworkControllerFactoryInterface> CreateFactory(
+    const std::string& name) {
+  if (name == "goog_cc")
+    return std::unique_ptr<webrtc::NetworkControllerFactoryInterface>(
+        new webrtc::GoogCcNetworkControllerFactory(nullptr));
+  if (name == "bbr")
+    return std::unique_ptr<webrtc::NetworkControllerFactoryInterface>(
+        new webrtc::BbrNetworkControllerFactory());
+  if (name == "pcc")
+    return std::unique_ptr<webrtc::NetworkControllerFactoryInterface>(
+        new webrtc::PccNetworkControllerFactory());
+  return nullptr;
+}
+}  // namespace
+
+// This utility replays the sent packets and received feedback of an event log
+// through network controllers and writes out the rates they decide on.
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Tool for replaying an RtcEventLog file through network controllers.\n"
+      "Writes a line per rate update and probe cluster of every controller.\n"
+      "Run " +
+      program_name +
+      " --help for usage.\n"
+      "Example usage:\n" +
+      program_name + " --controllers=goog_cc,bbr input.rel output.txt\n";
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) || FLAG_help ||
+      argc != 3) {
+    std::cout << usage;
+    if (FLAG_help) {
+      rtc::FlagList::Print(nullptr, false);
+      return 0;
+    }
+    return 1;
+  }
+
+  std::string input_file = argv[1];
+  std::string output_file = argv[2];
+
+  std::vector<std::string> names;
+  rtc::split(FLAG_controllers, ',', &names);
+  std::vector<std::unique_ptr<webrtc::NetworkControllerFactoryInterface>>
+      factories;
+  std::vector<webrtc::NetworkControllerFactoryInterface*> factory_ptrs;
+  for (const std::string& name : names) {
+    factories.push_back(CreateFactory(name));
+    if (!factories.back()) {
+      std::cerr << "Unknown network controller: " << name << std::endl;
+      return 1;
+    }
+    factory_ptrs.push_back(factories.back().get());
+  }
+
+  webrtc::ControllerReplayConfig config;
+  config.start_rate = webrtc::DataRate::kbps(FLAG_start_kbps);
+  config.min_rate = webrtc::DataRate::kbps(FLAG_min_kbps);
+  config.max_rate = webrtc::DataRate::kbps(FLAG_max_kbps);
+  config.chunk_bytes = static_cast<size_t>(FLAG_chunk_mb) * 1000000;
+
+  std::vector<webrtc::ControllerTimeline> timelines;
+  if (!webrtc::ReplayInParallel(input_file, factory_ptrs, config,
+                                &timelines)) {
+    std::cerr << "Error while replaying input file: " << input_file
+              << std::endl;
+    return -1;
+  }
+
+  FILE* output = fopen(output_file.c_str(), "w");
+  if (!output) {
+    std::cerr << "Error while opening output file: " << output_file
+              << std::endl;
+    return -1;
+  }
+  fprintf(output,
+          "# rate controller time_ms target_kbps pacing_kbps padding_kbps\n"
+          "# probe controller time_ms cluster_id target_kbps\n");
+  for (size_t i = 0; i < timelines.size(); ++i) {
+    for (const auto& update : timelines[i].rate_updates) {
+      fprintf(output,
+              "rate %s %" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 "\n",
+              names[i].c_str(), update.at_time.ms(),
+              update.target_rate.kbps(), update.pacing_rate.kbps(),
+              update.padding_rate.kbps());
+    }
+    for (const auto& probe : timelines[i].probe_clusters) {
+      fprintf(output, "probe %s %" PRId64 " %d %" PRId64 "\n",
+              names[i].c_str(), probe.at_time.ms(), probe.id,
+              probe.target_rate.kbps());
+    }
+  }
+  fclose(output);
+  return 0;
+}
@@ -0,0 +1,260 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/controller_replay.h"
+
+#include <deque>
+#include <memory>
+#include <sstream>  // no-presubmit-check TODO(webrtc:8982)
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/fake_clock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kSsrc = 1234;
+constexpr uint32_t kRemoteSsrc = 5678;
+// The parser falls back to this id for logs without an extension map.
+constexpr int kTransportSequenceNumberId = 5;
+constexpr size_t kPayloadSize = 1000;
+constexpr int64_t kStartTimeUs = 1000000;
+constexpr int64_t kStartRateKbps = 250;
+
+// Starts at the start rate, probing at twice that, and then sets the target
+// rate to 100 kbps for every packet acknowledged by a transport feedback.
+class FakeNetworkController : public NetworkControllerInterface {
+ public:
+  FakeNetworkController(DataRate start_rate,
+                        std::vector<TransportLossReport>* loss_reports)
+      : start_rate_(start_rate), loss_reports_(loss_reports) {}
+
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability msg) override {
+    NetworkControlUpdate update = CreateUpdate(msg.at_time, start_rate_);
+    ProbeClusterConfig probe;
+    probe.at_time = msg.at_time;
+    probe.target_data_rate = start_rate_ * 2;
+    probe.id = 1;
+    update.probe_cluster_configs.push_back(probe);
+    return update;
+  }
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnProcessInterval(ProcessInterval) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnSentPacket(SentPacket) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport msg) override {
+    loss_reports_->push_back(msg);
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback msg) override {
+    const int64_t num_received = msg.ReceivedWithSendInfo().size();
+    return CreateUpdate(msg.feedback_time, DataRate::kbps(100) * num_received);
+  }
+
+ private:
+  static NetworkControlUpdate CreateUpdate(Timestamp at_time,
+                                           DataRate target_rate) {
+    NetworkControlUpdate update;
+    update.target_rate = TargetTransferRate();
+    update.target_rate->at_time = at_time;
+    update.target_rate->target_rate = target_rate;
+    return update;
+  }
+
+  const DataRate start_rate_;
+  std::vector<TransportLossReport>* const loss_reports_;
+};
+
+class FakeNetworkControllerFactory : public NetworkControllerFactoryInterface {
+ public:
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override {
+    return absl::make_unique<FakeNetworkController>(
+        *config.constraints.starting_rate, &loss_reports);
+  }
+  TimeDelta GetProcessInterval() const override { return TimeDelta::ms(25); }
+
+  std::vector<TransportLossReport> loss_reports;
+};
+
+// Builds a log in the legacy format. Every event is a message of its own
+// there, so a replay with a chunk size of one byte parses one event at a time.
+class LogBuilder {
+ public:
+  LogBuilder() {
+    clock_.SetTimeMicros(kStartTimeUs);
+    extensions_.Register<TransportSequenceNumber>(kTransportSequenceNumberId);
+  }
+
+  void AdvanceTimeMs(int64_t ms) { clock_.AdvanceTimeMicros(ms * 1000); }
+
+  void SendPacket(uint16_t transport_sequence_number) {
+    RtpPacketToSend packet(&extensions_);
+    packet.SetSsrc(kSsrc);
+    packet.SetSequenceNumber(transport_sequence_number);
+    packet.SetExtension<TransportSequenceNumber>(transport_sequence_number);
+    packet.AllocatePayload(kPayloadSize);
+    events_.push_back(absl::make_unique<RtcEventRtpPacketOutgoing>(
+        packet, PacedPacketInfo::kNotAProbe));
+  }
+
+  // Acknowledges |sequence_numbers| as received 10 ms apart.
+  void ReceiveFeedback(const std::vector<uint16_t>& sequence_numbers) {
+    rtcp::TransportFeedback feedback;
+    feedback.SetSenderSsrc(kRemoteSsrc);
+    feedback.SetMediaSsrc(kSsrc);
+    int64_t receive_time_us = clock_.TimeNanos() / 1000;
+    feedback.SetBase(sequence_numbers.front(), receive_time_us);
+    for (uint16_t sequence_number : sequence_numbers) {
+      EXPECT_TRUE(feedback.AddReceivedPacket(sequence_number, receive_time_us));
+      receive_time_us += 10000;
+    }
+    ReceiveRtcp(feedback.Build());
+  }
+
+  void ReceiveReport(uint32_t extended_highest_sequence_number,
+                     int32_t cumulative_lost) {
+    rtcp::ReportBlock report_block;
+    report_block.SetMediaSsrc(kSsrc);
+    report_block.SetExtHighestSeqNum(extended_highest_sequence_number);
+    EXPECT_TRUE(report_block.SetCumulativeLost(cumulative_lost));
+    rtcp::ReceiverReport report;
+    report.SetSenderSsrc(kRemoteSsrc);
+    EXPECT_TRUE(report.AddReportBlock(report_block));
+    ReceiveRtcp(report.Build());
+  }
+
+  std::string Encode() {
+    RtcEventLogEncoderLegacy encoder;
+    return encoder.EncodeLogStart(kStartTimeUs, kStartTimeUs) +
+           encoder.EncodeBatch(events_.begin(), events_.end());
+  }
+
+ private:
+  void ReceiveRtcp(const rtc::Buffer& packet) {
+    events_.push_back(absl::make_unique<RtcEventRtcpPacketIncoming>(packet));
+  }
+
+  rtc::ScopedFakeClock clock_;
+  RtpHeaderExtensionMap extensions_;
+  std::deque<std::unique_ptr<RtcEvent>> events_;
+};
+
+ControllerTimeline Replay(const std::string& log,
+                          size_t chunk_bytes,
+                          FakeNetworkControllerFactory* factory) {
+  ControllerReplayConfig config;
+  config.start_rate = DataRate::kbps(kStartRateKbps);
+  config.chunk_bytes = chunk_bytes;
+  ControllerReplay replay(factory, config);
+  std::istringstream stream(log);  // no-presubmit-check TODO(webrtc:8982)
+  EXPECT_TRUE(replay.Replay(stream));
+  return replay.timeline();
+}
+
+// Sends ten packets 10 ms apart, half of them acknowledged by a feedback
+// 50 ms after the last one and three of the rest by one more 10 ms later.
+std::string CreateFeedbackLog() {
+  LogBuilder builder;
+  for (uint16_t sequence_number = 0; sequence_number < 10; ++sequence_number) {
+    builder.SendPacket(sequence_number);
+    builder.AdvanceTimeMs(10);
+  }
+  builder.AdvanceTimeMs(40);
+  builder.ReceiveFeedback({0, 1, 2, 3, 4});
+  builder.AdvanceTimeMs(10);
+  builder.ReceiveFeedback({5, 6, 7});
+  return builder.Encode();
+}
+
+void ExpectFeedbackTimeline(const ControllerTimeline& timeline) {
+  const Timestamp start_time = Timestamp::us(kStartTimeUs);
+  ASSERT_EQ(3u, timeline.rate_updates.size());
+  EXPECT_EQ(start_time, timeline.rate_updates[0].at_time);
+  EXPECT_EQ(DataRate::kbps(kStartRateKbps),
+            timeline.rate_updates[0].target_rate);
+  EXPECT_EQ(start_time + TimeDelta::ms(140), timeline.rate_updates[1].at_time);
+  EXPECT_EQ(DataRate::kbps(500), timeline.rate_updates[1].target_rate);
+  EXPECT_EQ(start_time + TimeDelta::ms(150), timeline.rate_updates[2].at_time);
+  EXPECT_EQ(DataRate::kbps(300), timeline.rate_updates[2].target_rate);
+
+  ASSERT_EQ(1u, timeline.probe_clusters.size());
+  EXPECT_EQ(start_time, timeline.probe_clusters[0].at_time);
+  EXPECT_EQ(1, timeline.probe_clusters[0].id);
+  EXPECT_EQ(DataRate::kbps(2 * kStartRateKbps),
+            timeline.probe_clusters[0].target_rate);
+}
+
+}  // namespace
+
+TEST(ControllerReplayTest, RecordsRateUpdatesAndProbes) {
+  FakeNetworkControllerFactory factory;
+  ExpectFeedbackTimeline(Replay(CreateFeedbackLog(),
+                                ControllerReplayConfig().chunk_bytes,
+                                &factory));
+}
+
+TEST(ControllerReplayTest, MatchesFeedbackToPacketsOfEarlierChunks) {
+  FakeNetworkControllerFactory factory;
+  ExpectFeedbackTimeline(Replay(CreateFeedbackLog(), 1, &factory));
+}
+
+TEST(ControllerReplayTest, LossReportStartsAtFirstReport) {
+  LogBuilder builder;
+  builder.SendPacket(0);
+  builder.AdvanceTimeMs(100);
+  builder.ReceiveReport(100, 0);
+  builder.AdvanceTimeMs(1000);
+  builder.ReceiveReport(150, 5);
+
+  FakeNetworkControllerFactory factory;
+  Replay(builder.Encode(), 1, &factory);
+  ASSERT_EQ(1u, factory.loss_reports.size());
+  const TransportLossReport& report = factory.loss_reports[0];
+  const Timestamp start_time = Timestamp::us(kStartTimeUs);
+  EXPECT_EQ(start_time + TimeDelta::ms(100), report.start_time);
+  EXPECT_EQ(start_time + TimeDelta::ms(1100), report.end_time);
+  EXPECT_EQ(45, report.packets_received_delta);
+  EXPECT_EQ(5, report.packets_lost_delta);
+}
+
+}  // namespace webrtc
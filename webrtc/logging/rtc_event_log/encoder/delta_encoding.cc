@@ -107,12 +107,14 @@ constexpr bool kDefaultValuesOptional = false;
 constexpr uint64_t kDefaultValueWidthBits = 64;
 
 // Wrap BitBufferWriter and extend its functionality by (1) keeping track of
-// the number of bits written and (2) owning its buffer.
+// the number of bits written and (2) sizing its buffer, which is owned by the
+// caller so that its capacity can be reused between encodings.
 class BitWriter final {
  public:
-  explicit BitWriter(size_t byte_count)
-      : buffer_(byte_count, '\0'),
-        bit_writer_(reinterpret_cast<uint8_t*>(&buffer_[0]), buffer_.size()),
+  BitWriter(std::string* buffer, size_t byte_count)
+      : buffer_(PrepareBuffer(buffer, byte_count)),
+        bit_writer_(reinterpret_cast<uint8_t*>(&(*buffer_)[0]),
+                    buffer_->size()),
         written_bits_(0),
         valid_(true) {
     RTC_DCHECK_GT(byte_count, 0);
@@ -125,29 +127,32 @@ class BitWriter final {
     written_bits_ += bit_count;
   }
 
-  void WriteBits(const std::string& input) {
+  void WriteBits(const char* input, size_t length) {
     RTC_DCHECK(valid_);
-    for (std::string::value_type c : input) {
-      WriteBits(c, 8 * sizeof(std::string::value_type));
+    for (size_t i = 0; i < length; ++i) {
+      WriteBits(static_cast<uint8_t>(input[i]), 8);
     }
   }
 
-  // Returns everything that was written so far.
+  // Trims the buffer to everything that was written so far.
   // Nothing more may be written after this is called.
-  std::string GetString() {
+  void Finish() {
     RTC_DCHECK(valid_);
     valid_ = false;
 
-    buffer_.resize(BitsToBytes(written_bits_));
+    buffer_->resize(BitsToBytes(written_bits_));
     written_bits_ = 0;
-
-    std::string result;
-    std::swap(buffer_, result);
-    return result;
   }
 
  private:
-  std::string buffer_;
+  // Bits that aren't written must be zero, so the buffer is cleared.
+  static std::string* PrepareBuffer(std::string* buffer, size_t byte_count) {
+    RTC_DCHECK(buffer);
+    buffer->assign(byte_count, '\0');
+    return buffer;
+  }
+
+  std::string* const buffer_;
   rtc::BitBufferWriter bit_writer_;
   // Note: Counting bits instead of bytes wraps around earlier than it has to,
   // which means the maximum length is lower than it could be. We don't expect
@@ -233,9 +238,9 @@ class FixedLengthDeltaEncoder final {
   // determine whether it was produced by FixedLengthDeltaEncoder, and can
   // therefore be decoded by FixedLengthDeltaDecoder, or whether it was produced
   // by a different encoder.
-  static std::string EncodeDeltas(
-      absl::optional<uint64_t> base,
-      const std::vector<absl::optional<uint64_t>>& values);
+  static void EncodeDeltas(absl::optional<uint64_t> base,
+                           const std::vector<absl::optional<uint64_t>>& values,
+                           std::string* output);
 
  private:
   // Calculate min/max values of unsigned/signed deltas, given the bit width
@@ -262,11 +267,12 @@ class FixedLengthDeltaEncoder final {
   FixedLengthDeltaEncoder(const FixedLengthEncodingParameters& params,
                           absl::optional<uint64_t> base,
                           const std::vector<absl::optional<uint64_t>>& values,
-                          size_t existent_values_count);
+                          size_t existent_values_count,
+                          std::string* output);
 
   // Perform delta-encoding using the parameters given to the ctor on the
-  // sequence of values given to the ctor.
-  std::string Encode();
+  // sequence of values given to the ctor, into the output given to the ctor.
+  void Encode();
 
   // Exact lengths.
   size_t OutputLengthBytes(size_t existent_values_count) const;
@@ -294,19 +300,19 @@ class FixedLengthDeltaEncoder final {
   // Note: This is a non-owning reference. See comment above ctor for details.
   const std::vector<absl::optional<uint64_t>>& values_;
 
-  // Buffer into which encoded values will be written.
-  // This is created dynmically as a way to enforce that the rest of the
-  // ctor has finished running when this is constructed, so that the lower
-  // bound on the buffer size would be guaranteed correct.
-  std::unique_ptr<BitWriter> writer_;
+  // Writes encoded values into the output given to the ctor.
+  // This must be declared after the members above, which the lower bound on
+  // the buffer size is computed from.
+  BitWriter writer_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(FixedLengthDeltaEncoder);
 };
 
 // TODO(eladalon): Reduce the number of passes.
-std::string FixedLengthDeltaEncoder::EncodeDeltas(
+void FixedLengthDeltaEncoder::EncodeDeltas(
     absl::optional<uint64_t> base,
-    const std::vector<absl::optional<uint64_t>>& values) {
+    const std::vector<absl::optional<uint64_t>>& values,
+    std::string* output) {
   RTC_DCHECK(!values.empty());
 
   // As a special case, if all of the elements are identical to the base,
@@ -315,7 +321,8 @@ std::string FixedLengthDeltaEncoder::EncodeDeltas(
   if (std::all_of(
           values.cbegin(), values.cend(),
           [base](absl::optional<uint64_t> val) { return val == base; })) {
-    return std::string();
+    output->clear();
+    return;
   }
 
   bool non_decreasing = true;
@@ -367,8 +374,9 @@ std::string FixedLengthDeltaEncoder::EncodeDeltas(
   ConsiderTestOverrides(&params, delta_width_bits_signed,
                         delta_width_bits_unsigned);
 
-  FixedLengthDeltaEncoder encoder(params, base, values, existent_values_count);
-  return encoder.Encode();
+  FixedLengthDeltaEncoder encoder(params, base, values, existent_values_count,
+                                  output);
+  encoder.Encode();
 }
 
 void FixedLengthDeltaEncoder::CalculateMinAndMaxDeltas(
@@ -443,20 +451,22 @@ FixedLengthDeltaEncoder::FixedLengthDeltaEncoder(
     const FixedLengthEncodingParameters& params,
     absl::optional<uint64_t> base,
     const std::vector<absl::optional<uint64_t>>& values,
-    size_t existent_values_count)
-    : params_(params), base_(base), values_(values) {
+    size_t existent_values_count,
+    std::string* output)
+    : params_(params),
+      base_(base),
+      values_(values),
+      writer_(output, OutputLengthBytes(existent_values_count)) {
   RTC_DCHECK(!values_.empty());
-  writer_ =
-      absl::make_unique<BitWriter>(OutputLengthBytes(existent_values_count));
 }
 
-std::string FixedLengthDeltaEncoder::Encode() {
+void FixedLengthDeltaEncoder::Encode() {
   EncodeHeader();
 
   if (params_.values_optional()) {
     // Encode which values exist and which don't.
     for (absl::optional<uint64_t> value : values_) {
-      writer_->WriteBits(value.has_value() ? 1u : 0u, 1);
+      writer_.WriteBits(value.has_value() ? 1u : 0u, 1);
     }
   }
 
@@ -471,7 +481,8 @@ std::string FixedLengthDeltaEncoder::Encode() {
       // If the base is non-existent, the first existent value is encoded as
       // a varint, rather than as a delta.
       RTC_DCHECK(!base_.has_value());
-      writer_->WriteBits(EncodeVarInt(value.value()));
+      char varint[kMaxVarIntLengthBytes];
+      writer_.WriteBits(varint, EncodeVarInt(value.value(), varint));
     } else {
       EncodeDelta(previous.value(), value.value());
     }
@@ -479,7 +490,7 @@ std::string FixedLengthDeltaEncoder::Encode() {
     previous = value;
   }
 
-  return writer_->GetString();
+  writer_.Finish();
 }
 
 size_t FixedLengthDeltaEncoder::OutputLengthBytes(
@@ -526,8 +537,6 @@ size_t FixedLengthDeltaEncoder::EncodedDeltasLengthBits(
 }
 
 void FixedLengthDeltaEncoder::EncodeHeader() {
-  RTC_DCHECK(writer_);
-
   const EncodingType encoding_type =
       (params_.value_width_bits() == kDefaultValueWidthBits &&
        params_.signed_deltas() == kDefaultSignedDeltas &&
@@ -535,25 +544,25 @@ void FixedLengthDeltaEncoder::EncodeHeader() {
           ? EncodingType::kFixedSizeUnsignedDeltasNoEarlyWrapNoOpt
           : EncodingType::kFixedSizeSignedDeltasEarlyWrapAndOptSupported;
 
-  writer_->WriteBits(static_cast<uint64_t>(encoding_type),
-                     kBitsInHeaderForEncodingType);
+  writer_.WriteBits(static_cast<uint64_t>(encoding_type),
+                    kBitsInHeaderForEncodingType);
 
   // Note: Since it's meaningless for a field to be of width 0, when it comes
   // to fields that relate widths, we encode  width 1 as 0, width 2 as 1,
 
-  writer_->WriteBits(params_.delta_width_bits() - 1,
-                     kBitsInHeaderForDeltaWidthBits);
+  writer_.WriteBits(params_.delta_width_bits() - 1,
+                    kBitsInHeaderForDeltaWidthBits);
 
   if (encoding_type == EncodingType::kFixedSizeUnsignedDeltasNoEarlyWrapNoOpt) {
     return;
   }
 
-  writer_->WriteBits(static_cast<uint64_t>(params_.signed_deltas()),
-                     kBitsInHeaderForSignedDeltas);
-  writer_->WriteBits(static_cast<uint64_t>(params_.values_optional()),
-                     kBitsInHeaderForValuesOptional);
-  writer_->WriteBits(params_.value_width_bits() - 1,
-                     kBitsInHeaderForValueWidthBits);
+  writer_.WriteBits(static_cast<uint64_t>(params_.signed_deltas()),
+                    kBitsInHeaderForSignedDeltas);
+  writer_.WriteBits(static_cast<uint64_t>(params_.values_optional()),
+                    kBitsInHeaderForValuesOptional);
+  writer_.WriteBits(params_.value_width_bits() - 1,
+                    kBitsInHeaderForValueWidthBits);
 }
 
 void FixedLengthDeltaEncoder::EncodeDelta(uint64_t previous, uint64_t current) {
@@ -566,15 +575,12 @@ void FixedLengthDeltaEncoder::EncodeDelta(uint64_t previous, uint64_t current) {
 
 void FixedLengthDeltaEncoder::EncodeUnsignedDelta(uint64_t previous,
                                                   uint64_t current) {
-  RTC_DCHECK(writer_);
   const uint64_t delta = UnsignedDelta(previous, current, params_.value_mask());
-  writer_->WriteBits(delta, params_.delta_width_bits());
+  writer_.WriteBits(delta, params_.delta_width_bits());
 }
 
 void FixedLengthDeltaEncoder::EncodeSignedDelta(uint64_t previous,
                                                 uint64_t current) {
-  RTC_DCHECK(writer_);
-
   const uint64_t forward_delta =
       UnsignedDelta(previous, current, params_.value_mask());
   const uint64_t backward_delta =
@@ -593,7 +599,7 @@ void FixedLengthDeltaEncoder::EncodeSignedDelta(uint64_t previous,
     RTC_DCHECK_LE(delta, params_.delta_mask());
   }
 
-  writer_->WriteBits(delta, params_.delta_width_bits());
+  writer_.WriteBits(delta, params_.delta_width_bits());
 }
 
 // Perform decoding of a a delta-encoded stream, extracting the original
@@ -935,8 +941,17 @@ uint64_t FixedLengthDeltaDecoder::ApplySignedDelta(uint64_t base,
 
 std::string EncodeDeltas(absl::optional<uint64_t> base,
                          const std::vector<absl::optional<uint64_t>>& values) {
+  std::string output;
+  EncodeDeltas(base, values, &output);
+  return output;
+}
+
+void EncodeDeltas(absl::optional<uint64_t> base,
+                  const std::vector<absl::optional<uint64_t>>& values,
+                  std::string* output) {
+  RTC_DCHECK(output);
   // TODO(eladalon): Support additional encodings.
-  return FixedLengthDeltaEncoder::EncodeDeltas(base, values);
+  FixedLengthDeltaEncoder::EncodeDeltas(base, values, output);
 }
 
 std::vector<absl::optional<uint64_t>> DecodeDeltas(
@@ -30,6 +30,12 @@ namespace webrtc {
 std::string EncodeDeltas(absl::optional<uint64_t> base,
                          const std::vector<absl::optional<uint64_t>>& values);
 
+// Same as other version, but writes the encoding into |output|, whose
+// capacity is reused, so that encoding many fields doesn't allocate for each.
+void EncodeDeltas(absl::optional<uint64_t> base,
+                  const std::vector<absl::optional<uint64_t>>& values,
+                  std::string* output);
+
 // EncodeDeltas() and DecodeDeltas() are inverse operations;
 // invoking DecodeDeltas() over the output of EncodeDeltas(), will return
 // the input originally given to EncodeDeltas().
@@ -244,6 +244,27 @@ TEST_P(DeltaEncodingTest, BaseNonExistentButSomeOtherValuesExist) {
   TestEncodingAndDecoding(base, values);
 }
 
+TEST_P(DeltaEncodingTest, ReusedOutputMatchesFreshOutput) {
+  const absl::optional<uint64_t> base(3432);
+  std::vector<absl::optional<uint64_t>> values(num_of_values_);
+
+  Random prng(Seed());
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (!optional_values_ || prng.Rand<bool>()) {
+      values[i] = RandomWithMaxBitWidth(&prng, 20);
+    }
+  }
+
+  // Bits that the encoding doesn't set must not be left over in the output.
+  std::string output(1000, '\xff');
+  EncodeDeltas(base, values, &output);
+  EXPECT_EQ(EncodeDeltas(base, values), output);
+
+  std::fill(values.begin(), values.end(), base);
+  EncodeDeltas(base, values, &output);
+  EXPECT_TRUE(output.empty());
+}
+
 TEST_P(DeltaEncodingTest, MinDeltaNoWrapAround) {
   const absl::optional<uint64_t> base(3432);
 
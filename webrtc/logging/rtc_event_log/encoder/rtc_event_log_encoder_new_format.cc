@@ -343,7 +343,7 @@ void EncodeRtcpPacket(rtc::ArrayView<const EventType*> batch,
     const EventType* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -455,7 +455,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -465,7 +465,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->header().Marker();
   }
-  encoded_deltas = EncodeDeltas(base_event->header().Marker(), values);
+  EncodeDeltas(base_event->header().Marker(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_marker_deltas(encoded_deltas);
   }
@@ -475,7 +475,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->header().PayloadType();
   }
-  encoded_deltas = EncodeDeltas(base_event->header().PayloadType(), values);
+  EncodeDeltas(base_event->header().PayloadType(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_payload_type_deltas(encoded_deltas);
   }
@@ -485,7 +485,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->header().SequenceNumber();
   }
-  encoded_deltas = EncodeDeltas(base_event->header().SequenceNumber(), values);
+  EncodeDeltas(base_event->header().SequenceNumber(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_sequence_number_deltas(encoded_deltas);
   }
@@ -495,7 +495,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->header().Timestamp();
   }
-  encoded_deltas = EncodeDeltas(base_event->header().Timestamp(), values);
+  EncodeDeltas(base_event->header().Timestamp(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_rtp_timestamp_deltas(encoded_deltas);
   }
@@ -505,7 +505,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->header().Ssrc();
   }
-  encoded_deltas = EncodeDeltas(base_event->header().Ssrc(), values);
+  EncodeDeltas(base_event->header().Ssrc(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_ssrc_deltas(encoded_deltas);
   }
@@ -515,7 +515,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->payload_length();
   }
-  encoded_deltas = EncodeDeltas(base_event->payload_length(), values);
+  EncodeDeltas(base_event->payload_length(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_payload_size_deltas(encoded_deltas);
   }
@@ -525,7 +525,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->header_length();
   }
-  encoded_deltas = EncodeDeltas(base_event->header_length(), values);
+  EncodeDeltas(base_event->header_length(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_header_size_deltas(encoded_deltas);
   }
@@ -535,7 +535,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
     const EventType* event = batch[i + 1];
     values[i] = event->padding_length();
   }
-  encoded_deltas = EncodeDeltas(base_event->padding_length(), values);
+  EncodeDeltas(base_event->padding_length(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_padding_size_deltas(encoded_deltas);
   }
@@ -551,7 +551,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
       values[i].reset();
     }
   }
-  encoded_deltas = EncodeDeltas(base_transport_sequence_number, values);
+  EncodeDeltas(base_transport_sequence_number, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_transport_sequence_number_deltas(encoded_deltas);
   }
@@ -566,7 +566,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
       values[i].reset();
     }
   }
-  encoded_deltas = EncodeDeltas(unsigned_base_transmission_time_offset, values);
+  EncodeDeltas(unsigned_base_transmission_time_offset, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_transmission_time_offset_deltas(encoded_deltas);
   }
@@ -581,7 +581,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
       values[i].reset();
     }
   }
-  encoded_deltas = EncodeDeltas(base_absolute_send_time, values);
+  EncodeDeltas(base_absolute_send_time, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_absolute_send_time_deltas(encoded_deltas);
   }
@@ -597,7 +597,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
       values[i].reset();
     }
   }
-  encoded_deltas = EncodeDeltas(base_video_rotation, values);
+  EncodeDeltas(base_video_rotation, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_video_rotation_deltas(encoded_deltas);
   }
@@ -615,7 +615,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
       values[i].reset();
     }
   }
-  encoded_deltas = EncodeDeltas(base_audio_level, values);
+  EncodeDeltas(base_audio_level, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_audio_level_deltas(encoded_deltas);
   }
@@ -633,7 +633,7 @@ void EncodeRtpPacket(const std::vector<const EventType*>& batch,
       values[i].reset();
     }
   }
-  encoded_deltas = EncodeDeltas(base_voice_activity, values);
+  EncodeDeltas(base_voice_activity, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_voice_activity_deltas(encoded_deltas);
   }
@@ -933,7 +933,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
     const RtcEventAudioNetworkAdaptation* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -951,7 +951,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
       base_event->config().bitrate_bps.has_value()
           ? ToUnsigned(base_event->config().bitrate_bps.value())
           : absl::optional<uint64_t>();
-  encoded_deltas = EncodeDeltas(unsigned_base_bitrate_bps, values);
+  EncodeDeltas(unsigned_base_bitrate_bps, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_bitrate_bps_deltas(encoded_deltas);
   }
@@ -969,7 +969,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
       base_event->config().frame_length_ms.has_value()
           ? ToUnsigned(base_event->config().frame_length_ms.value())
           : absl::optional<uint64_t>();
-  encoded_deltas = EncodeDeltas(unsigned_base_frame_length_ms, values);
+  EncodeDeltas(unsigned_base_frame_length_ms, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_frame_length_ms_deltas(encoded_deltas);
   }
@@ -984,7 +984,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
       values[i].reset();
     }
   }
-  encoded_deltas = EncodeDeltas(base_uplink_packet_loss_fraction, values);
+  EncodeDeltas(base_uplink_packet_loss_fraction, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_uplink_packet_loss_fraction_deltas(encoded_deltas);
   }
@@ -994,7 +994,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
     const RtcEventAudioNetworkAdaptation* event = batch[i + 1];
     values[i] = event->config().enable_fec;
   }
-  encoded_deltas = EncodeDeltas(base_event->config().enable_fec, values);
+  EncodeDeltas(base_event->config().enable_fec, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_enable_fec_deltas(encoded_deltas);
   }
@@ -1004,7 +1004,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
     const RtcEventAudioNetworkAdaptation* event = batch[i + 1];
     values[i] = event->config().enable_dtx;
   }
-  encoded_deltas = EncodeDeltas(base_event->config().enable_dtx, values);
+  EncodeDeltas(base_event->config().enable_dtx, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_enable_dtx_deltas(encoded_deltas);
   }
@@ -1032,7 +1032,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
     RTC_DCHECK_GT(base_event->config().num_channels.value(), 0u);
     shifted_base_num_channels = base_event->config().num_channels.value() - 1;
   }
-  encoded_deltas = EncodeDeltas(shifted_base_num_channels, values);
+  EncodeDeltas(shifted_base_num_channels, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_num_channels_deltas(encoded_deltas);
   }
@@ -1064,7 +1064,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioPlayout(
     const RtcEventAudioPlayout* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -1074,7 +1074,7 @@ void RtcEventLogEncoderNewFormat::EncodeAudioPlayout(
     const RtcEventAudioPlayout* event = batch[i + 1];
     values[i] = event->ssrc();
   }
-  encoded_deltas = EncodeDeltas(base_event->ssrc(), values);
+  EncodeDeltas(base_event->ssrc(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_local_ssrc_deltas(encoded_deltas);
   }
@@ -1145,7 +1145,7 @@ void RtcEventLogEncoderNewFormat::EncodeBweUpdateDelayBased(
     const RtcEventBweUpdateDelayBased* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -1155,7 +1155,7 @@ void RtcEventLogEncoderNewFormat::EncodeBweUpdateDelayBased(
     const RtcEventBweUpdateDelayBased* event = batch[i + 1];
     values[i] = event->bitrate_bps();
   }
-  encoded_deltas = EncodeDeltas(base_event->bitrate_bps(), values);
+  EncodeDeltas(base_event->bitrate_bps(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_bitrate_bps_deltas(encoded_deltas);
   }
@@ -1166,9 +1166,9 @@ void RtcEventLogEncoderNewFormat::EncodeBweUpdateDelayBased(
     values[i] =
         static_cast<uint64_t>(ConvertToProtoFormat(event->detector_state()));
   }
-  encoded_deltas = EncodeDeltas(
+  EncodeDeltas(
       static_cast<uint64_t>(ConvertToProtoFormat(base_event->detector_state())),
-      values);
+      values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_detector_state_deltas(encoded_deltas);
   }
@@ -1202,7 +1202,7 @@ void RtcEventLogEncoderNewFormat::EncodeBweUpdateLossBased(
     const RtcEventBweUpdateLossBased* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -1212,7 +1212,7 @@ void RtcEventLogEncoderNewFormat::EncodeBweUpdateLossBased(
     const RtcEventBweUpdateLossBased* event = batch[i + 1];
     values[i] = event->bitrate_bps();
   }
-  encoded_deltas = EncodeDeltas(base_event->bitrate_bps(), values);
+  EncodeDeltas(base_event->bitrate_bps(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_bitrate_bps_deltas(encoded_deltas);
   }
@@ -1222,7 +1222,7 @@ void RtcEventLogEncoderNewFormat::EncodeBweUpdateLossBased(
     const RtcEventBweUpdateLossBased* event = batch[i + 1];
     values[i] = event->fraction_loss();
   }
-  encoded_deltas = EncodeDeltas(base_event->fraction_loss(), values);
+  EncodeDeltas(base_event->fraction_loss(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_fraction_loss_deltas(encoded_deltas);
   }
@@ -1232,7 +1232,7 @@ void RtcEventLogEncoderNewFormat::EncodeBweUpdateLossBased(
     const RtcEventBweUpdateLossBased* event = batch[i + 1];
     values[i] = event->total_packets();
   }
-  encoded_deltas = EncodeDeltas(base_event->total_packets(), values);
+  EncodeDeltas(base_event->total_packets(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_total_packets_deltas(encoded_deltas);
   }
@@ -1358,7 +1358,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsSent(
     const RtcEventGenericPacketSent* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -1368,8 +1368,8 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsSent(
     const RtcEventGenericPacketSent* event = batch[i + 1];
     values[i] = ToUnsigned(event->packet_number());
   }
-  encoded_deltas =
-      EncodeDeltas(ToUnsigned(base_event->packet_number()), values);
+  EncodeDeltas(ToUnsigned(base_event->packet_number()), values,
+               &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_packet_number_deltas(encoded_deltas);
   }
@@ -1379,7 +1379,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsSent(
     const RtcEventGenericPacketSent* event = batch[i + 1];
     values[i] = event->overhead_length();
   }
-  encoded_deltas = EncodeDeltas(base_event->overhead_length(), values);
+  EncodeDeltas(base_event->overhead_length(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_overhead_length_deltas(encoded_deltas);
   }
@@ -1389,7 +1389,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsSent(
     const RtcEventGenericPacketSent* event = batch[i + 1];
     values[i] = event->payload_length();
   }
-  encoded_deltas = EncodeDeltas(base_event->payload_length(), values);
+  EncodeDeltas(base_event->payload_length(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_payload_length_deltas(encoded_deltas);
   }
@@ -1399,7 +1399,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsSent(
     const RtcEventGenericPacketSent* event = batch[i + 1];
     values[i] = event->padding_length();
   }
-  encoded_deltas = EncodeDeltas(base_event->padding_length(), values);
+  EncodeDeltas(base_event->padding_length(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_padding_length_deltas(encoded_deltas);
   }
@@ -1432,7 +1432,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsReceived(
     const RtcEventGenericPacketReceived* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -1442,8 +1442,8 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsReceived(
     const RtcEventGenericPacketReceived* event = batch[i + 1];
     values[i] = ToUnsigned(event->packet_number());
   }
-  encoded_deltas =
-      EncodeDeltas(ToUnsigned(base_event->packet_number()), values);
+  EncodeDeltas(ToUnsigned(base_event->packet_number()), values,
+               &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_packet_number_deltas(encoded_deltas);
   }
@@ -1453,7 +1453,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericPacketsReceived(
     const RtcEventGenericPacketReceived* event = batch[i + 1];
     values[i] = event->packet_length();
   }
-  encoded_deltas = EncodeDeltas(base_event->packet_length(), values);
+  EncodeDeltas(base_event->packet_length(), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_packet_length_deltas(encoded_deltas);
   }
@@ -1493,7 +1493,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericAcksReceived(
     const RtcEventGenericAckReceived* event = batch[i + 1];
     values[i] = ToUnsigned(event->timestamp_ms());
   }
-  encoded_deltas = EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values);
+  EncodeDeltas(ToUnsigned(base_event->timestamp_ms()), values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_timestamp_ms_deltas(encoded_deltas);
   }
@@ -1503,8 +1503,8 @@ void RtcEventLogEncoderNewFormat::EncodeGenericAcksReceived(
     const RtcEventGenericAckReceived* event = batch[i + 1];
     values[i] = ToUnsigned(event->packet_number());
   }
-  encoded_deltas =
-      EncodeDeltas(ToUnsigned(base_event->packet_number()), values);
+  EncodeDeltas(ToUnsigned(base_event->packet_number()), values,
+               &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_packet_number_deltas(encoded_deltas);
   }
@@ -1514,8 +1514,8 @@ void RtcEventLogEncoderNewFormat::EncodeGenericAcksReceived(
     const RtcEventGenericAckReceived* event = batch[i + 1];
     values[i] = ToUnsigned(event->acked_packet_number());
   }
-  encoded_deltas =
-      EncodeDeltas(ToUnsigned(base_event->acked_packet_number()), values);
+  EncodeDeltas(ToUnsigned(base_event->acked_packet_number()), values,
+               &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_acked_packet_number_deltas(encoded_deltas);
   }
@@ -1529,7 +1529,7 @@ void RtcEventLogEncoderNewFormat::EncodeGenericAcksReceived(
       values[i] = absl::nullopt;
     }
   }
-  encoded_deltas = EncodeDeltas(base_receive_timestamp, values);
+  EncodeDeltas(base_receive_timestamp, values, &encoded_deltas);
   if (!encoded_deltas.empty()) {
     proto_batch->set_receive_acked_packet_time_ms_deltas(encoded_deltas);
   }
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the time and output size of encoding RtcEventLog events, per event
+// type, with the legacy and the new format encoder.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
+#include "logging/rtc_event_log/events/rtc_event_alr_state.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_playout.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_delay_based.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_loss_based.h"
+#include "logging/rtc_event_log/events/rtc_event_probe_cluster_created.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_outgoing.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
+#include "logging/rtc_event_log/rtc_event_log_unittest_helper.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kNumEvents = 100000;
+constexpr size_t kQuickNumEvents = 10000;
+// Events encoded per call, as in a log written every few seconds.
+constexpr size_t kEventsPerBatch = 5000;
+constexpr uint64_t kSeed = 1234;
+constexpr uint32_t kSsrc = 0x12345678;
+
+using EventFactory = std::function<std::unique_ptr<RtcEvent>()>;
+
+struct EncodeCost {
+  double time_ns_per_event = 0;
+  double bytes_per_event = 0;
+};
+
+struct EncoderCosts {
+  EncodeCost legacy;
+  EncodeCost new_format;
+};
+
+EncodeCost MeasureEncodeCost(
+    RtcEventLogEncoder* encoder,
+    const std::deque<std::unique_ptr<RtcEvent>>& events) {
+  size_t encoded_bytes = 0;
+  const int64_t start_us = rtc::TimeMicros();
+  for (size_t i = 0; i < events.size(); i += kEventsPerBatch) {
+    const auto begin = events.begin() + i;
+    const auto end =
+        events.begin() + std::min(i + kEventsPerBatch, events.size());
+    encoded_bytes += encoder->EncodeBatch(begin, end).size();
+  }
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  EXPECT_GT(encoded_bytes, 0u);
+
+  EncodeCost cost;
+  cost.time_ns_per_event = 1e3 * elapsed_us / events.size();
+  cost.bytes_per_event = static_cast<double>(encoded_bytes) / events.size();
+  return cost;
+}
+
+// Encodes the same events, made by |create_event|, with both encoders.
+EncoderCosts MeasureEncoders(const EventFactory& create_event) {
+  const size_t num_events = field_trial::IsEnabled("WebRTC-QuickPerfTest")
+                                ? kQuickNumEvents
+                                : kNumEvents;
+  std::deque<std::unique_ptr<RtcEvent>> events;
+  for (size_t i = 0; i < num_events; ++i)
+    events.push_back(create_event());
+
+  RtcEventLogEncoderLegacy legacy_encoder;
+  RtcEventLogEncoderNewFormat new_format_encoder;
+  EncoderCosts costs;
+  costs.legacy = MeasureEncodeCost(&legacy_encoder, events);
+  costs.new_format = MeasureEncodeCost(&new_format_encoder, events);
+  return costs;
+}
+
+}  // namespace
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_RtpPacketOutgoing) {
+  test::EventGenerator gen(kSeed);
+  const RtpHeaderExtensionMap extensions =
+      gen.NewRtpHeaderExtensionMap(/*configure_all=*/true);
+  const EncoderCosts costs = MeasureEncoders(
+      [&] { return gen.NewRtpPacketOutgoing(kSsrc, extensions); });
+  test::PrintResult("rtc_event_log_encode_time", "", "rtp_outgoing_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "", "rtp_outgoing_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "rtp_outgoing_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "rtp_outgoing_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_RtpPacketIncoming) {
+  test::EventGenerator gen(kSeed);
+  const RtpHeaderExtensionMap extensions =
+      gen.NewRtpHeaderExtensionMap(/*configure_all=*/true);
+  const EncoderCosts costs = MeasureEncoders(
+      [&] { return gen.NewRtpPacketIncoming(kSsrc, extensions); });
+  test::PrintResult("rtc_event_log_encode_time", "", "rtp_incoming_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "", "rtp_incoming_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "rtp_incoming_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "rtp_incoming_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_RtcpPacketOutgoing) {
+  test::EventGenerator gen(kSeed);
+  const EncoderCosts costs =
+      MeasureEncoders([&] { return gen.NewRtcpPacketOutgoing(); });
+  test::PrintResult("rtc_event_log_encode_time", "", "rtcp_outgoing_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "", "rtcp_outgoing_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "rtcp_outgoing_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "",
+                    "rtcp_outgoing_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_RtcpPacketIncoming) {
+  test::EventGenerator gen(kSeed);
+  const EncoderCosts costs =
+      MeasureEncoders([&] { return gen.NewRtcpPacketIncoming(); });
+  test::PrintResult("rtc_event_log_encode_time", "", "rtcp_incoming_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "", "rtcp_incoming_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "rtcp_incoming_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "",
+                    "rtcp_incoming_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_BweUpdateDelayBased) {
+  test::EventGenerator gen(kSeed);
+  const EncoderCosts costs =
+      MeasureEncoders([&] { return gen.NewBweUpdateDelayBased(); });
+  test::PrintResult("rtc_event_log_encode_time", "", "bwe_delay_based_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "",
+                    "bwe_delay_based_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "bwe_delay_based_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "",
+                    "bwe_delay_based_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_BweUpdateLossBased) {
+  test::EventGenerator gen(kSeed);
+  const EncoderCosts costs =
+      MeasureEncoders([&] { return gen.NewBweUpdateLossBased(); });
+  test::PrintResult("rtc_event_log_encode_time", "", "bwe_loss_based_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "",
+                    "bwe_loss_based_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "bwe_loss_based_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "",
+                    "bwe_loss_based_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_ProbeClusterCreated) {
+  test::EventGenerator gen(kSeed);
+  const EncoderCosts costs =
+      MeasureEncoders([&] { return gen.NewProbeClusterCreated(); });
+  test::PrintResult("rtc_event_log_encode_time", "",
+                    "probe_cluster_created_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "",
+                    "probe_cluster_created_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "",
+                    "probe_cluster_created_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "",
+                    "probe_cluster_created_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_AudioPlayout) {
+  test::EventGenerator gen(kSeed);
+  const EncoderCosts costs =
+      MeasureEncoders([&] { return gen.NewAudioPlayout(kSsrc); });
+  test::PrintResult("rtc_event_log_encode_time", "", "audio_playout_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "", "audio_playout_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "audio_playout_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "",
+                    "audio_playout_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+TEST(RtcEventLogEncoderPerformanceTest, DISABLED_AlrState) {
+  test::EventGenerator gen(kSeed);
+  const EncoderCosts costs = MeasureEncoders([&] { return gen.NewAlrState(); });
+  test::PrintResult("rtc_event_log_encode_time", "", "alr_state_legacy",
+                    costs.legacy.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encode_time", "", "alr_state_new_format",
+                    costs.new_format.time_ns_per_event, "ns/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "alr_state_legacy",
+                    costs.legacy.bytes_per_event, "bytes/event", false);
+  test::PrintResult("rtc_event_log_encoded_size", "", "alr_state_new_format",
+                    costs.new_format.bytes_per_event, "bytes/event", false);
+}
+
+}  // namespace webrtc
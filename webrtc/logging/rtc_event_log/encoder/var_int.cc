@@ -16,25 +16,29 @@
 
 namespace webrtc {
 
-const size_t kMaxVarIntLengthBytes = 10;  // ceil(64 / 7.0) is 10.
-
 std::string EncodeVarInt(uint64_t input) {
-  std::string output;
-  output.reserve(kMaxVarIntLengthBytes);
+  char buffer[kMaxVarIntLengthBytes];
+  const size_t length = EncodeVarInt(input, buffer);
+  return std::string(buffer, length);
+}
+
+size_t EncodeVarInt(uint64_t input, char* output) {
+  RTC_DCHECK(output);
 
+  size_t length = 0;
   do {
     uint8_t byte = static_cast<uint8_t>(input & 0x7f);
     input >>= 7;
     if (input > 0) {
       byte |= 0x80;
     }
-    output += byte;
+    output[length++] = byte;
   } while (input > 0);
 
-  RTC_DCHECK_GE(output.size(), 1u);
-  RTC_DCHECK_LE(output.size(), kMaxVarIntLengthBytes);
+  RTC_DCHECK_GE(length, 1u);
+  RTC_DCHECK_LE(length, kMaxVarIntLengthBytes);
 
-  return output;
+  return length;
 }
 
 // There is some code duplication between the flavors of this function.
@@ -20,7 +20,7 @@
 
 namespace webrtc {
 
-extern const size_t kMaxVarIntLengthBytes;
+constexpr size_t kMaxVarIntLengthBytes = 10;  // ceil(64 / 7.0) is 10.
 
 // Encode a given uint64_t as a varint. From least to most significant,
 // each batch of seven bits are put into the lower bits of a byte, and the last
@@ -31,6 +31,10 @@ extern const size_t kMaxVarIntLengthBytes;
 // kMaxVarIntLengthBytes are used.
 std::string EncodeVarInt(uint64_t input);
 
+// Same as other version, but writes the varint into |output|, which must have
+// room for kMaxVarIntLengthBytes, and returns the number of bytes written.
+size_t EncodeVarInt(uint64_t input, char* output);
+
 // Inverse of EncodeVarInt().
 // If decoding is successful, a non-zero number is returned, indicating the
 // number of bytes read from |input|, and the decoded varint is written
@@ -10,6 +10,7 @@
 
 #include "logging/rtc_event_log/rtc_event_log.h"
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <limits>
@@ -44,6 +45,8 @@ constexpr size_t kMaxEventsInHistory = 10000;
 // The config-history is supposed to be unbounded, but needs to have some bound
 // to prevent an attack via unreasonable memory use.
 constexpr size_t kMaxEventsInConfigHistory = 1000;
+// Events handed to the writer that it hasn't encoded yet.
+constexpr size_t kMaxPendingEvents = 5 * kMaxEventsInHistory;
 
 // TODO(eladalon): This class exists because C++11 doesn't allow transferring a
 // unique_ptr to a lambda (a copy constructor is required). We should get
@@ -85,7 +88,9 @@ std::unique_ptr<RtcEventLogEncoder> CreateEncoder(
 class RtcEventLogImpl final : public RtcEventLog {
  public:
   RtcEventLogImpl(std::unique_ptr<RtcEventLogEncoder> event_encoder,
-                  std::unique_ptr<rtc::TaskQueue> task_queue);
+                  std::unique_ptr<RtcEventLogEncoder> config_encoder,
+                  std::unique_ptr<rtc::TaskQueue> task_queue,
+                  std::unique_ptr<rtc::TaskQueue> writer_queue);
 
   ~RtcEventLogImpl() override;
 
@@ -98,17 +103,23 @@ class RtcEventLogImpl final : public RtcEventLog {
   void Log(std::unique_ptr<RtcEvent> event) override;
 
  private:
+  using EventDeque = std::deque<std::unique_ptr<RtcEvent>>;
+
   void LogToMemory(std::unique_ptr<RtcEvent> event) RTC_RUN_ON(task_queue_);
   void LogEventsFromMemoryToOutput() RTC_RUN_ON(task_queue_);
+  // Returns whether events are being sent to the writer, which stops once the
+  // output has failed.
+  bool IsLoggingToOutput() RTC_RUN_ON(task_queue_);
 
-  void StopOutput() RTC_RUN_ON(task_queue_);
+  void StopOutput() RTC_RUN_ON(writer_queue_);
 
   void WriteConfigsAndHistoryToOutput(const std::string& encoded_configs,
                                       const std::string& encoded_history)
-      RTC_RUN_ON(task_queue_);
-  void WriteToOutput(const std::string& output_string) RTC_RUN_ON(task_queue_);
+      RTC_RUN_ON(writer_queue_);
+  void WriteToOutput(const std::string& output_string)
+      RTC_RUN_ON(writer_queue_);
 
-  void StopLoggingInternal() RTC_RUN_ON(task_queue_);
+  void StopLoggingInternal() RTC_RUN_ON(writer_queue_);
 
   void ScheduleOutput() RTC_RUN_ON(task_queue_);
 
@@ -117,23 +128,38 @@ class RtcEventLogImpl final : public RtcEventLog {
   rtc::SequencedTaskChecker owner_sequence_checker_;
 
   // History containing all past configuration events.
-  std::deque<std::unique_ptr<RtcEvent>> config_history_
-      RTC_GUARDED_BY(*task_queue_);
+  EventDeque config_history_ RTC_GUARDED_BY(*task_queue_);
 
   // History containing the most recent (non-configuration) events (~10s).
-  std::deque<std::unique_ptr<RtcEvent>> history_ RTC_GUARDED_BY(*task_queue_);
-
-  size_t max_size_bytes_ RTC_GUARDED_BY(*task_queue_);
-  size_t written_bytes_ RTC_GUARDED_BY(*task_queue_);
+  EventDeque history_ RTC_GUARDED_BY(*task_queue_);
 
-  std::unique_ptr<RtcEventLogEncoder> event_encoder_
+  // Configuration events are few, and are encoded where they are kept.
+  std::unique_ptr<RtcEventLogEncoder> config_encoder_
       RTC_GUARDED_BY(*task_queue_);
-  std::unique_ptr<RtcEventLogOutput> event_output_ RTC_GUARDED_BY(*task_queue_);
-
+  bool logging_to_output_ RTC_GUARDED_BY(*task_queue_);
   size_t num_config_events_written_ RTC_GUARDED_BY(*task_queue_);
   absl::optional<int64_t> output_period_ms_ RTC_GUARDED_BY(*task_queue_);
   int64_t last_output_ms_ RTC_GUARDED_BY(*task_queue_);
   bool output_scheduled_ RTC_GUARDED_BY(*task_queue_);
+  size_t num_dropped_events_ RTC_GUARDED_BY(*task_queue_);
+
+  // Events handed to the writer and not yet encoded, which bounds the memory
+  // held if the writer falls behind.
+  std::atomic<size_t> num_pending_events_;
+  // Set by the writer when the output fails.
+  std::atomic<bool> output_failed_;
+
+  size_t max_size_bytes_ RTC_GUARDED_BY(*writer_queue_);
+  size_t written_bytes_ RTC_GUARDED_BY(*writer_queue_);
+
+  std::unique_ptr<RtcEventLogEncoder> event_encoder_
+      RTC_GUARDED_BY(*writer_queue_);
+  std::unique_ptr<RtcEventLogOutput> event_output_
+      RTC_GUARDED_BY(*writer_queue_);
+
+  // Encodes and writes the batches of events, so that neither blocks the
+  // |task_queue_| events are logged on.
+  std::unique_ptr<rtc::TaskQueue> writer_queue_;
 
   // Since we are posting tasks bound to |this|,  it is critical that the event
   // log and it's members outlive the |task_queue_|. Keep the "task_queue_|
@@ -146,15 +172,24 @@ class RtcEventLogImpl final : public RtcEventLog {
 
 RtcEventLogImpl::RtcEventLogImpl(
     std::unique_ptr<RtcEventLogEncoder> event_encoder,
-    std::unique_ptr<rtc::TaskQueue> task_queue)
-    : max_size_bytes_(std::numeric_limits<decltype(max_size_bytes_)>::max()),
-      written_bytes_(0),
-      event_encoder_(std::move(event_encoder)),
+    std::unique_ptr<RtcEventLogEncoder> config_encoder,
+    std::unique_ptr<rtc::TaskQueue> task_queue,
+    std::unique_ptr<rtc::TaskQueue> writer_queue)
+    : config_encoder_(std::move(config_encoder)),
+      logging_to_output_(false),
       num_config_events_written_(0),
       last_output_ms_(rtc::TimeMillis()),
       output_scheduled_(false),
+      num_dropped_events_(0),
+      num_pending_events_(0),
+      output_failed_(false),
+      max_size_bytes_(std::numeric_limits<decltype(max_size_bytes_)>::max()),
+      written_bytes_(0),
+      event_encoder_(std::move(event_encoder)),
+      writer_queue_(std::move(writer_queue)),
       task_queue_(std::move(task_queue)) {
   RTC_DCHECK(task_queue_);
+  RTC_DCHECK(writer_queue_);
 }
 
 RtcEventLogImpl::~RtcEventLogImpl() {
@@ -164,10 +199,14 @@ RtcEventLogImpl::~RtcEventLogImpl() {
   StopLogging();
 
   // We want to block on any executing task by invoking ~TaskQueue() before
-  // we set unique_ptr's internal pointer to null.
+  // we set unique_ptr's internal pointer to null. The |task_queue_| goes
+  // first, since its tasks post to the |writer_queue_|.
   rtc::TaskQueue* tq = task_queue_.get();
   delete tq;
   task_queue_.release();
+  rtc::TaskQueue* writer_tq = writer_queue_.get();
+  delete writer_tq;
+  writer_queue_.release();
 }
 
 bool RtcEventLogImpl::StartLogging(std::unique_ptr<RtcEventLogOutput> output,
@@ -187,15 +226,26 @@ bool RtcEventLogImpl::StartLogging(std::unique_ptr<RtcEventLogOutput> output,
   RTC_LOG(LS_INFO) << "Starting WebRTC event log. (Timestamp, UTC) = "
                    << "(" << timestamp_us << ", " << utc_time_us << ").";
 
+  // Binding to |this| is safe because |this| outlives the |writer_queue_|.
+  auto start_writer = [this, timestamp_us,
+                       utc_time_us](std::unique_ptr<RtcEventLogOutput> output) {
+    RTC_DCHECK_RUN_ON(writer_queue_.get());
+    RTC_DCHECK(output->IsActive());
+    event_output_ = std::move(output);
+    WriteToOutput(event_encoder_->EncodeLogStart(timestamp_us, utc_time_us));
+  };
+
   // Binding to |this| is safe because |this| outlives the |task_queue_|.
-  auto start = [this, output_period_ms, timestamp_us,
-                utc_time_us](std::unique_ptr<RtcEventLogOutput> output) {
+  auto start = [this, output_period_ms,
+                start_writer](std::unique_ptr<RtcEventLogOutput> output) {
     RTC_DCHECK_RUN_ON(task_queue_.get());
-    RTC_DCHECK(output->IsActive());
     output_period_ms_ = output_period_ms;
-    event_output_ = std::move(output);
+    logging_to_output_ = true;
+    output_failed_ = false;
     num_config_events_written_ = 0;
-    WriteToOutput(event_encoder_->EncodeLogStart(timestamp_us, utc_time_us));
+    writer_queue_->PostTask(
+        absl::make_unique<ResourceOwningTask<RtcEventLogOutput>>(
+            std::move(output), start_writer));
     LogEventsFromMemoryToOutput();
   };
 
@@ -213,15 +263,18 @@ void RtcEventLogImpl::StopLogging() {
 
   rtc::Event output_stopped;
 
-  // Binding to |this| is safe because |this| outlives the |task_queue_|.
+  // Binding to |this| is safe because |this| outlives the |task_queue_| and
+  // the |writer_queue_|.
   task_queue_->PostTask([this, &output_stopped]() {
     RTC_DCHECK_RUN_ON(task_queue_.get());
-    if (event_output_) {
-      RTC_DCHECK(event_output_->IsActive());
+    if (IsLoggingToOutput())
       LogEventsFromMemoryToOutput();
-    }
-    StopLoggingInternal();
-    output_stopped.Set();
+    logging_to_output_ = false;
+    writer_queue_->PostTask([this, &output_stopped]() {
+      RTC_DCHECK_RUN_ON(writer_queue_.get());
+      StopLoggingInternal();
+      output_stopped.Set();
+    });
   });
 
   output_stopped.Wait(rtc::Event::kForever);
@@ -236,7 +289,7 @@ void RtcEventLogImpl::Log(std::unique_ptr<RtcEvent> event) {
   auto event_handler = [this](std::unique_ptr<RtcEvent> unencoded_event) {
     RTC_DCHECK_RUN_ON(task_queue_.get());
     LogToMemory(std::move(unencoded_event));
-    if (event_output_)
+    if (IsLoggingToOutput())
       ScheduleOutput();
   };
 
@@ -244,8 +297,16 @@ void RtcEventLogImpl::Log(std::unique_ptr<RtcEvent> event) {
       std::move(event), event_handler));
 }
 
+bool RtcEventLogImpl::IsLoggingToOutput() {
+  if (logging_to_output_ && output_failed_) {
+    // Events are kept in memory again, for a later output.
+    logging_to_output_ = false;
+  }
+  return logging_to_output_;
+}
+
 void RtcEventLogImpl::ScheduleOutput() {
-  RTC_DCHECK(event_output_ && event_output_->IsActive());
+  RTC_DCHECK(logging_to_output_);
   if (history_.size() >= kMaxEventsInHistory) {
     // We have to emergency drain the buffer. We can't wait for the scheduled
     // output task because there might be other event incoming before that.
@@ -266,10 +327,8 @@ void RtcEventLogImpl::ScheduleOutput() {
     // Binding to |this| is safe because |this| outlives the |task_queue_|.
     auto output_task = [this]() {
       RTC_DCHECK_RUN_ON(task_queue_.get());
-      if (event_output_) {
-        RTC_DCHECK(event_output_->IsActive());
+      if (IsLoggingToOutput())
         LogEventsFromMemoryToOutput();
-      }
       output_scheduled_ = false;
     };
     const int64_t now_ms = rtc::TimeMillis();
@@ -281,20 +340,21 @@ void RtcEventLogImpl::ScheduleOutput() {
 }
 
 void RtcEventLogImpl::LogToMemory(std::unique_ptr<RtcEvent> event) {
-  std::deque<std::unique_ptr<RtcEvent>>& container =
+  EventDeque& container =
       event->IsConfigEvent() ? config_history_ : history_;
   const size_t container_max_size =
       event->IsConfigEvent() ? kMaxEventsInConfigHistory : kMaxEventsInHistory;
 
   if (container.size() >= container_max_size) {
-    RTC_DCHECK(!event_output_);  // Shouldn't lose events if we have an output.
+    // Shouldn't lose events if we have an output.
+    RTC_DCHECK(!logging_to_output_);
     container.pop_front();
   }
   container.push_back(std::move(event));
 }
 
 void RtcEventLogImpl::LogEventsFromMemoryToOutput() {
-  RTC_DCHECK(event_output_ && event_output_->IsActive());
+  RTC_DCHECK(logging_to_output_);
   last_output_ms_ = rtc::TimeMillis();
 
   // Serialize all stream configurations that haven't already been written to
@@ -306,32 +366,58 @@ void RtcEventLogImpl::LogEventsFromMemoryToOutput() {
   if (num_config_events_written_ < config_history_.size()) {
     const auto begin = config_history_.begin() + num_config_events_written_;
     const auto end = config_history_.end();
-    encoded_configs = event_encoder_->EncodeBatch(begin, end);
+    encoded_configs = config_encoder_->EncodeBatch(begin, end);
     num_config_events_written_ = config_history_.size();
   }
 
-  // Serialize the events in the event queue. Note that the write may fail,
-  // for example if we are writing to a file and have reached the maximum limit.
-  // We don't get any feedback if this happens, so we still remove the events
-  // from the event log history. This is normally not a problem, but if another
-  // log is started immediately after the first one becomes full, then one
-  // cannot rely on the second log to contain everything that isn't in the first
-  // log; one batch of events might be missing.
-  std::string encoded_history =
-      event_encoder_->EncodeBatch(history_.begin(), history_.end());
-  history_.clear();
-
-  WriteConfigsAndHistoryToOutput(encoded_configs, encoded_history);
+  // Hand the events in the event queue over to the writer, which serializes
+  // them. Note that the write may fail, for example if we are writing to a file
+  // and have reached the maximum limit. We don't get any feedback if this
+  // happens, so we still remove the events from the event log history. This is
+  // normally not a problem, but if another log is started immediately after
+  // the first one becomes full, then one cannot rely on the second log to
+  // contain everything that isn't in the first log; one batch of events might
+  // be missing.
+  auto batch = absl::make_unique<EventDeque>();
+  batch->swap(history_);
+  const size_t num_events = batch->size();
+  if (num_pending_events_ + num_events > kMaxPendingEvents) {
+    // The writer can't keep up. Rather than holding on to ever more memory,
+    // the batch is dropped; the configurations are still written.
+    num_dropped_events_ += num_events;
+    RTC_LOG(LS_WARNING) << "RTC event log writer is behind, dropped "
+                        << num_dropped_events_ << " events so far.";
+    batch->clear();
+  }
+  num_pending_events_ += batch->size();
+
+  // Binding to |this| is safe because |this| outlives the |writer_queue_|.
+  auto write = [this, encoded_configs](std::unique_ptr<EventDeque> batch) {
+    RTC_DCHECK_RUN_ON(writer_queue_.get());
+    std::string encoded_history;
+    if (!batch->empty()) {
+      encoded_history = event_encoder_->EncodeBatch(batch->begin(),
+                                                    batch->end());
+    }
+    num_pending_events_ -= batch->size();
+    WriteConfigsAndHistoryToOutput(encoded_configs, encoded_history);
+  };
+  writer_queue_->PostTask(absl::make_unique<ResourceOwningTask<EventDeque>>(
+      std::move(batch), write));
 }
 
 void RtcEventLogImpl::WriteConfigsAndHistoryToOutput(
     const std::string& encoded_configs,
     const std::string& encoded_history) {
+  // The output may have failed since the batch was handed over.
+  if (!event_output_)
+    return;
   // This function is used to merge the strings instead of calling the output
   // object twice with small strings. The function also avoids copying any
   // strings in the typical case where there are no config events.
   if (encoded_configs.empty()) {
-    WriteToOutput(encoded_history);  // Typical case.
+    if (!encoded_history.empty())
+      WriteToOutput(encoded_history);  // Typical case.
   } else if (encoded_history.empty()) {
     WriteToOutput(encoded_configs);  // Very unusual case.
   } else {
@@ -361,6 +447,7 @@ void RtcEventLogImpl::WriteToOutput(const std::string& output_string) {
     // The first failure closes the output.
     RTC_DCHECK(!event_output_->IsActive());
     StopOutput();  // Clean-up.
+    output_failed_ = true;
     return;
   }
   written_bytes_ += output_string.size();
@@ -380,9 +467,11 @@ std::unique_ptr<RtcEventLog> RtcEventLog::Create(
     TaskQueueFactory* task_queue_factory) {
 #ifdef ENABLE_RTC_EVENT_LOG
   return absl::make_unique<RtcEventLogImpl>(
-      CreateEncoder(encoding_type),
+      CreateEncoder(encoding_type), CreateEncoder(encoding_type),
+      absl::make_unique<rtc::TaskQueue>(task_queue_factory->CreateTaskQueue(
+          "rtc_event_log", TaskQueueFactory::Priority::NORMAL)),
       absl::make_unique<rtc::TaskQueue>(task_queue_factory->CreateTaskQueue(
-          "rtc_event_log", TaskQueueFactory::Priority::NORMAL)));
+          "rtc_event_log_writer", TaskQueueFactory::Priority::LOW)));
 #else
   return CreateNull();
 #endif  // ENABLE_RTC_EVENT_LOG
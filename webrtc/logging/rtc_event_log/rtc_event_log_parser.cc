@@ -974,6 +974,21 @@ void ParsedRtcEventLog::Clear() {
   outgoing_video_ssrcs_.clear();
   outgoing_audio_ssrcs_.clear();
 
+  audio_recv_configs_.clear();
+  audio_send_configs_.clear();
+  video_recv_configs_.clear();
+  video_send_configs_.clear();
+
+  memset(last_incoming_rtcp_packet_, 0, IP_PACKET_SIZE);
+  last_incoming_rtcp_packet_length_ = 0;
+
+  incoming_rtp_extensions_maps_.clear();
+  outgoing_rtp_extensions_maps_.clear();
+
+  ClearEvents();
+}
+
+void ParsedRtcEventLog::ClearEvents() {
   incoming_rtp_packets_map_.clear();
   outgoing_rtp_packets_map_.clear();
   incoming_rtp_packets_by_ssrc_.clear();
@@ -988,10 +1003,16 @@ void ParsedRtcEventLog::Clear() {
   outgoing_rr_.clear();
   incoming_sr_.clear();
   outgoing_sr_.clear();
+  incoming_xr_.clear();
+  outgoing_xr_.clear();
   incoming_nack_.clear();
   outgoing_nack_.clear();
   incoming_remb_.clear();
   outgoing_remb_.clear();
+  incoming_fir_.clear();
+  outgoing_fir_.clear();
+  incoming_pli_.clear();
+  outgoing_pli_.clear();
   incoming_transport_feedback_.clear();
   outgoing_transport_feedback_.clear();
   incoming_loss_notification_.clear();
@@ -1011,19 +1032,12 @@ void ParsedRtcEventLog::Clear() {
   alr_state_events_.clear();
   ice_candidate_pair_configs_.clear();
   ice_candidate_pair_events_.clear();
-  audio_recv_configs_.clear();
-  audio_send_configs_.clear();
-  video_recv_configs_.clear();
-  video_send_configs_.clear();
-
-  memset(last_incoming_rtcp_packet_, 0, IP_PACKET_SIZE);
-  last_incoming_rtcp_packet_length_ = 0;
+  generic_packets_received_.clear();
+  generic_packets_sent_.clear();
+  generic_acks_received_.clear();
 
   first_timestamp_ = std::numeric_limits<int64_t>::max();
   last_timestamp_ = std::numeric_limits<int64_t>::min();
-
-  incoming_rtp_extensions_maps_.clear();
-  outgoing_rtp_extensions_maps_.clear();
 }
 
 bool ParsedRtcEventLog::ParseFile(const std::string& filename) {
@@ -1046,8 +1060,22 @@ bool ParsedRtcEventLog::ParseString(const std::string& s) {
 bool ParsedRtcEventLog::ParseStream(
     std::istream& stream) {  // no-presubmit-check TODO(webrtc:8982)
   Clear();
-  bool success = ParseStreamInternal(stream);
+  bool success =
+      ParseStreamInternal(stream, std::numeric_limits<size_t>::max());
+  OrganizeParsedEvents();
+  return success;
+}
 
+bool ParsedRtcEventLog::ParseStreamChunk(
+    std::istream& stream,  // no-presubmit-check TODO(webrtc:8982)
+    size_t max_bytes) {
+  ClearEvents();
+  bool success = ParseStreamInternal(stream, max_bytes);
+  OrganizeParsedEvents();
+  return success;
+}
+
+void ParsedRtcEventLog::OrganizeParsedEvents() {
   // Cache the configured SSRCs.
   for (const auto& video_recv_config : video_recv_configs()) {
     incoming_video_ssrcs_.insert(video_recv_config.config.remote_ssrc);
@@ -1154,18 +1182,18 @@ bool ParsedRtcEventLog::ParseStream(
   StoreFirstAndLastTimestamp(generic_packets_sent_);
   StoreFirstAndLastTimestamp(generic_packets_received_);
   StoreFirstAndLastTimestamp(generic_acks_received_);
-
-  return success;
 }
 
 bool ParsedRtcEventLog::ParseStreamInternal(
-    std::istream& stream) {  // no-presubmit-check TODO(webrtc:8982)
+    std::istream& stream,  // no-presubmit-check TODO(webrtc:8982)
+    size_t max_bytes) {
   constexpr uint64_t kMaxEventSize = 10000000;  // Sanity check.
   std::vector<char> buffer(0xFFFF);
+  size_t bytes_read = 0;
 
   RTC_DCHECK(stream.good());
 
-  while (1) {
+  while (bytes_read < max_bytes) {
     // Check whether we have reached end of file.
     stream.peek();
     if (stream.eof()) {
@@ -1215,6 +1243,7 @@ bool ParsedRtcEventLog::ParseStreamInternal(
       return false;
     }
     size_t buffer_size = bytes_written + *message_length;
+    bytes_read += buffer_size;
 
     if (*tag == kExpectedV1Tag) {
       // Parse the protobuf event from the buffer.
@@ -276,6 +276,16 @@ class ParsedRtcEventLog {
   bool ParseStream(
       std::istream& stream);  // no-presubmit-check TODO(webrtc:8982)
 
+  // Reads the events of about the next |max_bytes| of |stream|, replacing the
+  // events of the previous chunk but keeping the stream configurations, so
+  // that a log too large to keep in memory can be processed a chunk at a
+  // time. Events are only ordered within a chunk, and an RTP packet and its
+  // feedback may end up in different chunks. Returns true if successful; the
+  // whole log has been read once |stream| reaches its end.
+  bool ParseStreamChunk(
+      std::istream& stream,  // no-presubmit-check TODO(webrtc:8982)
+      size_t max_bytes);
+
   MediaType GetMediaType(uint32_t ssrc, PacketDirection direction) const;
 
   // Configured SSRCs.
@@ -525,8 +535,18 @@ class ParsedRtcEventLog {
   std::vector<LoggedRouteChangeEvent> GetRouteChanges() const;
 
  private:
+  // Clears everything but the stream configurations and the state needed to
+  // parse later events of the same log.
+  void ClearEvents();
+
+  // Reads events until at least |max_bytes| have been read or the end of
+  // |stream|.
   bool ParseStreamInternal(
-      std::istream& stream);  // no-presubmit-check TODO(webrtc:8982)
+      std::istream& stream,  // no-presubmit-check TODO(webrtc:8982)
+      size_t max_bytes);
+
+  // Groups the events of the last call to ParseStreamInternal() for lookup.
+  void OrganizeParsedEvents();
 
   void StoreParsedLegacyEvent(const rtclog::Event& event);
 
@@ -9,6 +9,7 @@
  */
 
 #include <algorithm>
+#include <fstream>
 #include <limits>
 #include <map>
 #include <memory>
@@ -18,6 +19,12 @@
 #include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "api/rtc_event_log_output.h"
+#include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "logging/rtc_event_log/events/rtc_event_alr_state.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_network_adaptation.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_playout.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_receive_stream_config.h"
@@ -46,8 +53,11 @@
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
 #include "rtc_base/fake_clock.h"
 #include "rtc_base/random.h"
+#include "rtc_base/task_utils/to_queued_task.h"
 #include "test/gtest.h"
 #include "test/testsupport/file_utils.h"
 
@@ -132,6 +142,8 @@ class RtcEventLogSession
     return encoding_type_ == RtcEventLog::EncodingType::NewFormat;
   }
 
+  const std::string& temp_filename() const { return temp_filename_; }
+
  private:
   void WriteAudioRecvConfigs(size_t audio_recv_streams, RtcEventLog* event_log);
   void WriteAudioSendConfigs(size_t audio_send_streams, RtcEventLog* event_log);
@@ -787,6 +799,55 @@ TEST_P(RtcEventLogSession, StartLoggingInTheMiddle) {
   ReadAndVerifyLog();
 }
 
+TEST_P(RtcEventLogSession, ParsesLogInChunks) {
+  EventCounts count;
+  count.video_send_streams = 2;
+  count.video_recv_streams = 2;
+  count.probe_successes = 20;
+  count.incoming_rtp_packets = 200;
+  count.outgoing_rtp_packets = 200;
+  count.incoming_rtcp_packets = 50;
+  count.outgoing_rtcp_packets = 50;
+  WriteLog(count, 0);
+
+  ParsedRtcEventLog whole_log;
+  ASSERT_TRUE(whole_log.ParseFile(temp_filename()));
+
+  std::ifstream stream(  // no-presubmit-check TODO(webrtc:8982)
+      temp_filename(), std::ios_base::in | std::ios_base::binary);
+  ASSERT_TRUE(stream.good());
+  ParsedRtcEventLog chunked_log;
+  size_t num_chunks = 0;
+  size_t probe_successes = 0;
+  std::map<uint32_t, size_t> outgoing_rtp_packets;
+  size_t incoming_rtcp_packets = 0;
+  while (!stream.eof()) {
+    ASSERT_TRUE(chunked_log.ParseStreamChunk(stream, 1000));
+    ++num_chunks;
+    probe_successes += chunked_log.bwe_probe_success_events().size();
+    for (const auto& rtp_stream : chunked_log.outgoing_rtp_packets_by_ssrc()) {
+      outgoing_rtp_packets[rtp_stream.ssrc] +=
+          rtp_stream.outgoing_packets.size();
+    }
+    incoming_rtcp_packets += chunked_log.incoming_rtcp_packets().size();
+  }
+  EXPECT_GT(num_chunks, 2u);
+  EXPECT_EQ(whole_log.bwe_probe_success_events().size(), probe_successes);
+  EXPECT_EQ(whole_log.incoming_rtcp_packets().size(), incoming_rtcp_packets);
+  for (const auto& rtp_stream : whole_log.outgoing_rtp_packets_by_ssrc()) {
+    EXPECT_EQ(rtp_stream.outgoing_packets.size(),
+              outgoing_rtp_packets[rtp_stream.ssrc]);
+  }
+  // Configurations are kept across chunks.
+  EXPECT_EQ(whole_log.video_send_configs().size(),
+            chunked_log.video_send_configs().size());
+  EXPECT_EQ(whole_log.outgoing_video_ssrcs(),
+            chunked_log.outgoing_video_ssrcs());
+
+  stream.close();
+  remove(temp_filename().c_str());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     RtcEventLogTest,
     RtcEventLogSession,
@@ -890,6 +951,147 @@ INSTANTIATE_TEST_SUITE_P(
     ::testing::Values(RtcEventLog::EncodingType::Legacy,
                       RtcEventLog::EncodingType::NewFormat));
 
+namespace {
+// Names of the task queues created by RtcEventLog::Create().
+constexpr char kLoggingQueue[] = "rtc_event_log";
+constexpr char kWriterQueue[] = "rtc_event_log_writer";
+// Same as in rtc_event_log_impl.cc.
+constexpr size_t kMaxEventsInHistory = 10000;
+constexpr size_t kMaxPendingEvents = 5 * kMaxEventsInHistory;
+constexpr size_t kUnlimitedWrites = std::numeric_limits<size_t>::max();
+
+// Creates task queues with the default factory and lets the test post tasks
+// of its own to them.
+class TaskQueueRecordingFactory : public TaskQueueFactory {
+ public:
+  TaskQueueRecordingFactory() : factory_(CreateDefaultTaskQueueFactory()) {}
+
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> CreateTaskQueue(
+      absl::string_view name,
+      Priority priority) const override {
+    std::unique_ptr<TaskQueueBase, TaskQueueDeleter> queue =
+        factory_->CreateTaskQueue(name, priority);
+    rtc::CritScope lock(&crit_);
+    queues_[std::string(name)] = queue.get();
+    return queue;
+  }
+
+  // Waits until the tasks posted to the queue |name| so far have run.
+  void Flush(const std::string& name) {
+    rtc::Event done;
+    GetQueue(name)->PostTask(ToQueuedTask([&done] { done.Set(); }));
+    done.Wait(rtc::Event::kForever);
+  }
+
+  // Holds back the tasks of the queue |name| until |release| is set.
+  void Block(const std::string& name, rtc::Event* release) {
+    GetQueue(name)->PostTask(
+        ToQueuedTask([release] { release->Wait(rtc::Event::kForever); }));
+  }
+
+ private:
+  TaskQueueBase* GetQueue(const std::string& name) {
+    rtc::CritScope lock(&crit_);
+    RTC_CHECK(queues_.count(name));
+    return queues_[name];
+  }
+
+  const std::unique_ptr<TaskQueueFactory> factory_;
+  rtc::CriticalSection crit_;
+  mutable std::map<std::string, TaskQueueBase*> queues_ RTC_GUARDED_BY(crit_);
+};
+
+struct OutputState {
+  std::string written;
+  size_t num_writes = 0;
+};
+
+// Keeps what is written in |state|. Fails, and closes, on the write after the
+// first |max_writes|.
+class MemoryOutput : public RtcEventLogOutput {
+ public:
+  MemoryOutput(OutputState* state, size_t max_writes)
+      : state_(state), max_writes_(max_writes) {}
+
+  bool IsActive() const override { return !failed_; }
+
+  bool Write(const std::string& output) override {
+    RTC_CHECK(!failed_);
+    if (++state_->num_writes > max_writes_) {
+      failed_ = true;
+      return false;
+    }
+    state_->written += output;
+    return true;
+  }
+
+ private:
+  OutputState* const state_;
+  const size_t max_writes_;
+  bool failed_ = false;
+};
+}  // namespace
+
+TEST(RtcEventLogWriterTest, DropsBatchesWhileWriterIsBehind) {
+  TaskQueueRecordingFactory factory;
+  std::unique_ptr<RtcEventLog> log =
+      RtcEventLog::Create(RtcEventLog::EncodingType::NewFormat, &factory);
+  OutputState output;
+  rtc::Event release_writer;
+  factory.Block(kWriterQueue, &release_writer);
+  // With a long output period, batches are only handed to the writer when the
+  // history is full.
+  log->StartLogging(absl::make_unique<MemoryOutput>(&output, kUnlimitedWrites),
+                    /*output_period_ms=*/1000000);
+  for (size_t i = 0; i < kMaxPendingEvents + kMaxEventsInHistory; ++i)
+    log->Log(absl::make_unique<RtcEventAlrState>(true));
+  factory.Flush(kLoggingQueue);
+  release_writer.Set();
+  log->StopLogging();
+
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseString(output.written));
+  EXPECT_EQ(1u, parsed_log.start_log_events().size());
+  EXPECT_EQ(1u, parsed_log.stop_log_events().size());
+  // The last full history didn't fit next to the batches held back.
+  EXPECT_EQ(kMaxPendingEvents, parsed_log.alr_state_events().size());
+}
+
+TEST(RtcEventLogWriterTest, KeepsEventsInMemoryAfterOutputFails) {
+  TaskQueueRecordingFactory factory;
+  std::unique_ptr<RtcEventLog> log =
+      RtcEventLog::Create(RtcEventLog::EncodingType::NewFormat, &factory);
+  // Takes the log start and fails on the first batch.
+  OutputState failed_output;
+  log->StartLogging(absl::make_unique<MemoryOutput>(&failed_output, 1),
+                    RtcEventLog::kImmediateOutput);
+  log->Log(absl::make_unique<RtcEventAlrState>(true));
+  factory.Flush(kLoggingQueue);
+  factory.Flush(kWriterQueue);
+  EXPECT_EQ(2u, failed_output.num_writes);
+
+  // Nothing more is handed to the writer after the failure.
+  log->Log(absl::make_unique<RtcEventAlrState>(false));
+  log->Log(absl::make_unique<RtcEventAlrState>(false));
+  factory.Flush(kLoggingQueue);
+  factory.Flush(kWriterQueue);
+  EXPECT_EQ(2u, failed_output.num_writes);
+
+  // The events logged since then go to the next output.
+  OutputState output;
+  log->StartLogging(absl::make_unique<MemoryOutput>(&output, kUnlimitedWrites),
+                    RtcEventLog::kImmediateOutput);
+  log->StopLogging();
+  EXPECT_EQ(2u, failed_output.num_writes);
+
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseString(output.written));
+  const auto& alr_state_events = parsed_log.alr_state_events();
+  ASSERT_EQ(2u, alr_state_events.size());
+  EXPECT_FALSE(alr_state_events[0].in_alr);
+  EXPECT_FALSE(alr_state_events[1].in_alr);
+}
+
 // TODO(terelius): Verify parser behavior if the timestamps are not
 // monotonically increasing in the log.
 
@@ -322,7 +322,8 @@ rtcp::TransportFeedback EventGenerator::NewTransportFeedback() {
   int64_t time_us = base_time_us;
   for (uint16_t i = 1u; i < 10u; i++) {
     time_us += prng_.Rand(0, 100000);
-    if (prng_.Rand<bool>()) {
+    // A feedback without any received packet can't be built.
+    if (i == 9u || prng_.Rand<bool>()) {
       transport_feedback.AddReceivedPacket(base_seq_no + i, time_us);
     }
   }
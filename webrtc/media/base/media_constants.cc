@@ -31,6 +31,9 @@ const char kFlexfecCodecName[] = "flexfec-03";
 
 // draft-ietf-payload-flexible-fec-scheme-02.txt
 const char kFlexfecFmtpRepairWindow[] = "repair-window";
+// Not part of the FlexFEC draft. Set to "1" if the Reed-Solomon erasure code
+// of webrtc::ReedSolomonFec can be decoded.
+const char kFlexfecFmtpReedSolomon[] = "x-google-reed-solomon";
 
 const char kCodecParamAssociatedPayloadType[] = "apt";
 const char kCodecParamAssociatedCodecName[] = "acn";
@@ -35,6 +35,7 @@ extern const char kFlexfecCodecName[];
 extern const char kMultiplexCodecName[];
 
 extern const char kFlexfecFmtpRepairWindow[];
+extern const char kFlexfecFmtpReedSolomon[];
 
 // Codec parameters
 extern const char kCodecParamAssociatedPayloadType[];
@@ -14,9 +14,11 @@
 #include <string.h>
 #include <algorithm>
 #include <cstdint>
+#include <numeric>
 #include <string>
 #include <utility>
 
+#include "absl/memory/memory.h"
 #include "api/scoped_refptr.h"
 #include "api/video/i420_buffer.h"
 #include "api/video/video_codec_constants.h"
@@ -28,6 +30,7 @@
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/experiments/rate_control_settings.h"
+#include "rtc_base/logging.h"
 #include "system_wrappers/include/field_trial.h"
 #include "third_party/libyuv/include/libyuv/scale.h"
 
@@ -94,6 +97,13 @@ bool StreamResolutionCompare(const webrtc::SimulcastStream& a,
          std::tie(b.height, b.width, b.maxBitrate, b.maxFramerate);
 }
 
+bool HasLargerOrEqualResolution(int width,
+                                int height,
+                                int other_width,
+                                int other_height) {
+  return width >= other_width && height >= other_height;
+}
+
 // An EncodedImageCallback implementation that forwards on calls to a
 // SimulcastEncoderAdapter, but with the stream index it's registered with as
 // the first parameter to Encoded.
@@ -125,9 +135,13 @@ SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory,
       factory_(factory),
       video_format_(format),
       encoded_complete_callback_(nullptr),
+      parallel_encoding_(0),
+      pending_layers_(0),
       experimental_boosted_screenshare_qp_(GetScreenshareBoostedQpValue()),
       boost_base_layer_quality_(RateControlSettings::ParseFromFieldTrials()
-                                    .Vp8BoostBaseLayerQuality()) {
+                                    .Vp8BoostBaseLayerQuality()),
+      parallel_encoding_enabled_(
+          webrtc::field_trial::IsEnabled("WebRTC-SimulcastParallelEncoding")) {
   RTC_DCHECK(factory_);
   encoder_info_.implementation_name = "SimulcastEncoderAdapter";
 
@@ -215,6 +229,8 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
   RTC_DCHECK_LT(lowest_resolution_stream_index, number_of_streams);
   RTC_DCHECK_LT(highest_resolution_stream_index, number_of_streams);
 
+  bool any_internal_source = false;
+
   for (int i = 0; i < number_of_streams; ++i) {
     VideoCodec stream_codec;
     uint32_t start_bitrate_kbps = start_bitrates[i];
@@ -321,6 +337,7 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
             encoder_impl_info.has_internal_source;
       }
       encoder_info_.fps_allocation[i] = encoder_impl_info.fps_allocation[0];
+      any_internal_source |= encoder_impl_info.has_internal_source;
     }
   }
 
@@ -328,6 +345,40 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     encoder_info_.implementation_name += ")";
   }
 
+  // Hardware encoders and encoders with an internal source may deliver their
+  // output after Encode() returns, so they are always run sequentially.
+  size_t num_workers = 0;
+  if (parallel_encoding_enabled_ && doing_simulcast && number_of_cores > 1 &&
+      !encoder_info_.is_hardware_accelerated && !any_internal_source) {
+    num_workers = std::max(std::min(number_of_streams, number_of_cores) - 1, 0);
+  }
+  encoder_workers_.resize(num_workers);
+  for (auto& worker : encoder_workers_) {
+    if (!worker) {
+      worker = absl::make_unique<rtc::TaskQueue>("SimulcastEncoderWorker");
+    }
+  }
+  // Pin every stream to one queue, so that its encoder always runs on the
+  // same thread whichever streams are sent. The streams are ordered as in
+  // Encode(): the highest resolution stream is encoded on the encoder queue
+  // and the others are spread over the workers.
+  std::vector<size_t> stream_order(streaminfos_.size());
+  std::iota(stream_order.begin(), stream_order.end(), 0);
+  std::stable_sort(stream_order.begin(), stream_order.end(),
+                   [this](size_t a, size_t b) {
+                     const StreamInfo& a_info = streaminfos_[a];
+                     const StreamInfo& b_info = streaminfos_[b];
+                     return a_info.width * a_info.height >
+                            b_info.width * b_info.height;
+                   });
+  for (size_t i = 0; i < stream_order.size(); ++i) {
+    streaminfos_[stream_order[i]].worker =
+        i == 0 || encoder_workers_.empty()
+            ? nullptr
+            : encoder_workers_[(i - 1) % encoder_workers_.size()].get();
+  }
+  layers_.reserve(number_of_streams);
+
   // To save memory, don't store encoders that we don't use.
   DestroyStoredEncoders();
 
@@ -367,75 +418,225 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
+  // Encode the streams from the highest to the lowest resolution, so that each
+  // stream can be downscaled from the previous one.
+  layers_.clear();
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream) {
       continue;
     }
-
-    std::vector<VideoFrameType> stream_frame_types;
+    // Act on a request to drop this frame that was returned for output
+    // delivered after a parallel encode. Key frames are always encoded.
+    if (streaminfos_[stream_idx].drop_next_frame) {
+      streaminfos_[stream_idx].drop_next_frame = false;
+      if (!send_key_frame) {
+        encoded_complete_callback_->OnDroppedFrame(
+            EncodedImageCallback::DropReason::kDroppedByEncoder);
+        continue;
+      }
+    }
+    Layer layer;
+    layer.stream_idx = stream_idx;
     if (send_key_frame) {
-      stream_frame_types.push_back(VideoFrameType::kVideoFrameKey);
+      layer.frame_type = VideoFrameType::kVideoFrameKey;
       streaminfos_[stream_idx].key_frame_request = false;
-    } else {
-      stream_frame_types.push_back(VideoFrameType::kVideoFrameDelta);
     }
+    layers_.push_back(layer);
+  }
+  std::stable_sort(layers_.begin(), layers_.end(),
+                   [this](const Layer& a, const Layer& b) {
+                     const StreamInfo& a_info = streaminfos_[a.stream_idx];
+                     const StreamInfo& b_info = streaminfos_[b.stream_idx];
+                     return a_info.width * a_info.height >
+                            b_info.width * b_info.height;
+                   });
+  if (layers_.empty()) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  // For texture frames, the underlying encoder is expected to be able to
+  // correctly sample/scale the source texture.
+  // TODO(perkj): ensure that works going forward, and figure out how this
+  // affects webrtc:5683.
+  const bool is_native = input_image.video_frame_buffer()->type() ==
+                         VideoFrameBuffer::Type::kNative;
+  const bool needs_scaling =
+      !is_native &&
+      std::any_of(layers_.begin(), layers_.end(), [&](const Layer& layer) {
+        const StreamInfo& info = streaminfos_[layer.stream_idx];
+        return info.width != input_image.width() ||
+               info.height != input_image.height();
+      });
+  if (needs_scaling) {
+    input_buffer_ = input_image.video_frame_buffer()->ToI420();
+  }
 
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources) or the source image has a native handle, pass the image on
-    // directly. Otherwise, we'll scale it to match what the encoder expects
-    // (below).
-    // For texture frames, the underlying encoder is expected to be able to
-    // correctly sample/scale the source texture.
-    // TODO(perkj): ensure that works going forward, and figure out how this
-    // affects webrtc:5683.
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.video_frame_buffer()->type() ==
-            VideoFrameBuffer::Type::kNative) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(input_image,
-                                                         &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
+  if (encoder_workers_.empty() || layers_.size() == 1) {
+    for (size_t layer = 0; layer < layers_.size(); ++layer) {
+      ScaleLayer(layer, input_image);
+    }
+    // Encode in stream order, which is the order in which the encoded images
+    // are delivered.
+    SortLayersByStreamIndex();
+    for (size_t layer = 0; layer < layers_.size(); ++layer) {
+      EncodeLayer(layer, input_image);
+      if (layers_[layer].result != WEBRTC_VIDEO_CODEC_OK) {
+        break;
       }
+    }
+  } else {
+    rtc::AtomicOps::ReleaseStore(&parallel_encoding_, 1);
+    rtc::AtomicOps::ReleaseStore(&pending_layers_,
+                                 static_cast<int>(layers_.size()));
+    // Every layer is encoded on the queue its stream is pinned to.
+    rtc::TaskQueue* const queue = streaminfos_[layers_[0].stream_idx].worker;
+    if (queue) {
+      queue->PostTask(
+          [this, &input_image] { ScaleAndEncodeLayer(0, input_image); });
     } else {
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-      rtc::scoped_refptr<I420BufferInterface> src_buffer =
-          input_image.video_frame_buffer()->ToI420();
-      libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
-                        src_buffer->DataU(), src_buffer->StrideU(),
-                        src_buffer->DataV(), src_buffer->StrideV(), src_width,
-                        src_height, dst_buffer->MutableDataY(),
-                        dst_buffer->StrideY(), dst_buffer->MutableDataU(),
-                        dst_buffer->StrideU(), dst_buffer->MutableDataV(),
-                        dst_buffer->StrideV(), dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-
-      // UpdateRect is not propagated to lower simulcast layers currently.
-      // TODO(ilnik): Consider scaling UpdateRect together with the buffer.
-      VideoFrame frame = VideoFrame::Builder()
-                             .set_video_frame_buffer(dst_buffer)
-                             .set_timestamp_rtp(input_image.timestamp())
-                             .set_rotation(webrtc::kVideoRotation_0)
-                             .set_timestamp_ms(input_image.render_time_ms())
-                             .build();
-      int ret =
-          streaminfos_[stream_idx].encoder->Encode(frame, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
+      ScaleAndEncodeLayer(0, input_image);
     }
+    layers_done_.Wait(rtc::Event::kForever);
+    rtc::AtomicOps::ReleaseStore(&parallel_encoding_, 0);
+    DeliverPendingImages();
+    SortLayersByStreamIndex();
+  }
+  // Return the downscaled buffers to their pools.
+  input_buffer_ = nullptr;
+  for (Layer& layer : layers_) {
+    layer.buffer = nullptr;
   }
 
+  // Report the error of the first failing stream, as when encoding
+  // sequentially.
+  for (const Layer& layer : layers_) {
+    if (layer.result != WEBRTC_VIDEO_CODEC_OK) {
+      return layer.result;
+    }
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void SimulcastEncoderAdapter::ScaleLayer(size_t layer,
+                                         const VideoFrame& input_image) {
+  Layer& current = layers_[layer];
+  const StreamInfo& info = streaminfos_[current.stream_idx];
+  const int dst_width = info.width;
+  const int dst_height = info.height;
+  // If scaling isn't required, because the input resolution matches the
+  // destination or the input image has a native handle, pass the image on
+  // directly.
+  if (!input_buffer_ || (dst_width == input_image.width() &&
+                         dst_height == input_image.height())) {
+    current.buffer = nullptr;
+    return;
+  }
+
+  // Downscale from the previous, larger, layer if there is one. The input
+  // frame is used for the top layer and if the previous layer is not larger in
+  // both dimensions.
+  const I420BufferInterface* src_buffer = input_buffer_.get();
+  VideoFrame::UpdateRect src_update_rect = input_image.update_rect();
+  if (layer > 0 && layers_[layer - 1].buffer &&
+      HasLargerOrEqualResolution(layers_[layer - 1].buffer->width(),
+                                 layers_[layer - 1].buffer->height(),
+                                 dst_width, dst_height)) {
+    src_buffer = layers_[layer - 1].buffer.get();
+    src_update_rect = layers_[layer - 1].update_rect;
+  }
+  // Scale the update rect along with the buffer, so that encoders of lower
+  // streams can still detect unchanged screen content.
+  current.update_rect = src_update_rect.ScaleWithFrame(
+      src_buffer->width(), src_buffer->height(), 0, 0, src_buffer->width(),
+      src_buffer->height(), dst_width, dst_height);
+
+  rtc::scoped_refptr<I420Buffer> dst_buffer =
+      info.buffer_pool->CreateBuffer(dst_width, dst_height);
+  if (!dst_buffer) {
+    RTC_LOG(LS_WARNING) << "Buffer pool exhausted, allocating a new buffer.";
+    dst_buffer = I420Buffer::Create(dst_width, dst_height);
+  }
+  libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
+                    src_buffer->DataU(), src_buffer->StrideU(),
+                    src_buffer->DataV(), src_buffer->StrideV(),
+                    src_buffer->width(), src_buffer->height(),
+                    dst_buffer->MutableDataY(), dst_buffer->StrideY(),
+                    dst_buffer->MutableDataU(), dst_buffer->StrideU(),
+                    dst_buffer->MutableDataV(), dst_buffer->StrideV(),
+                    dst_width, dst_height, libyuv::kFilterBilinear);
+  current.buffer = dst_buffer;
+}
+
+void SimulcastEncoderAdapter::EncodeLayer(size_t layer,
+                                          const VideoFrame& input_image) {
+  Layer& current = layers_[layer];
+  const std::vector<VideoFrameType> stream_frame_types(1, current.frame_type);
+  VideoEncoder* const encoder = streaminfos_[current.stream_idx].encoder.get();
+  if (!current.buffer) {
+    current.result = encoder->Encode(input_image, &stream_frame_types);
+    return;
+  }
+  VideoFrame frame = VideoFrame::Builder()
+                         .set_video_frame_buffer(current.buffer)
+                         .set_timestamp_rtp(input_image.timestamp())
+                         .set_rotation(webrtc::kVideoRotation_0)
+                         .set_timestamp_ms(input_image.render_time_ms())
+                         .set_update_rect(current.update_rect)
+                         .build();
+  current.result = encoder->Encode(frame, &stream_frame_types);
+}
+
+void SimulcastEncoderAdapter::ScaleAndEncodeLayer(
+    size_t layer,
+    const VideoFrame& input_image) {
+  ScaleLayer(layer, input_image);
+  // The next layer may be downscaled from this one, so it is only started
+  // once this layer is ready. |input_image| outlives the task since Encode()
+  // waits for all layers.
+  const size_t next_layer = layer + 1;
+  if (next_layer < layers_.size()) {
+    // Only the first layer can be pinned to the encoder queue.
+    rtc::TaskQueue* const worker =
+        streaminfos_[layers_[next_layer].stream_idx].worker;
+    RTC_DCHECK(worker);
+    worker->PostTask([this, next_layer, &input_image] {
+      ScaleAndEncodeLayer(next_layer, input_image);
+    });
+  }
+  EncodeLayer(layer, input_image);
+  if (rtc::AtomicOps::Decrement(&pending_layers_) == 0) {
+    layers_done_.Set();
+  }
+}
+
+void SimulcastEncoderAdapter::SortLayersByStreamIndex() {
+  std::sort(layers_.begin(), layers_.end(),
+            [](const Layer& a, const Layer& b) {
+              return a.stream_idx < b.stream_idx;
+            });
+}
+
+void SimulcastEncoderAdapter::DeliverPendingImages() {
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    StreamInfo& info = streaminfos_[stream_idx];
+    for (PendingImage& pending : info.pending_images) {
+      // The encoder has already been told that the image was delivered, see
+      // OnEncodedImage(), so the result is acted upon here instead.
+      const EncodedImageCallback::Result result =
+          encoded_complete_callback_->OnEncodedImage(
+              pending.encoded_image, &pending.codec_specific_info,
+              pending.fragmentation.get());
+      if (result.error != EncodedImageCallback::Result::OK) {
+        RTC_LOG(LS_WARNING) << "Failed to deliver an encoded image of stream "
+                            << stream_idx << ".";
+      }
+      info.drop_next_frame |= result.drop_next_frame;
+    }
+    info.pending_images.clear();
+  }
+}
+
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
     EncodedImageCallback* callback) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
@@ -512,6 +713,24 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
 
   stream_image.SetSpatialIndex(stream_idx);
 
+  if (rtc::AtomicOps::AcquireLoad(&parallel_encoding_) == 1) {
+    // Called on a worker queue. Keep a copy of the output, including the
+    // encoded data which the encoder may reuse, until all streams are done.
+    // Each stream is only encoded on one queue, so |pending_images| needs no
+    // lock.
+    PendingImage pending;
+    pending.encoded_image = std::move(stream_image);
+    pending.encoded_image.Retain();
+    pending.codec_specific_info = stream_codec_specific;
+    if (fragmentation) {
+      pending.fragmentation = absl::make_unique<RTPFragmentationHeader>();
+      pending.fragmentation->CopyFrom(*fragmentation);
+    }
+    streaminfos_[stream_idx].pending_images.push_back(std::move(pending));
+    return EncodedImageCallback::Result(EncodedImageCallback::Result::OK,
+                                        encodedImage.Timestamp());
+  }
+
   return encoded_complete_callback_->OnEncodedImage(
       stream_image, &stream_codec_specific, fragmentation);
 }
@@ -573,7 +792,15 @@ void SimulcastEncoderAdapter::DestroyStoredEncoders() {
 }
 
 VideoEncoder::EncoderInfo SimulcastEncoderAdapter::GetEncoderInfo() const {
-  return encoder_info_;
+  EncoderInfo info = encoder_info_;
+  // May change on every frame, so it is not cached in InitEncode. Effort can
+  // be reduced as long as any of the encoders can reduce it.
+  info.can_reduce_complexity = false;
+  for (const StreamInfo& stream_info : streaminfos_) {
+    info.can_reduce_complexity |=
+        stream_info.encoder->GetEncoderInfo().can_reduce_complexity;
+  }
+  return info;
 }
 
 }  // namespace webrtc
@@ -19,11 +19,19 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/scoped_refptr.h"
+#include "api/video/video_frame.h"
+#include "api/video/video_frame_buffer.h"
 #include "api/video_codecs/sdp_video_format.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "modules/include/module_common_types.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "modules/video_coding/include/video_error_codes.h"
 #include "rtc_base/atomic_ops.h"
+#include "rtc_base/event.h"
 #include "rtc_base/sequenced_task_checker.h"
 #include "rtc_base/system/rtc_export.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -34,6 +42,15 @@ class VideoEncoderFactory;
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // The object is created and destroyed on the worker thread, but all public
 // interfaces should be called from the encoder task queue.
+//
+// Lower resolution streams are downscaled from the next larger stream rather
+// than from the input frame. With the "WebRTC-SimulcastParallelEncoding" field
+// trial, and more than one core, the streams of a frame are downscaled and
+// encoded concurrently on a set of worker queues. Encode() joins the workers
+// before returning and delivers the encoded images in stream order, as in the
+// sequential case. Parallel encoding is not used with hardware encoders or
+// encoders with an internal source, which may deliver their output
+// asynchronously.
 class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
  public:
   explicit SimulcastEncoderAdapter(VideoEncoderFactory* factory,
@@ -63,6 +80,12 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
   EncoderInfo GetEncoderInfo() const override;
 
  private:
+  struct PendingImage {
+    EncodedImage encoded_image;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
+  };
+
   struct StreamInfo {
     StreamInfo(std::unique_ptr<VideoEncoder> encoder,
                std::unique_ptr<EncodedImageCallback> callback,
@@ -74,13 +97,36 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
           width(width),
           height(height),
           key_frame_request(false),
-          send_stream(send_stream) {}
+          send_stream(send_stream),
+          buffer_pool(new I420BufferPool()) {}
     std::unique_ptr<VideoEncoder> encoder;
     std::unique_ptr<EncodedImageCallback> callback;
     uint16_t width;
     uint16_t height;
     bool key_frame_request;
     bool send_stream;
+    // Recycles the buffers of the frames downscaled for this stream.
+    std::unique_ptr<I420BufferPool> buffer_pool;
+    // Output held back during a parallel encode, see OnEncodedImage().
+    std::vector<PendingImage> pending_images;
+    // Set when the callback asked to drop the frame after a delivered pending
+    // image.
+    bool drop_next_frame = false;
+    // Queue that the encoder is run on during a parallel encode, or null for
+    // the encoder queue.
+    rtc::TaskQueue* worker = nullptr;
+  };
+
+  // A stream to encode for the frame that is currently being encoded.
+  struct Layer {
+    size_t stream_idx = 0;
+    VideoFrameType frame_type = VideoFrameType::kVideoFrameDelta;
+    // The input frame downscaled to the stream resolution, or null if the input
+    // frame is passed on as is.
+    rtc::scoped_refptr<I420BufferInterface> buffer;
+    // The area of |buffer| that changed since the previous frame.
+    VideoFrame::UpdateRect update_rect = {0, 0, 0, 0};
+    int result = WEBRTC_VIDEO_CODEC_OK;
   };
 
   enum class StreamResolution {
@@ -100,6 +146,19 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
 
   void DestroyStoredEncoders();
 
+  // Downscales the input frame for |layers_[layer]|, from the buffer of the
+  // previous layer when possible.
+  void ScaleLayer(size_t layer, const VideoFrame& input_image);
+  void EncodeLayer(size_t layer, const VideoFrame& input_image);
+  // Scales and encodes |layers_[layer]| after posting the next layer to a
+  // worker queue. Signals |layers_done_| when it finishes the last pending
+  // layer.
+  void ScaleAndEncodeLayer(size_t layer, const VideoFrame& input_image);
+  void SortLayersByStreamIndex();
+  // Delivers the encoded images held back during a parallel encode and keeps
+  // the requests to drop the next frame of a stream.
+  void DeliverPendingImages();
+
   volatile int inited_;  // Accessed atomically.
   VideoEncoderFactory* const factory_;
   const SdpVideoFormat video_format_;
@@ -108,6 +167,18 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
   EncodedImageCallback* encoded_complete_callback_;
   EncoderInfo encoder_info_;
 
+  // Streams to encode for the current frame, ordered from the highest to the
+  // lowest resolution while scaling. Only used within Encode().
+  std::vector<Layer> layers_;
+  rtc::scoped_refptr<I420BufferInterface> input_buffer_;
+
+  // Worker queues for parallel encoding; empty when encoding sequentially.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> encoder_workers_;
+  // Set while the layers of a frame are encoded in parallel.
+  volatile int parallel_encoding_;  // Accessed atomically.
+  volatile int pending_layers_;     // Accessed atomically.
+  rtc::Event layers_done_;
+
   // Used for checking the single-threaded access of the encoder interface.
   rtc::SequencedTaskChecker encoder_queue_;
 
@@ -117,6 +188,7 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
 
   const absl::optional<unsigned int> experimental_boosted_screenshare_qp_;
   const bool boost_base_layer_quality_;
+  const bool parallel_encoding_enabled_;
 };
 
 }  // namespace webrtc
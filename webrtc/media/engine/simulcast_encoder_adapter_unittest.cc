@@ -9,6 +9,7 @@
  */
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -26,10 +27,13 @@
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "modules/video_coding/utility/simulcast_test_fixture_impl.h"
+#include "rtc_base/platform_thread_types.h"
+#include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
 using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
 using EncoderInfo = webrtc::VideoEncoder::EncoderInfo;
 using FramerateFractions =
@@ -220,6 +224,7 @@ class MockVideoEncoder : public VideoEncoder {
     info.scaling_settings = scaling_settings_;
     info.has_trusted_rate_controller = has_trusted_rate_controller_;
     info.is_hardware_accelerated = is_hardware_accelerated_;
+    info.can_reduce_complexity = can_reduce_complexity_;
     info.has_internal_source = has_internal_source_;
     info.fps_allocation[0] = fps_allocation_;
     return info;
@@ -263,6 +268,10 @@ class MockVideoEncoder : public VideoEncoder {
     is_hardware_accelerated_ = is_hardware_accelerated;
   }
 
+  void set_can_reduce_complexity(bool can_reduce_complexity) {
+    can_reduce_complexity_ = can_reduce_complexity;
+  }
+
   void set_has_internal_source(bool has_internal_source) {
     has_internal_source_ = has_internal_source;
   }
@@ -280,6 +289,7 @@ class MockVideoEncoder : public VideoEncoder {
   VideoEncoder::ScalingSettings scaling_settings_;
   bool has_trusted_rate_controller_ = false;
   bool is_hardware_accelerated_ = false;
+  bool can_reduce_complexity_ = false;
   bool has_internal_source_ = false;
   int32_t init_encode_return_value_ = 0;
   VideoBitrateAllocation last_set_bitrate_;
@@ -1106,6 +1116,24 @@ TEST_F(TestSimulcastEncoderAdapterFake, ReportsHardwareAccelerated) {
   EXPECT_TRUE(adapter_->GetEncoderInfo().is_hardware_accelerated);
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake, ReportsCanReduceComplexity) {
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec_.numberOfSimulcastStreams = 3;
+  adapter_->RegisterEncodeCompleteCallback(this);
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 1, 1200));
+  ASSERT_EQ(3u, helper_->factory()->encoders().size());
+  EXPECT_FALSE(adapter_->GetEncoderInfo().can_reduce_complexity);
+
+  // Queried from the encoders on every call, without a new InitEncode.
+  helper_->factory()->encoders()[1]->set_can_reduce_complexity(true);
+  EXPECT_TRUE(adapter_->GetEncoderInfo().can_reduce_complexity);
+
+  helper_->factory()->encoders()[1]->set_can_reduce_complexity(false);
+  EXPECT_FALSE(adapter_->GetEncoderInfo().can_reduce_complexity);
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, ReportsInternalSource) {
   SimulcastTestFixtureImpl::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
@@ -1157,5 +1185,347 @@ TEST_F(TestSimulcastEncoderAdapterFake, ReportsFpsAllocation) {
               ::testing::ElementsAreArray(expected_fps_allocation));
 }
 
+// Records the order and the thread in which the encoded images are delivered.
+class EncodedImageOrderRecorder : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    const int simulcast_index = encoded_image.SpatialIndex().value_or(-1);
+    simulcast_indices_.push_back(simulcast_index);
+    all_on_creating_thread_ &=
+        rtc::IsThreadRefEqual(thread_, rtc::CurrentThreadRef());
+    Result result(Result::OK, encoded_image.Timestamp());
+    result.drop_next_frame = simulcast_index == drop_next_frame_index_;
+    return result;
+  }
+
+  void OnDroppedFrame(DropReason reason) override { ++num_dropped_frames_; }
+
+  // Asks to drop the frame after each image of the given simulcast index.
+  void set_drop_next_frame_index(int index) { drop_next_frame_index_ = index; }
+
+  const std::vector<int>& simulcast_indices() const {
+    return simulcast_indices_;
+  }
+  bool all_on_creating_thread() const { return all_on_creating_thread_; }
+  int num_dropped_frames() const { return num_dropped_frames_; }
+
+ private:
+  const rtc::PlatformThreadRef thread_ = rtc::CurrentThreadRef();
+  std::vector<int> simulcast_indices_;
+  bool all_on_creating_thread_ = true;
+  int drop_next_frame_index_ = -1;
+  int num_dropped_frames_ = 0;
+};
+
+TEST(SimulcastEncoderAdapterParallelTest,
+     EncodesOnWorkersAndDeliversInStreamOrder) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastParallelEncoding/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  EncodedImageOrderRecorder recorder;
+  adapter->RegisterEncodeCompleteCallback(&recorder);
+
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  // High start bitrate, so all streams are enabled.
+  codec.startBitrate = 3000;
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 4, 1200));
+  const std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+
+  // Every encoder gets the frame downscaled to its own resolution and encodes
+  // it right away. The lower streams are encoded on the workers.
+  const rtc::PlatformThreadRef test_thread = rtc::CurrentThreadRef();
+  std::atomic<bool> lower_streams_on_workers(true);
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    MockVideoEncoder* encoder = encoders[i];
+    const bool is_top_stream = i + 1 == encoders.size();
+    EXPECT_CALL(*encoder, Encode(_, _))
+        .WillOnce(Invoke([&, encoder, is_top_stream](
+                             const VideoFrame& frame,
+                             const std::vector<VideoFrameType>* frame_types) {
+          EXPECT_EQ(encoder->codec().width, frame.width());
+          EXPECT_EQ(encoder->codec().height, frame.height());
+          if (!is_top_stream &&
+              rtc::IsThreadRefEqual(test_thread, rtc::CurrentThreadRef())) {
+            lower_streams_on_workers = false;
+          }
+          encoder->SendEncodedImage(frame.width(), frame.height());
+          return WEBRTC_VIDEO_CODEC_OK;
+        }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  VideoFrame input_frame = VideoFrame::Builder()
+                               .set_video_frame_buffer(buffer)
+                               .set_timestamp_rtp(100)
+                               .set_timestamp_ms(1000)
+                               .set_rotation(kVideoRotation_0)
+                               .build();
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(0, adapter->Encode(input_frame, &frame_types));
+
+  EXPECT_TRUE(lower_streams_on_workers);
+  EXPECT_THAT(recorder.simulcast_indices(), ::testing::ElementsAre(0, 1, 2));
+  EXPECT_TRUE(recorder.all_on_creating_thread());
+  adapter->Release();
+}
+
+TEST_F(TestSimulcastEncoderAdapterFake, ScalesUpdateRectToLowerStreams) {
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 1, 1200));
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+
+  std::vector<VideoFrame::UpdateRect> update_rects(3);
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    EXPECT_CALL(*encoders[i], Encode(_, _))
+        .WillRepeatedly(Invoke(
+            [&update_rects, i](const VideoFrame& frame,
+                               const std::vector<VideoFrameType>* types) {
+              update_rects[i] = frame.update_rect();
+              return WEBRTC_VIDEO_CODEC_OK;
+            }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  const VideoFrame::UpdateRect kUpdateRect = {640, 360, 100, 100};
+  VideoFrame input_frame = VideoFrame::Builder()
+                               .set_video_frame_buffer(buffer)
+                               .set_timestamp_rtp(100)
+                               .set_timestamp_ms(1000)
+                               .set_rotation(kVideoRotation_0)
+                               .set_update_rect(kUpdateRect)
+                               .build();
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameDelta);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, &frame_types));
+
+  // The top stream gets the input frame as is.
+  EXPECT_EQ(kUpdateRect.offset_x, update_rects[2].offset_x);
+  EXPECT_EQ(kUpdateRect.width, update_rects[2].width);
+  // Lower streams get the rect scaled to their resolution, covering at least
+  // the scaled area.
+  for (size_t i = 0; i < 2; ++i) {
+    const int scale = kDefaultWidth / encoders[i]->codec().width;
+    EXPECT_FALSE(update_rects[i].IsEmpty());
+    EXPECT_LE(update_rects[i].offset_x, kUpdateRect.offset_x / scale);
+    EXPECT_LE(update_rects[i].offset_y, kUpdateRect.offset_y / scale);
+    EXPECT_GE(update_rects[i].offset_x + update_rects[i].width,
+              (kUpdateRect.offset_x + kUpdateRect.width) / scale);
+    EXPECT_LT(update_rects[i].width, encoders[i]->codec().width);
+  }
+
+  // Unchanged frames stay unchanged in all streams.
+  input_frame.set_update_rect({0, 0, 0, 0});
+  EXPECT_EQ(0, adapter_->Encode(input_frame, &frame_types));
+  for (const VideoFrame::UpdateRect& update_rect : update_rects)
+    EXPECT_TRUE(update_rect.IsEmpty());
+}
+
+TEST(SimulcastEncoderAdapterParallelTest, EncodesSequentiallyWithOneCore) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastParallelEncoding/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  EncodedImageOrderRecorder recorder;
+  adapter->RegisterEncodeCompleteCallback(&recorder);
+
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec.startBitrate = 3000;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_ERR_PARAMETER,
+            adapter->InitEncode(&codec, 0, 1200));
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 1, 1200));
+  const std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+
+  const rtc::PlatformThreadRef test_thread = rtc::CurrentThreadRef();
+  bool all_on_test_thread = true;
+  for (MockVideoEncoder* encoder : encoders) {
+    EXPECT_CALL(*encoder, Encode(_, _))
+        .WillOnce(Invoke([&, encoder](
+                             const VideoFrame& frame,
+                             const std::vector<VideoFrameType>* frame_types) {
+          all_on_test_thread &=
+              rtc::IsThreadRefEqual(test_thread, rtc::CurrentThreadRef());
+          encoder->SendEncodedImage(frame.width(), frame.height());
+          return WEBRTC_VIDEO_CODEC_OK;
+        }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  VideoFrame input_frame = VideoFrame::Builder()
+                               .set_video_frame_buffer(buffer)
+                               .set_timestamp_rtp(100)
+                               .set_timestamp_ms(1000)
+                               .set_rotation(kVideoRotation_0)
+                               .build();
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(0, adapter->Encode(input_frame, &frame_types));
+
+  EXPECT_TRUE(all_on_test_thread);
+  EXPECT_THAT(recorder.simulcast_indices(), ::testing::ElementsAre(0, 1, 2));
+  adapter->Release();
+}
+
+TEST(SimulcastEncoderAdapterParallelTest, ReturnsErrorOfFirstFailingStream) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastParallelEncoding/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  EncodedImageOrderRecorder recorder;
+  adapter->RegisterEncodeCompleteCallback(&recorder);
+
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec.startBitrate = 3000;
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 4, 1200));
+  const std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  EXPECT_CALL(*encoders[0], Encode(_, _))
+      .WillOnce(Return(WEBRTC_VIDEO_CODEC_OK));
+  EXPECT_CALL(*encoders[1], Encode(_, _))
+      .WillOnce(Return(WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE));
+  EXPECT_CALL(*encoders[2], Encode(_, _))
+      .WillOnce(Return(WEBRTC_VIDEO_CODEC_ERROR));
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  VideoFrame input_frame = VideoFrame::Builder()
+                               .set_video_frame_buffer(buffer)
+                               .set_timestamp_rtp(0)
+                               .set_timestamp_us(0)
+                               .set_rotation(kVideoRotation_0)
+                               .build();
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE,
+            adapter->Encode(input_frame, &frame_types));
+  adapter->Release();
+}
+
+TEST(SimulcastEncoderAdapterParallelTest, PinsStreamsToQueues) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastParallelEncoding/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  EncodedImageOrderRecorder recorder;
+  adapter->RegisterEncodeCompleteCallback(&recorder);
+
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec.startBitrate = 3000;
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 4, 1200));
+  const std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+
+  std::vector<std::vector<rtc::PlatformThreadRef>> threads(encoders.size());
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    EXPECT_CALL(*encoders[i], Encode(_, _))
+        .WillRepeatedly(Invoke([&threads, i](
+                                   const VideoFrame& frame,
+                                   const std::vector<VideoFrameType>* types) {
+          threads[i].push_back(rtc::CurrentThreadRef());
+          return WEBRTC_VIDEO_CODEC_OK;
+        }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  VideoFrame input_frame = VideoFrame::Builder()
+                               .set_video_frame_buffer(buffer)
+                               .set_timestamp_rtp(100)
+                               .set_timestamp_ms(1000)
+                               .set_rotation(kVideoRotation_0)
+                               .build();
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameDelta);
+  EXPECT_EQ(0, adapter->Encode(input_frame, &frame_types));
+
+  // Stop sending the top stream, so that stream 1 becomes the first one to be
+  // encoded. It must stay on its queue.
+  VideoBitrateAllocation allocation;
+  allocation.SetBitrate(0, 0, 100000);
+  allocation.SetBitrate(1, 0, 500000);
+  EXPECT_EQ(0, adapter->SetRateAllocation(allocation, 30));
+  EXPECT_EQ(0, adapter->Encode(input_frame, &frame_types));
+
+  ASSERT_EQ(1u, threads[2].size());
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(2u, threads[i].size());
+    EXPECT_TRUE(rtc::IsThreadRefEqual(threads[i][0], threads[i][1]));
+    EXPECT_FALSE(rtc::IsThreadRefEqual(threads[i][0], threads[2][0]));
+  }
+  adapter->Release();
+}
+
+TEST(SimulcastEncoderAdapterParallelTest, DropsNextFrameOnRequest) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastParallelEncoding/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  EncodedImageOrderRecorder recorder;
+  recorder.set_drop_next_frame_index(1);
+  adapter->RegisterEncodeCompleteCallback(&recorder);
+
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec.startBitrate = 3000;
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 4, 1200));
+  const std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    MockVideoEncoder* encoder = encoders[i];
+    EXPECT_CALL(*encoder, Encode(_, _))
+        .Times(i == 1 ? 1 : 2)
+        .WillRepeatedly(Invoke(
+            [encoder](const VideoFrame& frame,
+                      const std::vector<VideoFrameType>* frame_types) {
+              encoder->SendEncodedImage(frame.width(), frame.height());
+              return WEBRTC_VIDEO_CODEC_OK;
+            }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  VideoFrame input_frame = VideoFrame::Builder()
+                               .set_video_frame_buffer(buffer)
+                               .set_timestamp_rtp(100)
+                               .set_timestamp_ms(1000)
+                               .set_rotation(kVideoRotation_0)
+                               .build();
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameDelta);
+  EXPECT_EQ(0, adapter->Encode(input_frame, &frame_types));
+  EXPECT_EQ(0, adapter->Encode(input_frame, &frame_types));
+
+  EXPECT_EQ(1, recorder.num_dropped_frames());
+  EXPECT_THAT(recorder.simulcast_indices(),
+              ::testing::ElementsAre(0, 1, 2, 0, 2));
+  adapter->Release();
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -57,6 +57,13 @@ bool IsFlexfecAdvertisedFieldTrialEnabled() {
   return webrtc::field_trial::IsEnabled("WebRTC-FlexFEC-03-Advertised");
 }
 
+// If this field trial is enabled, "flexfec-03" will be advertised with support
+// for the Reed-Solomon erasure code, which is then used for sending FlexFEC
+// whenever the remote advertises support for it too.
+bool IsFlexfecReedSolomonFieldTrialEnabled() {
+  return webrtc::field_trial::IsEnabled("WebRTC-FlexFEC-ReedSolomon");
+}
+
 void AddDefaultFeedbackParams(VideoCodec* codec) {
   // Don't add any feedback params for RED and ULPFEC.
   if (codec->name == kRedCodecName || codec->name == kUlpfecCodecName)
@@ -94,6 +101,8 @@ std::vector<VideoCodec> AssignPayloadTypesAndDefaultCodecs(
     // we never use the actual value anywhere in our code however.
     // TODO(brandtr): Consider honouring this value in the sender and receiver.
     flexfec_format.parameters = {{kFlexfecFmtpRepairWindow, "10000000"}};
+    if (IsFlexfecReedSolomonFieldTrialEnabled())
+      flexfec_format.parameters[kFlexfecFmtpReedSolomon] = "1";
     input_formats.push_back(flexfec_format);
   }
 
@@ -1254,6 +1263,9 @@ void WebRtcVideoChannel::ConfigureReceiverRtp(
 
   // TODO(brandtr): Generalize when we add support for multistream protection.
   flexfec_config->payload_type = recv_flexfec_payload_type_;
+  // Reed-Solomon support is advertised whenever the field trial is enabled.
+  if (IsFlexfecReedSolomonFieldTrialEnabled())
+    flexfec_config->scheme = webrtc::FlexfecScheme::kReedSolomon;
   if (IsFlexfecAdvertisedFieldTrialEnabled() &&
       sp.GetFecFrSsrc(ssrc, &flexfec_config->remote_ssrc)) {
     flexfec_config->protected_media_ssrcs = {ssrc};
@@ -1838,6 +1850,7 @@ void WebRtcVideoChannel::WebRtcVideoSendStream::SetCodec(
   parameters_.config.rtp.ulpfec = codec_settings.ulpfec;
   parameters_.config.rtp.flexfec.payload_type =
       codec_settings.flexfec_payload_type;
+  parameters_.config.rtp.flexfec.scheme = codec_settings.flexfec_scheme;
 
   // Set RTX payload type if RTX is enabled.
   if (!parameters_.config.rtp.rtx.ssrcs.empty()) {
@@ -2690,12 +2703,15 @@ WebRtcVideoChannel::WebRtcVideoReceiveStream::GetVideoReceiverInfo(
 }
 
 WebRtcVideoChannel::VideoCodecSettings::VideoCodecSettings()
-    : flexfec_payload_type(-1), rtx_payload_type(-1) {}
+    : flexfec_payload_type(-1),
+      flexfec_scheme(webrtc::FlexfecScheme::kXor),
+      rtx_payload_type(-1) {}
 
 bool WebRtcVideoChannel::VideoCodecSettings::operator==(
     const WebRtcVideoChannel::VideoCodecSettings& other) const {
   return codec == other.codec && ulpfec == other.ulpfec &&
          flexfec_payload_type == other.flexfec_payload_type &&
+         flexfec_scheme == other.flexfec_scheme &&
          rtx_payload_type == other.rtx_payload_type;
 }
 
@@ -2723,6 +2739,7 @@ WebRtcVideoChannel::MapCodecs(const std::vector<VideoCodec>& codecs) {
 
   webrtc::UlpfecConfig ulpfec_config;
   int flexfec_payload_type = -1;
+  webrtc::FlexfecScheme flexfec_scheme = webrtc::FlexfecScheme::kXor;
 
   for (size_t i = 0; i < codecs.size(); ++i) {
     const VideoCodec& in_codec = codecs[i];
@@ -2755,6 +2772,12 @@ WebRtcVideoChannel::MapCodecs(const std::vector<VideoCodec>& codecs) {
         // FlexFEC payload type, should not have duplicates.
         RTC_DCHECK_EQ(-1, flexfec_payload_type);
         flexfec_payload_type = in_codec.id;
+        int reed_solomon = 0;
+        if (IsFlexfecReedSolomonFieldTrialEnabled() &&
+            in_codec.GetParam(kFlexfecFmtpReedSolomon, &reed_solomon) &&
+            reed_solomon == 1) {
+          flexfec_scheme = webrtc::FlexfecScheme::kReedSolomon;
+        }
         continue;
       }
 
@@ -2805,6 +2828,7 @@ WebRtcVideoChannel::MapCodecs(const std::vector<VideoCodec>& codecs) {
   for (size_t i = 0; i < video_codecs.size(); ++i) {
     video_codecs[i].ulpfec = ulpfec_config;
     video_codecs[i].flexfec_payload_type = flexfec_payload_type;
+    video_codecs[i].flexfec_scheme = flexfec_scheme;
     if (rtx_mapping[video_codecs[i].codec.id] != 0 &&
         rtx_mapping[video_codecs[i].codec.id] !=
             ulpfec_config.red_payload_type) {
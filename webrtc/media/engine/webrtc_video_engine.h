@@ -30,6 +30,7 @@
 #include "call/video_send_stream.h"
 #include "media/base/media_engine.h"
 #include "media/engine/unhandled_packets_buffer.h"
+#include "modules/include/module_fec_types.h"
 #include "rtc_base/async_invoker.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/network_route.h"
@@ -214,14 +215,16 @@ class WebRtcVideoChannel : public VideoMediaChannel, public webrtc::Transport {
     bool operator==(const VideoCodecSettings& other) const;
     bool operator!=(const VideoCodecSettings& other) const;
 
-    // Checks if all members of |a|, except |flexfec_payload_type|, are equal
-    // to the corresponding members of |b|.
+    // Checks if all members of |a|, except |flexfec_payload_type| and
+    // |flexfec_scheme|, are equal to the corresponding members of |b|.
     static bool EqualsDisregardingFlexfec(const VideoCodecSettings& a,
                                           const VideoCodecSettings& b);
 
     VideoCodec codec;
     webrtc::UlpfecConfig ulpfec;
     int flexfec_payload_type;
+    // Only used for send codecs. kReedSolomon if both ends support it.
+    webrtc::FlexfecScheme flexfec_scheme;
     int rtx_payload_type;
   };
 
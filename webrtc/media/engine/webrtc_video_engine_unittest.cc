@@ -3620,6 +3620,72 @@ TEST_F(WebRtcVideoChannelFlexfecSendRecvTest, SetSendCodecsWithoutFec) {
   EXPECT_EQ(-1, config.rtp.flexfec.payload_type);
 }
 
+class WebRtcVideoChannelFlexfecReedSolomonTest : public WebRtcVideoChannelTest {
+ public:
+  WebRtcVideoChannelFlexfecReedSolomonTest()
+      : WebRtcVideoChannelTest(
+            "WebRTC-FlexFEC-03-Advertised/Enabled/WebRTC-FlexFEC-03/Enabled/"
+            "WebRTC-FlexFEC-ReedSolomon/Enabled/") {}
+};
+
+TEST_F(WebRtcVideoChannelFlexfecReedSolomonTest,
+       DefaultFlexfecCodecAdvertisesReedSolomon) {
+  int reed_solomon = 0;
+  EXPECT_TRUE(GetEngineCodec("flexfec-03").GetParam(
+      cricket::kFlexfecFmtpReedSolomon, &reed_solomon));
+  EXPECT_EQ(1, reed_solomon);
+}
+
+TEST_F(WebRtcVideoChannelFlexfecSendRecvTest,
+       DefaultFlexfecCodecDoesNotAdvertiseReedSolomon) {
+  int reed_solomon = 0;
+  EXPECT_FALSE(GetEngineCodec("flexfec-03").GetParam(
+      cricket::kFlexfecFmtpReedSolomon, &reed_solomon));
+}
+
+TEST_F(WebRtcVideoChannelFlexfecReedSolomonTest,
+       SendsReedSolomonIfRemoteSupportsIt) {
+  cricket::VideoSendParameters parameters;
+  parameters.codecs.push_back(GetEngineCodec("VP8"));
+  parameters.codecs.push_back(GetEngineCodec("flexfec-03"));
+  ASSERT_TRUE(channel_->SetSendParameters(parameters));
+
+  FakeVideoSendStream* stream = AddSendStream(
+      CreatePrimaryWithFecFrStreamParams("cname", kSsrcs1[0], kFlexfecSsrc));
+  webrtc::VideoSendStream::Config config = stream->GetConfig().Copy();
+
+  EXPECT_EQ(GetEngineCodec("flexfec-03").id, config.rtp.flexfec.payload_type);
+  EXPECT_EQ(webrtc::FlexfecScheme::kReedSolomon, config.rtp.flexfec.scheme);
+}
+
+TEST_F(WebRtcVideoChannelFlexfecReedSolomonTest,
+       SendsXorIfRemoteDoesNotSupportReedSolomon) {
+  cricket::VideoCodec flexfec_codec = GetEngineCodec("flexfec-03");
+  flexfec_codec.RemoveParam(cricket::kFlexfecFmtpReedSolomon);
+  cricket::VideoSendParameters parameters;
+  parameters.codecs.push_back(GetEngineCodec("VP8"));
+  parameters.codecs.push_back(flexfec_codec);
+  ASSERT_TRUE(channel_->SetSendParameters(parameters));
+
+  FakeVideoSendStream* stream = AddSendStream(
+      CreatePrimaryWithFecFrStreamParams("cname", kSsrcs1[0], kFlexfecSsrc));
+  webrtc::VideoSendStream::Config config = stream->GetConfig().Copy();
+
+  EXPECT_EQ(GetEngineCodec("flexfec-03").id, config.rtp.flexfec.payload_type);
+  EXPECT_EQ(webrtc::FlexfecScheme::kXor, config.rtp.flexfec.scheme);
+}
+
+TEST_F(WebRtcVideoChannelFlexfecReedSolomonTest, ReceivesReedSolomon) {
+  AddRecvStream(
+      CreatePrimaryWithFecFrStreamParams("cname", kSsrcs1[0], kFlexfecSsrc));
+
+  const std::vector<FakeFlexfecReceiveStream*>& streams =
+      fake_call_->GetFlexfecReceiveStreams();
+  ASSERT_EQ(1U, streams.size());
+  EXPECT_EQ(webrtc::FlexfecScheme::kReedSolomon,
+            streams.front()->GetConfig().scheme);
+}
+
 TEST_F(WebRtcVideoChannelFlexfecRecvTest, SetRecvCodecsWithFec) {
   AddRecvStream(
       CreatePrimaryWithFecFrStreamParams("cname", kSsrcs1[0], kFlexfecSsrc));
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures Opus encoder throughput for every complexity setting and reports
+// the number of encoded frames per second of CPU time, i.e. per core. With
+// --bitrates listing more than one rate, the multi-rate encoder is used and
+// every variant frame counts as one encoded frame.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/audio_coding/codecs/opus/opus_interface.h"
+#include "modules/audio_coding/codecs/opus/opus_multi_rate_encoder.h"
+#include "modules/audio_coding/neteq/tools/audio_loop.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/string_encode.h"
+#include "rtc_base/string_to_number.h"
+#include "test/testsupport/file_utils.h"
+
+WEBRTC_DEFINE_string(input,
+                     "",
+                     "Raw 16-bit PCM input at 48 kHz. Defaults to the "
+                     "speech_mono_32_48kHz resource.");
+WEBRTC_DEFINE_int(channels, 1, "Number of interleaved input channels.");
+WEBRTC_DEFINE_int(frame_ms, 20, "Opus frame length in ms.");
+WEBRTC_DEFINE_int(duration_s, 60, "Seconds of audio to encode per setting.");
+WEBRTC_DEFINE_string(bitrates,
+                     "32000",
+                     "Comma separated target bitrates in bps. More than one "
+                     "value benchmarks the multi-rate encoder.");
+WEBRTC_DEFINE_int(min_complexity, 0, "Lowest complexity to measure.");
+WEBRTC_DEFINE_int(max_complexity, 10, "Highest complexity to measure.");
+WEBRTC_DEFINE_bool(help, false, "Print this message.");
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kMaxLoopLengthSamples = kSampleRateHz * 10;
+
+struct Result {
+  int complexity;
+  size_t frames;
+  int64_t cpu_time_ns;
+  size_t encoded_bytes;
+};
+
+Result RunSingleRate(int complexity,
+                     int bitrate_bps,
+                     test::AudioLoop* audio_loop) {
+  OpusEncInst* inst = nullptr;
+  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst, FLAG_channels, 0));
+  RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst, bitrate_bps));
+  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst, complexity));
+
+  const size_t samples_per_channel = kSampleRateHz * FLAG_frame_ms / 1000;
+  const size_t num_frames = FLAG_duration_s * 1000 / FLAG_frame_ms;
+  std::vector<uint8_t> payload(4000);
+  Result result = {complexity, num_frames, 0, 0};
+  const int64_t start_ns = rtc::GetThreadCpuTimeNanos();
+  for (size_t i = 0; i < num_frames; ++i) {
+    const int bytes =
+        WebRtcOpus_Encode(inst, audio_loop->GetNextBlock().data(),
+                          samples_per_channel, payload.size(), payload.data());
+    RTC_CHECK_GE(bytes, 0);
+    result.encoded_bytes += bytes;
+  }
+  result.cpu_time_ns = rtc::GetThreadCpuTimeNanos() - start_ns;
+  RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst));
+  return result;
+}
+
+Result RunMultiRate(int complexity,
+                    const std::vector<int>& bitrates_bps,
+                    test::AudioLoop* audio_loop) {
+  OpusMultiRateEncoder::Config config;
+  config.opus.num_channels = FLAG_channels;
+  config.opus.frame_size_ms = FLAG_frame_ms;
+  config.opus.complexity = complexity;
+  config.opus.low_rate_complexity = complexity;
+  config.bitrates_bps = bitrates_bps;
+  std::unique_ptr<OpusMultiRateEncoder> encoder =
+      OpusMultiRateEncoder::Create(config);
+  RTC_CHECK(encoder);
+
+  const size_t num_blocks = FLAG_duration_s * 100;
+  std::vector<rtc::Buffer> encoded;
+  std::vector<AudioEncoder::EncodedInfo> info;
+  Result result = {complexity, 0, 0, 0};
+  uint32_t rtp_timestamp = 0;
+  const int64_t start_ns = rtc::GetThreadCpuTimeNanos();
+  for (size_t i = 0; i < num_blocks; ++i) {
+    if (encoder->Encode(rtp_timestamp, audio_loop->GetNextBlock(), &encoded,
+                        &info)) {
+      result.frames += encoded.size();
+      for (const rtc::Buffer& payload : encoded)
+        result.encoded_bytes += payload.size();
+    }
+    rtp_timestamp += kSampleRateHz / 100;
+  }
+  result.cpu_time_ns = rtc::GetThreadCpuTimeNanos() - start_ns;
+  return result;
+}
+
+int Run(const std::vector<int>& bitrates_bps) {
+  const std::string input =
+      strlen(FLAG_input) > 0
+          ? std::string(FLAG_input)
+          : test::ResourcePath("audio_coding/speech_mono_32_48kHz", "pcm");
+  const bool multi_rate = bitrates_bps.size() > 1;
+  // The multi-rate encoder takes 10 ms blocks; libopus takes whole frames.
+  const int block_ms = multi_rate ? 10 : FLAG_frame_ms;
+  const size_t block_samples = kSampleRateHz * block_ms / 1000 * FLAG_channels;
+
+  printf("complexity,frames,cpu_ms,frames_per_core_second,kbps\n");
+  for (int complexity = FLAG_min_complexity;
+       complexity <= FLAG_max_complexity; ++complexity) {
+    test::AudioLoop audio_loop;
+    if (!audio_loop.Init(input, kMaxLoopLengthSamples * FLAG_channels,
+                         block_samples)) {
+      fprintf(stderr, "Could not read %s\n", input.c_str());
+      return 1;
+    }
+    const Result result =
+        multi_rate ? RunMultiRate(complexity, bitrates_bps, &audio_loop)
+                   : RunSingleRate(complexity, bitrates_bps[0], &audio_loop);
+    const double cpu_s = result.cpu_time_ns / 1e9;
+    printf("%d,%zu,%.1f,%.1f,%.1f\n", result.complexity, result.frames,
+           cpu_s * 1000, cpu_s > 0 ? result.frames / cpu_s : 0.0,
+           result.encoded_bytes * 8.0 / FLAG_duration_s / 1000 /
+               bitrates_bps.size());
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) || FLAG_help ||
+      argc != 1) {
+    printf("Usage: %s [options]\n", argv[0]);
+    rtc::FlagList::Print(nullptr, false);
+    return FLAG_help ? 0 : 1;
+  }
+  RTC_CHECK(FLAG_channels == 1 || FLAG_channels == 2);
+  RTC_CHECK_GT(FLAG_duration_s, 0);
+  RTC_CHECK_LE(FLAG_min_complexity, FLAG_max_complexity);
+
+  std::vector<std::string> fields;
+  rtc::split(FLAG_bitrates, ',', &fields);
+  std::vector<int> bitrates_bps;
+  for (const std::string& field : fields) {
+    absl::optional<int> bitrate = rtc::StringToNumber<int>(field);
+    RTC_CHECK(bitrate) << "Invalid bitrate: " << field;
+    bitrates_bps.push_back(*bitrate);
+  }
+  RTC_CHECK(!bitrates_bps.empty());
+  return webrtc::Run(bitrates_bps);
+}
@@ -0,0 +1,255 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/codecs/opus/opus_multi_rate_encoder.h"
+
+#include "modules/audio_coding/codecs/opus/audio_encoder_opus.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/numerics/safe_minmax.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kOpusSampleRateHz = 48000;
+constexpr int kMinInputSampleRateHz = 8000;
+
+// After 20 DTX frames (MAX_CONSECUTIVE_DTX) Opus sends a frame coding the
+// background noise; see AudioEncoderOpusImpl::EncodeImpl().
+constexpr int kMaxConsecutiveDtxFrames = 20;
+
+}  // namespace
+
+OpusMultiRateEncoder::Config::Config() = default;
+OpusMultiRateEncoder::Config::Config(const Config&) = default;
+OpusMultiRateEncoder::Config::~Config() = default;
+OpusMultiRateEncoder::Config& OpusMultiRateEncoder::Config::operator=(
+    const Config&) = default;
+
+bool OpusMultiRateEncoder::Config::IsOk() const {
+  if (input_sample_rate_hz < kMinInputSampleRateHz ||
+      input_sample_rate_hz > kOpusSampleRateHz ||
+      input_sample_rate_hz % 100 != 0) {
+    return false;
+  }
+  if (bitrates_bps.empty())
+    return false;
+  for (int bitrate_bps : bitrates_bps) {
+    AudioEncoderOpusConfig variant = opus;
+    variant.bitrate_bps = bitrate_bps;
+    if (!variant.IsOk())
+      return false;
+  }
+  return true;
+}
+
+std::unique_ptr<OpusMultiRateEncoder> OpusMultiRateEncoder::Create(
+    const Config& config) {
+  if (!config.IsOk()) {
+    RTC_LOG(LS_ERROR) << "Invalid multi-rate Opus encoder config.";
+    return nullptr;
+  }
+  return std::unique_ptr<OpusMultiRateEncoder>(
+      new OpusMultiRateEncoder(config));
+}
+
+OpusMultiRateEncoder::OpusMultiRateEncoder(const Config& config)
+    : config_(config), variants_(config.bitrates_bps.size()) {
+  for (size_t i = 0; i < variants_.size(); ++i) {
+    variants_[i].config = config_.opus;
+    variants_[i].config.bitrate_bps = config_.bitrates_bps[i];
+    CreateVariant(&variants_[i]);
+  }
+  input_buffer_.reserve(Num10MsFramesInNextPacket() * SamplesPer10msFrame());
+  resampled_.resize(SamplesPer10msFrame());
+}
+
+OpusMultiRateEncoder::~OpusMultiRateEncoder() {
+  for (Variant& variant : variants_)
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(variant.inst));
+}
+
+size_t OpusMultiRateEncoder::Num10MsFramesInNextPacket() const {
+  return static_cast<size_t>(
+      rtc::CheckedDivExact(config_.opus.frame_size_ms, 10));
+}
+
+bool OpusMultiRateEncoder::Encode(
+    uint32_t rtp_timestamp,
+    rtc::ArrayView<const int16_t> audio,
+    std::vector<rtc::Buffer>* encoded,
+    std::vector<AudioEncoder::EncodedInfo>* info) {
+  RTC_DCHECK(encoded);
+  RTC_DCHECK(info);
+  RTC_DCHECK_EQ(audio.size(),
+                static_cast<size_t>(config_.input_sample_rate_hz / 100) *
+                    config_.opus.num_channels);
+
+  if (input_buffer_.empty())
+    first_timestamp_in_buffer_ = rtp_timestamp;
+
+  // Resample once; every variant encodes from the same 48 kHz buffer.
+  if (config_.input_sample_rate_hz == kOpusSampleRateHz) {
+    input_buffer_.insert(input_buffer_.end(), audio.cbegin(), audio.cend());
+  } else {
+    RTC_CHECK_EQ(0, resampler_.InitializeIfNeeded(config_.input_sample_rate_hz,
+                                                  kOpusSampleRateHz,
+                                                  config_.opus.num_channels));
+    const int resampled_length =
+        resampler_.Resample(audio.data(), audio.size(), resampled_.data(),
+                            resampled_.size());
+    RTC_CHECK_EQ(resampled_length, resampled_.size());
+    input_buffer_.insert(input_buffer_.end(), resampled_.cbegin(),
+                         resampled_.cend());
+  }
+  if (input_buffer_.size() <
+      Num10MsFramesInNextPacket() * SamplesPer10msFrame()) {
+    return false;
+  }
+  RTC_CHECK_EQ(input_buffer_.size(),
+               Num10MsFramesInNextPacket() * SamplesPer10msFrame());
+
+  const size_t samples_per_channel =
+      rtc::CheckedDivExact(input_buffer_.size(), config_.opus.num_channels);
+  encoded->resize(variants_.size());
+  info->resize(variants_.size());
+  for (size_t i = 0; i < variants_.size(); ++i) {
+    Variant& variant = variants_[i];
+    rtc::Buffer& payload = (*encoded)[i];
+    const size_t max_encoded_bytes = SufficientOutputBufferSize(variant);
+    payload.Clear();
+    (*info)[i] = AudioEncoder::EncodedInfo();
+    (*info)[i].encoded_bytes = payload.AppendData(
+        max_encoded_bytes, [&](rtc::ArrayView<uint8_t> out) {
+          int status = WebRtcOpus_Encode(
+              variant.inst, input_buffer_.data(), samples_per_channel,
+              rtc::saturated_cast<int16_t>(max_encoded_bytes), out.data());
+          RTC_CHECK_GE(status, 0);  // Fails only if fed invalid data.
+          return static_cast<size_t>(status);
+        });
+
+    if (variant.bitrate_changed) {
+      const auto bandwidth =
+          AudioEncoderOpusImpl::GetNewBandwidth(variant.config, variant.inst);
+      if (bandwidth)
+        RTC_CHECK_EQ(0, WebRtcOpus_SetBandwidth(variant.inst, *bandwidth));
+      variant.bitrate_changed = false;
+    }
+  }
+  input_buffer_.clear();
+
+  // The speech decision is made once, from the primary variant, so that all
+  // variants agree on which packets carry speech.
+  const bool dtx_frame = (*info)[0].encoded_bytes <= 2;
+  const bool speech =
+      !dtx_frame && consecutive_dtx_frames_ != kMaxConsecutiveDtxFrames;
+  consecutive_dtx_frames_ = dtx_frame ? consecutive_dtx_frames_ + 1 : 0;
+
+  for (AudioEncoder::EncodedInfo& variant_info : *info) {
+    variant_info.encoded_timestamp = first_timestamp_in_buffer_;
+    variant_info.payload_type = config_.opus.payload_type;
+    variant_info.send_even_if_empty = true;
+    variant_info.speech = speech;
+    variant_info.encoder_type = AudioEncoder::CodecType::kOpus;
+  }
+  return true;
+}
+
+void OpusMultiRateEncoder::SetTargetBitrate(size_t variant, int bitrate_bps) {
+  RTC_DCHECK_LT(variant, variants_.size());
+  Variant& v = variants_[variant];
+  const int new_bitrate_bps =
+      rtc::SafeClamp(bitrate_bps, AudioEncoderOpusConfig::kMinBitrateBps,
+                     AudioEncoderOpusConfig::kMaxBitrateBps);
+  if (v.config.bitrate_bps == new_bitrate_bps)
+    return;
+  v.config.bitrate_bps = new_bitrate_bps;
+  RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(v.inst, new_bitrate_bps));
+  const absl::optional<int> complexity =
+      AudioEncoderOpusImpl::GetNewComplexity(v.config);
+  if (complexity)
+    RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(v.inst, *complexity));
+  v.bitrate_changed = true;
+}
+
+void OpusMultiRateEncoder::SetPacketLossRate(float fraction) {
+  RTC_DCHECK_GE(fraction, 0.f);
+  RTC_DCHECK_LE(fraction, 1.f);
+  packet_loss_rate_ = fraction;
+  for (Variant& variant : variants_) {
+    RTC_CHECK_EQ(0, WebRtcOpus_SetPacketLossRate(
+                        variant.inst,
+                        static_cast<int32_t>(packet_loss_rate_ * 100 + .5)));
+  }
+}
+
+void OpusMultiRateEncoder::Reset() {
+  for (Variant& variant : variants_) {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(variant.inst));
+    variant.inst = nullptr;
+    CreateVariant(&variant);
+  }
+  input_buffer_.clear();
+  consecutive_dtx_frames_ = 0;
+}
+
+void OpusMultiRateEncoder::CreateVariant(Variant* variant) const {
+  const AudioEncoderOpusConfig& config = variant->config;
+  RTC_DCHECK(config.IsOk());
+  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(
+                      &variant->inst, config.num_channels,
+                      config.application ==
+                              AudioEncoderOpusConfig::ApplicationMode::kVoip
+                          ? 0
+                          : 1));
+  RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(variant->inst, *config.bitrate_bps));
+  if (config.fec_enabled) {
+    RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(variant->inst));
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_DisableFec(variant->inst));
+  }
+  RTC_CHECK_EQ(0, WebRtcOpus_SetMaxPlaybackRate(variant->inst,
+                                                config.max_playback_rate_hz));
+  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(
+                      variant->inst,
+                      AudioEncoderOpusImpl::GetNewComplexity(config).value_or(
+                          config.complexity)));
+  if (config.dtx_enabled) {
+    RTC_CHECK_EQ(0, WebRtcOpus_EnableDtx(variant->inst));
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_DisableDtx(variant->inst));
+  }
+  if (config.cbr_enabled) {
+    RTC_CHECK_EQ(0, WebRtcOpus_EnableCbr(variant->inst));
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_DisableCbr(variant->inst));
+  }
+  RTC_CHECK_EQ(0, WebRtcOpus_SetPacketLossRate(
+                      variant->inst,
+                      static_cast<int32_t>(packet_loss_rate_ * 100 + .5)));
+  variant->bitrate_changed = true;
+}
+
+size_t OpusMultiRateEncoder::SamplesPer10msFrame() const {
+  return rtc::CheckedDivExact(kOpusSampleRateHz, 100) *
+         config_.opus.num_channels;
+}
+
+size_t OpusMultiRateEncoder::SufficientOutputBufferSize(
+    const Variant& variant) const {
+  // Same margin as AudioEncoderOpusImpl: twice the expected packet size.
+  const size_t bytes_per_millisecond =
+      static_cast<size_t>(*variant.config.bitrate_bps / (1000 * 8) + 1);
+  return 2 * Num10MsFramesInNextPacket() * 10 * bytes_per_millisecond;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_MULTI_RATE_ENCODER_H_
+#define MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_MULTI_RATE_ENCODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/audio_codecs/audio_encoder.h"
+#include "api/audio_codecs/opus/audio_encoder_opus_config.h"
+#include "common_audio/resampler/include/push_resampler.h"
+#include "modules/audio_coding/codecs/opus/opus_interface.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/constructor_magic.h"
+
+namespace webrtc {
+
+// Encodes a single audio source into several Opus streams that only differ in
+// target bitrate, e.g. to serve receivers with heterogeneous downlinks from a
+// server. Work that does not depend on the bitrate is done once per packet and
+// shared by all variants: buffering of the 10 ms input blocks, resampling to
+// the 48 kHz Opus rate and the speech/DTX classification. Each variant then
+// only pays for its own call into libopus.
+class OpusMultiRateEncoder {
+ public:
+  struct Config {
+    Config();
+    Config(const Config&);
+    ~Config();
+    Config& operator=(const Config&);
+
+    bool IsOk() const;
+
+    // Sample rate of the audio passed to Encode(). Anything other than 48 kHz
+    // is resampled once, before the audio is handed to the variants.
+    int input_sample_rate_hz = 48000;
+    // Settings shared by all variants. |opus.bitrate_bps| is ignored.
+    AudioEncoderOpusConfig opus;
+    // Target bitrate of each variant; variant i produces output i. The first
+    // variant is the primary one and decides the speech flag for all.
+    std::vector<int> bitrates_bps;
+  };
+
+  static std::unique_ptr<OpusMultiRateEncoder> Create(const Config& config);
+  ~OpusMultiRateEncoder();
+
+  size_t num_variants() const { return variants_.size(); }
+  size_t Num10MsFramesInNextPacket() const;
+
+  // Accepts 10 ms of interleaved audio at |input_sample_rate_hz|.
+  // |rtp_timestamp| is in the 48 kHz Opus RTP clock. Returns false while
+  // audio is being buffered. Once a full packet is available all variants are
+  // encoded, |encoded| and |info| are resized to num_variants() and entry i
+  // holds the payload and metadata of variant i.
+  bool Encode(uint32_t rtp_timestamp,
+              rtc::ArrayView<const int16_t> audio,
+              std::vector<rtc::Buffer>* encoded,
+              std::vector<AudioEncoder::EncodedInfo>* info);
+
+  // Changes the target bitrate of a single variant.
+  void SetTargetBitrate(size_t variant, int bitrate_bps);
+  void SetPacketLossRate(float fraction);
+  void Reset();
+
+ private:
+  struct Variant {
+    AudioEncoderOpusConfig config;
+    OpusEncInst* inst = nullptr;
+    bool bitrate_changed = true;
+  };
+
+  explicit OpusMultiRateEncoder(const Config& config);
+
+  void CreateVariant(Variant* variant) const;
+  size_t SamplesPer10msFrame() const;
+  size_t SufficientOutputBufferSize(const Variant& variant) const;
+
+  const Config config_;
+  std::vector<Variant> variants_;
+  PushResampler<int16_t> resampler_;
+  std::vector<int16_t> resampled_;
+  std::vector<int16_t> input_buffer_;
+  uint32_t first_timestamp_in_buffer_ = 0;
+  int consecutive_dtx_frames_ = 0;
+  float packet_loss_rate_ = 0.f;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(OpusMultiRateEncoder);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_MULTI_RATE_ENCODER_H_
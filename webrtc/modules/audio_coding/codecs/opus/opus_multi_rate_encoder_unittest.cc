@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/codecs/opus/opus_multi_rate_encoder.h"
+
+#include <vector>
+
+#include "modules/audio_coding/neteq/tools/audio_loop.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kBlocksPerSecond = 100;
+
+OpusMultiRateEncoder::Config MakeConfig(int input_sample_rate_hz) {
+  OpusMultiRateEncoder::Config config;
+  config.input_sample_rate_hz = input_sample_rate_hz;
+  config.opus.frame_size_ms = 20;
+  config.opus.payload_type = 111;
+  config.bitrates_bps = {64000, 32000, 12000};
+  return config;
+}
+
+// Encodes |num_blocks| blocks of speech and returns the total payload size of
+// every variant.
+std::vector<size_t> EncodeSpeech(OpusMultiRateEncoder* encoder,
+                                 int input_sample_rate_hz,
+                                 size_t num_blocks) {
+  const size_t block_size = input_sample_rate_hz / kBlocksPerSecond;
+  test::AudioLoop audio_loop;
+  EXPECT_TRUE(audio_loop.Init(
+      test::ResourcePath("audio_coding/testfile32kHz", "pcm"),
+      input_sample_rate_hz * 10, block_size));
+
+  std::vector<size_t> total_bytes(encoder->num_variants(), 0);
+  std::vector<rtc::Buffer> encoded;
+  std::vector<AudioEncoder::EncodedInfo> info;
+  uint32_t rtp_timestamp = 0;
+  for (size_t i = 0; i < num_blocks; ++i) {
+    if (encoder->Encode(rtp_timestamp, audio_loop.GetNextBlock(), &encoded,
+                        &info)) {
+      EXPECT_EQ(encoder->num_variants(), encoded.size());
+      EXPECT_EQ(encoder->num_variants(), info.size());
+      for (size_t v = 0; v < info.size(); ++v) {
+        EXPECT_EQ(info[v].encoded_bytes, encoded[v].size());
+        EXPECT_EQ(info[0].encoded_timestamp, info[v].encoded_timestamp);
+        EXPECT_EQ(info[0].speech, info[v].speech);
+        EXPECT_EQ(111, info[v].payload_type);
+        total_bytes[v] += encoded[v].size();
+      }
+    }
+    rtp_timestamp += 48000 / kBlocksPerSecond;
+  }
+  return total_bytes;
+}
+
+}  // namespace
+
+TEST(OpusMultiRateEncoderTest, RejectsInvalidConfig) {
+  OpusMultiRateEncoder::Config config = MakeConfig(48000);
+  config.bitrates_bps.clear();
+  EXPECT_FALSE(OpusMultiRateEncoder::Create(config));
+
+  config = MakeConfig(48000);
+  config.bitrates_bps.push_back(1000);
+  EXPECT_FALSE(OpusMultiRateEncoder::Create(config));
+
+  config = MakeConfig(48000);
+  config.input_sample_rate_hz = 96000;
+  EXPECT_FALSE(OpusMultiRateEncoder::Create(config));
+}
+
+TEST(OpusMultiRateEncoderTest, EmitsOnePacketPerVariantAndFrame) {
+  auto encoder = OpusMultiRateEncoder::Create(MakeConfig(48000));
+  ASSERT_TRUE(encoder);
+  ASSERT_EQ(3u, encoder->num_variants());
+  EXPECT_EQ(2u, encoder->Num10MsFramesInNextPacket());
+
+  test::AudioLoop audio_loop;
+  ASSERT_TRUE(audio_loop.Init(
+      test::ResourcePath("audio_coding/testfile32kHz", "pcm"), 48000, 480));
+  std::vector<rtc::Buffer> encoded;
+  std::vector<AudioEncoder::EncodedInfo> info;
+  EXPECT_FALSE(encoder->Encode(0, audio_loop.GetNextBlock(), &encoded, &info));
+  EXPECT_TRUE(encoder->Encode(480, audio_loop.GetNextBlock(), &encoded, &info));
+  ASSERT_EQ(3u, info.size());
+  for (const AudioEncoder::EncodedInfo& variant_info : info) {
+    EXPECT_EQ(0u, variant_info.encoded_timestamp);
+    EXPECT_GT(variant_info.encoded_bytes, 0u);
+  }
+}
+
+TEST(OpusMultiRateEncoderTest, PayloadSizeFollowsVariantBitrate) {
+  auto encoder = OpusMultiRateEncoder::Create(MakeConfig(48000));
+  ASSERT_TRUE(encoder);
+  const std::vector<size_t> total_bytes =
+      EncodeSpeech(encoder.get(), 48000, 5 * kBlocksPerSecond);
+  EXPECT_GT(total_bytes[0], total_bytes[1]);
+  EXPECT_GT(total_bytes[1], total_bytes[2]);
+}
+
+TEST(OpusMultiRateEncoderTest, EncodesAllVariantsFromResampledInput) {
+  auto encoder = OpusMultiRateEncoder::Create(MakeConfig(16000));
+  ASSERT_TRUE(encoder);
+  const std::vector<size_t> total_bytes =
+      EncodeSpeech(encoder.get(), 16000, 5 * kBlocksPerSecond);
+  EXPECT_GT(total_bytes[0], total_bytes[1]);
+  EXPECT_GT(total_bytes[1], total_bytes[2]);
+  EXPECT_GT(total_bytes[2], 0u);
+}
+
+TEST(OpusMultiRateEncoderTest, SetTargetBitrateOnlyAffectsOneVariant) {
+  auto encoder = OpusMultiRateEncoder::Create(MakeConfig(48000));
+  ASSERT_TRUE(encoder);
+  encoder->SetTargetBitrate(0, 12000);
+  const std::vector<size_t> total_bytes =
+      EncodeSpeech(encoder.get(), 48000, 5 * kBlocksPerSecond);
+  EXPECT_LT(total_bytes[0], total_bytes[1]);
+}
+
+}  // namespace webrtc
@@ -14,7 +14,9 @@
 #include <functional>
 #include <iterator>
 
+#include "modules/audio_processing/utility/pffft_setup_cache.h"
 #include "rtc_base/checks.h"
+#include "third_party/pffft/src/pffft.h"
 
 namespace webrtc {
 
@@ -72,6 +74,51 @@ const float kSqrtHanning128[kFftLength] = {
 
 }  // namespace
 
+Aec3Fft::Aec3Fft()
+    : setup_(WebRtcPffft_GetSetup(kFftLength, /*complex_fft=*/0)) {
+  RTC_DCHECK(setup_);
+}
+
+Aec3Fft::~Aec3Fft() = default;
+
+void Aec3Fft::Fft(std::array<float, kFftLength>* x, FftData* X) const {
+  RTC_DCHECK(x);
+  RTC_DCHECK(X);
+  // PFFFT needs SIMD aligned buffers. A null work buffer makes it use one on
+  // the stack, which is what PFFFT recommends for small transforms.
+  alignas(16) std::array<float, kFftLength> out;
+  std::copy(x->begin(), x->end(), out.begin());
+  pffft_transform_ordered(setup_, out.data(), out.data(), nullptr,
+                          PFFFT_FORWARD);
+
+  // The ordered PFFFT output has the same packing as the Ooura FFT: DC and
+  // Nyquist followed by interleaved real and imaginary parts.
+  (*x)[0] = out[0];
+  (*x)[1] = out[1];
+  for (size_t k = 2; k < kFftLength; k += 2) {
+    (*x)[k] = out[k];
+    (*x)[k + 1] = -out[k + 1];
+  }
+  X->CopyFromPackedArray(*x);
+}
+
+void Aec3Fft::Ifft(const FftData& X, std::array<float, kFftLength>* x) const {
+  RTC_DCHECK(x);
+  alignas(16) std::array<float, kFftLength> out;
+  out[0] = X.re[0];
+  out[1] = X.re[kFftLengthBy2];
+  for (size_t k = 1; k < kFftLengthBy2; ++k) {
+    out[2 * k] = X.re[k];
+    out[2 * k + 1] = -X.im[k];
+  }
+  pffft_transform_ordered(setup_, out.data(), out.data(), nullptr,
+                          PFFFT_BACKWARD);
+
+  // PFFFT scales the inverse by kFftLength, Ooura by kFftLengthBy2.
+  std::transform(out.begin(), out.end(), x->begin(),
+                 [](float a) { return 0.5f * a; });
+}
+
 // TODO(peah): Change x to be std::array once the rest of the code allows this.
 void Aec3Fft::ZeroPaddedFft(rtc::ArrayView<const float> x,
                             Window window,
@@ -16,32 +16,30 @@
 #include "api/array_view.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/fft_data.h"
-#include "modules/audio_processing/utility/ooura_fft.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructor_magic.h"
 
+// Forward declaration.
+struct PFFFT_Setup;
+
 namespace webrtc {
 
 // Wrapper class that provides 128 point real valued FFT functionality with the
-// FftData type.
+// FftData type. The transforms are computed with PFFFT but keep the conventions
+// of the Ooura FFT used before: the imaginary parts have the opposite sign of
+// the standard DFT and the inverse transform is scaled by kFftLengthBy2.
+// All instances share one PFFFT setup and the transforms only use buffers on
+// the stack, so an instance holds no state besides the setup.
 class Aec3Fft {
  public:
   enum class Window { kRectangular, kHanning, kSqrtHanning };
 
-  Aec3Fft() = default;
+  Aec3Fft();
+  ~Aec3Fft();
   // Computes the FFT. Note that both the input and output are modified.
-  void Fft(std::array<float, kFftLength>* x, FftData* X) const {
-    RTC_DCHECK(x);
-    RTC_DCHECK(X);
-    ooura_fft_.Fft(x->data());
-    X->CopyFromPackedArray(*x);
-  }
+  void Fft(std::array<float, kFftLength>* x, FftData* X) const;
   // Computes the inverse Fft.
-  void Ifft(const FftData& X, std::array<float, kFftLength>* x) const {
-    RTC_DCHECK(x);
-    X.CopyToPackedArray(x);
-    ooura_fft_.InverseFft(x->data());
-  }
+  void Ifft(const FftData& X, std::array<float, kFftLength>* x) const;
 
   // Windows the input using a Hanning window, and then adds padding of
   // kFftLengthBy2 initial zeros before computing the Fft.
@@ -64,7 +62,7 @@ class Aec3Fft {
                  FftData* X) const;
 
  private:
-  const OouraFft ooura_fft_;
+  PFFFT_Setup* const setup_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(Aec3Fft);
 };
@@ -16,28 +16,40 @@ namespace webrtc {
 BlockDelayBuffer::BlockDelayBuffer(size_t num_bands,
                                    size_t frame_length,
                                    size_t delay_samples)
+    : BlockDelayBuffer(1, num_bands, frame_length, delay_samples) {}
+
+BlockDelayBuffer::BlockDelayBuffer(size_t num_channels,
+                                   size_t num_bands,
+                                   size_t frame_length,
+                                   size_t delay_samples)
     : frame_length_(frame_length),
       delay_(delay_samples),
-      buf_(num_bands, std::vector<float>(delay_, 0.f)) {}
+      buf_(num_channels,
+           std::vector<std::vector<float>>(num_bands,
+                                           std::vector<float>(delay_, 0.f))) {}
 
 BlockDelayBuffer::~BlockDelayBuffer() = default;
 
 void BlockDelayBuffer::DelaySignal(AudioBuffer* frame) {
-  RTC_DCHECK_EQ(1, frame->num_channels());
-  RTC_DCHECK_EQ(buf_.size(), frame->num_bands());
+  RTC_DCHECK_EQ(buf_.size(), frame->num_channels());
+  RTC_DCHECK_EQ(buf_[0].size(), frame->num_bands());
   if (delay_ == 0) {
     return;
   }
 
   const size_t i_start = last_insert_;
   size_t i = 0;
-  for (size_t j = 0; j < buf_.size(); ++j) {
-    i = i_start;
-    for (size_t k = 0; k < frame_length_; ++k) {
-      const float tmp = buf_[j][i];
-      buf_[j][i] = frame->split_bands_f(0)[j][k];
-      frame->split_bands_f(0)[j][k] = tmp;
-      i = i < buf_[0].size() - 1 ? i + 1 : 0;
+  for (size_t ch = 0; ch < buf_.size(); ++ch) {
+    for (size_t j = 0; j < buf_[ch].size(); ++j) {
+      std::vector<float>& buf = buf_[ch][j];
+      float* band = frame->split_bands_f(ch)[j];
+      i = i_start;
+      for (size_t k = 0; k < frame_length_; ++k) {
+        const float tmp = buf[i];
+        buf[i] = band[k];
+        band[k] = tmp;
+        i = i < buf.size() - 1 ? i + 1 : 0;
+      }
     }
   }
 
@@ -23,15 +23,19 @@ namespace webrtc {
 class BlockDelayBuffer {
  public:
   BlockDelayBuffer(size_t num_bands, size_t frame_length, size_t delay_samples);
+  BlockDelayBuffer(size_t num_channels,
+                   size_t num_bands,
+                   size_t frame_length,
+                   size_t delay_samples);
   ~BlockDelayBuffer();
 
-  // Delays the samples by the specified delay.
+  // Delays the samples of all channels by the specified delay.
   void DelaySignal(AudioBuffer* frame);
 
  private:
   const size_t frame_length_;
   const size_t delay_;
-  std::vector<std::vector<float>> buf_;
+  std::vector<std::vector<std::vector<float>>> buf_;
   size_t last_insert_ = 0;
 };
 }  // namespace webrtc
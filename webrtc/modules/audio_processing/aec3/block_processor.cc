@@ -49,6 +49,10 @@ class BlockProcessorImpl final : public BlockProcessor {
                       bool capture_signal_saturation,
                       std::vector<std::vector<float>>* capture_block) override;
 
+  void ProcessAdditionalCapture(
+      size_t channel,
+      std::vector<std::vector<float>>* capture_block) override;
+
   void BufferRender(const std::vector<std::vector<float>>& block) override;
 
   void UpdateEchoLeakageStatus(bool leakage_detected) override;
@@ -181,6 +185,21 @@ void BlockProcessorImpl::ProcessCapture(
   metrics_.UpdateCapture(false);
 }
 
+void BlockProcessorImpl::ProcessAdditionalCapture(
+    size_t channel,
+    std::vector<std::vector<float>>* capture_block) {
+  RTC_DCHECK(capture_block);
+  RTC_DCHECK_LT(0, channel);
+  RTC_DCHECK_EQ(NumBandsForRate(sample_rate_hz_), capture_block->size());
+  RTC_DCHECK_EQ(kBlockSize, (*capture_block)[0].size());
+
+  // Leave the channel untouched until the primary channel is processed.
+  if (!capture_properly_started_) {
+    return;
+  }
+  echo_remover_->ProcessAdditionalCapture(channel, capture_block);
+}
+
 void BlockProcessorImpl::BufferRender(
     const std::vector<std::vector<float>>& block) {
   RTC_DCHECK_EQ(NumBandsForRate(sample_rate_hz_), block.size());
@@ -220,12 +239,18 @@ void BlockProcessorImpl::SetAudioBufferDelay(size_t delay_ms) {
 
 BlockProcessor* BlockProcessor::Create(const EchoCanceller3Config& config,
                                        int sample_rate_hz) {
+  return Create(config, sample_rate_hz, 1);
+}
+
+BlockProcessor* BlockProcessor::Create(const EchoCanceller3Config& config,
+                                       int sample_rate_hz,
+                                       size_t num_capture_channels) {
   std::unique_ptr<RenderDelayBuffer> render_buffer(
       RenderDelayBuffer::Create(config, NumBandsForRate(sample_rate_hz)));
   std::unique_ptr<RenderDelayController> delay_controller(
       RenderDelayController::Create(config, sample_rate_hz));
   std::unique_ptr<EchoRemover> echo_remover(
-      EchoRemover::Create(config, sample_rate_hz));
+      EchoRemover::Create(config, sample_rate_hz, num_capture_channels));
   return Create(config, sample_rate_hz, std::move(render_buffer),
                 std::move(delay_controller), std::move(echo_remover));
 }
@@ -28,6 +28,9 @@ class BlockProcessor {
  public:
   static BlockProcessor* Create(const EchoCanceller3Config& config,
                                 int sample_rate_hz);
+  static BlockProcessor* Create(const EchoCanceller3Config& config,
+                                int sample_rate_hz,
+                                size_t num_capture_channels);
   // Only used for testing purposes.
   static BlockProcessor* Create(
       const EchoCanceller3Config& config,
@@ -54,6 +57,12 @@ class BlockProcessor {
       bool capture_signal_saturation,
       std::vector<std::vector<float>>* capture_block) = 0;
 
+  // Processes the block of an additional capture channel (1 and up) that
+  // corresponds to the block last passed to ProcessCapture().
+  virtual void ProcessAdditionalCapture(
+      size_t channel,
+      std::vector<std::vector<float>>* capture_block) = 0;
+
   // Buffers a block of render data supplied by a FrameBlocker object.
   virtual void BufferRender(
       const std::vector<std::vector<float>>& render_block) = 0;
@@ -45,14 +45,16 @@ EchoCanceller3Config AdjustConfig(const EchoCanceller3Config& config) {
 }
 
 void FillSubFrameView(AudioBuffer* frame,
+                      size_t channel,
                       size_t sub_frame_index,
                       std::vector<rtc::ArrayView<float>>* sub_frame_view) {
   RTC_DCHECK_GE(1, sub_frame_index);
   RTC_DCHECK_LE(0, sub_frame_index);
+  RTC_DCHECK_LT(channel, frame->num_channels());
   RTC_DCHECK_EQ(frame->num_bands(), sub_frame_view->size());
   for (size_t k = 0; k < sub_frame_view->size(); ++k) {
     (*sub_frame_view)[k] = rtc::ArrayView<float>(
-        &frame->split_bands_f(0)[k][sub_frame_index * kSubFrameLength],
+        &frame->split_bands_f(channel)[k][sub_frame_index * kSubFrameLength],
         kSubFrameLength);
   }
 }
@@ -78,13 +80,28 @@ void ProcessCaptureFrameContent(
     BlockProcessor* block_processor,
     std::vector<std::vector<float>>* block,
     std::vector<rtc::ArrayView<float>>* sub_frame_view) {
-  FillSubFrameView(capture, sub_frame_index, sub_frame_view);
+  FillSubFrameView(capture, 0, sub_frame_index, sub_frame_view);
   capture_blocker->InsertSubFrameAndExtractBlock(*sub_frame_view, block);
   block_processor->ProcessCapture(level_change, saturated_microphone_signal,
                                   block);
   output_framer->InsertBlockAndExtractSubFrame(*block, sub_frame_view);
 }
 
+void ProcessAdditionalCaptureFrameContent(
+    AudioBuffer* capture,
+    size_t channel,
+    size_t sub_frame_index,
+    FrameBlocker* capture_blocker,
+    BlockFramer* output_framer,
+    BlockProcessor* block_processor,
+    std::vector<std::vector<float>>* block,
+    std::vector<rtc::ArrayView<float>>* sub_frame_view) {
+  FillSubFrameView(capture, channel, sub_frame_index, sub_frame_view);
+  capture_blocker->InsertSubFrameAndExtractBlock(*sub_frame_view, block);
+  block_processor->ProcessAdditionalCapture(channel, block);
+  output_framer->InsertBlockAndExtractSubFrame(*block, sub_frame_view);
+}
+
 void ProcessRemainingCaptureFrameContent(
     bool level_change,
     bool saturated_microphone_signal,
@@ -102,6 +119,21 @@ void ProcessRemainingCaptureFrameContent(
   output_framer->InsertBlock(*block);
 }
 
+void ProcessRemainingAdditionalCaptureFrameContent(
+    size_t channel,
+    FrameBlocker* capture_blocker,
+    BlockFramer* output_framer,
+    BlockProcessor* block_processor,
+    std::vector<std::vector<float>>* block) {
+  if (!capture_blocker->IsBlockAvailable()) {
+    return;
+  }
+
+  capture_blocker->ExtractBlock(block);
+  block_processor->ProcessAdditionalCapture(channel, block);
+  output_framer->InsertBlock(*block);
+}
+
 void BufferRenderFrameContent(
     std::vector<std::vector<float>>* render_frame,
     size_t sub_frame_index,
@@ -219,25 +251,49 @@ void EchoCanceller3::RenderWriter::Insert(AudioBuffer* input) {
   static_cast<void>(render_transfer_queue_->Insert(&render_queue_input_frame_));
 }
 
+EchoCanceller3::AdditionalCaptureChannel::AdditionalCaptureChannel(
+    size_t num_bands)
+    : capture_blocker(num_bands), output_framer(num_bands) {}
+
+EchoCanceller3::AdditionalCaptureChannel::~AdditionalCaptureChannel() = default;
+
 int EchoCanceller3::instance_count_ = 0;
 
 EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                int sample_rate_hz,
                                bool use_highpass_filter)
-    : EchoCanceller3(
-          AdjustConfig(config),
-          sample_rate_hz,
-          use_highpass_filter,
-          std::unique_ptr<BlockProcessor>(
-              BlockProcessor::Create(AdjustConfig(config), sample_rate_hz))) {}
+    : EchoCanceller3(config, sample_rate_hz, 1, use_highpass_filter) {}
+EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
+                               int sample_rate_hz,
+                               size_t num_capture_channels,
+                               bool use_highpass_filter)
+    : EchoCanceller3(AdjustConfig(config),
+                     sample_rate_hz,
+                     num_capture_channels,
+                     use_highpass_filter,
+                     std::unique_ptr<BlockProcessor>(
+                         BlockProcessor::Create(AdjustConfig(config),
+                                                sample_rate_hz,
+                                                num_capture_channels))) {}
+EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
+                               int sample_rate_hz,
+                               bool use_highpass_filter,
+                               std::unique_ptr<BlockProcessor> block_processor)
+    : EchoCanceller3(config,
+                     sample_rate_hz,
+                     1,
+                     use_highpass_filter,
+                     std::move(block_processor)) {}
 EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                int sample_rate_hz,
+                               size_t num_capture_channels,
                                bool use_highpass_filter,
                                std::unique_ptr<BlockProcessor> block_processor)
     : data_dumper_(
           new ApmDataDumper(rtc::AtomicOps::Increment(&instance_count_))),
       config_(config),
       sample_rate_hz_(sample_rate_hz),
+      num_capture_channels_(num_capture_channels),
       num_bands_(NumBandsForRate(sample_rate_hz_)),
       frame_length_(rtc::CheckedDivExact(LowestBandRate(sample_rate_hz_), 100)),
       output_framer_(num_bands_),
@@ -254,10 +310,18 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                  std::vector<float>(frame_length_, 0.f)),
       block_(num_bands_, std::vector<float>(kBlockSize, 0.f)),
       sub_frame_view_(num_bands_),
-      block_delay_buffer_(num_bands_,
+      block_delay_buffer_(num_capture_channels_,
+                          num_bands_,
                           frame_length_,
                           config_.delay.fixed_capture_delay_samples) {
   RTC_DCHECK(ValidFullBandRate(sample_rate_hz_));
+  RTC_DCHECK_LT(0, num_capture_channels_);
+
+  for (size_t ch = 1; ch < num_capture_channels_; ++ch) {
+    additional_capture_channels_.push_back(
+        std::unique_ptr<AdditionalCaptureChannel>(
+            new AdditionalCaptureChannel(num_bands_)));
+  }
 
   std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter;
   if (use_highpass_filter) {
@@ -271,6 +335,13 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                 : kHighPassFilterCoefficients_16kHz,
         sample_rate_hz_ == 8000 ? kNumberOfHighPassBiQuads_8kHz
                                 : kNumberOfHighPassBiQuads_16kHz));
+    for (auto& channel : additional_capture_channels_) {
+      channel->highpass_filter.reset(new CascadedBiQuadFilter(
+          sample_rate_hz_ == 8000 ? kHighPassFilterCoefficients_8kHz
+                                  : kHighPassFilterCoefficients_16kHz,
+          sample_rate_hz_ == 8000 ? kNumberOfHighPassBiQuads_8kHz
+                                  : kNumberOfHighPassBiQuads_16kHz));
+    }
   }
 
   render_writer_.reset(
@@ -313,7 +384,7 @@ void EchoCanceller3::AnalyzeCapture(AudioBuffer* capture) {
 void EchoCanceller3::ProcessCapture(AudioBuffer* capture, bool level_change) {
   RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
   RTC_DCHECK(capture);
-  RTC_DCHECK_EQ(1u, capture->num_channels());
+  RTC_DCHECK_EQ(num_capture_channels_, capture->num_channels());
   RTC_DCHECK_EQ(num_bands_, capture->num_bands());
   RTC_DCHECK_EQ(frame_length_, capture->num_frames_per_band());
   data_dumper_->DumpRaw("aec3_call_order",
@@ -338,22 +409,43 @@ void EchoCanceller3::ProcessCapture(AudioBuffer* capture, bool level_change) {
 
   if (capture_highpass_filter_) {
     capture_highpass_filter_->Process(capture_lower_band);
+    for (size_t ch = 1; ch < num_capture_channels_; ++ch) {
+      additional_capture_channels_[ch - 1]->highpass_filter->Process(
+          rtc::ArrayView<float>(&capture->split_bands_f(ch)[0][0],
+                                frame_length_));
+    }
   }
 
-  ProcessCaptureFrameContent(
-      capture, level_change, saturated_microphone_signal_, 0, &capture_blocker_,
-      &output_framer_, block_processor_.get(), &block_, &sub_frame_view_);
-
-  if (sample_rate_hz_ != 8000) {
-    ProcessCaptureFrameContent(
-        capture, level_change, saturated_microphone_signal_, 1,
-        &capture_blocker_, &output_framer_, block_processor_.get(), &block_,
-        &sub_frame_view_);
+  // The additional channels reuse the suppression gain computed for channel 0,
+  // so each of their blocks is processed right after the matching channel 0
+  // block. All channels are blocked in lockstep.
+  const size_t num_sub_frames = sample_rate_hz_ != 8000 ? 2 : 1;
+  for (size_t sub_frame = 0; sub_frame < num_sub_frames; ++sub_frame) {
+    ProcessCaptureFrameContent(capture, level_change,
+                               saturated_microphone_signal_, sub_frame,
+                               &capture_blocker_, &output_framer_,
+                               block_processor_.get(), &block_,
+                               &sub_frame_view_);
+    for (size_t ch = 1; ch < num_capture_channels_; ++ch) {
+      AdditionalCaptureChannel* channel =
+          additional_capture_channels_[ch - 1].get();
+      ProcessAdditionalCaptureFrameContent(
+          capture, ch, sub_frame, &channel->capture_blocker,
+          &channel->output_framer, block_processor_.get(), &block_,
+          &sub_frame_view_);
+    }
   }
 
   ProcessRemainingCaptureFrameContent(
       level_change, saturated_microphone_signal_, &capture_blocker_,
       &output_framer_, block_processor_.get(), &block_);
+  for (size_t ch = 1; ch < num_capture_channels_; ++ch) {
+    AdditionalCaptureChannel* channel =
+        additional_capture_channels_[ch - 1].get();
+    ProcessRemainingAdditionalCaptureFrameContent(
+        ch, &channel->capture_blocker, &channel->output_framer,
+        block_processor_.get(), &block_);
+  }
 
   data_dumper_->DumpWav("aec3_capture_output", frame_length_,
                         &capture->split_bands_f(0)[0][0],
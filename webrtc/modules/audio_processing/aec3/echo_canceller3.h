@@ -76,9 +76,22 @@ class EchoCanceller3 : public EchoControl {
   EchoCanceller3(const EchoCanceller3Config& config,
                  int sample_rate_hz,
                  bool use_highpass_filter);
-  // Testing c-tor that is used only for testing purposes.
+  // C-tor for processing |num_capture_channels| capture channels against a
+  // mono render signal. Only channel 0 is echo cancelled; the other channels
+  // get no linear echo removal and only have the suppression gain computed
+  // for channel 0 applied.
   EchoCanceller3(const EchoCanceller3Config& config,
                  int sample_rate_hz,
+                 size_t num_capture_channels,
+                 bool use_highpass_filter);
+  // Testing c-tors that are used only for testing purposes.
+  EchoCanceller3(const EchoCanceller3Config& config,
+                 int sample_rate_hz,
+                 bool use_highpass_filter,
+                 std::unique_ptr<BlockProcessor> block_processor);
+  EchoCanceller3(const EchoCanceller3Config& config,
+                 int sample_rate_hz,
+                 size_t num_capture_channels,
                  bool use_highpass_filter,
                  std::unique_ptr<BlockProcessor> block_processor);
   ~EchoCanceller3() override;
@@ -107,6 +120,15 @@ class EchoCanceller3 : public EchoControl {
  private:
   class RenderWriter;
 
+  // Framing and filtering state of capture channels 1 and up.
+  struct AdditionalCaptureChannel {
+    explicit AdditionalCaptureChannel(size_t num_bands);
+    ~AdditionalCaptureChannel();
+    FrameBlocker capture_blocker;
+    BlockFramer output_framer;
+    std::unique_ptr<CascadedBiQuadFilter> highpass_filter;
+  };
+
   // Empties the render SwapQueue.
   void EmptyRenderQueue();
 
@@ -122,6 +144,7 @@ class EchoCanceller3 : public EchoControl {
   std::unique_ptr<ApmDataDumper> data_dumper_;
   const EchoCanceller3Config config_;
   const int sample_rate_hz_;
+  const size_t num_capture_channels_;
   const int num_bands_;
   const size_t frame_length_;
   BlockFramer output_framer_ RTC_GUARDED_BY(capture_race_checker_);
@@ -135,6 +158,8 @@ class EchoCanceller3 : public EchoControl {
       RTC_GUARDED_BY(capture_race_checker_);
   std::unique_ptr<CascadedBiQuadFilter> capture_highpass_filter_
       RTC_GUARDED_BY(capture_race_checker_);
+  std::vector<std::unique_ptr<AdditionalCaptureChannel>>
+      additional_capture_channels_ RTC_GUARDED_BY(capture_race_checker_);
   bool saturated_microphone_signal_ RTC_GUARDED_BY(capture_race_checker_) =
       false;
   std::vector<std::vector<float>> block_ RTC_GUARDED_BY(capture_race_checker_);
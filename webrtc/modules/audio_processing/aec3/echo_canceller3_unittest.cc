@@ -98,6 +98,10 @@ class CaptureTransportVerificationProcessor : public BlockProcessor {
                       std::vector<std::vector<float>>* capture_block) override {
   }
 
+  void ProcessAdditionalCapture(
+      size_t channel,
+      std::vector<std::vector<float>>* capture_block) override {}
+
   void BufferRender(const std::vector<std::vector<float>>& block) override {}
 
   void UpdateEchoLeakageStatus(bool leakage_detected) override {}
@@ -126,6 +130,10 @@ class RenderTransportVerificationProcessor : public BlockProcessor {
     capture_block->swap(render_block);
   }
 
+  void ProcessAdditionalCapture(
+      size_t channel,
+      std::vector<std::vector<float>>* capture_block) override {}
+
   void BufferRender(const std::vector<std::vector<float>>& block) override {
     received_render_blocks_.push_back(block);
   }
@@ -185,6 +193,56 @@ class EchoCanceller3Tester {
     }
   }
 
+  // Verifies that all channels of a multi-channel capture signal pass through
+  // the block processor and that the additional channels are processed after
+  // the matching block of the first channel.
+  void RunMultiChannelCaptureTransportVerificationTest() {
+    constexpr size_t kNumChannels = 3;
+    const size_t expected_num_blocks =
+        (kNumFramesToProcess *
+         rtc::CheckedDivExact(LowestBandRate(sample_rate_hz_), 100)) /
+        kBlockSize;
+    std::unique_ptr<StrictMock<webrtc::test::MockBlockProcessor>>
+        block_processor_mock(
+            new StrictMock<webrtc::test::MockBlockProcessor>());
+    {
+      testing::InSequence s;
+      for (size_t k = 0; k < expected_num_blocks; ++k) {
+        EXPECT_CALL(*block_processor_mock, ProcessCapture(_, _, _)).Times(1);
+        for (size_t ch = 1; ch < kNumChannels; ++ch) {
+          EXPECT_CALL(*block_processor_mock, ProcessAdditionalCapture(ch, _))
+              .Times(1);
+        }
+      }
+    }
+    EXPECT_CALL(*block_processor_mock, BufferRender(_))
+        .Times(expected_num_blocks);
+
+    AudioBuffer capture_buffer(fullband_frame_length_, kNumChannels,
+                               fullband_frame_length_, kNumChannels,
+                               fullband_frame_length_);
+    EchoCanceller3 aec3(EchoCanceller3Config(), sample_rate_hz_, kNumChannels,
+                        false, std::move(block_processor_mock));
+
+    for (size_t frame_index = 0; frame_index < kNumFramesToProcess;
+         ++frame_index) {
+      aec3.AnalyzeCapture(&capture_buffer);
+      OptionalBandSplit();
+      if (sample_rate_hz_ > 16000) {
+        capture_buffer.SplitIntoFrequencyBands();
+      }
+      for (size_t ch = 0; ch < kNumChannels; ++ch) {
+        PopulateInputFrame(frame_length_, num_bands_, frame_index,
+                           &capture_buffer.split_bands_f(ch)[0], 0);
+      }
+      PopulateInputFrame(frame_length_, num_bands_, frame_index,
+                         &render_buffer_.split_bands_f(0)[0], 0);
+
+      aec3.AnalyzeRender(&render_buffer_);
+      aec3.ProcessCapture(&capture_buffer, false);
+    }
+  }
+
   // Test method for testing that the render data is properly received by the
   // block processor.
   void RunRenderTransportVerificationTest() {
@@ -624,6 +682,14 @@ TEST(EchoCanceller3Buffering, CaptureBitexactness) {
   }
 }
 
+TEST(EchoCanceller3Buffering, MultiChannelCaptureTransport) {
+  for (auto rate : {8000, 16000, 32000, 48000}) {
+    SCOPED_TRACE(ProduceDebugText(rate));
+    EchoCanceller3Tester(rate)
+        .RunMultiChannelCaptureTransportVerificationTest();
+  }
+}
+
 TEST(EchoCanceller3Buffering, RenderBitexactness) {
   for (auto rate : {8000, 16000, 32000, 48000}) {
     SCOPED_TRACE(ProduceDebugText(rate));
@@ -15,6 +15,7 @@
 #include <array>
 #include <cmath>
 #include <memory>
+#include <vector>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
@@ -83,7 +84,9 @@ void WindowedPaddedFft(const Aec3Fft& fft,
 // Class for removing the echo from the capture signal.
 class EchoRemoverImpl final : public EchoRemover {
  public:
-  EchoRemoverImpl(const EchoCanceller3Config& config, int sample_rate_hz);
+  EchoRemoverImpl(const EchoCanceller3Config& config,
+                  int sample_rate_hz,
+                  size_t num_capture_channels);
   ~EchoRemoverImpl() override;
 
   void GetMetrics(EchoControl::Metrics* metrics) const override;
@@ -97,6 +100,12 @@ class EchoRemoverImpl final : public EchoRemover {
                       RenderBuffer* render_buffer,
                       std::vector<std::vector<float>>* capture) override;
 
+  // Applies the suppression gain of the latest ProcessCapture() call to an
+  // additional capture channel.
+  void ProcessAdditionalCapture(
+      size_t channel,
+      std::vector<std::vector<float>>* capture) override;
+
   // Returns the internal delay estimate in blocks.
   absl::optional<int> Delay() const override {
     // TODO(peah): Remove or reactivate this functionality.
@@ -110,6 +119,16 @@ class EchoRemoverImpl final : public EchoRemover {
   }
 
  private:
+  // State of a capture channel that only gets the suppression gain applied.
+  struct AdditionalChannel {
+    AdditionalChannel(Aec3Optimization optimization, int sample_rate_hz)
+        : suppression_filter(optimization, sample_rate_hz) {
+      y_old.fill(0.f);
+    }
+    SuppressionFilter suppression_filter;
+    std::array<float, kFftLengthBy2> y_old;
+  };
+
   // Selects which of the shadow and main linear filter outputs that is most
   // appropriate to pass to the suppressor and forms the linear filter output by
   // smoothly transition between those.
@@ -139,6 +158,13 @@ class EchoRemoverImpl final : public EchoRemover {
   int gain_change_hangover_ = 0;
   bool main_filter_output_last_selected_ = true;
   bool linear_filter_output_last_selected_ = true;
+  // Capture channels 1 and up. The gains and comfort noise computed for
+  // channel 0 are kept so that they can be applied to these channels.
+  std::vector<std::unique_ptr<AdditionalChannel>> additional_channels_;
+  std::array<float, kFftLengthBy2Plus1> last_gain_;
+  float last_high_bands_gain_ = 1.f;
+  FftData last_comfort_noise_;
+  FftData last_high_band_comfort_noise_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(EchoRemoverImpl);
 };
@@ -146,7 +172,8 @@ class EchoRemoverImpl final : public EchoRemover {
 int EchoRemoverImpl::instance_count_ = 0;
 
 EchoRemoverImpl::EchoRemoverImpl(const EchoCanceller3Config& config,
-                                 int sample_rate_hz)
+                                 int sample_rate_hz,
+                                 size_t num_capture_channels)
     : config_(config),
       fft_(),
       data_dumper_(
@@ -163,9 +190,17 @@ EchoRemoverImpl::EchoRemoverImpl(const EchoCanceller3Config& config,
       residual_echo_estimator_(config_),
       aec_state_(config_) {
   RTC_DCHECK(ValidFullBandRate(sample_rate_hz));
+  RTC_DCHECK_LT(0, num_capture_channels);
   x_old_.fill(0.f);
   y_old_.fill(0.f);
   e_old_.fill(0.f);
+  for (size_t ch = 1; ch < num_capture_channels; ++ch) {
+    additional_channels_.push_back(std::unique_ptr<AdditionalChannel>(
+        new AdditionalChannel(optimization_, sample_rate_hz_)));
+  }
+  last_gain_.fill(1.f);
+  last_comfort_noise_.Clear();
+  last_high_band_comfort_noise_.Clear();
 }
 
 EchoRemoverImpl::~EchoRemoverImpl() = default;
@@ -311,6 +346,13 @@ void EchoRemoverImpl::ProcessCapture(
   suppression_filter_.ApplyGain(comfort_noise, high_band_comfort_noise, G,
                                 high_bands_gain, Y_fft, y);
 
+  if (!additional_channels_.empty()) {
+    last_gain_ = G;
+    last_high_bands_gain_ = high_bands_gain;
+    last_comfort_noise_.Assign(comfort_noise);
+    last_high_band_comfort_noise_.Assign(high_band_comfort_noise);
+  }
+
   // Update the metrics.
   metrics_.Update(aec_state_, cng_.NoiseSpectrum(), G);
 
@@ -341,6 +383,23 @@ void EchoRemoverImpl::ProcessCapture(
                         aec_state_.SaturatedCapture() ? 1 : 0);
 }
 
+void EchoRemoverImpl::ProcessAdditionalCapture(
+    size_t channel,
+    std::vector<std::vector<float>>* capture) {
+  RTC_DCHECK(capture);
+  RTC_DCHECK_LT(0, channel);
+  RTC_DCHECK_LE(channel, additional_channels_.size());
+  RTC_DCHECK_EQ(capture->size(), NumBandsForRate(sample_rate_hz_));
+  RTC_DCHECK_EQ((*capture)[0].size(), kBlockSize);
+  AdditionalChannel& state = *additional_channels_[channel - 1];
+
+  FftData Y;
+  WindowedPaddedFft(fft_, (*capture)[0], state.y_old, &Y);
+  state.suppression_filter.ApplyGain(last_comfort_noise_,
+                                     last_high_band_comfort_noise_, last_gain_,
+                                     last_high_bands_gain_, Y, capture);
+}
+
 void EchoRemoverImpl::FormLinearFilterOutput(
     const SubtractorOutput& subtractor_output,
     rtc::ArrayView<float> output) {
@@ -390,7 +449,13 @@ void EchoRemoverImpl::FormLinearFilterOutput(
 
 EchoRemover* EchoRemover::Create(const EchoCanceller3Config& config,
                                  int sample_rate_hz) {
-  return new EchoRemoverImpl(config, sample_rate_hz);
+  return Create(config, sample_rate_hz, 1);
+}
+
+EchoRemover* EchoRemover::Create(const EchoCanceller3Config& config,
+                                 int sample_rate_hz,
+                                 size_t num_capture_channels) {
+  return new EchoRemoverImpl(config, sample_rate_hz, num_capture_channels);
 }
 
 }  // namespace webrtc
@@ -27,6 +27,9 @@ class EchoRemover {
  public:
   static EchoRemover* Create(const EchoCanceller3Config& config,
                              int sample_rate_hz);
+  static EchoRemover* Create(const EchoCanceller3Config& config,
+                             int sample_rate_hz,
+                             size_t num_capture_channels);
   virtual ~EchoRemover() = default;
 
   // Get current metrics.
@@ -42,6 +45,14 @@ class EchoRemover {
       RenderBuffer* render_buffer,
       std::vector<std::vector<float>>* capture) = 0;
 
+  // Removes the echo from a block of an additional capture channel, i.e.,
+  // channel 1 and up, by applying the suppression gain computed by the
+  // preceding ProcessCapture() call for the same block. No linear echo
+  // cancellation is done on the additional channels.
+  virtual void ProcessAdditionalCapture(
+      size_t channel,
+      std::vector<std::vector<float>>* capture) = 0;
+
   // Returns the internal delay estimate in blocks.
   virtual absl::optional<int> Delay() const = 0;
 
@@ -28,6 +28,9 @@ class MockBlockProcessor : public BlockProcessor {
                void(bool level_change,
                     bool saturated_microphone_signal,
                     std::vector<std::vector<float>>* capture_block));
+  MOCK_METHOD2(ProcessAdditionalCapture,
+               void(size_t channel,
+                    std::vector<std::vector<float>>* capture_block));
   MOCK_METHOD1(BufferRender,
                void(const std::vector<std::vector<float>>& block));
   MOCK_METHOD1(UpdateEchoLeakageStatus, void(bool leakage_detected));
@@ -33,6 +33,8 @@ class MockEchoRemover : public EchoRemover {
                     const absl::optional<DelayEstimate>& delay_estimate,
                     RenderBuffer* render_buffer,
                     std::vector<std::vector<float>>* capture));
+  MOCK_METHOD2(ProcessAdditionalCapture,
+               void(size_t channel, std::vector<std::vector<float>>* capture));
   MOCK_CONST_METHOD0(Delay, absl::optional<int>());
   MOCK_METHOD1(UpdateEchoLeakageStatus, void(bool leakage_detected));
   MOCK_CONST_METHOD1(GetMetrics, void(EchoControl::Metrics* metrics));
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec_dump/aec_dump_events.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+void PopulateInitEvent(const ProcessingConfig& api_format,
+                       int64_t time_now_ms,
+                       audioproc::Event* event) {
+  event->set_type(audioproc::Event::INIT);
+  audioproc::Init* msg = event->mutable_init();
+
+  msg->set_sample_rate(api_format.input_stream().sample_rate_hz());
+  msg->set_output_sample_rate(api_format.output_stream().sample_rate_hz());
+  msg->set_reverse_sample_rate(
+      api_format.reverse_input_stream().sample_rate_hz());
+  msg->set_reverse_output_sample_rate(
+      api_format.reverse_output_stream().sample_rate_hz());
+
+  msg->set_num_input_channels(
+      static_cast<int32_t>(api_format.input_stream().num_channels()));
+  msg->set_num_output_channels(
+      static_cast<int32_t>(api_format.output_stream().num_channels()));
+  msg->set_num_reverse_channels(
+      static_cast<int32_t>(api_format.reverse_input_stream().num_channels()));
+  msg->set_num_reverse_output_channels(
+      api_format.reverse_output_stream().num_channels());
+  msg->set_timestamp_ms(time_now_ms);
+}
+
+void PopulateConfigEvent(const InternalAPMConfig& config,
+                         audioproc::Event* event) {
+  event->set_type(audioproc::Event::CONFIG);
+  audioproc::Config* pb_cfg = event->mutable_config();
+  pb_cfg->set_aec_enabled(config.aec_enabled);
+  pb_cfg->set_aec_delay_agnostic_enabled(config.aec_delay_agnostic_enabled);
+  pb_cfg->set_aec_drift_compensation_enabled(
+      config.aec_drift_compensation_enabled);
+  pb_cfg->set_aec_extended_filter_enabled(config.aec_extended_filter_enabled);
+  pb_cfg->set_aec_suppression_level(config.aec_suppression_level);
+
+  pb_cfg->set_aecm_enabled(config.aecm_enabled);
+  pb_cfg->set_aecm_comfort_noise_enabled(config.aecm_comfort_noise_enabled);
+  pb_cfg->set_aecm_routing_mode(config.aecm_routing_mode);
+
+  pb_cfg->set_agc_enabled(config.agc_enabled);
+  pb_cfg->set_agc_mode(config.agc_mode);
+  pb_cfg->set_agc_limiter_enabled(config.agc_limiter_enabled);
+  pb_cfg->set_noise_robust_agc_enabled(config.noise_robust_agc_enabled);
+
+  pb_cfg->set_hpf_enabled(config.hpf_enabled);
+
+  pb_cfg->set_ns_enabled(config.ns_enabled);
+  pb_cfg->set_ns_level(config.ns_level);
+
+  pb_cfg->set_transient_suppression_enabled(
+      config.transient_suppression_enabled);
+
+  pb_cfg->set_pre_amplifier_enabled(config.pre_amplifier_enabled);
+  pb_cfg->set_pre_amplifier_fixed_gain_factor(
+      config.pre_amplifier_fixed_gain_factor);
+
+  pb_cfg->set_experiments_description(config.experiments_description);
+}
+
+void PopulateRuntimeSettingEvent(
+    const AudioProcessing::RuntimeSetting& runtime_setting,
+    audioproc::Event* event) {
+  event->set_type(audioproc::Event::RUNTIME_SETTING);
+  switch (runtime_setting.type()) {
+    case AudioProcessing::RuntimeSetting::Type::kCapturePreGain: {
+      float x;
+      runtime_setting.GetFloat(&x);
+      event->mutable_runtime_setting()->set_capture_pre_gain(x);
+      break;
+    }
+    case AudioProcessing::RuntimeSetting::Type::
+        kCustomRenderProcessingRuntimeSetting: {
+      float x;
+      runtime_setting.GetFloat(&x);
+      event->mutable_runtime_setting()->set_custom_render_processing_setting(
+          x);
+      break;
+    }
+    case AudioProcessing::RuntimeSetting::Type::kCaptureCompressionGain:
+      // Runtime AGC1 compression gain is ignored.
+      // TODO(http://bugs.webrtc.org/10432): Store compression gain in aecdumps.
+      break;
+    case AudioProcessing::RuntimeSetting::Type::kNotSpecified:
+      RTC_NOTREACHED();
+      break;
+  }
+}
+
+void PopulateRenderStreamEvent(const AudioFrame& frame,
+                               audioproc::Event* event) {
+  event->set_type(audioproc::Event::REVERSE_STREAM);
+  audioproc::ReverseStream* msg = event->mutable_reverse_stream();
+  const size_t data_size =
+      sizeof(int16_t) * frame.samples_per_channel_ * frame.num_channels_;
+  msg->set_data(frame.data(), data_size);
+}
+
+void PopulateRenderStreamEvent(const AudioFrameView<const float>& src,
+                               audioproc::Event* event) {
+  event->set_type(audioproc::Event::REVERSE_STREAM);
+  audioproc::ReverseStream* msg = event->mutable_reverse_stream();
+  for (size_t i = 0; i < src.num_channels(); ++i) {
+    const auto& channel_view = src.channel(i);
+    msg->add_channel(channel_view.begin(), sizeof(float) * channel_view.size());
+  }
+}
+
+void AddCaptureStreamInput(const AudioFrameView<const float>& src,
+                           audioproc::Stream* stream) {
+  for (size_t i = 0; i < src.num_channels(); ++i) {
+    const auto& channel_view = src.channel(i);
+    stream->add_input_channel(channel_view.begin(),
+                              sizeof(float) * channel_view.size());
+  }
+}
+
+void AddCaptureStreamOutput(const AudioFrameView<const float>& src,
+                            audioproc::Stream* stream) {
+  for (size_t i = 0; i < src.num_channels(); ++i) {
+    const auto& channel_view = src.channel(i);
+    stream->add_output_channel(channel_view.begin(),
+                               sizeof(float) * channel_view.size());
+  }
+}
+
+void AddCaptureStreamInput(const AudioFrame& frame, audioproc::Stream* stream) {
+  const size_t data_size =
+      sizeof(int16_t) * frame.samples_per_channel_ * frame.num_channels_;
+  stream->set_input_data(frame.data(), data_size);
+}
+
+void AddCaptureStreamOutput(const AudioFrame& frame,
+                            audioproc::Stream* stream) {
+  const size_t data_size =
+      sizeof(int16_t) * frame.samples_per_channel_ * frame.num_channels_;
+  stream->set_output_data(frame.data(), data_size);
+}
+
+void AddAudioProcessingState(const AecDump::AudioProcessingState& state,
+                             audioproc::Stream* stream) {
+  stream->set_delay(state.delay);
+  stream->set_drift(state.drift);
+  stream->set_level(state.level);
+  stream->set_keypress(state.keypress);
+}
+
+}  // namespace webrtc
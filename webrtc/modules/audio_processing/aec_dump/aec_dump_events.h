@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC_DUMP_AEC_DUMP_EVENTS_H_
+#define MODULES_AUDIO_PROCESSING_AEC_DUMP_AEC_DUMP_EVENTS_H_
+
+#include <stdint.h>
+
+#include "modules/audio_processing/include/aec_dump.h"
+#include "rtc_base/ignore_wundef.h"
+
+// Files generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/modules/audio_processing/debug.pb.h"
+#else
+#include "modules/audio_processing/debug.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+// Helpers that fill in debug.proto events from the AecDump API arguments. They
+// are shared by the AecDump implementations so that all of them produce the
+// same records. None of them clear |event| first, which allows a caller to
+// reuse the storage of a cleared event.
+void PopulateInitEvent(const ProcessingConfig& api_format,
+                       int64_t time_now_ms,
+                       audioproc::Event* event);
+void PopulateConfigEvent(const InternalAPMConfig& config,
+                         audioproc::Event* event);
+// Settings that are not logged leave an empty RUNTIME_SETTING event.
+void PopulateRuntimeSettingEvent(
+    const AudioProcessing::RuntimeSetting& runtime_setting,
+    audioproc::Event* event);
+
+void PopulateRenderStreamEvent(const AudioFrame& frame,
+                               audioproc::Event* event);
+void PopulateRenderStreamEvent(const AudioFrameView<const float>& src,
+                               audioproc::Event* event);
+
+void AddCaptureStreamInput(const AudioFrameView<const float>& src,
+                           audioproc::Stream* stream);
+void AddCaptureStreamOutput(const AudioFrameView<const float>& src,
+                            audioproc::Stream* stream);
+void AddCaptureStreamInput(const AudioFrame& frame, audioproc::Stream* stream);
+void AddCaptureStreamOutput(const AudioFrame& frame,
+                            audioproc::Stream* stream);
+void AddAudioProcessingState(const AecDump::AudioProcessingState& state,
+                             audioproc::Stream* stream);
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC_DUMP_AEC_DUMP_EVENTS_H_
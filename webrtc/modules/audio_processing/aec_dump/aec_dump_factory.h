@@ -41,6 +41,16 @@ class RTC_EXPORT AecDumpFactory {
   static std::unique_ptr<AecDump> Create(FILE* handle,
                                          int64_t max_log_size_bytes,
                                          rtc::TaskQueue* worker_queue);
+  // Creates an AecDump that can be left enabled in production: the audio
+  // threads never wait for the file system, and the dump is written to
+  // |num_files| rotating files of about |max_file_size_bytes| each in the
+  // existing directory |dir_path|. |num_files| must be at least 2. Returns
+  // null if the files cannot be opened.
+  static std::unique_ptr<AecDump> CreateStreaming(
+      const std::string& dir_path,
+      size_t max_file_size_bytes,
+      size_t num_files,
+      rtc::TaskQueue* worker_queue);
 };
 
 }  // namespace webrtc
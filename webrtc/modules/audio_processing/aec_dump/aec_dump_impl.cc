@@ -13,48 +13,14 @@
 #include "modules/audio_processing/aec_dump/aec_dump_impl.h"
 
 #include "absl/memory/memory.h"
+#include "modules/audio_processing/aec_dump/aec_dump_events.h"
 #include "modules/audio_processing/aec_dump/aec_dump_factory.h"
+#include "modules/audio_processing/aec_dump/streaming_aec_dump.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
 
 namespace webrtc {
 
-namespace {
-void CopyFromConfigToEvent(const webrtc::InternalAPMConfig& config,
-                           webrtc::audioproc::Config* pb_cfg) {
-  pb_cfg->set_aec_enabled(config.aec_enabled);
-  pb_cfg->set_aec_delay_agnostic_enabled(config.aec_delay_agnostic_enabled);
-  pb_cfg->set_aec_drift_compensation_enabled(
-      config.aec_drift_compensation_enabled);
-  pb_cfg->set_aec_extended_filter_enabled(config.aec_extended_filter_enabled);
-  pb_cfg->set_aec_suppression_level(config.aec_suppression_level);
-
-  pb_cfg->set_aecm_enabled(config.aecm_enabled);
-  pb_cfg->set_aecm_comfort_noise_enabled(config.aecm_comfort_noise_enabled);
-  pb_cfg->set_aecm_routing_mode(config.aecm_routing_mode);
-
-  pb_cfg->set_agc_enabled(config.agc_enabled);
-  pb_cfg->set_agc_mode(config.agc_mode);
-  pb_cfg->set_agc_limiter_enabled(config.agc_limiter_enabled);
-  pb_cfg->set_noise_robust_agc_enabled(config.noise_robust_agc_enabled);
-
-  pb_cfg->set_hpf_enabled(config.hpf_enabled);
-
-  pb_cfg->set_ns_enabled(config.ns_enabled);
-  pb_cfg->set_ns_level(config.ns_level);
-
-  pb_cfg->set_transient_suppression_enabled(
-      config.transient_suppression_enabled);
-
-  pb_cfg->set_pre_amplifier_enabled(config.pre_amplifier_enabled);
-  pb_cfg->set_pre_amplifier_fixed_gain_factor(
-      config.pre_amplifier_fixed_gain_factor);
-
-  pb_cfg->set_experiments_description(config.experiments_description);
-}
-
-}  // namespace
-
 AecDumpImpl::AecDumpImpl(FileWrapper debug_file,
                          int64_t max_log_size_bytes,
                          rtc::TaskQueue* worker_queue)
@@ -75,27 +41,7 @@ AecDumpImpl::~AecDumpImpl() {
 void AecDumpImpl::WriteInitMessage(const ProcessingConfig& api_format,
                                    int64_t time_now_ms) {
   auto task = CreateWriteToFileTask();
-  auto* event = task->GetEvent();
-  event->set_type(audioproc::Event::INIT);
-  audioproc::Init* msg = event->mutable_init();
-
-  msg->set_sample_rate(api_format.input_stream().sample_rate_hz());
-  msg->set_output_sample_rate(api_format.output_stream().sample_rate_hz());
-  msg->set_reverse_sample_rate(
-      api_format.reverse_input_stream().sample_rate_hz());
-  msg->set_reverse_output_sample_rate(
-      api_format.reverse_output_stream().sample_rate_hz());
-
-  msg->set_num_input_channels(
-      static_cast<int32_t>(api_format.input_stream().num_channels()));
-  msg->set_num_output_channels(
-      static_cast<int32_t>(api_format.output_stream().num_channels()));
-  msg->set_num_reverse_channels(
-      static_cast<int32_t>(api_format.reverse_input_stream().num_channels()));
-  msg->set_num_reverse_output_channels(
-      api_format.reverse_output_stream().num_channels());
-  msg->set_timestamp_ms(time_now_ms);
-
+  PopulateInitEvent(api_format, time_now_ms, task->GetEvent());
   worker_queue_->PostTask(std::move(task));
 }
 
@@ -130,40 +76,21 @@ void AecDumpImpl::WriteCaptureStreamMessage() {
 
 void AecDumpImpl::WriteRenderStreamMessage(const AudioFrame& frame) {
   auto task = CreateWriteToFileTask();
-  auto* event = task->GetEvent();
-
-  event->set_type(audioproc::Event::REVERSE_STREAM);
-  audioproc::ReverseStream* msg = event->mutable_reverse_stream();
-  const size_t data_size =
-      sizeof(int16_t) * frame.samples_per_channel_ * frame.num_channels_;
-  msg->set_data(frame.data(), data_size);
-
+  PopulateRenderStreamEvent(frame, task->GetEvent());
   worker_queue_->PostTask(std::move(task));
 }
 
 void AecDumpImpl::WriteRenderStreamMessage(
     const AudioFrameView<const float>& src) {
   auto task = CreateWriteToFileTask();
-  auto* event = task->GetEvent();
-
-  event->set_type(audioproc::Event::REVERSE_STREAM);
-
-  audioproc::ReverseStream* msg = event->mutable_reverse_stream();
-
-  for (size_t i = 0; i < src.num_channels(); ++i) {
-    const auto& channel_view = src.channel(i);
-    msg->add_channel(channel_view.begin(), sizeof(float) * channel_view.size());
-  }
-
+  PopulateRenderStreamEvent(src, task->GetEvent());
   worker_queue_->PostTask(std::move(task));
 }
 
 void AecDumpImpl::WriteConfig(const InternalAPMConfig& config) {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   auto task = CreateWriteToFileTask();
-  auto* event = task->GetEvent();
-  event->set_type(audioproc::Event::CONFIG);
-  CopyFromConfigToEvent(config, event->mutable_config());
+  PopulateConfigEvent(config, task->GetEvent());
   worker_queue_->PostTask(std::move(task));
 }
 
@@ -171,31 +98,7 @@ void AecDumpImpl::WriteRuntimeSetting(
     const AudioProcessing::RuntimeSetting& runtime_setting) {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   auto task = CreateWriteToFileTask();
-  auto* event = task->GetEvent();
-  event->set_type(audioproc::Event::RUNTIME_SETTING);
-  audioproc::RuntimeSetting* setting = event->mutable_runtime_setting();
-  switch (runtime_setting.type()) {
-    case AudioProcessing::RuntimeSetting::Type::kCapturePreGain: {
-      float x;
-      runtime_setting.GetFloat(&x);
-      setting->set_capture_pre_gain(x);
-      break;
-    }
-    case AudioProcessing::RuntimeSetting::Type::
-        kCustomRenderProcessingRuntimeSetting: {
-      float x;
-      runtime_setting.GetFloat(&x);
-      setting->set_custom_render_processing_setting(x);
-      break;
-    }
-    case AudioProcessing::RuntimeSetting::Type::kCaptureCompressionGain:
-      // Runtime AGC1 compression gain is ignored.
-      // TODO(http://bugs.webrtc.org/10432): Store compression gain in aecdumps.
-      break;
-    case AudioProcessing::RuntimeSetting::Type::kNotSpecified:
-      RTC_NOTREACHED();
-      break;
-  }
+  PopulateRuntimeSettingEvent(runtime_setting, task->GetEvent());
   worker_queue_->PostTask(std::move(task));
 }
 
@@ -236,4 +139,17 @@ std::unique_ptr<AecDump> AecDumpFactory::Create(FILE* handle,
   return absl::make_unique<AecDumpImpl>(FileWrapper(handle), max_log_size_bytes,
                                         worker_queue);
 }
+
+std::unique_ptr<AecDump> AecDumpFactory::CreateStreaming(
+    const std::string& dir_path,
+    size_t max_file_size_bytes,
+    size_t num_files,
+    rtc::TaskQueue* worker_queue) {
+  RTC_DCHECK(worker_queue);
+  StreamingAecDump::Config config;
+  config.dir_path = dir_path;
+  config.max_file_size_bytes = max_file_size_bytes;
+  config.num_files = num_files;
+  return StreamingAecDump::Create(config, worker_queue);
+}
 }  // namespace webrtc
@@ -10,6 +10,8 @@
 
 #include "modules/audio_processing/aec_dump/capture_stream_info.h"
 
+#include "modules/audio_processing/aec_dump/aec_dump_events.h"
+
 namespace webrtc {
 CaptureStreamInfo::CaptureStreamInfo(std::unique_ptr<WriteToFileTask> task)
     : task_(std::move(task)) {
@@ -21,49 +23,27 @@ CaptureStreamInfo::~CaptureStreamInfo() = default;
 
 void CaptureStreamInfo::AddInput(const AudioFrameView<const float>& src) {
   RTC_DCHECK(task_);
-  auto* stream = task_->GetEvent()->mutable_stream();
-
-  for (size_t i = 0; i < src.num_channels(); ++i) {
-    const auto& channel_view = src.channel(i);
-    stream->add_input_channel(channel_view.begin(),
-                              sizeof(float) * channel_view.size());
-  }
+  AddCaptureStreamInput(src, task_->GetEvent()->mutable_stream());
 }
 
 void CaptureStreamInfo::AddOutput(const AudioFrameView<const float>& src) {
   RTC_DCHECK(task_);
-  auto* stream = task_->GetEvent()->mutable_stream();
-
-  for (size_t i = 0; i < src.num_channels(); ++i) {
-    const auto& channel_view = src.channel(i);
-    stream->add_output_channel(channel_view.begin(),
-                               sizeof(float) * channel_view.size());
-  }
+  AddCaptureStreamOutput(src, task_->GetEvent()->mutable_stream());
 }
 
 void CaptureStreamInfo::AddInput(const AudioFrame& frame) {
   RTC_DCHECK(task_);
-  auto* stream = task_->GetEvent()->mutable_stream();
-  const size_t data_size =
-      sizeof(int16_t) * frame.samples_per_channel_ * frame.num_channels_;
-  stream->set_input_data(frame.data(), data_size);
+  AddCaptureStreamInput(frame, task_->GetEvent()->mutable_stream());
 }
 
 void CaptureStreamInfo::AddOutput(const AudioFrame& frame) {
   RTC_DCHECK(task_);
-  auto* stream = task_->GetEvent()->mutable_stream();
-  const size_t data_size =
-      sizeof(int16_t) * frame.samples_per_channel_ * frame.num_channels_;
-  stream->set_output_data(frame.data(), data_size);
+  AddCaptureStreamOutput(frame, task_->GetEvent()->mutable_stream());
 }
 
 void CaptureStreamInfo::AddAudioProcessingState(
     const AecDump::AudioProcessingState& state) {
   RTC_DCHECK(task_);
-  auto* stream = task_->GetEvent()->mutable_stream();
-  stream->set_delay(state.delay);
-  stream->set_drift(state.drift);
-  stream->set_level(state.level);
-  stream->set_keypress(state.keypress);
+  webrtc::AddAudioProcessingState(state, task_->GetEvent()->mutable_stream());
 }
 }  // namespace webrtc
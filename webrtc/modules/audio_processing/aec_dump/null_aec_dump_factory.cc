@@ -30,4 +30,12 @@ std::unique_ptr<AecDump> AecDumpFactory::Create(FILE* handle,
                                                 rtc::TaskQueue* worker_queue) {
   return nullptr;
 }
+
+std::unique_ptr<AecDump> AecDumpFactory::CreateStreaming(
+    const std::string& dir_path,
+    size_t max_file_size_bytes,
+    size_t num_files,
+    rtc::TaskQueue* worker_queue) {
+  return nullptr;
+}
 }  // namespace webrtc
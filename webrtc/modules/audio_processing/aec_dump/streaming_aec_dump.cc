@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec_dump/streaming_aec_dump.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "modules/audio_processing/aec_dump/aec_dump_events.h"
+#include "rtc_base/atomic_ops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/file_rotating_stream.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+// FileRotatingStream that never splits a record between two files: when a
+// record reaches the size limit, the limit is raised for that one write so that
+// the file is rotated right after the record instead of in the middle of it.
+class StreamingAecDump::RecordStream : public rtc::FileRotatingStream {
+ public:
+  RecordStream(const std::string& dir_path,
+               const std::string& file_prefix,
+               size_t max_file_size,
+               size_t num_files)
+      : FileRotatingStream(dir_path, file_prefix, max_file_size, num_files) {}
+
+  bool WriteRecord(const uint8_t* data, size_t size) {
+    RTC_DCHECK_GT(size, 0);
+    const size_t max_file_size = GetMaxFileSize();
+    const bool last_in_file = current_file_bytes_ + size >= max_file_size;
+    if (last_in_file) {
+      SetMaxFileSize(current_file_bytes_ + size);
+    }
+    size_t written = 0;
+    int error = 0;
+    const rtc::StreamResult result = Write(data, size, &written, &error);
+    if (last_in_file) {
+      SetMaxFileSize(max_file_size);
+    }
+    // A failed write is neither counted by the base class nor followed by a
+    // rotation, so the count stays as it was.
+    if (result != rtc::SR_SUCCESS) {
+      return false;
+    }
+    // The limit always leaves room for the whole record.
+    RTC_DCHECK_EQ(size, written);
+    current_file_bytes_ = last_in_file ? 0 : current_file_bytes_ + size;
+    return true;
+  }
+
+ private:
+  size_t current_file_bytes_ = 0;
+};
+
+std::unique_ptr<StreamingAecDump> StreamingAecDump::Create(
+    const Config& config,
+    rtc::TaskQueue* worker_queue) {
+  RTC_DCHECK(worker_queue);
+  RTC_DCHECK_GT(config.max_file_size_bytes, 0);
+  RTC_DCHECK_GT(config.num_files, 1);
+  RTC_DCHECK_GT(config.queue_size, 0);
+  RTC_DCHECK_GT(config.write_interval_ms, 0);
+  auto stream = absl::make_unique<RecordStream>(
+      config.dir_path, config.file_prefix, config.max_file_size_bytes,
+      config.num_files);
+  if (!stream->Open()) {
+    RTC_LOG(LS_ERROR) << "Could not open aec dump files in "
+                      << config.dir_path;
+    return nullptr;
+  }
+  return std::unique_ptr<StreamingAecDump>(
+      new StreamingAecDump(config, std::move(stream), worker_queue));
+}
+
+StreamingAecDump::StreamingAecDump(const Config& config,
+                                   std::unique_ptr<RecordStream> stream,
+                                   rtc::TaskQueue* worker_queue)
+    : config_(config),
+      worker_queue_(worker_queue),
+      record_queue_(config.queue_size,
+                    std::vector<uint8_t>(config.record_size_bytes)),
+      capture_record_(config.record_size_bytes),
+      render_record_(config.record_size_bytes),
+      control_record_(config.record_size_bytes),
+      stream_(std::move(stream)),
+      write_record_(config.record_size_bytes) {
+  worker_queue_->PostTask([this] {
+    write_task_ = RepeatingTaskHandle::DelayedStart(
+        worker_queue_->Get(), TimeDelta::ms(config_.write_interval_ms), [this] {
+          WriteQueuedRecords();
+          return TimeDelta::ms(config_.write_interval_ms);
+        });
+  });
+}
+
+StreamingAecDump::~StreamingAecDump() {
+  // Write what is left in the queue and block until the files are closed.
+  rtc::Event done;
+  worker_queue_->PostTask([this, &done] {
+    write_task_.Stop();
+    WriteQueuedRecords();
+    stream_->Close();
+    done.Set();
+  });
+  done.Wait(rtc::Event::kForever);
+}
+
+void StreamingAecDump::WriteInitMessage(const ProcessingConfig& api_format,
+                                        int64_t time_now_ms) {
+  rtc::CritScope cs(&control_crit_);
+  PopulateInitEvent(api_format, time_now_ms, &control_event_);
+  QueueEvent(&control_event_, &control_record_);
+}
+
+void StreamingAecDump::AddCaptureStreamInput(
+    const AudioFrameView<const float>& src) {
+  webrtc::AddCaptureStreamInput(src, capture_event_.mutable_stream());
+}
+
+void StreamingAecDump::AddCaptureStreamOutput(
+    const AudioFrameView<const float>& src) {
+  webrtc::AddCaptureStreamOutput(src, capture_event_.mutable_stream());
+}
+
+void StreamingAecDump::AddCaptureStreamInput(const AudioFrame& frame) {
+  webrtc::AddCaptureStreamInput(frame, capture_event_.mutable_stream());
+}
+
+void StreamingAecDump::AddCaptureStreamOutput(const AudioFrame& frame) {
+  webrtc::AddCaptureStreamOutput(frame, capture_event_.mutable_stream());
+}
+
+void StreamingAecDump::AddAudioProcessingState(
+    const AudioProcessingState& state) {
+  webrtc::AddAudioProcessingState(state, capture_event_.mutable_stream());
+}
+
+void StreamingAecDump::WriteCaptureStreamMessage() {
+  capture_event_.set_type(audioproc::Event::STREAM);
+  QueueEvent(&capture_event_, &capture_record_);
+}
+
+void StreamingAecDump::WriteRenderStreamMessage(const AudioFrame& frame) {
+  PopulateRenderStreamEvent(frame, &render_event_);
+  QueueEvent(&render_event_, &render_record_);
+}
+
+void StreamingAecDump::WriteRenderStreamMessage(
+    const AudioFrameView<const float>& src) {
+  PopulateRenderStreamEvent(src, &render_event_);
+  QueueEvent(&render_event_, &render_record_);
+}
+
+void StreamingAecDump::WriteConfig(const InternalAPMConfig& config) {
+  rtc::CritScope cs(&control_crit_);
+  PopulateConfigEvent(config, &control_event_);
+  QueueEvent(&control_event_, &control_record_);
+}
+
+void StreamingAecDump::WriteRuntimeSetting(
+    const AudioProcessing::RuntimeSetting& runtime_setting) {
+  rtc::CritScope cs(&control_crit_);
+  PopulateRuntimeSettingEvent(runtime_setting, &control_event_);
+  QueueEvent(&control_event_, &control_record_);
+}
+
+StreamingAecDump::Stats StreamingAecDump::GetStats() const {
+  Stats stats;
+  {
+    rtc::CritScope cs(&stats_crit_);
+    stats = written_stats_;
+  }
+  stats.records_dropped = rtc::AtomicOps::AcquireLoad(&records_dropped_);
+  return stats;
+}
+
+void StreamingAecDump::QueueEvent(audioproc::Event* event,
+                                  std::vector<uint8_t>* record) {
+  // Same layout as WriteToFileTask: the event size followed by the event.
+  const size_t event_byte_size = event->ByteSizeLong();
+  const int32_t size_prefix = static_cast<int32_t>(event_byte_size);
+  record->resize(sizeof(size_prefix) + event_byte_size);
+  memcpy(record->data(), &size_prefix, sizeof(size_prefix));
+  event->SerializeWithCachedSizesToArray(record->data() + sizeof(size_prefix));
+  event->Clear();
+
+  if (!record_queue_.Insert(record)) {
+    rtc::AtomicOps::Increment(&records_dropped_);
+  }
+}
+
+void StreamingAecDump::WriteQueuedRecords() {
+  RTC_DCHECK(worker_queue_->IsCurrent());
+  int64_t records_written = 0;
+  int64_t bytes_written = 0;
+  int write_errors = 0;
+  while (record_queue_.Remove(&write_record_)) {
+    if (stream_->WriteRecord(write_record_.data(), write_record_.size())) {
+      ++records_written;
+      bytes_written += write_record_.size();
+    } else {
+      ++write_errors;
+    }
+  }
+  if (records_written == 0 && write_errors == 0) {
+    return;
+  }
+  stream_->Flush();
+
+  rtc::CritScope cs(&stats_crit_);
+  written_stats_.records_written += records_written;
+  written_stats_.bytes_written += bytes_written;
+  written_stats_.write_errors += write_errors;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC_DUMP_STREAMING_AEC_DUMP_H_
+#define MODULES_AUDIO_PROCESSING_AEC_DUMP_STREAMING_AEC_DUMP_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/audio_processing/include/aec_dump.h"
+#include "rtc_base/constructor_magic.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ignore_wundef.h"
+#include "rtc_base/swap_queue.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/task_utils/repeating_task.h"
+#include "rtc_base/thread_annotations.h"
+
+// Files generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/modules/audio_processing/debug.pb.h"
+#else
+#include "modules/audio_processing/debug.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+// AecDump meant to be left enabled in production. The audio threads serialize
+// each event into a preallocated record and hand it over through a fixed-size
+// SwapQueue; they never allocate in steady state, never wait for the file
+// system and never block for longer than a swap. The worker queue drains the
+// records periodically into a set of size-bounded rotating files. Records that
+// do not fit in the queue are dropped and counted instead of stalling the
+// caller.
+//
+// Every file holds whole records in the regular aec-dump format, so each of
+// them can be unpacked on its own once the oldest files have been rotated out.
+class StreamingAecDump : public AecDump {
+ public:
+  struct Config {
+    // Existing directory to write the files to.
+    std::string dir_path;
+    std::string file_prefix = "aec_dump";
+    // A file is closed after the first record that reaches this size, so files
+    // may exceed it by at most one record.
+    size_t max_file_size_bytes = 10 * 1024 * 1024;
+    // Number of files to rotate through; must be at least 2.
+    size_t num_files = 3;
+    // Number of records that can be queued between two writes.
+    size_t queue_size = 200;
+    // Bytes preallocated for every record. Larger records are still accepted
+    // but cause the audio thread to allocate.
+    size_t record_size_bytes = 16 * 1024;
+    int write_interval_ms = 50;
+  };
+
+  struct Stats {
+    int64_t records_written = 0;
+    int64_t bytes_written = 0;
+    // Records dropped because the queue was full.
+    int records_dropped = 0;
+    // Records lost because writing to the file failed.
+    int write_errors = 0;
+  };
+
+  // The |worker_queue| may not be null and must outlive the created instance.
+  // Returns null if the files cannot be opened.
+  static std::unique_ptr<StreamingAecDump> Create(const Config& config,
+                                                  rtc::TaskQueue* worker_queue);
+
+  // Blocks until all queued records have been written and the files closed.
+  ~StreamingAecDump() override;
+
+  void WriteInitMessage(const ProcessingConfig& api_format,
+                        int64_t time_now_ms) override;
+  void AddCaptureStreamInput(const AudioFrameView<const float>& src) override;
+  void AddCaptureStreamOutput(const AudioFrameView<const float>& src) override;
+  void AddCaptureStreamInput(const AudioFrame& frame) override;
+  void AddCaptureStreamOutput(const AudioFrame& frame) override;
+  void AddAudioProcessingState(const AudioProcessingState& state) override;
+  void WriteCaptureStreamMessage() override;
+
+  void WriteRenderStreamMessage(const AudioFrame& frame) override;
+  void WriteRenderStreamMessage(
+      const AudioFrameView<const float>& src) override;
+
+  void WriteConfig(const InternalAPMConfig& config) override;
+
+  void WriteRuntimeSetting(
+      const AudioProcessing::RuntimeSetting& runtime_setting) override;
+
+  Stats GetStats() const;
+
+ private:
+  class RecordStream;
+
+  StreamingAecDump(const Config& config,
+                   std::unique_ptr<RecordStream> stream,
+                   rtc::TaskQueue* worker_queue);
+
+  // Serializes |event| into |record|, clears |event| and queues the record.
+  void QueueEvent(audioproc::Event* event, std::vector<uint8_t>* record);
+  // Runs on the worker queue.
+  void WriteQueuedRecords();
+
+  const Config config_;
+  rtc::TaskQueue* const worker_queue_;
+  SwapQueue<std::vector<uint8_t>> record_queue_;
+
+  // Scratch storage of the capture and render threads. Events are cleared, not
+  // destroyed, so that the protobuf keeps its allocated buffers.
+  audioproc::Event capture_event_;
+  std::vector<uint8_t> capture_record_;
+  audioproc::Event render_event_;
+  std::vector<uint8_t> render_record_;
+  // Init, config and runtime setting events are rare and may come from any
+  // thread.
+  rtc::CriticalSection control_crit_;
+  audioproc::Event control_event_ RTC_GUARDED_BY(control_crit_);
+  std::vector<uint8_t> control_record_ RTC_GUARDED_BY(control_crit_);
+
+  // Only used on the worker queue.
+  std::unique_ptr<RecordStream> stream_;
+  std::vector<uint8_t> write_record_;
+  RepeatingTaskHandle write_task_;
+
+  volatile int records_dropped_ = 0;
+  rtc::CriticalSection stats_crit_;
+  Stats written_stats_ RTC_GUARDED_BY(stats_crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(StreamingAecDump);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC_DUMP_STREAMING_AEC_DUMP_H_
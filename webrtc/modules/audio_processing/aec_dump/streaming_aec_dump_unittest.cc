@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec_dump/streaming_aec_dump.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "modules/audio_processing/aec_dump/aec_dump_factory.h"
+#include "rtc_base/task_queue_for_test.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kNumSamples = 480;
+
+class StreamingAecDumpTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const ::testing::TestInfo* const test_info =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+    dir_path_ = test::OutputPath() + "streaming_aec_dump_" + test_info->name() +
+                test::kPathDelimiter;
+    ASSERT_TRUE(test::CreateDir(dir_path_));
+    config_.dir_path = dir_path_;
+  }
+
+  void TearDown() override {
+    for (const std::string& file : Files()) {
+      EXPECT_TRUE(test::RemoveFile(file));
+    }
+    EXPECT_TRUE(test::RemoveDir(dir_path_));
+  }
+
+  std::vector<std::string> Files() const {
+    return test::ReadDirectory(dir_path_).value_or(std::vector<std::string>());
+  }
+
+  // Parses |file_name| as an aec dump. Returns the number of events, or -1 if
+  // the file does not consist of whole records.
+  static int CountEvents(const std::string& file_name) {
+    FILE* file = fopen(file_name.c_str(), "rb");
+    if (!file)
+      return -1;
+    int num_events = 0;
+    int32_t event_size;
+    while (fread(&event_size, sizeof(event_size), 1, file) == 1) {
+      std::vector<char> bytes(event_size);
+      audioproc::Event event;
+      if (fread(bytes.data(), 1, bytes.size(), file) != bytes.size() ||
+          !event.ParseFromArray(bytes.data(), bytes.size())) {
+        num_events = -1;
+        break;
+      }
+      ++num_events;
+    }
+    fclose(file);
+    return num_events;
+  }
+
+  std::string dir_path_;
+  StreamingAecDump::Config config_;
+  TaskQueueForTest worker_queue_{"aec_dump_writer"};
+  AudioFrame frame_;
+};
+
+}  // namespace
+
+TEST_F(StreamingAecDumpTest, WritesAllEventsOnDestruction) {
+  constexpr int kNumFrames = 50;
+  {
+    auto aec_dump = StreamingAecDump::Create(config_, &worker_queue_);
+    ASSERT_TRUE(aec_dump);
+    aec_dump->WriteInitMessage(ProcessingConfig(), 0);
+    aec_dump->WriteConfig(InternalAPMConfig());
+    for (int i = 0; i < kNumFrames; ++i) {
+      aec_dump->WriteRenderStreamMessage(frame_);
+      aec_dump->AddCaptureStreamInput(frame_);
+      aec_dump->AddCaptureStreamOutput(frame_);
+      aec_dump->WriteCaptureStreamMessage();
+    }
+  }
+  const std::vector<std::string> files = Files();
+  ASSERT_FALSE(files.empty());
+  int num_events = 0;
+  for (const std::string& file : files) {
+    const int file_events = CountEvents(file);
+    ASSERT_GE(file_events, 0);
+    num_events += file_events;
+  }
+  EXPECT_EQ(2 + 2 * kNumFrames, num_events);
+}
+
+TEST_F(StreamingAecDumpTest, RotatesFilesAtRecordBoundaries) {
+  const int16_t samples[kNumSamples] = {0};
+  frame_.UpdateFrame(0, samples, kNumSamples, 48000,
+                     AudioFrame::kNormalSpeech, AudioFrame::kVadActive, 1);
+  config_.max_file_size_bytes = 4000;  // About four records per file.
+  config_.num_files = 3;
+  {
+    auto aec_dump = StreamingAecDump::Create(config_, &worker_queue_);
+    ASSERT_TRUE(aec_dump);
+    for (int i = 0; i < 100; ++i) {
+      aec_dump->WriteRenderStreamMessage(frame_);
+    }
+  }
+  const std::vector<std::string> files = Files();
+  EXPECT_EQ(config_.num_files, files.size());
+  // The newest file may still be empty if the last record filled its
+  // predecessor.
+  int num_events = 0;
+  for (const std::string& file : files) {
+    const int file_events = CountEvents(file);
+    EXPECT_GE(file_events, 0) << file;
+    num_events += file_events;
+    EXPECT_LT(test::GetFileSize(file),
+              config_.max_file_size_bytes + 2 * kNumSamples + 64);
+  }
+  EXPECT_GT(num_events, 0);
+}
+
+TEST_F(StreamingAecDumpTest, DropsAndCountsRecordsWhenQueueIsFull) {
+  config_.queue_size = 4;
+  config_.write_interval_ms = 60 * 1000;  // Nothing is written until the end.
+  auto aec_dump = StreamingAecDump::Create(config_, &worker_queue_);
+  ASSERT_TRUE(aec_dump);
+  for (int i = 0; i < 10; ++i) {
+    aec_dump->WriteRenderStreamMessage(frame_);
+  }
+  StreamingAecDump::Stats stats = aec_dump->GetStats();
+  EXPECT_EQ(6, stats.records_dropped);
+  EXPECT_EQ(0, stats.records_written);
+
+  // The queued records are still written on destruction.
+  aec_dump.reset();
+  const std::vector<std::string> files = Files();
+  ASSERT_EQ(1u, files.size());
+  EXPECT_EQ(4, CountEvents(files[0]));
+}
+
+TEST_F(StreamingAecDumpTest, CreatedByFactory) {
+  {
+    std::unique_ptr<AecDump> aec_dump = AecDumpFactory::CreateStreaming(
+        dir_path_, config_.max_file_size_bytes, 2, &worker_queue_);
+    ASSERT_TRUE(aec_dump);
+    aec_dump->WriteRenderStreamMessage(frame_);
+  }
+  const std::vector<std::string> files = Files();
+  ASSERT_EQ(1u, files.size());
+  EXPECT_EQ(1, CountEvents(files[0]));
+}
+
+}  // namespace webrtc
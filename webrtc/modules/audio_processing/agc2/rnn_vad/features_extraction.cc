@@ -27,12 +27,16 @@ const BiQuadFilter::BiQuadCoefficients kHpfConfig24k = {
 }  // namespace
 
 FeaturesExtractor::FeaturesExtractor()
-    : use_high_pass_filter_(false),
+    : FeaturesExtractor(DetectOptimization()) {}
+
+FeaturesExtractor::FeaturesExtractor(Optimization optimization)
+    : optimization_(optimization),
+      use_high_pass_filter_(false),
       pitch_buf_24kHz_(),
       pitch_buf_24kHz_view_(pitch_buf_24kHz_.GetBufferView()),
       lp_residual_(kBufSize24kHz),
       lp_residual_view_(lp_residual_.data(), kBufSize24kHz),
-      pitch_estimator_(),
+      pitch_estimator_(optimization),
       reference_frame_view_(pitch_buf_24kHz_.GetMostRecentValuesView()) {
   RTC_DCHECK_EQ(kBufSize24kHz, lp_residual_.size());
   hpf_.Initialize(kHpfConfig24k);
@@ -63,7 +67,8 @@ bool FeaturesExtractor::CheckSilenceComputeFeatures(
   }
   // Extract the LP residual.
   float lpc_coeffs[kNumLpcCoefficients];
-  ComputeAndPostProcessLpcCoefficients(pitch_buf_24kHz_view_, lpc_coeffs);
+  ComputeAndPostProcessLpcCoefficients(optimization_, pitch_buf_24kHz_view_,
+                                       lpc_coeffs);
   ComputeLpResidual(lpc_coeffs, pitch_buf_24kHz_view_, lp_residual_view_);
   // Estimate pitch on the LP-residual and write the normalized pitch period
   // into the output vector (normalization based on training data stats).
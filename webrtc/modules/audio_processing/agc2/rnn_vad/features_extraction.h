@@ -28,6 +28,7 @@ namespace rnn_vad {
 class FeaturesExtractor {
  public:
   FeaturesExtractor();
+  explicit FeaturesExtractor(Optimization optimization);
   FeaturesExtractor(const FeaturesExtractor&) = delete;
   FeaturesExtractor& operator=(const FeaturesExtractor&) = delete;
   ~FeaturesExtractor();
@@ -41,6 +42,7 @@ class FeaturesExtractor {
       rtc::ArrayView<float, kFeatureVectorSize> feature_vector);
 
  private:
+  const Optimization optimization_;
   const bool use_high_pass_filter_;
   // TODO(bugs.webrtc.org/7494): Remove HPF depending on how AGC2 is used in APM
   // and on whether an HPF is already used as pre-processing step in APM.
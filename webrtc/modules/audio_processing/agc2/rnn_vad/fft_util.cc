@@ -11,7 +11,6 @@
 #include "modules/audio_processing/agc2/rnn_vad/fft_util.h"
 
 #include <stddef.h>
-#include <algorithm>
 #include <cmath>
 
 #include "rtc_base/checks.h"
@@ -37,7 +36,9 @@ std::array<float, kHalfFrameSize> ComputeHalfVorbisWindow() {
 
 BandAnalysisFft::BandAnalysisFft()
     : half_window_(ComputeHalfVorbisWindow()),
-      fft_(static_cast<int>(input_buf_.size())) {}
+      fft_(kFrameSize20ms24kHz, Pffft::FftType::kReal),
+      input_buf_(fft_.CreateBuffer()),
+      output_buf_(fft_.CreateBuffer()) {}
 
 BandAnalysisFft::~BandAnalysisFft() = default;
 
@@ -46,17 +47,23 @@ void BandAnalysisFft::ForwardFft(rtc::ArrayView<const float> samples,
   RTC_DCHECK_EQ(samples.size(), kFrameSize20ms24kHz);
   RTC_DCHECK_EQ(dst.size(), kFrameSize20ms24kHz / 2 + 1);
   // Apply windowing.
-  RTC_DCHECK_EQ(input_buf_.size(), 2 * half_window_.size());
-  for (size_t i = 0; i < input_buf_.size() / 2; ++i) {
-    input_buf_[i].real(samples[i] * half_window_[i]);
+  rtc::ArrayView<float> input = input_buf_->GetView();
+  RTC_DCHECK_EQ(input.size(), 2 * half_window_.size());
+  for (size_t i = 0; i < input.size() / 2; ++i) {
+    input[i] = samples[i] * half_window_[i];
     size_t j = kFrameSize20ms24kHz - i - 1;
-    input_buf_[j].real(samples[j] * half_window_[i]);
+    input[j] = samples[j] * half_window_[i];
+  }
+  fft_.ForwardTransform(*input_buf_, output_buf_.get(), /*ordered=*/true);
+  // Unpack the ordered PFFFT output (DC and Nyquist first, followed by the
+  // interleaved real and imaginary parts) and apply the KISS FFT scaling.
+  constexpr float kScaling = 1.f / kFrameSize20ms24kHz;
+  rtc::ArrayView<const float> output = output_buf_->GetConstView();
+  dst[0] = {kScaling * output[0], 0.f};
+  dst[kFrameSize20ms24kHz / 2] = {kScaling * output[1], 0.f};
+  for (size_t k = 1; k < kFrameSize20ms24kHz / 2; ++k) {
+    dst[k] = {kScaling * output[2 * k], kScaling * output[2 * k + 1]};
   }
-  fft_.ForwardFft(kFrameSize20ms24kHz, input_buf_.data(), kFrameSize20ms24kHz,
-                  output_buf_.data());
-  // Copy the first symmetric conjugate part.
-  RTC_DCHECK_LT(dst.size(), output_buf_.size());
-  std::copy(output_buf_.begin(), output_buf_.begin() + dst.size(), dst.begin());
 }
 
 }  // namespace rnn_vad
@@ -13,21 +13,21 @@
 
 #include <array>
 #include <complex>
+#include <memory>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
-#include "third_party/rnnoise/src/kiss_fft.h"
+#include "modules/audio_processing/utility/pffft_wrapper.h"
 
 namespace webrtc {
 namespace rnn_vad {
 
-// TODO(alessiob): Switch to PFFFT using its own wrapper.
-// TODO(alessiob): Delete this class when switching to PFFFT.
 // FFT implementation wrapper for the band-wise analysis step in which 20 ms
 // frames at 24 kHz are analyzed in the frequency domain. The goal of this class
 // are (i) making easy to switch to another FFT implementation, (ii) own the
 // input buffer for the FFT and (iii) apply a windowing function before
-// computing the FFT.
+// computing the FFT. The FFT is computed with PFFFT; the output is scaled by
+// 1 / kFrameSize20ms24kHz to match the KISS FFT used by RNNoise.
 class BandAnalysisFft {
  public:
   BandAnalysisFft();
@@ -45,9 +45,9 @@ class BandAnalysisFft {
   static_assert((kFrameSize20ms24kHz & 1) == 0,
                 "kFrameSize20ms24kHz must be even.");
   const std::array<float, kFrameSize20ms24kHz / 2> half_window_;
-  std::array<std::complex<float>, kFrameSize20ms24kHz> input_buf_{};
-  std::array<std::complex<float>, kFrameSize20ms24kHz> output_buf_{};
-  rnnoise::KissFft fft_;
+  Pffft fft_;
+  const std::unique_ptr<Pffft::FloatBuffer> input_buf_;
+  const std::unique_ptr<Pffft::FloatBuffer> output_buf_;
 };
 
 }  // namespace rnn_vad
@@ -15,6 +15,7 @@
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
 #include "modules/audio_processing/agc2/rnn_vad/fft_util.h"
 #include "rtc_base/checks.h"
+#include "third_party/rnnoise/src/kiss_fft.h"
 // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
 // #include "test/fpe_observer.h"
 #include "test/gtest.h"
@@ -39,6 +40,36 @@ std::vector<float> CreateSine(float amplitude,
 
 }  // namespace
 
+// Checks that the PFFFT based implementation matches the KISS FFT that RNNoise
+// uses, including its 1 / N scaling.
+TEST(RnnVadTest, BandAnalysisFftMatchesKissFft) {
+  constexpr size_t kHalfFrameSize = kFrameSize20ms24kHz / 2;
+  std::vector<std::complex<float>> windowed(kFrameSize20ms24kHz);
+  auto x = CreateSine(/*amplitude=*/1000.f, /*frequency_hz=*/700.f,
+                      /*duration_s=*/0.02f,
+                      /*sample_rate_hz=*/kSampleRate24kHz);
+  for (size_t i = 0; i < kHalfFrameSize; ++i) {
+    const float w = std::sin(
+        0.5 * kPi * std::sin(0.5 * kPi * (i + 0.5) / kHalfFrameSize) *
+        std::sin(0.5 * kPi * (i + 0.5) / kHalfFrameSize));
+    windowed[i] = x[i] * w;
+    windowed[kFrameSize20ms24kHz - i - 1] = x[kFrameSize20ms24kHz - i - 1] * w;
+  }
+  rnnoise::KissFft kiss_fft(kFrameSize20ms24kHz);
+  std::vector<std::complex<float>> expected(kFrameSize20ms24kHz);
+  kiss_fft.ForwardFft(kFrameSize20ms24kHz, windowed.data(),
+                      kFrameSize20ms24kHz, expected.data());
+
+  BandAnalysisFft analyzer;
+  std::vector<std::complex<float>> x_fft(kHalfFrameSize + 1);
+  analyzer.ForwardFft(x, x_fft);
+  for (size_t i = 0; i < x_fft.size(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_NEAR(expected[i].real(), x_fft[i].real(), 1e-3f);
+    EXPECT_NEAR(expected[i].imag(), x_fft[i].imag(), 1e-3f);
+  }
+}
+
 TEST(RnnVadTest, BandAnalysisFftTest) {
   for (float frequency_hz : {200.f, 450.f, 1500.f}) {
     SCOPED_TRACE(frequency_hz);
@@ -15,6 +15,7 @@
 #include <cmath>
 #include <numeric>
 
+#include "modules/audio_processing/agc2/rnn_vad/vector_math.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -28,6 +29,7 @@ namespace {
 // for a lag l have both size "size of |x| - l" - i.e., the longest sub-array is
 // used. |x| and |y| must have the same size.
 void ComputeCrossCorrelation(
+    Optimization optimization,
     rtc::ArrayView<const float> x,
     rtc::ArrayView<const float> y,
     rtc::ArrayView<float, kNumLpcCoefficients> x_corr) {
@@ -35,8 +37,8 @@ void ComputeCrossCorrelation(
   RTC_DCHECK_EQ(x.size(), y.size());
   RTC_DCHECK_LT(max_lag, x.size());
   for (size_t lag = 0; lag < max_lag; ++lag) {
-    x_corr[lag] =
-        std::inner_product(x.begin(), x.end() - lag, y.begin() + lag, 0.f);
+    x_corr[lag] = DotProduct(optimization, x.subview(0, x.size() - lag),
+                             y.subview(lag));
   }
 }
 
@@ -88,10 +90,12 @@ void ComputeInitialInverseFilterCoefficients(
 }  // namespace
 
 void ComputeAndPostProcessLpcCoefficients(
+    Optimization optimization,
     rtc::ArrayView<const float> x,
     rtc::ArrayView<float, kNumLpcCoefficients> lpc_coeffs) {
   std::array<float, kNumLpcCoefficients> auto_corr;
-  ComputeCrossCorrelation(x, x, {auto_corr.data(), auto_corr.size()});
+  ComputeCrossCorrelation(optimization, x, x,
+                          {auto_corr.data(), auto_corr.size()});
   if (auto_corr[0] == 0.f) {  // Empty frame.
     std::fill(lpc_coeffs.begin(), lpc_coeffs.end(), 0);
     return;
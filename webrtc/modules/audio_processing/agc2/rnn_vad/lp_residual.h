@@ -14,6 +14,7 @@
 #include <stddef.h>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/rnn_vad/common.h"
 
 namespace webrtc {
 namespace rnn_vad {
@@ -24,6 +25,7 @@ constexpr size_t kNumLpcCoefficients = 5;
 // Given a frame |x|, computes a post-processed version of LPC coefficients
 // tailored for pitch estimation.
 void ComputeAndPostProcessLpcCoefficients(
+    Optimization optimization,
     rtc::ArrayView<const float> x,
     rtc::ArrayView<float, kNumLpcCoefficients> lpc_coeffs);
 
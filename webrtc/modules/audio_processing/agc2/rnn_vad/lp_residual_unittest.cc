@@ -31,7 +31,8 @@ TEST(RnnVadTest, LpResidualOfEmptyFrame) {
   empty_frame.fill(0.f);
   // Compute inverse filter coefficients.
   std::array<float, kNumLpcCoefficients> lpc_coeffs;
-  ComputeAndPostProcessLpcCoefficients(empty_frame, lpc_coeffs);
+  ComputeAndPostProcessLpcCoefficients(Optimization::kNone, empty_frame,
+                                       lpc_coeffs);
   // Compute LP residual.
   std::array<float, kFrameSize10ms24kHz> lp_residual;
   ComputeLpResidual(lpc_coeffs, empty_frame, lp_residual);
@@ -56,6 +57,9 @@ TEST(RnnVadTest, LpResidualPipelineBitExactness) {
   std::array<float, kBufSize24kHz> computed_lp_residual;
   rtc::ArrayView<float, kBufSize24kHz> computed_lp_residual_view(
       computed_lp_residual.data(), computed_lp_residual.size());
+  // The reference implementation is used since the expected output is only
+  // matched up to |kFloatMin|.
+  const Optimization optimization = Optimization::kNone;
   {
     // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
     // FloatingPointExceptionObserver fpe_observer;
@@ -69,7 +73,8 @@ TEST(RnnVadTest, LpResidualPipelineBitExactness) {
       lp_residual_reader.first->ReadValue(&unused);
       lp_residual_reader.first->ReadValue(&unused);
       // Run pipeline.
-      ComputeAndPostProcessLpcCoefficients(pitch_buf_data, lpc_coeffs_view);
+      ComputeAndPostProcessLpcCoefficients(optimization, pitch_buf_data,
+                                           lpc_coeffs_view);
       ComputeLpResidual(lpc_coeffs_view, pitch_buf_data,
                         computed_lp_residual_view);
       // Compare.
@@ -18,8 +18,11 @@
 namespace webrtc {
 namespace rnn_vad {
 
-PitchEstimator::PitchEstimator()
-    : pitch_buf_decimated_(kBufSize12kHz),
+PitchEstimator::PitchEstimator() : PitchEstimator(DetectOptimization()) {}
+
+PitchEstimator::PitchEstimator(Optimization optimization)
+    : optimization_(optimization),
+      pitch_buf_decimated_(kBufSize12kHz),
       pitch_buf_decimated_view_(pitch_buf_decimated_.data(), kBufSize12kHz),
       auto_corr_(kNumInvertedLags12kHz),
       auto_corr_view_(auto_corr_.data(), kNumInvertedLags12kHz) {
@@ -35,20 +38,22 @@ PitchInfo PitchEstimator::Estimate(
   Decimate2x(pitch_buf, pitch_buf_decimated_view_);
   auto_corr_calculator_.ComputeOnPitchBuffer(pitch_buf_decimated_view_,
                                              auto_corr_view_);
-  std::array<size_t, 2> pitch_candidates_inv_lags = FindBestPitchPeriods(
-      auto_corr_view_, pitch_buf_decimated_view_, kMaxPitch12kHz);
+  std::array<size_t, 2> pitch_candidates_inv_lags =
+      FindBestPitchPeriods(optimization_, auto_corr_view_,
+                           pitch_buf_decimated_view_, kMaxPitch12kHz);
   // Refine the pitch period estimation.
   // The refinement is done using the pitch buffer that contains 24 kHz samples.
   // Therefore, adapt the inverted lags in |pitch_candidates_inv_lags| from 12
   // to 24 kHz.
   pitch_candidates_inv_lags[0] *= 2;
   pitch_candidates_inv_lags[1] *= 2;
-  size_t pitch_inv_lag_48kHz =
-      RefinePitchPeriod48kHz(pitch_buf, pitch_candidates_inv_lags);
+  size_t pitch_inv_lag_48kHz = RefinePitchPeriod48kHz(
+      optimization_, pitch_buf, pitch_candidates_inv_lags);
   // Look for stronger harmonics to find the final pitch period and its gain.
   RTC_DCHECK_LT(pitch_inv_lag_48kHz, kMaxPitch48kHz);
   last_pitch_48kHz_ = CheckLowerPitchPeriodsAndComputePitchGain(
-      pitch_buf, kMaxPitch48kHz - pitch_inv_lag_48kHz, last_pitch_48kHz_);
+      optimization_, pitch_buf, kMaxPitch48kHz - pitch_inv_lag_48kHz,
+      last_pitch_48kHz_);
   return last_pitch_48kHz_;
 }
 
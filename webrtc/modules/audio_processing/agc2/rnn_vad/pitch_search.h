@@ -27,6 +27,7 @@ namespace rnn_vad {
 class PitchEstimator {
  public:
   PitchEstimator();
+  explicit PitchEstimator(Optimization optimization);
   PitchEstimator(const PitchEstimator&) = delete;
   PitchEstimator& operator=(const PitchEstimator&) = delete;
   ~PitchEstimator();
@@ -35,6 +36,7 @@ class PitchEstimator {
   PitchInfo Estimate(rtc::ArrayView<const float, kBufSize24kHz> pitch_buf);
 
  private:
+  const Optimization optimization_;
   PitchInfo last_pitch_48kHz_;
   AutoCorrelationCalculator auto_corr_calculator_;
   std::vector<float> pitch_buf_decimated_;
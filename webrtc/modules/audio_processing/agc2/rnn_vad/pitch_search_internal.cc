@@ -14,9 +14,9 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
-#include <numeric>
 
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
+#include "modules/audio_processing/agc2/rnn_vad/vector_math.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -29,15 +29,16 @@ size_t GetInvertedLag(size_t lag) {
   return kMaxPitch24kHz - lag;
 }
 
-float ComputeAutoCorrelationCoeff(rtc::ArrayView<const float> pitch_buf,
+float ComputeAutoCorrelationCoeff(Optimization optimization,
+                                  rtc::ArrayView<const float> pitch_buf,
                                   size_t inv_lag,
                                   size_t max_pitch_period) {
   RTC_DCHECK_LT(inv_lag, pitch_buf.size());
   RTC_DCHECK_LT(max_pitch_period, pitch_buf.size());
   RTC_DCHECK_LE(inv_lag, max_pitch_period);
-  // TODO(bugs.webrtc.org/9076): Maybe optimize using vectorization.
-  return std::inner_product(pitch_buf.begin() + max_pitch_period,
-                            pitch_buf.end(), pitch_buf.begin() + inv_lag, 0.f);
+  const size_t frame_size = pitch_buf.size() - max_pitch_period;
+  return DotProduct(optimization, pitch_buf.subview(max_pitch_period),
+                    pitch_buf.subview(inv_lag, frame_size));
 }
 
 // Computes a pseudo-interpolation offset for an estimated pitch period |lag| by
@@ -68,6 +69,7 @@ int GetPitchPseudoInterpolationOffset(size_t lag,
 // Refines a pitch period |lag| encoded as lag with pseudo-interpolation. The
 // output sample rate is twice as that of |lag|.
 size_t PitchPseudoInterpolationLagPitchBuf(
+    Optimization optimization,
     size_t lag,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf) {
   int offset = 0;
@@ -75,12 +77,12 @@ size_t PitchPseudoInterpolationLagPitchBuf(
   if (lag > 0 && lag < kMaxPitch24kHz) {
     offset = GetPitchPseudoInterpolationOffset(
         lag,
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag - 1),
-                                    kMaxPitch24kHz),
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag),
-                                    kMaxPitch24kHz),
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag + 1),
-                                    kMaxPitch24kHz));
+        ComputeAutoCorrelationCoeff(optimization, pitch_buf,
+                                    GetInvertedLag(lag - 1), kMaxPitch24kHz),
+        ComputeAutoCorrelationCoeff(optimization, pitch_buf,
+                                    GetInvertedLag(lag), kMaxPitch24kHz),
+        ComputeAutoCorrelationCoeff(optimization, pitch_buf,
+                                    GetInvertedLag(lag + 1), kMaxPitch24kHz));
   }
   return 2 * lag + offset;
 }
@@ -195,10 +197,11 @@ float ComputePitchGainThreshold(int candidate_pitch_period,
 }
 
 void ComputeSlidingFrameSquareEnergies(
+    Optimization optimization,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values) {
-  float yy =
-      ComputeAutoCorrelationCoeff(pitch_buf, kMaxPitch24kHz, kMaxPitch24kHz);
+  float yy = ComputeAutoCorrelationCoeff(optimization, pitch_buf,
+                                         kMaxPitch24kHz, kMaxPitch24kHz);
   yy_values[0] = yy;
   for (size_t i = 1; i < yy_values.size(); ++i) {
     RTC_DCHECK_LE(i, kMaxPitch24kHz + kFrameSize20ms24kHz);
@@ -213,6 +216,7 @@ void ComputeSlidingFrameSquareEnergies(
 }
 
 std::array<size_t, 2> FindBestPitchPeriods(
+    Optimization optimization,
     rtc::ArrayView<const float> auto_corr,
     rtc::ArrayView<const float> pitch_buf,
     size_t max_pitch_period) {
@@ -234,10 +238,8 @@ std::array<size_t, 2> FindBestPitchPeriods(
   RTC_DCHECK_GT(max_pitch_period, auto_corr.size());
   RTC_DCHECK_LT(max_pitch_period, pitch_buf.size());
   const size_t frame_size = pitch_buf.size() - max_pitch_period;
-  // TODO(bugs.webrtc.org/9076): Maybe optimize using vectorization.
-  float yy =
-      std::inner_product(pitch_buf.begin(), pitch_buf.begin() + frame_size + 1,
-                         pitch_buf.begin(), 1.f);
+  const auto first_frame = pitch_buf.subview(0, frame_size + 1);
+  float yy = 1.f + DotProduct(optimization, first_frame, first_frame);
   // Search best and second best pitches by looking at the scaled
   // auto-correlation.
   PitchCandidate candidate;
@@ -270,6 +272,7 @@ std::array<size_t, 2> FindBestPitchPeriods(
 }
 
 size_t RefinePitchPeriod48kHz(
+    Optimization optimization,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     rtc::ArrayView<const size_t, 2> inv_lags) {
   // Compute the auto-correlation terms only for neighbors of the given pitch
@@ -282,12 +285,12 @@ size_t RefinePitchPeriod48kHz(
   };
   for (size_t inv_lag = 0; inv_lag < auto_corr.size(); ++inv_lag) {
     if (is_neighbor(inv_lag, inv_lags[0]) || is_neighbor(inv_lag, inv_lags[1]))
-      auto_corr[inv_lag] =
-          ComputeAutoCorrelationCoeff(pitch_buf, inv_lag, kMaxPitch24kHz);
+      auto_corr[inv_lag] = ComputeAutoCorrelationCoeff(
+          optimization, pitch_buf, inv_lag, kMaxPitch24kHz);
   }
   // Find best pitch at 24 kHz.
   const auto pitch_candidates_inv_lags = FindBestPitchPeriods(
-      {auto_corr.data(), auto_corr.size()},
+      optimization, {auto_corr.data(), auto_corr.size()},
       {pitch_buf.data(), pitch_buf.size()}, kMaxPitch24kHz);
   const auto inv_lag = pitch_candidates_inv_lags[0];  // Refine the best.
   // Pseudo-interpolation.
@@ -295,6 +298,7 @@ size_t RefinePitchPeriod48kHz(
 }
 
 PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
+    Optimization optimization,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     int initial_pitch_period_48kHz,
     PitchInfo prev_pitch_48kHz) {
@@ -316,7 +320,7 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
 
   // Initialize.
   std::array<float, kMaxPitch24kHz + 1> yy_values;
-  ComputeSlidingFrameSquareEnergies(pitch_buf,
+  ComputeSlidingFrameSquareEnergies(optimization, pitch_buf,
                                     {yy_values.data(), yy_values.size()});
   const float xx = yy_values[0];
   // Helper lambdas.
@@ -329,7 +333,8 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
   best_pitch.period_24kHz = std::min(initial_pitch_period_48kHz / 2,
                                      static_cast<int>(kMaxPitch24kHz - 1));
   best_pitch.xy = ComputeAutoCorrelationCoeff(
-      pitch_buf, GetInvertedLag(best_pitch.period_24kHz), kMaxPitch24kHz);
+      optimization, pitch_buf, GetInvertedLag(best_pitch.period_24kHz),
+      kMaxPitch24kHz);
   best_pitch.yy = yy_values[best_pitch.period_24kHz];
   best_pitch.gain = pitch_gain(best_pitch.xy, best_pitch.yy, xx);
 
@@ -366,10 +371,11 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     // |candidate_pitch_period| by also looking at its possible sub-harmonic
     // |candidate_pitch_secondary_period|.
     float xy_primary_period = ComputeAutoCorrelationCoeff(
-        pitch_buf, GetInvertedLag(candidate_pitch_period), kMaxPitch24kHz);
-    float xy_secondary_period = ComputeAutoCorrelationCoeff(
-        pitch_buf, GetInvertedLag(candidate_pitch_secondary_period),
+        optimization, pitch_buf, GetInvertedLag(candidate_pitch_period),
         kMaxPitch24kHz);
+    float xy_secondary_period = ComputeAutoCorrelationCoeff(
+        optimization, pitch_buf,
+        GetInvertedLag(candidate_pitch_secondary_period), kMaxPitch24kHz);
     float xy = 0.5f * (xy_primary_period + xy_secondary_period);
     float yy = 0.5f * (yy_values[candidate_pitch_period] +
                        yy_values[candidate_pitch_secondary_period]);
@@ -393,7 +399,8 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
   final_pitch_gain = std::min(best_pitch.gain, final_pitch_gain);
   int final_pitch_period_48kHz = std::max(
       kMinPitch48kHz,
-      PitchPseudoInterpolationLagPitchBuf(best_pitch.period_24kHz, pitch_buf));
+      PitchPseudoInterpolationLagPitchBuf(optimization, best_pitch.period_24kHz,
+                                          pitch_buf));
 
   return {final_pitch_period_48kHz, final_pitch_gain};
 }
@@ -45,6 +45,7 @@ float ComputePitchGainThreshold(int candidate_pitch_period,
 // most recent ones. The size of "a" corresponds to the maximum pitch period,
 // that of "b" to the frame size (e.g., 16 ms and 20 ms respectively).
 void ComputeSlidingFrameSquareEnergies(
+    Optimization optimization,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values);
 
@@ -52,6 +53,7 @@ void ComputeSlidingFrameSquareEnergies(
 // ComputePitchAutoCorrelation() (i.e., using inverted lags), returns the best
 // and the second best pitch periods.
 std::array<size_t, 2> FindBestPitchPeriods(
+    Optimization optimization,
     rtc::ArrayView<const float> auto_corr,
     rtc::ArrayView<const float> pitch_buf,
     size_t max_pitch_period);
@@ -60,12 +62,14 @@ std::array<size_t, 2> FindBestPitchPeriods(
 // the initial pitch period estimation |inv_lags|. Returns an inverted lag at
 // 48 kHz.
 size_t RefinePitchPeriod48kHz(
+    Optimization optimization,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     rtc::ArrayView<const size_t, 2> inv_lags);
 
 // Refines the pitch period estimation and compute the pitch gain. Returns the
 // refined pitch estimation data at 48 kHz.
 PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
+    Optimization optimization,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     int initial_pitch_period_48kHz,
     PitchInfo prev_pitch_48kHz);
@@ -80,47 +80,57 @@ INSTANTIATE_TEST_SUITE_P(
 TEST(RnnVadTest, ComputeSlidingFrameSquareEnergiesBitExactness) {
   PitchTestData test_data;
   std::array<float, kNumPitchBufSquareEnergies> computed_output;
-  {
-    // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
-    // FloatingPointExceptionObserver fpe_observer;
-    ComputeSlidingFrameSquareEnergies(test_data.GetPitchBufView(),
-                                      computed_output);
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    {
+      // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
+      // FloatingPointExceptionObserver fpe_observer;
+      ComputeSlidingFrameSquareEnergies(
+          optimization, test_data.GetPitchBufView(), computed_output);
+    }
+    auto square_energies_view = test_data.GetPitchBufSquareEnergiesView();
+    ExpectNearAbsolute(
+        {square_energies_view.data(), square_energies_view.size()},
+        computed_output, 3e-2f);
   }
-  auto square_energies_view = test_data.GetPitchBufSquareEnergiesView();
-  ExpectNearAbsolute({square_energies_view.data(), square_energies_view.size()},
-                     computed_output, 3e-2f);
 }
 
 TEST(RnnVadTest, FindBestPitchPeriodsBitExactness) {
   PitchTestData test_data;
   std::array<float, kBufSize12kHz> pitch_buf_decimated;
   Decimate2x(test_data.GetPitchBufView(), pitch_buf_decimated);
-  std::array<size_t, 2> pitch_candidates_inv_lags;
-  {
-    // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
-    // FloatingPointExceptionObserver fpe_observer;
-    auto auto_corr_view = test_data.GetPitchBufAutoCorrCoeffsView();
-    pitch_candidates_inv_lags =
-        FindBestPitchPeriods({auto_corr_view.data(), auto_corr_view.size()},
-                             pitch_buf_decimated, kMaxPitch12kHz);
-  }
   const std::array<size_t, 2> expected_output = {140, 142};
-  EXPECT_EQ(expected_output, pitch_candidates_inv_lags);
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    std::array<size_t, 2> pitch_candidates_inv_lags;
+    {
+      // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
+      // FloatingPointExceptionObserver fpe_observer;
+      auto auto_corr_view = test_data.GetPitchBufAutoCorrCoeffsView();
+      pitch_candidates_inv_lags = FindBestPitchPeriods(
+          optimization, {auto_corr_view.data(), auto_corr_view.size()},
+          pitch_buf_decimated, kMaxPitch12kHz);
+    }
+    EXPECT_EQ(expected_output, pitch_candidates_inv_lags);
+  }
 }
 
 TEST(RnnVadTest, RefinePitchPeriod48kHzBitExactness) {
   PitchTestData test_data;
   std::array<float, kBufSize12kHz> pitch_buf_decimated;
   Decimate2x(test_data.GetPitchBufView(), pitch_buf_decimated);
-  size_t pitch_inv_lag;
-  {
-    // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
-    // FloatingPointExceptionObserver fpe_observer;
-    const std::array<size_t, 2> pitch_candidates_inv_lags = {280, 284};
-    pitch_inv_lag = RefinePitchPeriod48kHz(test_data.GetPitchBufView(),
-                                           pitch_candidates_inv_lags);
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    size_t pitch_inv_lag;
+    {
+      // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
+      // FloatingPointExceptionObserver fpe_observer;
+      const std::array<size_t, 2> pitch_candidates_inv_lags = {280, 284};
+      pitch_inv_lag = RefinePitchPeriod48kHz(
+          optimization, test_data.GetPitchBufView(), pitch_candidates_inv_lags);
+    }
+    EXPECT_EQ(560u, pitch_inv_lag);
   }
-  EXPECT_EQ(560u, pitch_inv_lag);
 }
 
 class CheckLowerPitchPeriodsAndComputePitchGainTest
@@ -136,14 +146,17 @@ TEST_P(CheckLowerPitchPeriodsAndComputePitchGainTest, BitExactness) {
   const int expected_pitch_period = std::get<3>(params);
   const float expected_pitch_gain = std::get<4>(params);
   PitchTestData test_data;
-  {
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
     // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
     // FloatingPointExceptionObserver fpe_observer;
     const auto computed_output = CheckLowerPitchPeriodsAndComputePitchGain(
-        test_data.GetPitchBufView(), initial_pitch_period,
+        optimization, test_data.GetPitchBufView(), initial_pitch_period,
         {prev_pitch_period, prev_pitch_gain});
     EXPECT_EQ(expected_pitch_period, computed_output.period);
-    EXPECT_NEAR(expected_pitch_gain, computed_output.gain, 1e-6f);
+    // The optimized dot products add the terms in a different order.
+    EXPECT_NEAR(expected_pitch_gain, computed_output.gain,
+                optimization == Optimization::kNone ? 1e-6f : 1e-5f);
   }
 }
 
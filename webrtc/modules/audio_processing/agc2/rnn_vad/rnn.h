@@ -14,6 +14,7 @@
 #include <stddef.h>
 #include <sys/types.h>
 #include <array>
+#include <vector>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
@@ -40,7 +41,8 @@ class FullyConnectedLayer {
                       const size_t output_size,
                       const rtc::ArrayView<const int8_t> bias,
                       const rtc::ArrayView<const int8_t> weights,
-                      float (*const activation_function)(float));
+                      float (*const activation_function)(float),
+                      Optimization optimization);
   FullyConnectedLayer(const FullyConnectedLayer&) = delete;
   FullyConnectedLayer& operator=(const FullyConnectedLayer&) = delete;
   ~FullyConnectedLayer();
@@ -53,9 +55,12 @@ class FullyConnectedLayer {
  private:
   const size_t input_size_;
   const size_t output_size_;
-  const rtc::ArrayView<const int8_t> bias_;
-  const rtc::ArrayView<const int8_t> weights_;
+  const std::vector<float> bias_;
+  // Weights converted to float and transposed so that the weights of each
+  // output unit are contiguous.
+  const std::vector<float> weights_;
   float (*const activation_function_)(float);
+  const Optimization optimization_;
   // The output vector of a recurrent layer has length equal to |output_size_|.
   // However, for efficiency, over-allocation is used.
   std::array<float, kFullyConnectedLayersMaxUnits> output_;
@@ -69,7 +74,8 @@ class GatedRecurrentLayer {
                       const rtc::ArrayView<const int8_t> bias,
                       const rtc::ArrayView<const int8_t> weights,
                       const rtc::ArrayView<const int8_t> recurrent_weights,
-                      float (*const activation_function)(float));
+                      float (*const activation_function)(float),
+                      Optimization optimization);
   GatedRecurrentLayer(const GatedRecurrentLayer&) = delete;
   GatedRecurrentLayer& operator=(const GatedRecurrentLayer&) = delete;
   ~GatedRecurrentLayer();
@@ -83,10 +89,13 @@ class GatedRecurrentLayer {
  private:
   const size_t input_size_;
   const size_t output_size_;
-  const rtc::ArrayView<const int8_t> bias_;
-  const rtc::ArrayView<const int8_t> weights_;
-  const rtc::ArrayView<const int8_t> recurrent_weights_;
+  const std::vector<float> bias_;
+  // Weights converted to float and transposed so that the weights of each
+  // gate and output unit are contiguous.
+  const std::vector<float> weights_;
+  const std::vector<float> recurrent_weights_;
   float (*const activation_function_)(float);
+  const Optimization optimization_;
   // The state vector of a recurrent layer has length equal to |output_size_|.
   // However, to avoid dynamic allocation, over-allocation is used.
   std::array<float, kRecurrentLayersMaxUnits> state_;
@@ -96,6 +105,7 @@ class GatedRecurrentLayer {
 class RnnBasedVad {
  public:
   RnnBasedVad();
+  explicit RnnBasedVad(Optimization optimization);
   RnnBasedVad(const RnnBasedVad&) = delete;
   RnnBasedVad& operator=(const RnnBasedVad&) = delete;
   ~RnnBasedVad();
@@ -10,8 +10,10 @@
 
 #include <algorithm>
 #include <array>
+#include <memory>
 #include <vector>
 
+#include "absl/memory/memory.h"
 #include "modules/audio_processing/agc2/rnn_vad/rnn.h"
 #include "modules/audio_processing/agc2/rnn_vad/test_utils.h"
 #include "rtc_base/checks.h"
@@ -61,16 +63,8 @@ void TestGatedRecurrentLayer(
   }
 }
 
-}  // namespace
-
-// Bit-exactness check for fully connected layers.
-TEST(RnnVadTest, CheckFullyConnectedLayerOutput) {
-  const std::array<int8_t, 1> bias = {-50};
-  const std::array<int8_t, 24> weights = {
-      127,  127,  127, 127,  127,  20,  127,  -126, -126, -54, 14,  125,
-      -126, -126, 127, -125, -126, 127, -127, -127, -57,  -30, 127, 80};
-  FullyConnectedLayer fc(24, 1, bias, weights, SigmoidApproximated);
-  // Test on different inputs.
+// Feeds |fc| with different inputs and checks the output.
+void TestFullyConnectedLayerOnInputs(FullyConnectedLayer* fc) {
   {
     const std::array<float, 24> input_vector = {
         0.f,           0.f,           0.f,          0.f,          0.f,
@@ -78,7 +72,7 @@ TEST(RnnVadTest, CheckFullyConnectedLayerOutput) {
         0.f,           0.0461241305f, 0.106401242f, 0.223070428f, 0.630603909f,
         0.690453172f,  0.f,           0.387645692f, 0.166913897f, 0.f,
         0.0327451192f, 0.f,           0.136149868f, 0.446351469f};
-    TestFullyConnectedLayer(&fc, input_vector, 0.436567038f);
+    TestFullyConnectedLayer(fc, input_vector, 0.436567038f);
   }
   {
     const std::array<float, 24> input_vector = {
@@ -90,7 +84,7 @@ TEST(RnnVadTest, CheckFullyConnectedLayerOutput) {
         0.9688586f,    0.0320267938f, 0.244722098f,
         0.312745273f,  0.f,           0.00650715502f,
         0.312553257f,  1.62619662f,   0.782880902f};
-    TestFullyConnectedLayer(&fc, input_vector, 0.874741316f);
+    TestFullyConnectedLayer(fc, input_vector, 0.874741316f);
   }
   {
     const std::array<float, 24> input_vector = {
@@ -102,10 +96,27 @@ TEST(RnnVadTest, CheckFullyConnectedLayerOutput) {
         1.20532358f,   0.0254284926f, 0.283327013f,
         0.726210058f,  0.0550272502f, 0.000344108557f,
         0.369803518f,  1.56680179f,   0.997883797f};
-    TestFullyConnectedLayer(&fc, input_vector, 0.672785878f);
+    TestFullyConnectedLayer(fc, input_vector, 0.672785878f);
   }
 }
 
+}  // namespace
+
+// Bit-exactness check for fully connected layers.
+TEST(RnnVadTest, CheckFullyConnectedLayerOutput) {
+  const std::array<int8_t, 1> bias = {-50};
+  const std::array<int8_t, 24> weights = {
+      127,  127,  127, 127,  127,  20,  127,  -126, -126, -54, 14,  125,
+      -126, -126, 127, -125, -126, 127, -127, -127, -57,  -30, 127, 80};
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    FullyConnectedLayer fc(24, 1, bias, weights, SigmoidApproximated,
+                           optimization);
+    TestFullyConnectedLayerOnInputs(&fc);
+  }
+}
+
+// Bit-exactness check for the gated recurrent layer.
 TEST(RnnVadTest, CheckGatedRecurrentLayer) {
   const std::array<int8_t, 12> bias = {96,   -99, -81, -114, 49,  119,
                                        -118, 68,  -76, 91,   121, 125};
@@ -121,20 +132,20 @@ TEST(RnnVadTest, CheckGatedRecurrentLayer) {
       64,  -62, 117, 85,  -51,  -43, 54,  -105, 120, 56,  -128, -107,
       39,  50,  -17, -47, -117, 14,  108, 12,   -7,  -72, 103,  -87,
       -66, 82,  84,  100, -98,  102, -49, 44,   122, 106, -20,  -69};
-  GatedRecurrentLayer gru(5, 4, bias, weights, recurrent_weights,
-                          RectifiedLinearUnit);
-  // Test on different inputs.
-  {
-    const std::array<float, 20> input_sequence = {
-        0.89395463f, 0.93224651f, 0.55788344f, 0.32341808f, 0.93355054f,
-        0.13475326f, 0.97370994f, 0.14253306f, 0.93710381f, 0.76093364f,
-        0.65780413f, 0.41657975f, 0.49403164f, 0.46843281f, 0.75138855f,
-        0.24517593f, 0.47657707f, 0.57064998f, 0.435184f,   0.19319285f};
-    const std::array<float, 16> expected_output_sequence = {
-        0.0239123f,  0.5773077f,  0.f,         0.f,
-        0.01282811f, 0.64330572f, 0.f,         0.04863098f,
-        0.00781069f, 0.75267816f, 0.f,         0.02579715f,
-        0.00471378f, 0.59162533f, 0.11087593f, 0.01334511f};
+  const std::array<float, 20> input_sequence = {
+      0.89395463f, 0.93224651f, 0.55788344f, 0.32341808f, 0.93355054f,
+      0.13475326f, 0.97370994f, 0.14253306f, 0.93710381f, 0.76093364f,
+      0.65780413f, 0.41657975f, 0.49403164f, 0.46843281f, 0.75138855f,
+      0.24517593f, 0.47657707f, 0.57064998f, 0.435184f,   0.19319285f};
+  const std::array<float, 16> expected_output_sequence = {
+      0.0239123f,  0.5773077f,  0.f,         0.f,
+      0.01282811f, 0.64330572f, 0.f,         0.04863098f,
+      0.00781069f, 0.75267816f, 0.f,         0.02579715f,
+      0.00471378f, 0.59162533f, 0.11087593f, 0.01334511f};
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    GatedRecurrentLayer gru(5, 4, bias, weights, recurrent_weights,
+                            RectifiedLinearUnit, optimization);
     TestGatedRecurrentLayer(&gru, input_sequence, expected_output_sequence);
   }
 }
@@ -154,7 +165,10 @@ TEST(RnnVadTest, RnnBitExactness) {
   std::array<float, kFeatureVectorSize> features;
 
   // Compute VAD probability using the precomputed features.
-  RnnBasedVad vad;
+  std::vector<std::unique_ptr<RnnBasedVad>> vads;
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    vads.push_back(absl::make_unique<RnnBasedVad>(optimization));
+  }
   for (size_t i = 0; i < num_frames; ++i) {
     SCOPED_TRACE(i);
     // Read frame data.
@@ -162,14 +176,16 @@ TEST(RnnVadTest, RnnBitExactness) {
     // The features file also includes a silence flag for each frame.
     RTC_CHECK(features_reader.first->ReadValue(&is_silence));
     RTC_CHECK(features_reader.first->ReadChunk(features));
-    // Compute and check VAD probability.
-    float vad_probability = vad.ComputeVadProbability(features, is_silence);
     ASSERT_TRUE(is_silence == 0.f || is_silence == 1.f);
-    if (is_silence == 1.f) {
-      ASSERT_EQ(0.f, expected_vad_probability);
-      EXPECT_EQ(0.f, vad_probability);
-    } else {
-      EXPECT_NEAR(expected_vad_probability, vad_probability, 3e-6f);
+    // Compute and check VAD probability.
+    for (const auto& vad : vads) {
+      float vad_probability = vad->ComputeVadProbability(features, is_silence);
+      if (is_silence == 1.f) {
+        ASSERT_EQ(0.f, expected_vad_probability);
+        EXPECT_EQ(0.f, vad_probability);
+      } else {
+        EXPECT_NEAR(expected_vad_probability, vad_probability, 3e-6f);
+      }
     }
   }
 }
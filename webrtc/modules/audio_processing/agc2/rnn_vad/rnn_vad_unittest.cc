@@ -65,30 +65,35 @@ TEST(RnnVadTest, DISABLED_RnnVadPerformance) {
                        &prefetched_decimated_samples[i * kFrameSize10ms24kHz],
                        kFrameSize10ms24kHz);
   }
-  // Initialize.
-  FeaturesExtractor features_extractor;
-  std::array<float, kFeatureVectorSize> feature_vector;
-  RnnBasedVad rnn_vad;
-  constexpr size_t number_of_tests = 100;
-  ::webrtc::test::PerformanceTimer perf_timer(number_of_tests);
-  for (size_t k = 0; k < number_of_tests; ++k) {
-    features_extractor.Reset();
-    rnn_vad.Reset();
-    // Process frames.
-    perf_timer.StartTimer();
-    for (size_t i = 0; i < num_frames; ++i) {
-      bool is_silence = features_extractor.CheckSilenceComputeFeatures(
-          {&prefetched_decimated_samples[i * kFrameSize10ms24kHz],
-           kFrameSize10ms24kHz},
-          feature_vector);
-      rnn_vad.ComputeVadProbability(feature_vector, is_silence);
+  // Measure each available optimization separately.
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    RTC_LOG(LS_INFO) << "optimization: " << static_cast<int>(optimization);
+    // Initialize.
+    FeaturesExtractor features_extractor(optimization);
+    std::array<float, kFeatureVectorSize> feature_vector;
+    RnnBasedVad rnn_vad(optimization);
+    constexpr size_t number_of_tests = 100;
+    ::webrtc::test::PerformanceTimer perf_timer(number_of_tests);
+    for (size_t k = 0; k < number_of_tests; ++k) {
+      features_extractor.Reset();
+      rnn_vad.Reset();
+      // Process frames.
+      perf_timer.StartTimer();
+      for (size_t i = 0; i < num_frames; ++i) {
+        bool is_silence = features_extractor.CheckSilenceComputeFeatures(
+            {&prefetched_decimated_samples[i * kFrameSize10ms24kHz],
+             kFrameSize10ms24kHz},
+            feature_vector);
+        rnn_vad.ComputeVadProbability(feature_vector, is_silence);
+      }
+      perf_timer.StopTimer();
     }
-    perf_timer.StopTimer();
-    samples_reader.first->SeekBeginning();
+    DumpPerfStats(num_frames * kFrameSize10ms24kHz, kSampleRate24kHz,
+                  perf_timer.GetDurationAverage(),
+                  perf_timer.GetDurationStandardDeviation());
+    RTC_LOG(LS_INFO) << "average time per frame (us): "
+                     << perf_timer.GetDurationAverage() / num_frames;
   }
-  DumpPerfStats(num_frames * kFrameSize10ms24kHz, kSampleRate24kHz,
-                perf_timer.GetDurationAverage(),
-                perf_timer.GetDurationStandardDeviation());
 }
 
 }  // namespace test
@@ -27,6 +27,19 @@ using ReaderPairType =
 
 using webrtc::test::ResourcePath;
 
+std::vector<Optimization> GetOptimizationsToTest() {
+  std::vector<Optimization> optimizations = {Optimization::kNone};
+  const Optimization detected_optimization = DetectOptimization();
+  // AVX2 is only picked on CPUs that also have SSE2.
+  if (detected_optimization == Optimization::kAvx2) {
+    optimizations.push_back(Optimization::kSse2);
+  }
+  if (detected_optimization != Optimization::kNone) {
+    optimizations.push_back(detected_optimization);
+  }
+  return optimizations;
+}
+
 void ExpectEqualFloatArray(rtc::ArrayView<const float> expected,
                            rtc::ArrayView<const float> computed) {
   ASSERT_EQ(expected.size(), computed.size());
@@ -41,6 +41,10 @@ void ExpectNearAbsolute(rtc::ArrayView<const float> expected,
                         rtc::ArrayView<const float> computed,
                         float tolerance);
 
+// Returns the optimizations to test, i.e., the reference implementation and, if
+// different, the one detected on the current CPU.
+std::vector<Optimization> GetOptimizationsToTest();
+
 // Reader for binary files consisting of an arbitrary long sequence of elements
 // having type T. It is possible to read and cast to another type D at once.
 template <typename T, typename D = T>
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/rnn_vad/vector_math.h"
+
+#include "rtc_base/system/arch.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include <numeric>
+
+#include "rtc_base/checks.h"
+
+#if defined(WEBRTC_RNN_VAD_AVX2)
+#include "modules/audio_processing/agc2/rnn_vad/vector_math_avx2.h"
+#endif
+
+namespace webrtc {
+namespace rnn_vad {
+namespace {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+float DotProductSse2(rtc::ArrayView<const float> x,
+                     rtc::ArrayView<const float> y) {
+  const size_t vector_limit = x.size() & ~static_cast<size_t>(3);
+  __m128 accumulator = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i < vector_limit; i += 4) {
+    const __m128 x_j = _mm_loadu_ps(&x[i]);
+    const __m128 y_j = _mm_loadu_ps(&y[i]);
+    accumulator = _mm_add_ps(accumulator, _mm_mul_ps(x_j, y_j));
+  }
+  // Reduce the four partial sums.
+  __m128 high = _mm_movehl_ps(accumulator, accumulator);
+  accumulator = _mm_add_ps(accumulator, high);
+  high = _mm_shuffle_ps(accumulator, accumulator, 1);
+  accumulator = _mm_add_ss(accumulator, high);
+  float dot_product = _mm_cvtss_f32(accumulator);
+  // Add the remaining products.
+  for (; i < x.size(); ++i) {
+    dot_product += x[i] * y[i];
+  }
+  return dot_product;
+}
+#endif
+
+}  // namespace
+
+float DotProduct(Optimization optimization,
+                 rtc::ArrayView<const float> x,
+                 rtc::ArrayView<const float> y) {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case Optimization::kSse2:
+      return DotProductSse2(x, y);
+#endif
+#if defined(WEBRTC_RNN_VAD_AVX2)
+    case Optimization::kAvx2:
+      return DotProductAvx2(x, y);
+#endif
+    default:
+      return std::inner_product(x.begin(), x.end(), y.begin(), 0.f);
+  }
+}
+
+}  // namespace rnn_vad
+}  // namespace webrtc
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/rnn_vad/vector_math_avx2.h"
+
+#include <immintrin.h>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace rnn_vad {
+
+float DotProductAvx2(rtc::ArrayView<const float> x,
+                     rtc::ArrayView<const float> y) {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  const size_t vector_limit = x.size() & ~static_cast<size_t>(7);
+  __m256 accumulator = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i < vector_limit; i += 8) {
+    const __m256 x_j = _mm256_loadu_ps(&x[i]);
+    const __m256 y_j = _mm256_loadu_ps(&y[i]);
+    accumulator = _mm256_add_ps(accumulator, _mm256_mul_ps(x_j, y_j));
+  }
+  // Reduce the eight partial sums.
+  __m128 sum = _mm_add_ps(_mm256_extractf128_ps(accumulator, 0),
+                          _mm256_extractf128_ps(accumulator, 1));
+  __m128 high = _mm_movehl_ps(sum, sum);
+  sum = _mm_add_ps(sum, high);
+  high = _mm_shuffle_ps(sum, sum, 1);
+  sum = _mm_add_ss(sum, high);
+  float dot_product = _mm_cvtss_f32(sum);
+  // Add the remaining products.
+  for (; i < x.size(); ++i) {
+    dot_product += x[i] * y[i];
+  }
+  return dot_product;
+}
+
+}  // namespace rnn_vad
+}  // namespace webrtc
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/rnn_vad/vector_math.h"
+
+#include <cmath>
+#include <vector>
+
+#include "modules/audio_processing/agc2/rnn_vad/test_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace rnn_vad {
+namespace test {
+
+TEST(RnnVadTest, DotProductOfEmptyVectorsIsZero) {
+  for (Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    EXPECT_EQ(0.f, DotProduct(optimization, {}, {}));
+  }
+}
+
+// Checks that the optimized implementations match the reference one for sizes
+// that are and that are not a multiple of the SIMD width.
+TEST(RnnVadTest, DotProductOptimizationsMatchReference) {
+  for (size_t size : {1, 3, 4, 7, 16, 24, 29, 96, 385}) {
+    SCOPED_TRACE(size);
+    std::vector<float> x(size);
+    std::vector<float> y(size);
+    // Scale of the rounding errors, which depend on the summation order.
+    float abs_sum = 0.f;
+    for (size_t i = 0; i < size; ++i) {
+      x[i] = std::sin(0.1f * i);
+      y[i] = 0.5f - std::cos(0.37f * i);
+      abs_sum += std::fabs(x[i] * y[i]);
+    }
+    const float expected = DotProduct(Optimization::kNone, x, y);
+    for (Optimization optimization : GetOptimizationsToTest()) {
+      SCOPED_TRACE(static_cast<int>(optimization));
+      EXPECT_NEAR(expected, DotProduct(optimization, x, y), 1e-6f * abs_sum);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace rnn_vad
+}  // namespace webrtc
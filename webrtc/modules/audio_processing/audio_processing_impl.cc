@@ -697,6 +697,10 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
        config_.echo_canceller.legacy_moderate_suppression_level !=
            config.echo_canceller.legacy_moderate_suppression_level);
 
+  const bool pipeline_config_changed =
+      config_.pipeline.experimental_multi_channel !=
+      config.pipeline.experimental_multi_channel;
+
   const bool agc1_config_changed =
       config_.gain_controller1.enabled != config.gain_controller1.enabled ||
       config_.gain_controller1.mode != config.gain_controller1.mode ||
@@ -713,7 +717,14 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
 
   config_ = config;
 
-  if (aec_config_changed) {
+  if (pipeline_config_changed) {
+    // Injected echo controllers are only given mono capture audio.
+    capture_nonlocked_.multi_channel_capture =
+        config_.pipeline.experimental_multi_channel && !echo_control_factory_;
+    // The number of processed channels changes, which requires all submodules
+    // to be reinitialized; this also reinitializes the echo controller.
+    InitializeLocked(formats_.api_format);
+  } else if (aec_config_changed) {
     InitializeEchoController();
   }
 
@@ -834,7 +845,10 @@ size_t AudioProcessingImpl::num_input_channels() const {
 
 size_t AudioProcessingImpl::num_proc_channels() const {
   // Used as callback from submodules, hence locking is not allowed.
-  return capture_nonlocked_.echo_controller_enabled ? 1 : num_output_channels();
+  return capture_nonlocked_.echo_controller_enabled &&
+                 !capture_nonlocked_.multi_channel_capture
+             ? 1
+             : num_output_channels();
 }
 
 size_t AudioProcessingImpl::num_output_channels() const {
@@ -1349,7 +1363,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
     capture_buffer->SplitIntoFrequencyBands();
   }
 
-  if (private_submodules_->echo_controller) {
+  if (private_submodules_->echo_controller &&
+      !capture_nonlocked_.multi_channel_capture) {
     // Force down-mixing of the number of channels after the detection of
     // capture signal saturation.
     // TODO(peah): Look into ensuring that this kind of tampering with the
@@ -1868,7 +1883,9 @@ void AudioProcessingImpl::InitializeEchoController() {
           echo_control_factory_->Create(proc_sample_rate_hz());
     } else {
       private_submodules_->echo_controller = absl::make_unique<EchoCanceller3>(
-          EchoCanceller3Config(), proc_sample_rate_hz(), true);
+          EchoCanceller3Config(), proc_sample_rate_hz(),
+          capture_nonlocked_.multi_channel_capture ? num_output_channels() : 1,
+          true);
     }
 
     capture_nonlocked_.echo_controller_enabled = true;
@@ -417,6 +417,9 @@ class AudioProcessingImpl : public AudioProcessing {
     int split_rate;
     int stream_delay_ms;
     bool echo_controller_enabled = false;
+    // Whether all capture channels are processed, see
+    // AudioProcessing::Config::Pipeline::experimental_multi_channel.
+    bool multi_channel_capture = false;
   } capture_nonlocked_;
 
   struct ApmRenderState {
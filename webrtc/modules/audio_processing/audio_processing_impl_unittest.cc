@@ -10,6 +10,7 @@
 
 #include "modules/audio_processing/audio_processing_impl.h"
 
+#include <cmath>
 #include <memory>
 
 #include "absl/memory/memory.h"
@@ -180,6 +181,60 @@ TEST(AudioProcessingImplTest, AudioParameterChangeTriggersInit) {
   EXPECT_NOERR(mock.ProcessReverseStream(&frame));
 }
 
+TEST(AudioProcessingImplTest, MultiChannelPipelineKeepsCaptureChannelsApart) {
+  std::unique_ptr<AudioProcessing> apm(AudioProcessingBuilder().Create());
+  webrtc::AudioProcessing::Config apm_config;
+  apm_config.echo_canceller.enabled = true;
+  apm_config.pipeline.experimental_multi_channel = true;
+  apm->ApplyConfig(apm_config);
+
+  AudioFrame frame;
+  constexpr size_t kSampleRateHz = 48000;
+  constexpr size_t kNumChannels = 2;
+  constexpr float kPi = 3.14159265f;
+  InitializeAudioFrame(kSampleRateHz, kNumChannels, &frame);
+
+  // A 1 kHz tone in the first channel and silence in the second. Without
+  // multi-channel processing the first channel would be copied to both
+  // output channels.
+  bool first_channel_active = false;
+  for (int frame_index = 0; frame_index < 10; ++frame_index) {
+    for (size_t i = 0; i < frame.samples_per_channel_; ++i) {
+      const size_t n = frame_index * frame.samples_per_channel_ + i;
+      frame.mutable_data()[kNumChannels * i] = static_cast<int16_t>(
+          10000.f * std::sin(2.f * kPi * 1000.f * n / kSampleRateHz));
+      frame.mutable_data()[kNumChannels * i + 1] = 0;
+    }
+    EXPECT_NOERR(apm->ProcessStream(&frame));
+    ASSERT_EQ(kNumChannels, frame.num_channels_);
+    for (size_t i = 0; i < frame.samples_per_channel_; ++i) {
+      first_channel_active |= frame.data()[kNumChannels * i] != 0;
+      EXPECT_EQ(0, frame.data()[kNumChannels * i + 1]);
+    }
+  }
+  EXPECT_TRUE(first_channel_active);
+}
+
+TEST(AudioProcessingImplTest, MultiChannelPipelineDownmixesRender) {
+  AudioFrame frame;
+  constexpr size_t kNumChannels = 2;
+  InitializeAudioFrame(48000, kNumChannels, &frame);
+
+  // Echo control models a single render signal, so the render stream is
+  // downmixed also when the capture channels are kept apart.
+  for (bool use_legacy_aec : {false, true}) {
+    std::unique_ptr<AudioProcessing> apm(AudioProcessingBuilder().Create());
+    webrtc::AudioProcessing::Config apm_config;
+    apm_config.echo_canceller.enabled = true;
+    apm_config.echo_canceller.use_legacy_aec = use_legacy_aec;
+    apm_config.pipeline.experimental_multi_channel = true;
+    apm->ApplyConfig(apm_config);
+
+    EXPECT_NOERR(apm->ProcessReverseStream(&frame));
+    EXPECT_EQ(1u, apm->num_reverse_channels());
+  }
+}
+
 TEST(AudioProcessingImplTest, UpdateCapturePreGainRuntimeSetting) {
   std::unique_ptr<AudioProcessing> apm(AudioProcessingBuilder().Create());
   webrtc::AudioProcessing::Config apm_config;
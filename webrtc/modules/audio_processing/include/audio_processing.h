@@ -245,6 +245,16 @@ class AudioProcessing : public rtc::RefCountInterface {
   // submodule resets, affecting the audio quality. Use the RuntimeSetting
   // construct for runtime configuration.
   struct Config {
+    // Sets the properties of the audio processing pipeline.
+    struct Pipeline {
+      // Keeps every capture channel instead of downmixing the capture signal
+      // to mono when AEC3 is active. This is mono echo control applied to N
+      // channels: AEC3 cancels echo on channel 0 against the downmixed render
+      // signal and applies the resulting suppression gain to the other
+      // channels. Injected echo controllers still get mono capture audio.
+      bool experimental_multi_channel = false;
+    } pipeline;
+
     // Enabled the pre-amplifier. It amplifies the capture signal
     // before any other processing is done.
     struct PreAmplifier {
@@ -24,10 +24,8 @@
 #define FACTOR (float)40.0
 #define WIDTH (float)0.01
 
-// Length of fft work arrays.
-#define IP_LENGTH \
-  (ANAL_BLOCKL_MAX >> 1)  // must be at least ceil(2 + sqrt(ANAL_BLOCKL_MAX/2))
-#define W_LENGTH (ANAL_BLOCKL_MAX >> 1)
+// Number of floats in the SIMD aligned FFT buffer: input, output and work.
+#define FFT_BUFFER_LENGTH (3 * ANAL_BLOCKL_MAX)
 
 // PARAMETERS FOR NEW METHOD
 #define DD_PR_SNR (float)0.98  // DD update of prior SNR
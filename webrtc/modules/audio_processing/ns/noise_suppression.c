@@ -16,14 +16,21 @@
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "modules/audio_processing/ns/defines.h"
 #include "modules/audio_processing/ns/ns_core.h"
+#include "third_party/pffft/src/pffft.h"
 
 NsHandle* WebRtcNs_Create() {
   NoiseSuppressionC* self = malloc(sizeof(NoiseSuppressionC));
   self->initFlag = 0;
+  self->fftSetup = NULL;
+  self->fftBuffer = pffft_aligned_malloc(FFT_BUFFER_LENGTH * sizeof(float));
   return (NsHandle*)self;
 }
 
 void WebRtcNs_Free(NsHandle* NS_inst) {
+  NoiseSuppressionC* self = (NoiseSuppressionC*)NS_inst;
+  if (self != NULL) {
+    pffft_aligned_free(self->fftBuffer);
+  }
   free(NS_inst);
 }
 
@@ -14,10 +14,11 @@
 
 #include "rtc_base/checks.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
-#include "common_audio/third_party/fft4g/fft4g.h"
 #include "modules/audio_processing/ns/noise_suppression.h"
 #include "modules/audio_processing/ns/ns_core.h"
 #include "modules/audio_processing/ns/windows_private.h"
+#include "modules/audio_processing/utility/pffft_setup_cache.h"
+#include "third_party/pffft/src/pffft.h"
 
 // Set Feature Extraction Parameters.
 static void set_feature_extraction_parameters(NoiseSuppressionC* self) {
@@ -97,10 +98,11 @@ int WebRtcNs_InitCore(NoiseSuppressionC* self, uint32_t fs) {
   }
   self->magnLen = self->anaLen / 2 + 1;  // Number of frequency bins.
 
-  // Initialize FFT work arrays.
-  self->ip[0] = 0;  // Setting this triggers initialization.
-  memset(self->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
-  WebRtc_rdft(self->anaLen, 1, self->dataBuf, self->ip, self->wfft);
+  // Get the shared FFT setup.
+  self->fftSetup = WebRtcPffft_GetSetup(self->anaLen, /*complex_fft=*/0);
+  if (self->fftSetup == NULL || self->fftBuffer == NULL) {
+    return -1;
+  }
 
   memset(self->analyzeBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
   memset(self->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
@@ -882,32 +884,38 @@ static void UpdateBuffer(const float* frame,
 //   * |magnitude_length| is the length of the spectrum magnitude, which equals
 //     the length of both |real| and |imag| (time_data_length / 2 + 1).
 // Outputs:
-//   * |time_data| is the signal in the frequency domain.
 //   * |real| is the real part of the frequency domain.
 //   * |imag| is the imaginary part of the frequency domain.
 //   * |magn| is the calculated signal magnitude in the frequency domain.
 static void FFT(NoiseSuppressionC* self,
-                float* time_data,
+                const float* time_data,
                 size_t time_data_length,
                 size_t magnitude_length,
                 float* real,
                 float* imag,
                 float* magn) {
   size_t i;
+  float* fft_in = self->fftBuffer;
+  float* fft_out = fft_in + ANAL_BLOCKL_MAX;
+  float* fft_work = fft_out + ANAL_BLOCKL_MAX;
 
   RTC_DCHECK_EQ(magnitude_length, time_data_length / 2 + 1);
 
-  WebRtc_rdft(time_data_length, 1, time_data, self->ip, self->wfft);
+  memcpy(fft_in, time_data, sizeof(float) * time_data_length);
+  pffft_transform_ordered(self->fftSetup, fft_in, fft_out, fft_work,
+                          PFFFT_FORWARD);
 
+  // The imaginary parts are negated to keep the sign convention of the Ooura
+  // real FFT used before.
   imag[0] = 0;
-  real[0] = time_data[0];
+  real[0] = fft_out[0];
   magn[0] = fabsf(real[0]) + 1.f;
   imag[magnitude_length - 1] = 0;
-  real[magnitude_length - 1] = time_data[1];
+  real[magnitude_length - 1] = fft_out[1];
   magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
   for (i = 1; i < magnitude_length - 1; ++i) {
-    real[i] = time_data[2 * i];
-    imag[i] = time_data[2 * i + 1];
+    real[i] = fft_out[2 * i];
+    imag[i] = -fft_out[2 * i + 1];
     // Magnitude spectrum.
     magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
   }
@@ -930,19 +938,23 @@ static void IFFT(NoiseSuppressionC* self,
                  size_t time_data_length,
                  float* time_data) {
   size_t i;
+  float* fft_in = self->fftBuffer;
+  float* fft_out = fft_in + ANAL_BLOCKL_MAX;
+  float* fft_work = fft_out + ANAL_BLOCKL_MAX;
 
   RTC_DCHECK_EQ(time_data_length, 2 * (magnitude_length - 1));
 
-  time_data[0] = real[0];
-  time_data[1] = real[magnitude_length - 1];
+  fft_in[0] = real[0];
+  fft_in[1] = real[magnitude_length - 1];
   for (i = 1; i < magnitude_length - 1; ++i) {
-    time_data[2 * i] = real[i];
-    time_data[2 * i + 1] = imag[i];
+    fft_in[2 * i] = real[i];
+    fft_in[2 * i + 1] = -imag[i];
   }
-  WebRtc_rdft(time_data_length, -1, time_data, self->ip, self->wfft);
+  pffft_transform_ordered(self->fftSetup, fft_in, fft_out, fft_work,
+                          PFFFT_BACKWARD);
 
   for (i = 0; i < time_data_length; ++i) {
-    time_data[i] *= 2.f / time_data_length;  // FFT scaling.
+    time_data[i] = fft_out[i] * (1.f / time_data_length);  // FFT scaling.
   }
 }
 
@@ -73,9 +73,11 @@ typedef struct NoiseSuppressionC_ {
   float overdrive;
   float denoiseBound;
   int gainmap;
-  // FFT work arrays.
-  size_t ip[IP_LENGTH];
-  float wfft[W_LENGTH];
+  // FFT state. The PFFFT setup is shared with the rest of APM (see
+  // utility/pffft_setup_cache.h). |fftBuffer| is SIMD aligned and holds
+  // FFT_BUFFER_LENGTH floats; it is allocated in WebRtcNs_Create().
+  struct PFFFT_Setup* fftSetup;
+  float* fftBuffer;
 
   // Parameters for new method: some not needed, will reduce/cleanup later.
   int32_t blockInd;        // Frame index counter.
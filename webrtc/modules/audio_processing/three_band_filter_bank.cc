@@ -182,31 +182,45 @@ void ThreeBandFilterBank::Synthesis(const float* const* in,
 // Modulates |in| by |dct_modulation_| and accumulates it in each of the
 // |kNumBands| bands of |out|. |offset| is the index in the period of the
 // cosines used for modulation. |split_length| is the length of |in| and each
-// band of |out|.
+// band of |out|. All bands are updated in a single pass over |in|.
 void ThreeBandFilterBank::DownModulate(const float* in,
                                        size_t split_length,
                                        size_t offset,
                                        float* const* out) {
-  for (size_t i = 0; i < kNumBands; ++i) {
-    for (size_t j = 0; j < split_length; ++j) {
-      out[i][j] += dct_modulation_[offset][i] * in[j];
-    }
+  static_assert(kNumBands == 3, "The modulation loop is unrolled for 3 bands");
+  const std::vector<float>& modulation = dct_modulation_[offset];
+  const float m0 = modulation[0];
+  const float m1 = modulation[1];
+  const float m2 = modulation[2];
+  float* out0 = out[0];
+  float* out1 = out[1];
+  float* out2 = out[2];
+  for (size_t j = 0; j < split_length; ++j) {
+    const float x = in[j];
+    out0[j] += m0 * x;
+    out1[j] += m1 * x;
+    out2[j] += m2 * x;
   }
 }
 
 // Modulates each of the |kNumBands| bands of |in| by |dct_modulation_| and
-// accumulates them in |out|. |out| is cleared before starting to accumulate.
-// |offset| is the index in the period of the cosines used for modulation.
-// |split_length| is the length of each band of |in| and |out|.
+// sums them into |out|, overwriting its previous content. |offset| is the
+// index in the period of the cosines used for modulation. |split_length| is
+// the length of each band of |in| and |out|.
 void ThreeBandFilterBank::UpModulate(const float* const* in,
                                      size_t split_length,
                                      size_t offset,
                                      float* out) {
-  memset(out, 0, split_length * sizeof(*out));
-  for (size_t i = 0; i < kNumBands; ++i) {
-    for (size_t j = 0; j < split_length; ++j) {
-      out[j] += dct_modulation_[offset][i] * in[i][j];
-    }
+  static_assert(kNumBands == 3, "The modulation loop is unrolled for 3 bands");
+  const std::vector<float>& modulation = dct_modulation_[offset];
+  const float m0 = modulation[0];
+  const float m1 = modulation[1];
+  const float m2 = modulation[2];
+  const float* in0 = in[0];
+  const float* in1 = in[1];
+  const float* in2 = in[2];
+  for (size_t j = 0; j < split_length; ++j) {
+    out[j] = m0 * in0[j] + m1 * in1[j] + m2 * in2[j];
   }
 }
 
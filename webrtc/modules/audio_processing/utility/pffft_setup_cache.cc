@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/utility/pffft_setup_cache.h"
+
+#include <map>
+#include <utility>
+
+#include "rtc_base/critical_section.h"
+#include "third_party/pffft/src/pffft.h"
+
+namespace {
+
+using SetupKey = std::pair<size_t, bool>;
+
+rtc::CriticalSection* GetCacheLock() {
+  static rtc::CriticalSection* const lock = new rtc::CriticalSection();
+  return lock;
+}
+
+std::map<SetupKey, PFFFT_Setup*>* GetCache() {
+  static std::map<SetupKey, PFFFT_Setup*>* const cache =
+      new std::map<SetupKey, PFFFT_Setup*>();
+  return cache;
+}
+
+}  // namespace
+
+PFFFT_Setup* WebRtcPffft_GetSetup(size_t fft_size, int complex_fft) {
+  const SetupKey key(fft_size, complex_fft != 0);
+  rtc::CritScope lock(GetCacheLock());
+  std::map<SetupKey, PFFFT_Setup*>* cache = GetCache();
+  auto it = cache->find(key);
+  if (it != cache->end()) {
+    return it->second;
+  }
+  PFFFT_Setup* setup = pffft_new_setup(static_cast<int>(fft_size),
+                                       complex_fft ? PFFFT_COMPLEX : PFFFT_REAL);
+  // Do not cache unsupported sizes so that every caller sees the failure.
+  if (setup) {
+    cache->emplace(key, setup);
+  }
+  return setup;
+}
@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_UTILITY_PFFFT_SETUP_CACHE_H_
+#define MODULES_AUDIO_PROCESSING_UTILITY_PFFFT_SETUP_CACHE_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declaration.
+struct PFFFT_Setup;
+
+// Returns the PFFFT setup (plan and twiddle factors) for a real or complex
+// transform of |fft_size| points, or NULL if PFFFT does not support the size.
+// A setup is read-only once created, so a single instance per size is shared
+// by every FFT user in the process; only the scratch buffer passed to the
+// transform functions is per-user state. Setups are created on first use and
+// are never freed. Thread-safe. Plain C so that ns_core.c can use it.
+struct PFFFT_Setup* WebRtcPffft_GetSetup(size_t fft_size, int complex_fft);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // MODULES_AUDIO_PROCESSING_UTILITY_PFFFT_SETUP_CACHE_H_
@@ -10,6 +10,7 @@
 
 #include "modules/audio_processing/utility/pffft_wrapper.h"
 
+#include "modules/audio_processing/utility/pffft_setup_cache.h"
 #include "rtc_base/checks.h"
 #include "third_party/pffft/src/pffft.h"
 
@@ -45,9 +46,9 @@ rtc::ArrayView<float> Pffft::FloatBuffer::GetView() {
 Pffft::Pffft(size_t fft_size, FftType fft_type)
     : fft_size_(fft_size),
       fft_type_(fft_type),
-      pffft_status_(pffft_new_setup(
-          fft_size_,
-          fft_type == Pffft::FftType::kReal ? PFFFT_REAL : PFFFT_COMPLEX)),
+      pffft_status_(
+          WebRtcPffft_GetSetup(fft_size_,
+                               fft_type == Pffft::FftType::kComplex ? 1 : 0)),
       scratch_buffer_(
           AllocatePffftBuffer(GetBufferSize(fft_size_, fft_type_))) {
   RTC_DCHECK(pffft_status_);
@@ -55,7 +56,7 @@ Pffft::Pffft(size_t fft_size, FftType fft_type)
 }
 
 Pffft::~Pffft() {
-  pffft_destroy_setup(pffft_status_);
+  // |pffft_status_| is owned by the setup cache.
   pffft_aligned_free(scratch_buffer_);
 }
 
@@ -21,6 +21,8 @@ struct PFFFT_Setup;
 namespace webrtc {
 
 // Pretty-Fast Fast Fourier Transform (PFFFT) wrapper class.
+// The PFFFT setup is shared with every other instance using the same FFT size
+// and type (see pffft_setup_cache.h); each instance owns its scratch buffer.
 // Not thread safe.
 class Pffft {
  public:
@@ -85,7 +87,7 @@ class Pffft {
  private:
   const size_t fft_size_;
   const FftType fft_type_;
-  PFFFT_Setup* pffft_status_;
+  PFFFT_Setup* const pffft_status_;
   float* const scratch_buffer_;
 };
 
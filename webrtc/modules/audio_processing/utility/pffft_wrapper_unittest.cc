@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <memory>
 
+#include "modules/audio_processing/utility/pffft_setup_cache.h"
 #include "test/gtest.h"
 #include "third_party/pffft/src/pffft.h"
 
@@ -177,5 +178,16 @@ TEST(PffftTest, FftBitExactness) {
   }
 }
 
+TEST(PffftTest, SetupIsSharedPerSizeAndType) {
+  PFFFT_Setup* real_128 = WebRtcPffft_GetSetup(128, /*complex_fft=*/0);
+  ASSERT_TRUE(real_128);
+  EXPECT_EQ(real_128, WebRtcPffft_GetSetup(128, /*complex_fft=*/0));
+  PFFFT_Setup* complex_128 = WebRtcPffft_GetSetup(128, /*complex_fft=*/1);
+  ASSERT_TRUE(complex_128);
+  EXPECT_NE(real_128, complex_128);
+  EXPECT_NE(real_128, WebRtcPffft_GetSetup(256, /*complex_fft=*/0));
+  EXPECT_FALSE(WebRtcPffft_GetSetup(17, /*complex_fft=*/0));
+}
+
 }  // namespace test
 }  // namespace webrtc
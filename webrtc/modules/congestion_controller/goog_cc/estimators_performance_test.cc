@@ -0,0 +1,220 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the time per packet spent in the estimators GoogCC runs on every
+// transport feedback, fed with the feedback of a simulated bottleneck link.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/transport/field_trial_based_config.h"
+#include "api/units/data_rate.h"
+#include "api/units/timestamp.h"
+#include "modules/congestion_controller/goog_cc/acknowledged_bitrate_estimator.h"
+#include "modules/congestion_controller/goog_cc/delay_based_bwe.h"
+#include "modules/congestion_controller/goog_cc/median_slope_estimator.h"
+#include "modules/congestion_controller/goog_cc/probe_bitrate_estimator.h"
+#include "modules/congestion_controller/goog_cc/trendline_estimator.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "rtc_base/arraysize.h"
+#include "rtc_base/random.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int64_t kDurationMs = 600000;
+constexpr int64_t kQuickDurationMs = 60000;
+constexpr size_t kPacketSize = 1200;
+constexpr int64_t kSendIntervalMs = 5;  // 1.92 Mbps.
+constexpr int64_t kFeedbackIntervalMs = 50;
+constexpr int64_t kPropagationDelayMs = 50;
+// The link alternates between these capacities, so that the estimators see
+// both queues building up and draining.
+constexpr int kLinkCapacitiesKbps[] = {2500, 1000, 4000, 1500};
+constexpr int64_t kCapacityPeriodMs = 5000;
+constexpr int64_t kProbeIntervalMs = 1000;
+constexpr int kProbePackets = 10;
+constexpr int64_t kProbeSendIntervalMs = 1;
+constexpr size_t kTrendlineWindowSize = 20;
+constexpr size_t kMedianSlopeWindowSize = 20;
+
+// Feedback vectors, as delivered by the TransportFeedbackAdapter, of a sender
+// pacing out media at a constant rate with a probe cluster every second over
+// a link of varying capacity.
+std::vector<std::vector<PacketFeedback>> CreateFeedbackVectors(
+    int64_t duration_ms) {
+  Random random(0x5e1f);
+  std::vector<std::vector<PacketFeedback>> feedbacks(1);
+  int64_t send_time_ms = 100000;
+  const int64_t end_time_ms = send_time_ms + duration_ms;
+  int64_t next_feedback_ms = send_time_ms + kFeedbackIntervalMs;
+  int64_t next_probe_ms = send_time_ms;
+  int64_t link_free_ms = send_time_ms;
+  uint16_t sequence_number = 0;
+  int probe_cluster_id = 0;
+  int probe_packets_left = 0;
+  while (send_time_ms < end_time_ms) {
+    PacedPacketInfo pacing_info;
+    if (probe_packets_left == 0 && send_time_ms >= next_probe_ms) {
+      ++probe_cluster_id;
+      probe_packets_left = kProbePackets;
+      next_probe_ms += kProbeIntervalMs;
+    }
+    if (probe_packets_left > 0) {
+      pacing_info = PacedPacketInfo(probe_cluster_id, kProbePackets,
+                                    kProbePackets * kPacketSize);
+      --probe_packets_left;
+    }
+    const int capacity_kbps =
+        kLinkCapacitiesKbps[(send_time_ms / kCapacityPeriodMs) %
+                            arraysize(kLinkCapacitiesKbps)];
+    const int64_t transmit_ms = kPacketSize * 8 / capacity_kbps;
+    link_free_ms = std::max(link_free_ms, send_time_ms) + transmit_ms;
+    const int64_t arrival_time_ms =
+        link_free_ms + kPropagationDelayMs + random.Rand(0u, 2u);
+    // Feedback for a packet goes out with the first report after it arrives.
+    while (arrival_time_ms >= next_feedback_ms) {
+      feedbacks.emplace_back();
+      next_feedback_ms += kFeedbackIntervalMs;
+    }
+    feedbacks.back().emplace_back(arrival_time_ms, send_time_ms,
+                                  sequence_number++, kPacketSize, pacing_info);
+    send_time_ms +=
+        probe_packets_left > 0 ? kProbeSendIntervalMs : kSendIntervalMs;
+  }
+  // Like the adapter, deliver every report sorted by arrival time.
+  for (auto& feedback : feedbacks) {
+    std::sort(feedback.begin(), feedback.end(), PacketFeedbackComparator());
+  }
+  return feedbacks;
+}
+
+size_t CountPackets(const std::vector<std::vector<PacketFeedback>>& feedbacks) {
+  size_t num_packets = 0;
+  for (const auto& feedback : feedbacks)
+    num_packets += feedback.size();
+  return num_packets;
+}
+
+void PrintTimePerPacket(const std::string& estimator,
+                        int64_t elapsed_us,
+                        size_t num_packets) {
+  test::PrintResult("goog_cc_estimator_time", "", estimator,
+                    1e3 * elapsed_us / num_packets, "ns/packet", false);
+}
+
+template <typename DelayDetector>
+void RunDelayDetector(
+    const std::string& estimator,
+    DelayDetector* detector,
+    const std::vector<std::vector<PacketFeedback>>& feedbacks) {
+  size_t num_packets = 0;
+  const int64_t start_us = rtc::TimeMicros();
+  for (const auto& feedback : feedbacks) {
+    for (size_t i = 1; i < feedback.size(); ++i) {
+      detector->Update(feedback[i].arrival_time_ms -
+                           feedback[i - 1].arrival_time_ms,
+                       feedback[i].send_time_ms - feedback[i - 1].send_time_ms,
+                       feedback[i].arrival_time_ms);
+    }
+    num_packets += feedback.size();
+  }
+  PrintTimePerPacket(estimator, rtc::TimeMicros() - start_us, num_packets);
+}
+
+}  // namespace
+
+class GoogCcEstimatorsPerformanceTest : public ::testing::Test {
+ protected:
+  GoogCcEstimatorsPerformanceTest()
+      : feedbacks_(CreateFeedbackVectors(
+            field_trial::IsEnabled("WebRTC-QuickPerfTest") ? kQuickDurationMs
+                                                           : kDurationMs)),
+        num_packets_(CountPackets(feedbacks_)) {}
+
+  const std::vector<std::vector<PacketFeedback>> feedbacks_;
+  const size_t num_packets_;
+};
+
+TEST_F(GoogCcEstimatorsPerformanceTest, DISABLED_TrendlineEstimator) {
+  TrendlineEstimator estimator(kTrendlineWindowSize, 0.9, 4.0);
+  RunDelayDetector("trendline", &estimator, feedbacks_);
+}
+
+TEST_F(GoogCcEstimatorsPerformanceTest, DISABLED_MedianSlopeEstimator) {
+  MedianSlopeEstimator estimator(kMedianSlopeWindowSize, 4.0);
+  RunDelayDetector("median_slope", &estimator, feedbacks_);
+}
+
+TEST_F(GoogCcEstimatorsPerformanceTest, DISABLED_AcknowledgedBitrateEstimator) {
+  FieldTrialBasedConfig field_trials;
+  AcknowledgedBitrateEstimator estimator(&field_trials);
+  const int64_t start_us = rtc::TimeMicros();
+  for (const auto& feedback : feedbacks_)
+    estimator.IncomingPacketFeedbackVector(feedback);
+  PrintTimePerPacket("acknowledged_bitrate", rtc::TimeMicros() - start_us,
+                     num_packets_);
+  EXPECT_TRUE(estimator.bitrate().has_value());
+}
+
+TEST_F(GoogCcEstimatorsPerformanceTest, DISABLED_ProbeBitrateEstimator) {
+  ProbeBitrateEstimator estimator(nullptr);
+  int num_estimates = 0;
+  const int64_t start_us = rtc::TimeMicros();
+  for (const auto& feedback : feedbacks_) {
+    for (const PacketFeedback& packet : feedback) {
+      if (packet.pacing_info.probe_cluster_id != PacedPacketInfo::kNotAProbe)
+        estimator.HandleProbeAndEstimateBitrate(packet);
+    }
+    if (estimator.FetchAndResetLastEstimatedBitrate())
+      ++num_estimates;
+  }
+  PrintTimePerPacket("probe_bitrate", rtc::TimeMicros() - start_us,
+                     num_packets_);
+  EXPECT_GT(num_estimates, 0);
+}
+
+TEST_F(GoogCcEstimatorsPerformanceTest, DISABLED_DelayBasedBwe) {
+  FieldTrialBasedConfig field_trials;
+  DelayBasedBwe bwe(&field_trials, nullptr);
+  bwe.SetStartBitrate(DataRate::kbps(300));
+  bwe.SetMinBitrate(DataRate::kbps(30));
+  // Feed the acknowledged rate too, as GoogCcNetworkController does, but
+  // measure it separately above.
+  AcknowledgedBitrateEstimator acknowledged_bitrate(&field_trials);
+  std::vector<absl::optional<DataRate>> acked_bitrates;
+  acked_bitrates.reserve(feedbacks_.size());
+  for (const auto& feedback : feedbacks_) {
+    acknowledged_bitrate.IncomingPacketFeedbackVector(feedback);
+    acked_bitrates.push_back(acknowledged_bitrate.bitrate());
+  }
+
+  const int64_t start_us = rtc::TimeMicros();
+  for (size_t i = 0; i < feedbacks_.size(); ++i) {
+    if (feedbacks_[i].empty())
+      continue;
+    bwe.IncomingPacketFeedbackVector(
+        feedbacks_[i], acked_bitrates[i], absl::nullopt, /*in_alr=*/false,
+        Timestamp::ms(feedbacks_[i].back().arrival_time_ms));
+  }
+  PrintTimePerPacket("delay_based_bwe", rtc::TimeMicros() - start_us,
+                     num_packets_);
+}
+
+}  // namespace webrtc
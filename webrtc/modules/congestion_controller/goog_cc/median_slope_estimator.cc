@@ -26,8 +26,11 @@ MedianSlopeEstimator::MedianSlopeEstimator(size_t window_size,
       num_of_deltas_(0),
       accumulated_delay_(0),
       delay_hist_(),
+      delay_hist_begin_(0),
       median_filter_(0.5),
-      trendline_(0) {}
+      trendline_(0) {
+  delay_hist_.reserve(window_size_);
+}
 
 MedianSlopeEstimator::~MedianSlopeEstimator() {}
 
@@ -53,16 +56,19 @@ void MedianSlopeEstimator::Update(double recv_delta_ms,
                         accumulated_delay_);
 
   // If the window is full, remove the |window_size_| - 1 slopes that belong to
-  // the oldest point.
+  // the oldest point. Its entry is reused for the new point below.
+  DelayInfo* oldest = nullptr;
   if (delay_hist_.size() == window_size_) {
-    for (double slope : delay_hist_.front().slopes) {
+    oldest = &delay_hist_[delay_hist_begin_];
+    for (double slope : oldest->slopes) {
       const bool success = median_filter_.Erase(slope);
       RTC_CHECK(success);
     }
-    delay_hist_.pop_front();
   }
   // Add |window_size_| - 1 new slopes.
   for (auto& old_delay : delay_hist_) {
+    if (&old_delay == oldest)
+      continue;
     if (arrival_time_ms - old_delay.time != 0) {
       // The C99 standard explicitly states that casts and assignments must
       // perform the associated conversions. This means that |slope| will be
@@ -79,8 +85,16 @@ void MedianSlopeEstimator::Update(double recv_delta_ms,
       old_delay.slopes.push_back(slope);
     }
   }
-  delay_hist_.emplace_back(arrival_time_ms, accumulated_delay_,
-                           window_size_ - 1);
+  if (oldest) {
+    oldest->time = arrival_time_ms;
+    oldest->delay = accumulated_delay_;
+    oldest->slopes.clear();
+    if (++delay_hist_begin_ == window_size_)
+      delay_hist_begin_ = 0;
+  } else {
+    delay_hist_.emplace_back(arrival_time_ms, accumulated_delay_,
+                             window_size_ - 1);
+  }
   // Recompute the median slope.
   if (delay_hist_.size() == window_size_)
     trendline_ = median_filter_.GetPercentileValue();
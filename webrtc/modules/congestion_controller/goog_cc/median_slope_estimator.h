@@ -13,7 +13,6 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <deque>
 #include <vector>
 
 #include "rtc_base/constructor_magic.h"
@@ -61,7 +60,11 @@ class MedianSlopeEstimator {
   unsigned int num_of_deltas_;
   // Theil-Sen robust line fitting
   double accumulated_delay_;
-  std::deque<DelayInfo> delay_hist_;
+  // The last |window_size_| points, kept in a ring so that the points and
+  // their slope vectors are reused once the window is full.
+  // |delay_hist_begin_| is the index of the oldest point.
+  std::vector<DelayInfo> delay_hist_;
+  size_t delay_hist_begin_;
   PercentileFilter<double> median_filter_;
   double trendline_;
 
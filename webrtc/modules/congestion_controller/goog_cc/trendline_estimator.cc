@@ -22,24 +22,30 @@
 namespace webrtc {
 
 namespace {
+// |points| is a ring starting at |begin|. The points are visited oldest first
+// so that the sums are rounded the same way regardless of where the ring
+// starts.
 absl::optional<double> LinearFitSlope(
-    const std::deque<std::pair<double, double>>& points) {
+    const std::vector<std::pair<double, double>>& points,
+    size_t begin) {
   RTC_DCHECK(points.size() >= 2);
+  RTC_DCHECK_LT(begin, points.size());
+  const size_t size = points.size();
   // Compute the "center of mass".
   double sum_x = 0;
   double sum_y = 0;
-  for (const auto& point : points) {
-    sum_x += point.first;
-    sum_y += point.second;
+  for (size_t i = 0, j = begin; i < size; ++i, j = j + 1 < size ? j + 1 : 0) {
+    sum_x += points[j].first;
+    sum_y += points[j].second;
   }
-  double x_avg = sum_x / points.size();
-  double y_avg = sum_y / points.size();
+  double x_avg = sum_x / size;
+  double y_avg = sum_y / size;
   // Compute the slope k = \sum (x_i-x_avg)(y_i-y_avg) / \sum (x_i-x_avg)^2
   double numerator = 0;
   double denominator = 0;
-  for (const auto& point : points) {
-    numerator += (point.first - x_avg) * (point.second - y_avg);
-    denominator += (point.first - x_avg) * (point.first - x_avg);
+  for (size_t i = 0, j = begin; i < size; ++i, j = j + 1 < size ? j + 1 : 0) {
+    numerator += (points[j].first - x_avg) * (points[j].second - y_avg);
+    denominator += (points[j].first - x_avg) * (points[j].first - x_avg);
   }
   if (denominator == 0)
     return absl::nullopt;
@@ -64,6 +70,7 @@ TrendlineEstimator::TrendlineEstimator(size_t window_size,
       accumulated_delay_(0),
       smoothed_delay_(0),
       delay_hist_(),
+      delay_hist_begin_(0),
       k_up_(0.0087),
       k_down_(0.039),
       overusing_time_threshold_(kOverUsingTimeThreshold),
@@ -73,7 +80,10 @@ TrendlineEstimator::TrendlineEstimator(size_t window_size,
       prev_trend_(0.0),
       time_over_using_(-1),
       overuse_counter_(0),
-      hypothesis_(BandwidthUsage::kBwNormal) {}
+      hypothesis_(BandwidthUsage::kBwNormal) {
+  RTC_DCHECK_GE(window_size_, 2);
+  delay_hist_.reserve(window_size_);
+}
 
 TrendlineEstimator::~TrendlineEstimator() {}
 
@@ -96,11 +106,17 @@ void TrendlineEstimator::Update(double recv_delta_ms,
                         smoothed_delay_);
 
   // Simple linear regression.
-  delay_hist_.push_back(std::make_pair(
+  const std::pair<double, double> point(
       static_cast<double>(arrival_time_ms - first_arrival_time_ms_),
-      smoothed_delay_));
-  if (delay_hist_.size() > window_size_)
-    delay_hist_.pop_front();
+      smoothed_delay_);
+  if (delay_hist_.size() < window_size_) {
+    delay_hist_.push_back(point);
+  } else {
+    // Replace the oldest point.
+    delay_hist_[delay_hist_begin_] = point;
+    if (++delay_hist_begin_ == window_size_)
+      delay_hist_begin_ = 0;
+  }
   double trend = prev_trend_;
   if (delay_hist_.size() == window_size_) {
     // Update trend_ if it is possible to fit a line to the data. The delay
@@ -108,7 +124,7 @@ void TrendlineEstimator::Update(double recv_delta_ms,
     // 0 < trend < 1   ->  the delay increases, queues are filling up
     //   trend == 0    ->  the delay does not change
     //   trend < 0     ->  the delay decreases, queues are being emptied
-    trend = LinearFitSlope(delay_hist_).value_or(trend);
+    trend = LinearFitSlope(delay_hist_, delay_hist_begin_).value_or(trend);
   }
 
   BWE_TEST_LOGGING_PLOT(1, "trendline_slope", arrival_time_ms, trend);
@@ -12,8 +12,8 @@
 
 #include <stddef.h>
 #include <stdint.h>
-#include <deque>
 #include <utility>
+#include <vector>
 
 #include "modules/congestion_controller/goog_cc/delay_increase_detector_interface.h"
 #include "modules/remote_bitrate_estimator/include/bwe_defines.h"
@@ -65,8 +65,11 @@ class TrendlineEstimator : public DelayIncreaseDetectorInterface {
   // Exponential backoff filtering.
   double accumulated_delay_;
   double smoothed_delay_;
-  // Linear least squares regression.
-  std::deque<std::pair<double, double>> delay_hist_;
+  // Linear least squares regression over the last |window_size_| points, kept
+  // in a ring so that updates don't allocate. |delay_hist_begin_| is the
+  // index of the oldest point once the window is full.
+  std::vector<std::pair<double, double>> delay_hist_;
+  size_t delay_hist_begin_;
 
   const double k_up_;
   const double k_down_;
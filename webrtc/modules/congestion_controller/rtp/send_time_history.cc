@@ -12,12 +12,16 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
 namespace webrtc {
+namespace {
+constexpr size_t kMinHistoryCapacity = 256;
+}  // namespace
 
 SendTimeHistory::SendTimeHistory(int64_t packet_age_limit_ms)
     : packet_age_limit_ms_(packet_age_limit_ms) {}
@@ -26,21 +30,31 @@ SendTimeHistory::~SendTimeHistory() {}
 
 void SendTimeHistory::AddAndRemoveOld(const PacketFeedback& packet,
                                       int64_t at_time_ms) {
-  // Remove old.
-  while (!history_.empty() &&
-         at_time_ms - history_.begin()->second.creation_time_ms >
-             packet_age_limit_ms_) {
-    // TODO(sprang): Warn if erasing (too many) old items?
-    RemovePacketBytes(history_.begin()->second);
-    history_.erase(history_.begin());
+  // Remove old, along with the slots of acknowledged packets before them.
+  while (history_size_ > 0) {
+    absl::optional<PacketFeedback>& oldest = Slot(history_begin_);
+    if (oldest) {
+      if (at_time_ms - oldest->creation_time_ms <= packet_age_limit_ms_)
+        break;
+      // TODO(sprang): Warn if erasing (too many) old items?
+      RemovePacketBytes(*oldest);
+      oldest.reset();
+    }
+    ++history_begin_;
+    --history_size_;
   }
+  ShrinkToFit();
 
   // Add new.
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(packet.sequence_number);
-  PacketFeedback packet_copy = packet;
-  packet_copy.long_sequence_number = unwrapped_seq_num;
-  history_.insert(std::make_pair(unwrapped_seq_num, packet_copy));
+  absl::optional<PacketFeedback>& slot = ExtendTo(unwrapped_seq_num);
+  if (!slot) {
+    slot.emplace(packet);
+    slot->long_sequence_number = unwrapped_seq_num;
+  }
   if (packet.send_time_ms >= 0) {
+    PacketFeedback packet_copy = packet;
+    packet_copy.long_sequence_number = unwrapped_seq_num;
     AddPacketBytes(packet_copy);
     last_send_time_ms_ = std::max(last_send_time_ms_, packet.send_time_ms);
   }
@@ -58,20 +72,20 @@ void SendTimeHistory::AddUntracked(size_t packet_size, int64_t send_time_ms) {
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PacketFeedback* packet = FindPacket(unwrapped_seq_num);
+  if (!packet)
     return false;
-  bool packet_retransmit = it->second.send_time_ms >= 0;
-  it->second.send_time_ms = send_time_ms;
+  bool packet_retransmit = packet->send_time_ms >= 0;
+  packet->send_time_ms = send_time_ms;
   last_send_time_ms_ = std::max(last_send_time_ms_, send_time_ms);
   if (!packet_retransmit)
-    AddPacketBytes(it->second);
+    AddPacketBytes(*packet);
   if (pending_untracked_size_ > 0) {
     if (send_time_ms < last_untracked_send_time_ms_)
       RTC_LOG(LS_WARNING)
           << "appending acknowledged data for out of order packet. (Diff: "
           << last_untracked_send_time_ms_ - send_time_ms << " ms.)";
-    it->second.unacknowledged_data += pending_untracked_size_;
+    packet->unacknowledged_data += pending_untracked_size_;
     pending_untracked_size_ = 0;
   }
   return true;
@@ -82,9 +96,9 @@ absl::optional<PacketFeedback> SendTimeHistory::GetPacket(
   int64_t unwrapped_seq_num =
       seq_num_unwrapper_.UnwrapWithoutUpdate(sequence_number);
   absl::optional<PacketFeedback> optional_feedback;
-  auto it = history_.find(unwrapped_seq_num);
-  if (it != history_.end())
-    optional_feedback.emplace(it->second);
+  const PacketFeedback* packet = FindPacket(unwrapped_seq_num);
+  if (packet)
+    optional_feedback.emplace(*packet);
   return optional_feedback;
 }
 
@@ -95,17 +109,17 @@ bool SendTimeHistory::GetFeedback(PacketFeedback* packet_feedback,
       seq_num_unwrapper_.Unwrap(packet_feedback->sequence_number);
   UpdateAckedSeqNum(unwrapped_seq_num);
   RTC_DCHECK_GE(*last_ack_seq_num_, 0);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PacketFeedback* packet = FindPacket(unwrapped_seq_num);
+  if (!packet)
     return false;
 
   // Save arrival_time not to overwrite it.
   int64_t arrival_time_ms = packet_feedback->arrival_time_ms;
-  *packet_feedback = it->second;
+  *packet_feedback = *packet;
   packet_feedback->arrival_time_ms = arrival_time_ms;
 
   if (remove)
-    history_.erase(it);
+    Slot(unwrapped_seq_num).reset();
   return true;
 }
 
@@ -122,11 +136,86 @@ DataSize SendTimeHistory::GetOutstandingData(uint16_t local_net_id,
 absl::optional<int64_t> SendTimeHistory::GetFirstUnackedSendTime() const {
   if (!last_ack_seq_num_)
     return absl::nullopt;
-  auto it = history_.find(*last_ack_seq_num_);
-  if (it == history_.end() ||
-      it->second.send_time_ms == PacketFeedback::kNoSendTime)
+  const PacketFeedback* packet = FindPacket(*last_ack_seq_num_);
+  if (!packet || packet->send_time_ms == PacketFeedback::kNoSendTime)
     return absl::nullopt;
-  return it->second.send_time_ms;
+  return packet->send_time_ms;
+}
+
+PacketFeedback* SendTimeHistory::FindPacket(int64_t unwrapped_seq_num) {
+  return const_cast<PacketFeedback*>(
+      static_cast<const SendTimeHistory*>(this)->FindPacket(unwrapped_seq_num));
+}
+
+const PacketFeedback* SendTimeHistory::FindPacket(
+    int64_t unwrapped_seq_num) const {
+  if (unwrapped_seq_num < history_begin_ ||
+      unwrapped_seq_num - history_begin_ >=
+          static_cast<int64_t>(history_size_)) {
+    return nullptr;
+  }
+  const absl::optional<PacketFeedback>& slot =
+      history_[unwrapped_seq_num & (history_.size() - 1)];
+  return slot ? &*slot : nullptr;
+}
+
+absl::optional<PacketFeedback>& SendTimeHistory::Slot(
+    int64_t unwrapped_seq_num) {
+  RTC_DCHECK(!history_.empty());
+  return history_[unwrapped_seq_num & (history_.size() - 1)];
+}
+
+absl::optional<PacketFeedback>& SendTimeHistory::ExtendTo(
+    int64_t unwrapped_seq_num) {
+  if (history_size_ == 0) {
+    Reserve(1);
+    history_begin_ = unwrapped_seq_num;
+    history_size_ = 1;
+  } else if (unwrapped_seq_num < history_begin_) {
+    size_t new_size = history_size_ + (history_begin_ - unwrapped_seq_num);
+    Reserve(new_size);
+    history_begin_ = unwrapped_seq_num;
+    history_size_ = new_size;
+  } else if (unwrapped_seq_num - history_begin_ >=
+             static_cast<int64_t>(history_size_)) {
+    size_t new_size = unwrapped_seq_num - history_begin_ + 1;
+    Reserve(new_size);
+    history_size_ = new_size;
+  }
+  return Slot(unwrapped_seq_num);
+}
+
+void SendTimeHistory::Reserve(size_t min_capacity) {
+  if (history_.size() >= min_capacity)
+    return;
+  size_t capacity = std::max(kMinHistoryCapacity, history_.size());
+  while (capacity < min_capacity)
+    capacity *= 2;
+  Resize(capacity);
+}
+
+void SendTimeHistory::ShrinkToFit() {
+  // Only shrink when the span is a quarter of the capacity, and then to at
+  // least twice the span, so that a span moving around a power of two does not
+  // reallocate on every packet.
+  if (history_.size() <= kMinHistoryCapacity ||
+      history_size_ >= history_.size() / 4) {
+    return;
+  }
+  size_t capacity = kMinHistoryCapacity;
+  while (capacity < 2 * history_size_)
+    capacity *= 2;
+  Resize(capacity);
+}
+
+void SendTimeHistory::Resize(size_t capacity) {
+  RTC_DCHECK_GE(capacity, history_size_);
+  std::vector<absl::optional<PacketFeedback>> history(capacity);
+  for (size_t i = 0; i < history_size_; ++i) {
+    int64_t seq_num = history_begin_ + i;
+    history[seq_num & (capacity - 1)] = std::move(Slot(seq_num));
+  }
+  history_.swap(history);
 }
 
 void SendTimeHistory::AddPacketBytes(const PacketFeedback& packet) {
@@ -158,13 +247,16 @@ void SendTimeHistory::UpdateAckedSeqNum(int64_t acked_seq_num) {
   if (last_ack_seq_num_ && *last_ack_seq_num_ >= acked_seq_num)
     return;
 
-  auto unacked_it = history_.begin();
+  int64_t unacked_seq_num = history_begin_;
   if (last_ack_seq_num_)
-    unacked_it = history_.lower_bound(*last_ack_seq_num_);
+    unacked_seq_num = std::max(unacked_seq_num, *last_ack_seq_num_);
 
-  auto newly_acked_end = history_.upper_bound(acked_seq_num);
-  for (; unacked_it != newly_acked_end; ++unacked_it) {
-    RemovePacketBytes(unacked_it->second);
+  int64_t newly_acked_end = std::min<int64_t>(
+      acked_seq_num + 1, history_begin_ + history_size_);
+  for (; unacked_seq_num < newly_acked_end; ++unacked_seq_num) {
+    const PacketFeedback* packet = FindPacket(unacked_seq_num);
+    if (packet)
+      RemovePacketBytes(*packet);
   }
   last_ack_seq_num_.emplace(acked_seq_num);
 }
@@ -13,7 +13,9 @@
 
 #include <map>
 #include <utility>
+#include <vector>
 
+#include "absl/types/optional.h"
 #include "api/units/data_size.h"
 #include "modules/include/module_common_types.h"
 #include "rtc_base/constructor_magic.h"
@@ -21,6 +23,12 @@
 namespace webrtc {
 struct PacketFeedback;
 
+// Keeps the packets sent with a transport sequence number until they are
+// acknowledged or too old. Packets are kept in a ring buffer indexed by the
+// unwrapped sequence number, which spans from the oldest packet kept to the
+// newest one. A packet whose feedback is lost keeps that span open until it is
+// older than the age limit, so the buffer grows with everything sent within the
+// age limit, and shrinks again once the span has dropped well below its size.
 class SendTimeHistory {
  public:
   explicit SendTimeHistory(int64_t packet_age_limit_ms);
@@ -51,6 +59,15 @@ class SendTimeHistory {
  private:
   using RemoteAndLocalNetworkId = std::pair<uint16_t, uint16_t>;
 
+  // Returns the packet with |unwrapped_seq_num|, or null if not in history.
+  PacketFeedback* FindPacket(int64_t unwrapped_seq_num);
+  const PacketFeedback* FindPacket(int64_t unwrapped_seq_num) const;
+  absl::optional<PacketFeedback>& Slot(int64_t unwrapped_seq_num);
+  // Makes the history span |unwrapped_seq_num|, growing the buffer if needed.
+  absl::optional<PacketFeedback>& ExtendTo(int64_t unwrapped_seq_num);
+  void Reserve(size_t min_capacity);
+  void ShrinkToFit();
+  void Resize(size_t capacity);
   void AddPacketBytes(const PacketFeedback& packet);
   void RemovePacketBytes(const PacketFeedback& packet);
   void UpdateAckedSeqNum(int64_t acked_seq_num);
@@ -59,7 +76,13 @@ class SendTimeHistory {
   int64_t last_send_time_ms_ = -1;
   int64_t last_untracked_send_time_ms_ = -1;
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketFeedback> history_;
+  // Ring buffer with a power of two size. Slot i holds the packet with an
+  // unwrapped sequence number equal to i modulo the size, if it is within
+  // [history_begin_, history_begin_ + history_size_). Slots outside that
+  // range are always empty.
+  std::vector<absl::optional<PacketFeedback>> history_;
+  int64_t history_begin_ = 0;
+  size_t history_size_ = 0;
   absl::optional<int64_t> last_ack_seq_num_;
   std::map<RemoteAndLocalNetworkId, size_t> in_flight_bytes_;
 
@@ -222,6 +222,58 @@ TEST_F(SendTimeHistoryTest, HistorySizeWithWraparound) {
   EXPECT_TRUE(history_.GetFeedback(&packet10, false));
 }
 
+TEST_F(SendTimeHistoryTest, KeepsPacketsWhileGrowing) {
+  // Enough packets to grow the history several times, with the oldest
+  // acknowledged and a few added out of order.
+  const int kNumPackets = 5000;
+  for (int i = 0; i < kNumPackets; ++i) {
+    uint16_t sequence_number = static_cast<uint16_t>(i ^ 1);
+    AddPacketWithSendTime(sequence_number, 100, i, PacedPacketInfo());
+    if (i % 100 == 99) {
+      PacketFeedback packet(0, static_cast<uint16_t>(i - 99));
+      EXPECT_TRUE(history_.GetFeedback(&packet, true));
+    }
+  }
+  for (int i = 0; i < kNumPackets; ++i) {
+    PacketFeedback packet(0, static_cast<uint16_t>(i));
+    EXPECT_EQ(i % 100 != 0, history_.GetFeedback(&packet, false));
+    if (i % 100 != 0) {
+      EXPECT_EQ(i ^ 1, packet.send_time_ms);
+    }
+  }
+}
+
+TEST_F(SendTimeHistoryTest, KeepsPacketsAfterLostFeedbackTimesOut) {
+  // The feedback for the first packet is lost, which keeps every packet sent
+  // within the age limit in the history, even though they are acknowledged.
+  const int kNumPackets = 4000;
+  const int kNumUnacked = 10;
+  for (int i = 0; i < kNumPackets; ++i) {
+    clock_.AdvanceTimeMilliseconds(i % 4 == 0 ? 1 : 0);
+    AddPacketWithSendTime(i, 100, clock_.TimeInMilliseconds(),
+                          PacedPacketInfo());
+    if (i > 0 && i < kNumPackets - kNumUnacked) {
+      PacketFeedback packet(0, i);
+      EXPECT_TRUE(history_.GetFeedback(&packet, true));
+    }
+  }
+
+  // Once the first packet has timed out, the history only spans the packets
+  // that are still unacknowledged.
+  clock_.AdvanceTimeMilliseconds(kDefaultHistoryLengthMs - 10);
+  AddPacketWithSendTime(kNumPackets, 100, clock_.TimeInMilliseconds(),
+                        PacedPacketInfo());
+  EXPECT_EQ(DataSize::bytes(100 * (kNumUnacked + 1)),
+            history_.GetOutstandingData(0, 0));
+  PacketFeedback first_packet(0, 0);
+  EXPECT_FALSE(history_.GetFeedback(&first_packet, false));
+  for (int i = kNumPackets - kNumUnacked; i <= kNumPackets; ++i) {
+    PacketFeedback packet(0, i);
+    EXPECT_TRUE(history_.GetFeedback(&packet, true));
+    EXPECT_EQ(i, packet.long_sequence_number);
+  }
+}
+
 TEST_F(SendTimeHistoryTest, InterlievedGetAndRemove) {
   const uint16_t kSeqNo = 1;
   const int64_t kTimestamp = 2;
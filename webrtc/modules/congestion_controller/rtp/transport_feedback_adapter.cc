@@ -127,8 +127,8 @@ TransportFeedbackAdapter::ProcessTransportFeedback(
     Timestamp feedback_receive_time) {
   DataSize prior_in_flight = GetOutstandingData();
 
-  last_packet_feedback_vector_ =
-      GetPacketFeedbackVector(feedback, feedback_receive_time);
+  GetPacketFeedbackVector(feedback, feedback_receive_time,
+                          &last_packet_feedback_vector_);
   {
     rtc::CritScope cs(&observers_lock_);
     for (auto* observer : observers_) {
@@ -136,12 +136,12 @@ TransportFeedbackAdapter::ProcessTransportFeedback(
     }
   }
 
-  std::vector<PacketFeedback> feedback_vector = last_packet_feedback_vector_;
-  if (feedback_vector.empty())
+  if (last_packet_feedback_vector_.empty())
     return absl::nullopt;
 
   TransportPacketsFeedback msg;
-  for (const PacketFeedback& rtp_feedback : feedback_vector) {
+  msg.packet_feedbacks.reserve(last_packet_feedback_vector_.size());
+  for (const PacketFeedback& rtp_feedback : last_packet_feedback_vector_) {
     if (rtp_feedback.send_time_ms != PacketFeedback::kNoSendTime) {
       auto feedback = NetworkPacketFeedbackFromRtpPacketFeedback(rtp_feedback);
       msg.packet_feedbacks.push_back(feedback);
@@ -177,9 +177,10 @@ DataSize TransportFeedbackAdapter::GetOutstandingData() const {
   return send_time_history_.GetOutstandingData(local_net_id_, remote_net_id_);
 }
 
-std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
+void TransportFeedbackAdapter::GetPacketFeedbackVector(
     const rtcp::TransportFeedback& feedback,
-    Timestamp feedback_time) {
+    Timestamp feedback_time,
+    std::vector<PacketFeedback>* packet_feedback_vector) {
   int64_t timestamp_us = feedback.GetBaseTimeUs();
 
   // Add timestamp deltas to a local time base selected on first packet arrival.
@@ -201,12 +202,12 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
   }
   last_timestamp_us_ = timestamp_us;
 
-  std::vector<PacketFeedback> packet_feedback_vector;
+  packet_feedback_vector->clear();
   if (feedback.GetPacketStatusCount() == 0) {
     RTC_LOG(LS_INFO) << "Empty transport feedback packet received.";
-    return packet_feedback_vector;
+    return;
   }
-  packet_feedback_vector.reserve(feedback.GetPacketStatusCount());
+  packet_feedback_vector->reserve(feedback.GetPacketStatusCount());
   {
     rtc::CritScope cs(&lock_);
     size_t failed_lookups = 0;
@@ -224,7 +225,7 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
           ++failed_lookups;
         if (packet_feedback.local_net_id == local_net_id_ &&
             packet_feedback.remote_net_id == remote_net_id_) {
-          packet_feedback_vector.push_back(packet_feedback);
+          packet_feedback_vector->push_back(packet_feedback);
         }
       }
 
@@ -236,7 +237,7 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
         ++failed_lookups;
       if (packet_feedback.local_net_id == local_net_id_ &&
           packet_feedback.remote_net_id == remote_net_id_) {
-        packet_feedback_vector.push_back(packet_feedback);
+        packet_feedback_vector->push_back(packet_feedback);
       }
 
       ++seq_num;
@@ -248,7 +249,6 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
                           << ". Send time history too small?";
     }
   }
-  return packet_feedback_vector;
 }
 
 std::vector<PacketFeedback>
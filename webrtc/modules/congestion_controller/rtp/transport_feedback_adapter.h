@@ -59,9 +59,11 @@ class TransportFeedbackAdapter {
  private:
   void OnTransportFeedback(const rtcp::TransportFeedback& feedback);
 
-  std::vector<PacketFeedback> GetPacketFeedbackVector(
+  // Fills |packet_feedback_vector|, reusing its capacity.
+  void GetPacketFeedbackVector(
       const rtcp::TransportFeedback& feedback,
-      Timestamp feedback_time);
+      Timestamp feedback_time,
+      std::vector<PacketFeedback>* packet_feedback_vector);
 
   rtc::CriticalSection lock_;
   SendTimeHistory send_time_history_ RTC_GUARDED_BY(&lock_);
@@ -99,6 +99,14 @@ class RTC_EXPORT DesktopCaptureOptions {
     detect_updated_region_ = detect_updated_region;
   }
 
+  // Number of threads used to compare frames when detect_updated_region() is
+  // set. Comparing large frames, e.g. of 4K or 5K displays, on a single thread
+  // may take a large part of the capture interval.
+  int differ_threads() const { return differ_threads_; }
+  void set_differ_threads(int differ_threads) {
+    differ_threads_ = differ_threads;
+  }
+
 #if defined(WEBRTC_WIN)
   bool allow_use_magnification_api() const {
     return allow_use_magnification_api_;
@@ -142,6 +150,7 @@ class RTC_EXPORT DesktopCaptureOptions {
 #endif
   bool disable_effects_ = true;
   bool detect_updated_region_ = false;
+  int differ_threads_ = 1;
 #if defined(WEBRTC_USE_PIPEWIRE)
   bool allow_pipewire_ = false;
 #endif
@@ -49,7 +49,8 @@ std::unique_ptr<DesktopCapturer> DesktopCapturer::CreateWindowCapturer(
     const DesktopCaptureOptions& options) {
   std::unique_ptr<DesktopCapturer> capturer = CreateRawWindowCapturer(options);
   if (capturer && options.detect_updated_region()) {
-    capturer.reset(new DesktopCapturerDifferWrapper(std::move(capturer)));
+    capturer.reset(new DesktopCapturerDifferWrapper(std::move(capturer),
+                                                    options.differ_threads()));
   }
 
   return capturer;
@@ -60,7 +61,8 @@ std::unique_ptr<DesktopCapturer> DesktopCapturer::CreateScreenCapturer(
     const DesktopCaptureOptions& options) {
   std::unique_ptr<DesktopCapturer> capturer = CreateRawScreenCapturer(options);
   if (capturer && options.detect_updated_region()) {
-    capturer.reset(new DesktopCapturerDifferWrapper(std::move(capturer)));
+    capturer.reset(new DesktopCapturerDifferWrapper(std::move(capturer),
+                                                    options.differ_threads()));
   }
 
   return capturer;
@@ -12,18 +12,26 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <algorithm>
+#include <string>
 #include <utility>
 
+#include "absl/memory/memory.h"
 #include "modules/desktop_capture/desktop_geometry.h"
 #include "modules/desktop_capture/desktop_region.h"
 #include "modules/desktop_capture/differ_block.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/time_utils.h"
 
 namespace webrtc {
 
 namespace {
 
+// Minimum number of block-rows in each band. Smaller bands are not worth the
+// cost of posting them to another thread.
+const int kMinBlockRowsPerBand = 4;
+
 // Returns true if (0, 0) - (|width|, |height|) vector in |old_buffer| and
 // |new_buffer| are equal. |width| should be less than 32
 // (defined by kBlockSize), otherwise BlockDifference() should be used.
@@ -145,11 +153,25 @@ void CompareFrames(const DesktopFrame& old_frame,
 
 DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
     std::unique_ptr<DesktopCapturer> base_capturer)
+    : DesktopCapturerDifferWrapper(std::move(base_capturer), 1) {}
+
+DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
+    std::unique_ptr<DesktopCapturer> base_capturer,
+    int num_threads)
     : base_capturer_(std::move(base_capturer)) {
   RTC_DCHECK(base_capturer_);
+  RTC_DCHECK_GT(num_threads, 0);
+  for (int i = 1; i < num_threads; ++i) {
+    workers_.push_back(absl::make_unique<rtc::TaskQueue>(
+        ("DifferWorker" + std::to_string(i)).c_str()));
+  }
+  band_regions_.resize(workers_.size());
 }
 
-DesktopCapturerDifferWrapper::~DesktopCapturerDifferWrapper() {}
+DesktopCapturerDifferWrapper::~DesktopCapturerDifferWrapper() {
+  // Stop the workers before the regions they write to are destroyed.
+  workers_.clear();
+}
 
 void DesktopCapturerDifferWrapper::Start(DesktopCapturer::Callback* callback) {
   callback_ = callback;
@@ -207,8 +229,8 @@ void DesktopCapturerDifferWrapper::OnCaptureResult(
     DesktopRegion hints;
     hints.Swap(frame->mutable_updated_region());
     for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
-      CompareFrames(*last_frame_, *frame, it.rect(),
-                    frame->mutable_updated_region());
+      CompareRect(*last_frame_, *frame, it.rect(),
+                  frame->mutable_updated_region());
     }
   } else {
     frame->mutable_updated_region()->SetRect(
@@ -222,4 +244,49 @@ void DesktopCapturerDifferWrapper::OnCaptureResult(
   callback_->OnCaptureResult(result, std::move(frame));
 }
 
+void DesktopCapturerDifferWrapper::CompareRect(const DesktopFrame& old_frame,
+                                               const DesktopFrame& new_frame,
+                                               DesktopRect rect,
+                                               DesktopRegion* output) {
+  rect.IntersectWith(DesktopRect::MakeSize(old_frame.size()));
+  const int y_block_count = (rect.height() + kBlockSize - 1) / kBlockSize;
+  const int num_bands =
+      std::min(static_cast<int>(workers_.size()) + 1,
+               y_block_count / kMinBlockRowsPerBand);
+  if (num_bands <= 1) {
+    CompareFrames(old_frame, new_frame, rect, output);
+    return;
+  }
+
+  // Bands start at a multiple of kBlockSize below the top of |rect|, so the
+  // blocks compared are the same as when comparing |rect| at once.
+  auto band_rect = [&rect, y_block_count, num_bands](int band) {
+    const int top =
+        rect.top() + band * y_block_count / num_bands * kBlockSize;
+    const int bottom = std::min(
+        rect.bottom(),
+        rect.top() + (band + 1) * y_block_count / num_bands * kBlockSize);
+    return DesktopRect::MakeLTRB(rect.left(), top, rect.right(), bottom);
+  };
+
+  std::vector<rtc::Event> done(num_bands - 1);
+  for (int band = 1; band < num_bands; ++band) {
+    const DesktopRect band_area = band_rect(band);
+    DesktopRegion* band_region = &band_regions_[band - 1];
+    rtc::Event* band_done = &done[band - 1];
+    workers_[band - 1]->PostTask(
+        [&old_frame, &new_frame, band_area, band_region, band_done] {
+          band_region->Clear();
+          CompareFrames(old_frame, new_frame, band_area, band_region);
+          band_done->Set();
+        });
+  }
+  CompareFrames(old_frame, new_frame, band_rect(0), output);
+  for (rtc::Event& band_done : done)
+    band_done.Wait(rtc::Event::kForever);
+
+  for (int band = 1; band < num_bands; ++band)
+    output->AddRegion(band_regions_[band - 1]);
+}
+
 }  // namespace webrtc
@@ -12,13 +12,16 @@
 #define MODULES_DESKTOP_CAPTURE_DESKTOP_CAPTURER_DIFFER_WRAPPER_H_
 
 #include <memory>
+#include <vector>
 
 #include "modules/desktop_capture/desktop_capture_types.h"
 #include "modules/desktop_capture/desktop_capturer.h"
 #include "modules/desktop_capture/desktop_frame.h"
 #include "modules/desktop_capture/desktop_geometry.h"
+#include "modules/desktop_capture/desktop_region.h"
 #include "modules/desktop_capture/shared_desktop_frame.h"
 #include "modules/desktop_capture/shared_memory.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -38,6 +41,12 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
   explicit DesktopCapturerDifferWrapper(
       std::unique_ptr<DesktopCapturer> base_capturer);
 
+  // Same as above, but compares large updated rectangles in up to
+  // |num_threads| horizontal bands in parallel. The resulting
+  // updated_region() is the same as with a single thread.
+  DesktopCapturerDifferWrapper(std::unique_ptr<DesktopCapturer> base_capturer,
+                               int num_threads);
+
   ~DesktopCapturerDifferWrapper() override;
 
   // DesktopCapturer interface.
@@ -56,9 +65,20 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
   void OnCaptureResult(Result result,
                        std::unique_ptr<DesktopFrame> frame) override;
 
+  // Compares |rect| area in |old_frame| and |new_frame|, and adds dirty
+  // regions to |output|. Splits |rect| into bands if it is large enough.
+  void CompareRect(const DesktopFrame& old_frame,
+                   const DesktopFrame& new_frame,
+                   DesktopRect rect,
+                   DesktopRegion* output);
+
   const std::unique_ptr<DesktopCapturer> base_capturer_;
   DesktopCapturer::Callback* callback_;
   std::unique_ptr<SharedDesktopFrame> last_frame_;
+  // Dirty regions of all but the first band, which is compared on the
+  // capturing thread and written to the frame directly.
+  std::vector<DesktopRegion> band_regions_;
+  std::vector<std::unique_ptr<rtc::TaskQueue>> workers_;
 };
 
 }  // namespace webrtc
@@ -12,6 +12,7 @@
 
 #include <initializer_list>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -20,10 +21,12 @@
 #include "modules/desktop_capture/differ_block.h"
 #include "modules/desktop_capture/fake_desktop_capturer.h"
 #include "modules/desktop_capture/mock_desktop_capturer_callback.h"
+#include "modules/desktop_capture/shared_desktop_frame.h"
 #include "rtc_base/random.h"
 #include "rtc_base/time_utils.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
 
 namespace webrtc {
 
@@ -152,7 +155,8 @@ void ExecuteCapturer(DesktopCapturerDifferWrapper* capturer,
 void ExecuteDifferWrapperTest(bool with_hints,
                               bool enlarge_updated_region,
                               bool random_updated_region,
-                              bool check_result) {
+                              bool check_result,
+                              int num_threads) {
   const bool updated_region_should_exactly_match =
       with_hints && !enlarge_updated_region && !random_updated_region;
   BlackWhiteDesktopFramePainter frame_painter;
@@ -160,7 +164,7 @@ void ExecuteDifferWrapperTest(bool with_hints,
   frame_generator.set_desktop_frame_painter(&frame_painter);
   std::unique_ptr<FakeDesktopCapturer> fake(new FakeDesktopCapturer());
   fake->set_frame_generator(&frame_generator);
-  DesktopCapturerDifferWrapper capturer(std::move(fake));
+  DesktopCapturerDifferWrapper capturer(std::move(fake), num_threads);
   MockDesktopCapturerCallback callback;
   frame_generator.set_provide_updated_region_hints(with_hints);
   frame_generator.set_enlarge_updated_region(enlarge_updated_region);
@@ -221,26 +225,155 @@ void ExecuteDifferWrapperTest(bool with_hints,
   }
 }
 
+// Alternately returns two frames which differ in |num_changed_pixels| random
+// pixels. The entire frame is always set as updated region hint, so all
+// blocks are compared.
+class AlternatingFramesCapturer : public DesktopCapturer {
+ public:
+  AlternatingFramesCapturer(DesktopSize size, int num_changed_pixels) {
+    std::unique_ptr<DesktopFrame> first(new BasicDesktopFrame(size));
+    for (int y = 0; y < size.height(); y++) {
+      uint8_t* row = first->GetFrameDataAtPos(DesktopVector(0, y));
+      for (int x = 0; x < size.width() * DesktopFrame::kBytesPerPixel; x++) {
+        row[x] = static_cast<uint8_t>(x + y);
+      }
+    }
+    std::unique_ptr<DesktopFrame> second(new BasicDesktopFrame(size));
+    second->CopyPixelsFrom(*first, DesktopVector(),
+                           DesktopRect::MakeSize(size));
+    Random random(17);
+    for (int i = 0; i < num_changed_pixels; i++) {
+      const DesktopVector pos(random.Rand(0, size.width() - 1),
+                              random.Rand(0, size.height() - 1));
+      second->GetFrameDataAtPos(pos)[random.Rand(0, 3)] ^= 0xFF;
+      changed_region_.AddRect(DesktopRect::MakeXYWH(pos.x(), pos.y(), 1, 1));
+    }
+    frames_[0] = SharedDesktopFrame::Wrap(std::move(first));
+    frames_[1] = SharedDesktopFrame::Wrap(std::move(second));
+  }
+
+  // Pixels which differ between the two frames.
+  const DesktopRegion& changed_region() const { return changed_region_; }
+
+  // DesktopCapturer interface.
+  void Start(DesktopCapturer::Callback* callback) override {
+    callback_ = callback;
+  }
+
+  void CaptureFrame() override {
+    std::unique_ptr<DesktopFrame> frame = frames_[next_frame_]->Share();
+    next_frame_ = 1 - next_frame_;
+    frame->mutable_updated_region()->SetRect(
+        DesktopRect::MakeSize(frame->size()));
+    callback_->OnCaptureResult(Result::SUCCESS, std::move(frame));
+  }
+
+ private:
+  std::unique_ptr<SharedDesktopFrame> frames_[2];
+  DesktopRegion changed_region_;
+  int next_frame_ = 0;
+  DesktopCapturer::Callback* callback_ = nullptr;
+};
+
+// Keeps the updated region of the last captured frame.
+class UpdatedRegionCallback : public DesktopCapturer::Callback {
+ public:
+  const DesktopRegion& updated_region() const { return updated_region_; }
+
+  // DesktopCapturer::Callback interface.
+  void OnCaptureResult(DesktopCapturer::Result result,
+                       std::unique_ptr<DesktopFrame> frame) override {
+    ASSERT_EQ(result, DesktopCapturer::Result::SUCCESS);
+    updated_region_ = frame->updated_region();
+  }
+
+ private:
+  DesktopRegion updated_region_;
+};
+
+// Compares frames of |size| with different numbers of threads, and reports
+// the number of comparisons per second.
+void RunDifferSpeedTest(DesktopSize size, const std::string& label) {
+  const int kNumFrames = 100;
+  for (int num_threads : {1, 2, 4}) {
+    std::unique_ptr<AlternatingFramesCapturer> frames(
+        new AlternatingFramesCapturer(size, 10));
+    DesktopCapturerDifferWrapper capturer(std::move(frames), num_threads);
+    UpdatedRegionCallback callback;
+    capturer.Start(&callback);
+    // The first frame is not compared.
+    capturer.CaptureFrame();
+
+    const int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumFrames; i++) {
+      capturer.CaptureFrame();
+    }
+    const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+
+    ASSERT_GT(elapsed_us, 0);
+    test::PrintResult("differ_speed", label,
+                      std::to_string(num_threads) + "_threads",
+                      kNumFrames * 1e6 / elapsed_us, "fps", false);
+  }
+}
+
 }  // namespace
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithoutHints) {
-  ExecuteDifferWrapperTest(false, false, false, true);
+  ExecuteDifferWrapperTest(false, false, false, true, 1);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithHints) {
-  ExecuteDifferWrapperTest(true, false, false, true);
+  ExecuteDifferWrapperTest(true, false, false, true, 1);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedHints) {
-  ExecuteDifferWrapperTest(true, true, false, true);
+  ExecuteDifferWrapperTest(true, true, false, true, 1);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithRandomHints) {
-  ExecuteDifferWrapperTest(true, false, true, true);
+  ExecuteDifferWrapperTest(true, false, true, true, 1);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedAndRandomHints) {
-  ExecuteDifferWrapperTest(true, true, true, true);
+  ExecuteDifferWrapperTest(true, true, true, true, 1);
+}
+
+TEST(DesktopCapturerDifferWrapperTest, CaptureWithoutHintsMultiThreaded) {
+  ExecuteDifferWrapperTest(false, false, false, true, 4);
+}
+
+TEST(DesktopCapturerDifferWrapperTest, CaptureWithHintsMultiThreaded) {
+  ExecuteDifferWrapperTest(true, false, false, true, 4);
+}
+
+TEST(DesktopCapturerDifferWrapperTest,
+     MultiThreadedUpdatedRegionMatchesSingleThreaded) {
+  // Not a multiple of kBlockSize, so the last band is a partial block-row.
+  const DesktopSize size(1000, 1000);
+  for (int num_threads : {2, 3, 8}) {
+    std::unique_ptr<AlternatingFramesCapturer> frames(
+        new AlternatingFramesCapturer(size, 50));
+    std::unique_ptr<AlternatingFramesCapturer> banded_frames(
+        new AlternatingFramesCapturer(size, 50));
+    DesktopRegion changed_region = frames->changed_region();
+    DesktopCapturerDifferWrapper capturer(std::move(frames));
+    DesktopCapturerDifferWrapper banded_capturer(std::move(banded_frames),
+                                                 num_threads);
+    UpdatedRegionCallback callback;
+    UpdatedRegionCallback banded_callback;
+    capturer.Start(&callback);
+    banded_capturer.Start(&banded_callback);
+    for (int i = 0; i < 3; i++) {
+      capturer.CaptureFrame();
+      banded_capturer.CaptureFrame();
+      ASSERT_TRUE(
+          banded_callback.updated_region().Equals(callback.updated_region()));
+    }
+    DesktopRegion covered(changed_region);
+    covered.IntersectWith(banded_callback.updated_region());
+    ASSERT_TRUE(covered.Equals(changed_region));
+  }
 }
 
 // When hints are provided, DesktopCapturerDifferWrapper has a slightly better
@@ -258,33 +391,41 @@ TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedAndRandomHints) {
 // [       OK ] DISABLED_CaptureWithEnlargedAndRandomHintsPerf (6347 ms)
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithoutHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(false, false, false, false);
+  ExecuteDifferWrapperTest(false, false, false, false, 1);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, false, false, false);
+  ExecuteDifferWrapperTest(true, false, false, false, 1);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithEnlargedHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, true, false, false);
+  ExecuteDifferWrapperTest(true, true, false, false, 1);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithRandomHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, false, true, false);
+  ExecuteDifferWrapperTest(true, false, true, false, 1);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest,
      DISABLED_CaptureWithEnlargedAndRandomHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, true, true, false);
+  ExecuteDifferWrapperTest(true, true, true, false, 1);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
+TEST(DesktopCapturerDifferWrapperTest, DISABLED_CompareSpeed4K) {
+  RunDifferSpeedTest(DesktopSize(3840, 2160), "_4k");
+}
+
+TEST(DesktopCapturerDifferWrapperTest, DISABLED_CompareSpeed5K) {
+  RunDifferSpeedTest(DesktopSize(5120, 2880), "_5k");
+}
+
 }  // namespace webrtc
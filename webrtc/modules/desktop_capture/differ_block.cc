@@ -16,6 +16,11 @@
 #include "rtc_base/system/arch.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
+#if defined(WEBRTC_DESKTOP_CAPTURE_DIFFER_AVX2)
+#include "modules/desktop_capture/differ_vector_avx2.h"
+#include "third_party/libyuv/include/libyuv/cpu_id.h"
+#endif
+
 namespace webrtc {
 
 namespace {
@@ -44,6 +49,17 @@ bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
     } else {
       diff_proc = &VectorDifference_C;
     }
+#if defined(WEBRTC_DESKTOP_CAPTURE_DIFFER_AVX2)
+    // Prefer AVX2 when it is available. Unlike cpu_features_wrapper, libyuv
+    // also checks that the OS saves the AVX registers.
+    if (libyuv::TestCpuFlag(libyuv::kCpuHasAVX2)) {
+      if (kBlockSize == 32) {
+        diff_proc = &VectorDifference_AVX2_W32;
+      } else if (kBlockSize == 16) {
+        diff_proc = &VectorDifference_AVX2_W16;
+      }
+    }
+#endif
 #endif
   }
 
@@ -86,4 +86,19 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+// Every byte of a vector has to be compared, whichever of the C, SSE2 or AVX2
+// versions is used.
+TEST(VectorDifferenceTestEveryByte, VectorDifference) {
+  uint8_t* block1;
+  uint8_t* block2;
+  PrepareBuffers(block1, block2);
+
+  for (int i = 0; i < kBlockSize * kBytesPerPixel; ++i) {
+    block2[i] += 1;
+    EXPECT_TRUE(VectorDifference(block1, block2)) << "byte " << i;
+    block2[i] -= 1;
+  }
+  EXPECT_FALSE(VectorDifference(block1, block2));
+}
+
 }  // namespace webrtc
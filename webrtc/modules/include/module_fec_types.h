@@ -29,6 +29,15 @@ struct FecProtectionParams {
   FecMaskType fec_mask_type;
 };
 
+// Erasure codes available for FlexFEC. |kXor| is the parity code of the
+// FlexFEC specification. |kReedSolomon| recovers any loss pattern of up to as
+// many packets as there are FEC packets, but is not part of the specification,
+// so it's only sent to receivers that signaled support for it.
+enum class FlexfecScheme {
+  kXor,
+  kReedSolomon,
+};
+
 }  // namespace webrtc
 
 #endif  // MODULES_INCLUDE_MODULE_FEC_TYPES_H_
@@ -27,6 +27,7 @@ namespace webrtc {
 namespace {
 // Time limit in milliseconds between packet bursts.
 const int64_t kDefaultMinPacketLimitMs = 5;
+const int64_t kDefaultBurstIntervalMs = 10;
 const int64_t kCongestedPacketIntervalMs = 500;
 const int64_t kPausedProcessIntervalMs = kCongestedPacketIntervalMs;
 const int64_t kMaxElapsedTimeMs = 2000;
@@ -47,6 +48,21 @@ bool IsEnabled(const WebRtcKeyValueConfig& field_trials,
 
 }  // namespace
 
+size_t PacedSender::PacketSender::TimeToSendPackets(
+    rtc::ArrayView<const QueuedPacket> packets,
+    const PacedPacketInfo& cluster_info) {
+  size_t packets_sent = 0;
+  for (const QueuedPacket& packet : packets) {
+    if (!TimeToSendPacket(packet.ssrc, packet.sequence_number,
+                          packet.capture_time_ms, packet.retransmission,
+                          cluster_info)) {
+      break;
+    }
+    ++packets_sent;
+  }
+  return packets_sent;
+}
+
 const int64_t PacedSender::kMaxQueueLengthMs = 2000;
 const float PacedSender::kDefaultPaceMultiplier = 2.5f;
 
@@ -74,6 +90,12 @@ PacedSender::PacedSender(Clock* clock,
           IsEnabled(field_trials, "WebRTC-Pacer-PadInSilence")),
       pace_audio_(!IsDisabled(field_trials, "WebRTC-Pacer-BlockAudio")),
       min_packet_limit_ms_("", kDefaultMinPacketLimitMs),
+      burst_mode_("Enabled"),
+      // The budget only builds up for kMaxIntervalTimeMs between runs.
+      burst_interval_ms_("interval_ms",
+                         kDefaultBurstIntervalMs,
+                         1,
+                         kMaxIntervalTimeMs),
       last_timestamp_ms_(clock_->TimeInMilliseconds()),
       paused_(false),
       media_budget_(0),
@@ -85,6 +107,7 @@ PacedSender::PacedSender(Clock* clock,
       max_padding_bitrate_kbps_(0u),
       pacing_bitrate_kbps_(0),
       time_last_process_us_(clock->TimeInMicroseconds()),
+      next_process_time_us_(time_last_process_us_),
       last_send_time_us_(clock->TimeInMicroseconds()),
       first_sent_packet_ms_(-1),
       packets_(clock->TimeInMicroseconds()),
@@ -98,6 +121,8 @@ PacedSender::PacedSender(Clock* clock,
   }
   ParseFieldTrial({&min_packet_limit_ms_},
                   field_trials.Lookup("WebRTC-Pacer-MinPacketLimitMs"));
+  ParseFieldTrial({&burst_mode_, &burst_interval_ms_},
+                  field_trials.Lookup("WebRTC-Pacer-BurstMode"));
   UpdateBudgetWithElapsedTime(min_packet_limit_ms_);
 }
 
@@ -149,9 +174,14 @@ void PacedSender::UpdateOutstandingData(int64_t outstanding_bytes) {
 }
 
 bool PacedSender::Congested() const {
+  return CongestedWith(0);
+}
+
+bool PacedSender::CongestedWith(size_t pending_bytes) const {
   if (congestion_window_bytes_ == kNoCongestionWindow)
     return false;
-  return outstanding_bytes_ >= congestion_window_bytes_;
+  return outstanding_bytes_ + static_cast<int64_t>(pending_bytes) >=
+         congestion_window_bytes_;
 }
 
 int64_t PacedSender::TimeMilliseconds() const {
@@ -279,8 +309,14 @@ int64_t PacedSender::QueueInMs() const {
 
 int64_t PacedSender::TimeUntilNextProcess() {
   rtc::CritScope cs(&critsect_);
-  int64_t elapsed_time_us =
-      clock_->TimeInMicroseconds() - time_last_process_us_;
+  int64_t now_us = clock_->TimeInMicroseconds();
+  int64_t time_until_next_ms = ComputeTimeUntilNextProcess(now_us);
+  next_process_time_us_ = now_us + time_until_next_ms * 1000;
+  return time_until_next_ms;
+}
+
+int64_t PacedSender::ComputeTimeUntilNextProcess(int64_t now_us) {
+  int64_t elapsed_time_us = now_us - time_last_process_us_;
   int64_t elapsed_time_ms = (elapsed_time_us + 500) / 1000;
   // When paused we wake up every 500 ms to send a padding packet to ensure
   // we won't get stuck in the paused state due to no feedback being received.
@@ -292,6 +328,14 @@ int64_t PacedSender::TimeUntilNextProcess() {
     if (ret > 0 || (ret == 0 && !probing_send_failure_))
       return ret;
   }
+  if (burst_mode_) {
+    // Timers fire late rather than early, so ask to run early by the delay
+    // seen so far, and round down, to keep bursts close to the interval.
+    int64_t slack_us = std::min<int64_t>(smoothed_process_delay_us_,
+                                         burst_interval_ms_ * 1000 / 2);
+    return std::max<int64_t>(
+        (burst_interval_ms_ * 1000 - elapsed_time_us - slack_us) / 1000, 0);
+  }
   return std::max<int64_t>(min_packet_limit_ms_ - elapsed_time_ms, 0);
 }
 
@@ -323,9 +367,23 @@ bool PacedSender::ShouldSendKeepalive(int64_t now_us) const {
   return false;
 }
 
+PacedSender::Stats PacedSender::GetStats() const {
+  rtc::CritScope cs(&critsect_);
+  return stats_;
+}
+
 void PacedSender::Process() {
   rtc::CritScope cs(&critsect_);
   int64_t now_us = clock_->TimeInMicroseconds();
+  int64_t process_delay_us = std::max<int64_t>(now_us - next_process_time_us_,
+                                               0);
+  smoothed_process_delay_us_ =
+      (7 * smoothed_process_delay_us_ + process_delay_us) / 8;
+  ++stats_.process_calls;
+  stats_.total_process_delay_us += process_delay_us;
+  stats_.max_process_delay_us =
+      std::max(stats_.max_process_delay_us, process_delay_us);
+
   int64_t elapsed_time_ms = UpdateTimeAndGetElapsedMs(now_us);
   if (ShouldSendKeepalive(now_us)) {
     critsect_.Leave();
@@ -372,28 +430,38 @@ void PacedSender::Process() {
     pacing_info = prober_.CurrentCluster();
     recommended_probe_size = prober_.RecommendedMinProbeSize();
   }
-  // The paused state is checked in the loop since it leaves the critical
-  // section allowing the paused state to be changed from other code.
-  while (!packets_.Empty() && !paused_) {
-    const auto* packet = GetPendingPacket(pacing_info);
-    if (packet == nullptr)
-      break;
+  if (burst_mode_) {
+    bytes_sent = SendBurst(pacing_info, is_probing, recommended_probe_size);
+  } else {
+    // The paused state is checked in the loop since it leaves the critical
+    // section allowing the paused state to be changed from other code.
+    int64_t packets_sent = 0;
+    while (!packets_.Empty() && !paused_) {
+      const auto* packet = GetPendingPacket(pacing_info, 0);
+      if (packet == nullptr)
+        break;
 
-    critsect_.Leave();
-    bool success = packet_sender_->TimeToSendPacket(
-        packet->ssrc, packet->sequence_number, packet->capture_time_ms,
-        packet->retransmission, pacing_info);
-    critsect_.Enter();
-    if (success) {
-      bytes_sent += packet->bytes;
-      // Send succeeded, remove it from the queue.
-      OnPacketSent(packet);
-      if (is_probing && bytes_sent > recommended_probe_size)
+      critsect_.Leave();
+      bool success = packet_sender_->TimeToSendPacket(
+          packet->ssrc, packet->sequence_number, packet->capture_time_ms,
+          packet->retransmission, pacing_info);
+      critsect_.Enter();
+      if (success) {
+        bytes_sent += packet->bytes;
+        ++packets_sent;
+        // Send succeeded, remove it from the queue.
+        OnPacketSent(packet);
+        if (is_probing && bytes_sent > recommended_probe_size)
+          break;
+      } else {
+        // Send failed, put it back into the queue.
+        packets_.CancelPop(*packet);
         break;
-    } else {
-      // Send failed, put it back into the queue.
-      packets_.CancelPop(*packet);
-      break;
+      }
+    }
+    if (packets_sent > 0) {
+      ++stats_.bursts;
+      stats_.burst_packets += packets_sent;
     }
   }
 
@@ -430,37 +498,100 @@ void PacedSender::ProcessThreadAttached(ProcessThread* process_thread) {
 }
 
 const RoundRobinPacketQueue::Packet* PacedSender::GetPendingPacket(
-    const PacedPacketInfo& pacing_info) {
+    const PacedPacketInfo& pacing_info,
+    size_t pending_bytes) {
   // Since we need to release the lock in order to send, we first pop the
   // element from the priority queue but keep it in storage, so that we can
   // reinsert it if send fails.
   const RoundRobinPacketQueue::Packet* packet = &packets_.BeginPop();
   bool audio_packet = packet->priority == kHighPriority;
   bool apply_pacing = !audio_packet || pace_audio_;
-  if (apply_pacing && (Congested() || (media_budget_.bytes_remaining() == 0 &&
-                                       pacing_info.probe_cluster_id ==
-                                           PacedPacketInfo::kNotAProbe))) {
+  if (apply_pacing &&
+      (CongestedWith(pending_bytes) ||
+       (media_budget_.bytes_remaining() <= pending_bytes &&
+        pacing_info.probe_cluster_id == PacedPacketInfo::kNotAProbe))) {
     packets_.CancelPop(*packet);
     return nullptr;
   }
   return packet;
 }
 
+size_t PacedSender::SendBurst(const PacedPacketInfo& pacing_info,
+                              bool is_probing,
+                              size_t recommended_probe_size) {
+  // Only one packet can be popped at a time, so the packets of the burst are
+  // removed from the queue as they are picked, and put back if not sent. The
+  // budget is used once they have been sent.
+  burst_packets_.clear();
+  burst_.clear();
+  size_t pending_bytes = 0;
+  size_t burst_bytes = 0;
+  while (!packets_.Empty()) {
+    const auto* packet = GetPendingPacket(pacing_info, pending_bytes);
+    if (packet == nullptr)
+      break;
+    burst_packets_.push_back(*packet);
+    burst_.push_back({packet->ssrc, packet->sequence_number,
+                      packet->capture_time_ms, packet->retransmission});
+    if (UsesBudget(*packet))
+      pending_bytes += packet->bytes;
+    burst_bytes += packet->bytes;
+    packets_.FinalizePop(*packet);
+    if (is_probing && burst_bytes > recommended_probe_size)
+      break;
+  }
+  if (burst_.empty())
+    return 0;
+
+  critsect_.Leave();
+  size_t packets_sent = packet_sender_->TimeToSendPackets(burst_, pacing_info);
+  critsect_.Enter();
+  RTC_DCHECK_LE(packets_sent, burst_.size());
+
+  size_t bytes_sent = 0;
+  for (size_t i = 0; i < burst_packets_.size(); ++i) {
+    const RoundRobinPacketQueue::Packet& packet = burst_packets_[i];
+    if (i < packets_sent) {
+      bytes_sent += packet.bytes;
+      UpdateBudgetWithPacketSent(packet);
+    } else {
+      // Put back the packets that weren't sent, keeping their order and their
+      // time in the queue.
+      packets_.Reinsert(packet);
+    }
+  }
+  if (packets_sent > 0) {
+    ++stats_.bursts;
+    stats_.burst_packets += packets_sent;
+  }
+  return bytes_sent;
+}
+
+bool PacedSender::UsesBudget(
+    const RoundRobinPacketQueue::Packet& packet) const {
+  bool audio_packet = packet.priority == kHighPriority;
+  return !audio_packet || account_for_audio_;
+}
+
 void PacedSender::OnPacketSent(const RoundRobinPacketQueue::Packet* packet) {
+  UpdateBudgetWithPacketSent(*packet);
+  // Send succeeded, remove it from the queue.
+  packets_.FinalizePop(*packet);
+}
+
+void PacedSender::UpdateBudgetWithPacketSent(
+    const RoundRobinPacketQueue::Packet& packet) {
   if (first_sent_packet_ms_ == -1)
     first_sent_packet_ms_ = TimeMilliseconds();
-  bool audio_packet = packet->priority == kHighPriority;
-  if (!audio_packet || account_for_audio_) {
+  if (UsesBudget(packet)) {
     // Update media bytes sent.
     // TODO(eladalon): TimeToSendPacket() can also return |true| in some
     // situations where nothing actually ended up being sent to the network,
     // and we probably don't want to update the budget in such cases.
     // https://bugs.chromium.org/p/webrtc/issues/detail?id=8052
-    UpdateBudgetWithBytesSent(packet->bytes);
+    UpdateBudgetWithBytesSent(packet.bytes);
     last_send_time_us_ = clock_->TimeInMicroseconds();
   }
-  // Send succeeded, remove it from the queue.
-  packets_.FinalizePop(*packet);
 }
 
 void PacedSender::OnPaddingSent(size_t bytes_sent) {
@@ -15,8 +15,10 @@
 #include <stdint.h>
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/transport/field_trial_based_config.h"
 #include "api/transport/network_types.h"
 #include "api/transport/webrtc_key_value_config.h"
@@ -40,6 +42,13 @@ class PacedSender : public Pacer {
  public:
   class PacketSender {
    public:
+    struct QueuedPacket {
+      uint32_t ssrc;
+      uint16_t sequence_number;
+      int64_t capture_time_ms;
+      bool retransmission;
+    };
+
     // Note: packets sent as a result of a callback should not pass by this
     // module again.
     // Called when it's time to send a queued packet.
@@ -49,6 +58,12 @@ class PacedSender : public Pacer {
                                   int64_t capture_time_ms,
                                   bool retransmission,
                                   const PacedPacketInfo& cluster_info) = 0;
+    // Called in burst mode with the queued packets to send back to back, in
+    // send order. Returns the number of packets sent from the start of
+    // |packets|, stopping at the first one that cannot be sent. The default
+    // implementation calls TimeToSendPacket() for each packet.
+    virtual size_t TimeToSendPackets(rtc::ArrayView<const QueuedPacket> packets,
+                                     const PacedPacketInfo& cluster_info);
     // Called when it's a good time to send a padding data.
     // Returns the number of bytes sent.
     virtual size_t TimeToSendPadding(size_t bytes,
@@ -71,6 +86,19 @@ class PacedSender : public Pacer {
   // overshoots from the encoder.
   static const float kDefaultPaceMultiplier;
 
+  // How closely Process() follows the schedule set by TimeUntilNextProcess(),
+  // and how many packets it sends at a time.
+  struct Stats {
+    int64_t process_calls = 0;
+    // Time by which Process() ran later than requested, summed over all
+    // calls and the largest seen.
+    int64_t total_process_delay_us = 0;
+    int64_t max_process_delay_us = 0;
+    // Number of Process() calls that sent media packets, and their total.
+    int64_t bursts = 0;
+    int64_t burst_packets = 0;
+  };
+
   PacedSender(Clock* clock,
               PacketSender* packet_sender,
               RtcEventLog* event_log,
@@ -143,6 +171,8 @@ class PacedSender : public Pacer {
   // Process any pending packets in the queue(s).
   void Process() override;
 
+  Stats GetStats() const;
+
   // Called when the prober is associated with a process thread.
   void ProcessThreadAttached(ProcessThread* process_thread) override;
   // Deprecated, SetPacingRates should be used instead.
@@ -155,6 +185,8 @@ class PacedSender : public Pacer {
               RtcEventLog* event_log,
               const WebRtcKeyValueConfig& field_trials);
 
+  int64_t ComputeTimeUntilNextProcess(int64_t now_us)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   int64_t UpdateTimeAndGetElapsedMs(int64_t now_us)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   bool ShouldSendKeepalive(int64_t at_time_us) const
@@ -166,15 +198,29 @@ class PacedSender : public Pacer {
   void UpdateBudgetWithBytesSent(size_t bytes)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
+  // |pending_bytes| is the budget taken by packets picked for the current
+  // burst that haven't been sent yet.
   const RoundRobinPacketQueue::Packet* GetPendingPacket(
-      const PacedPacketInfo& pacing_info)
+      const PacedPacketInfo& pacing_info,
+      size_t pending_bytes) RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  // Sends the packets the budget allows for as one batch, with the lock
+  // released. Returns the number of bytes sent.
+  size_t SendBurst(const PacedPacketInfo& pacing_info,
+                   bool is_probing,
+                   size_t recommended_probe_size)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  bool UsesBudget(const RoundRobinPacketQueue::Packet& packet) const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void OnPacketSent(const RoundRobinPacketQueue::Packet* packet)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void UpdateBudgetWithPacketSent(const RoundRobinPacketQueue::Packet& packet)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void OnPaddingSent(size_t padding_sent)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   bool Congested() const RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  bool CongestedWith(size_t pending_bytes) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   int64_t TimeMilliseconds() const RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   Clock* const clock_;
@@ -185,6 +231,10 @@ class PacedSender : public Pacer {
   const bool send_padding_if_silent_;
   const bool pace_audio_;
   FieldTrialParameter<int> min_packet_limit_ms_;
+  // In burst mode, Process() runs every |burst_interval_ms_| and releases the
+  // budget built up since the last run as one batch.
+  FieldTrialFlag burst_mode_;
+  FieldTrialConstrained<int> burst_interval_ms_;
 
   rtc::CriticalSection critsect_;
   // TODO(webrtc:9716): Remove this when we are certain clocks are monotonic.
@@ -209,11 +259,20 @@ class PacedSender : public Pacer {
   uint32_t pacing_bitrate_kbps_ RTC_GUARDED_BY(critsect_);
 
   int64_t time_last_process_us_ RTC_GUARDED_BY(critsect_);
+  // When Process() was last asked to run by TimeUntilNextProcess().
+  int64_t next_process_time_us_ RTC_GUARDED_BY(critsect_);
+  // Smoothed delay of Process() compared to |next_process_time_us_|. Burst
+  // mode asks to run that much earlier to make up for timer slack.
+  int64_t smoothed_process_delay_us_ RTC_GUARDED_BY(critsect_) = 0;
+  Stats stats_ RTC_GUARDED_BY(critsect_);
   int64_t last_send_time_us_ RTC_GUARDED_BY(critsect_);
   int64_t first_sent_packet_ms_ RTC_GUARDED_BY(critsect_);
 
   RoundRobinPacketQueue packets_ RTC_GUARDED_BY(critsect_);
   uint64_t packet_counter_ RTC_GUARDED_BY(critsect_);
+  // The burst being sent. Only used from Process(), kept to reuse capacity.
+  std::vector<RoundRobinPacketQueue::Packet> burst_packets_;
+  std::vector<PacketSender::QueuedPacket> burst_;
 
   int64_t congestion_window_bytes_ RTC_GUARDED_BY(critsect_) =
       kNoCongestionWindow;
@@ -8,9 +8,11 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "modules/pacing/paced_sender.h"
 #include "system_wrappers/include/clock.h"
@@ -106,6 +108,42 @@ class PacedSenderProbing : public PacedSender::PacketSender {
   int padding_sent_;
 };
 
+class PacedSenderBursts : public PacedSender::PacketSender {
+ public:
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission,
+                        const PacedPacketInfo& pacing_info) override {
+    if (sent_sequence_numbers_.size() >= max_packets_)
+      return false;
+    sent_sequence_numbers_.push_back(sequence_number);
+    return true;
+  }
+
+  size_t TimeToSendPackets(rtc::ArrayView<const QueuedPacket> packets,
+                           const PacedPacketInfo& pacing_info) override {
+    burst_sizes_.push_back(packets.size());
+    return PacedSender::PacketSender::TimeToSendPackets(packets, pacing_info);
+  }
+
+  size_t TimeToSendPadding(size_t bytes,
+                           const PacedPacketInfo& pacing_info) override {
+    return 0;
+  }
+
+  void set_max_packets(size_t max_packets) { max_packets_ = max_packets; }
+  const std::vector<uint16_t>& sent_sequence_numbers() const {
+    return sent_sequence_numbers_;
+  }
+  const std::vector<size_t>& burst_sizes() const { return burst_sizes_; }
+
+ private:
+  size_t max_packets_ = std::numeric_limits<size_t>::max();
+  std::vector<uint16_t> sent_sequence_numbers_;
+  std::vector<size_t> burst_sizes_;
+};
+
 class PacedSenderTest : public testing::TestWithParam<std::string> {
  protected:
   PacedSenderTest() : clock_(123456) {
@@ -274,6 +312,95 @@ TEST_F(PacedSenderFieldTrialTest, BudgetDoesNotAffectAudioInTrial) {
   ProcessNext(&pacer);
 }
 
+TEST_F(PacedSenderFieldTrialTest, BurstModeSendsBudgetOncePerInterval) {
+  ScopedFieldTrials trial("WebRTC-Pacer-BurstMode/Enabled,interval_ms:10/");
+  PacedSenderBursts sender;
+  PacedSender pacer(&clock_, &sender, nullptr);
+  // 1000 bytes, four packets, per 10 ms.
+  pacer.SetPacingRates(800000, 0);
+  for (int i = 0; i < 20; ++i) {
+    pacer.InsertPacket(PacedSender::kNormalPriority, video.ssrc, i,
+                       clock_.TimeInMilliseconds(), 250, false);
+  }
+  EXPECT_EQ(10, pacer.TimeUntilNextProcess());
+  clock_.AdvanceTimeMilliseconds(10);
+  pacer.Process();
+  EXPECT_EQ(std::vector<size_t>({4}), sender.burst_sizes());
+
+  // Running 2 ms late builds up more budget, and makes the pacer ask to run
+  // a bit early next time.
+  EXPECT_EQ(10, pacer.TimeUntilNextProcess());
+  clock_.AdvanceTimeMilliseconds(12);
+  pacer.Process();
+  EXPECT_EQ(std::vector<size_t>({4, 5}), sender.burst_sizes());
+  EXPECT_EQ(9, pacer.TimeUntilNextProcess());
+
+  PacedSender::Stats stats = pacer.GetStats();
+  EXPECT_EQ(2, stats.process_calls);
+  EXPECT_EQ(2000, stats.total_process_delay_us);
+  EXPECT_EQ(2000, stats.max_process_delay_us);
+  EXPECT_EQ(2, stats.bursts);
+  EXPECT_EQ(9, stats.burst_packets);
+}
+
+TEST_F(PacedSenderFieldTrialTest, BurstModeRequeuesUnsentPackets) {
+  ScopedFieldTrials trial("WebRTC-Pacer-BurstMode/Enabled,interval_ms:10/");
+  PacedSenderBursts sender;
+  PacedSender pacer(&clock_, &sender, nullptr);
+  pacer.SetPacingRates(800000, 0);
+  for (int i = 0; i < 4; ++i) {
+    pacer.InsertPacket(PacedSender::kNormalPriority, video.ssrc, i,
+                       clock_.TimeInMilliseconds(), 250, false);
+  }
+  sender.set_max_packets(2);
+  clock_.AdvanceTimeMilliseconds(10);
+  pacer.Process();
+  EXPECT_EQ(2u, pacer.QueueSizePackets());
+
+  sender.set_max_packets(4);
+  clock_.AdvanceTimeMilliseconds(10);
+  pacer.Process();
+  EXPECT_EQ(0u, pacer.QueueSizePackets());
+  EXPECT_EQ(std::vector<uint16_t>({0, 1, 2, 3}),
+            sender.sent_sequence_numbers());
+  EXPECT_EQ(std::vector<size_t>({4, 2}), sender.burst_sizes());
+}
+
+TEST_F(PacedSenderFieldTrialTest, BurstModeUnsentPacketsKeepQueueTime) {
+  ScopedFieldTrials trial("WebRTC-Pacer-BurstMode/Enabled,interval_ms:10/");
+  PacedSenderBursts sender;
+  PacedSender pacer(&clock_, &sender, nullptr);
+  pacer.SetProbingEnabled(false);
+  pacer.SetPacingRates(800000, 0);
+  pacer.SetQueueTimeLimit(450);
+  for (int i = 0; i < 10; ++i) {
+    pacer.InsertPacket(PacedSender::kNormalPriority, video.ssrc, i,
+                       clock_.TimeInMilliseconds(), 100, false);
+  }
+
+  // The whole queue fits in every burst, but no packet gets sent, so all of
+  // them are put back each time.
+  sender.set_max_packets(0);
+  for (int i = 0; i < 40; ++i) {
+    clock_.AdvanceTimeMilliseconds(10);
+    pacer.Process();
+  }
+  EXPECT_EQ(std::vector<size_t>(40, 10), sender.burst_sizes());
+  EXPECT_EQ(10u, pacer.QueueSizePackets());
+  EXPECT_EQ(400, pacer.QueueInMs());
+  EXPECT_EQ(10, pacer.ExpectedQueueTimeMs());
+
+  // At 80 kbps the queue needs 100 ms. With 410 ms of the 450 ms queue time
+  // limit used, it has to drain at 200 kbps, which is 250 bytes in the next
+  // 10 ms instead of 100.
+  pacer.SetPacingRates(80000, 0);
+  EXPECT_EQ(100, pacer.ExpectedQueueTimeMs());
+  sender.set_max_packets(std::numeric_limits<size_t>::max());
+  clock_.AdvanceTimeMilliseconds(10);
+  pacer.Process();
+  EXPECT_EQ(std::vector<uint16_t>({0, 1, 2}), sender.sent_sequence_numbers());
+}
+
 TEST_F(PacedSenderTest, FirstSentPacketTimeIsSet) {
   uint16_t sequence_number = 1234;
   const uint32_t kSsrc = 12345;
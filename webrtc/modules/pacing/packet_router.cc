@@ -105,6 +105,31 @@ bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
                                     bool retransmission,
                                     const PacedPacketInfo& pacing_info) {
   rtc::CritScope cs(&modules_crit_);
+  return SendPacket(ssrc, sequence_number, capture_timestamp, retransmission,
+                    pacing_info);
+}
+
+size_t PacketRouter::TimeToSendPackets(
+    rtc::ArrayView<const QueuedPacket> packets,
+    const PacedPacketInfo& pacing_info) {
+  size_t packets_sent = 0;
+  rtc::CritScope cs(&modules_crit_);
+  for (const QueuedPacket& packet : packets) {
+    if (!SendPacket(packet.ssrc, packet.sequence_number,
+                    packet.capture_time_ms, packet.retransmission,
+                    pacing_info)) {
+      break;
+    }
+    ++packets_sent;
+  }
+  return packets_sent;
+}
+
+bool PacketRouter::SendPacket(uint32_t ssrc,
+                              uint16_t sequence_number,
+                              int64_t capture_timestamp,
+                              bool retransmission,
+                              const PacedPacketInfo& pacing_info) {
   for (auto* rtp_module : rtp_send_modules_) {
     if (!rtp_module->SendingMedia()) {
       continue;
@@ -16,6 +16,7 @@
 #include <list>
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/transport/network_types.h"
 #include "modules/pacing/paced_sender.h"
 #include "modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
@@ -57,6 +58,9 @@ class PacketRouter : public PacedSender::PacketSender,
                         int64_t capture_timestamp,
                         bool retransmission,
                         const PacedPacketInfo& packet_info) override;
+  // Sends the whole burst with the module list locked once.
+  size_t TimeToSendPackets(rtc::ArrayView<const QueuedPacket> packets,
+                           const PacedPacketInfo& packet_info) override;
 
   size_t TimeToSendPadding(size_t bytes,
                            const PacedPacketInfo& packet_info) override;
@@ -83,6 +87,12 @@ class PacketRouter : public PacedSender::PacketSender,
   bool SendTransportFeedback(rtcp::TransportFeedback* packet) override;
 
  private:
+  bool SendPacket(uint32_t ssrc,
+                  uint16_t sequence_number,
+                  int64_t capture_timestamp,
+                  bool retransmission,
+                  const PacedPacketInfo& packet_info)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(modules_crit_);
   void AddRembModuleCandidate(RtcpFeedbackSenderInterface* candidate_module,
                               bool media_sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(modules_crit_);
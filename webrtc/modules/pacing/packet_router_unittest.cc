@@ -175,6 +175,38 @@ TEST(PacketRouterTest, TimeToSendPacket) {
   packet_router.RemoveSendRtpModule(&rtp_2);
 }
 
+TEST(PacketRouterTest, TimeToSendPacketsStopsAtFirstFailure) {
+  PacketRouter packet_router;
+  NiceMock<MockRtpRtcp> rtp_1;
+  NiceMock<MockRtpRtcp> rtp_2;
+  const uint32_t kSsrc1 = 1234;
+  const uint32_t kSsrc2 = 4567;
+  ON_CALL(rtp_1, SendingMedia()).WillByDefault(Return(true));
+  ON_CALL(rtp_1, SSRC()).WillByDefault(Return(kSsrc1));
+  ON_CALL(rtp_2, SendingMedia()).WillByDefault(Return(true));
+  ON_CALL(rtp_2, SSRC()).WillByDefault(Return(kSsrc2));
+  packet_router.AddSendRtpModule(&rtp_1, false);
+  packet_router.AddSendRtpModule(&rtp_2, false);
+
+  const PacedSender::PacketSender::QueuedPacket kPackets[] = {
+      {kSsrc1, 1, 1000, false},
+      {kSsrc2, 2, 1000, true},
+      {kSsrc1, 3, 1010, false},
+      {kSsrc2, 4, 1010, false}};
+  testing::InSequence s;
+  EXPECT_CALL(rtp_1, TimeToSendPacket(kSsrc1, 1, 1000, false, _))
+      .WillOnce(Return(true));
+  EXPECT_CALL(rtp_2, TimeToSendPacket(kSsrc2, 2, 1000, true, _))
+      .WillOnce(Return(true));
+  EXPECT_CALL(rtp_1, TimeToSendPacket(kSsrc1, 3, 1010, false, _))
+      .WillOnce(Return(false));
+  EXPECT_CALL(rtp_2, TimeToSendPacket(_, 4, _, _, _)).Times(0);
+  EXPECT_EQ(2u, packet_router.TimeToSendPackets(kPackets, PacedPacketInfo()));
+
+  packet_router.RemoveSendRtpModule(&rtp_1);
+  packet_router.RemoveSendRtpModule(&rtp_2);
+}
+
 TEST(PacketRouterTest, TimeToSendPadding) {
   PacketRouter packet_router;
 
@@ -95,6 +95,7 @@ void RoundRobinPacketQueue::Push(const Packet& packet_to_insert) {
   // subtract the total amount of time the packet has spent in the queue while
   // in a paused state.
   UpdateQueueTime(packet.enqueue_time_ms);
+  packet.sum_paused_ms = pause_time_sum_ms_;
   packet.enqueue_time_ms -= pause_time_sum_ms_;
   streams_->packet_queue.push(packet);
 
@@ -168,6 +169,39 @@ void RoundRobinPacketQueue::FinalizePop(const Packet& packet) {
   }
 }
 
+void RoundRobinPacketQueue::Reinsert(const Packet& packet_to_insert) {
+  RTC_CHECK(!pop_packet_);
+  Packet packet(packet_to_insert);
+
+  auto stream_info_it = streams_.find(packet.ssrc);
+  RTC_CHECK(stream_info_it != streams_.end());
+  Stream* stream = &stream_info_it->second;
+
+  // Give back the bytes FinalizePop() charged the stream for, so that it
+  // keeps its place in the round robin.
+  stream->bytes -= std::min(stream->bytes, packet.bytes);
+
+  RtpPacketSender::Priority priority = packet.priority;
+  if (stream->priority_it != stream_priorities_.end()) {
+    priority = std::min(priority, stream->priority_it->first.priority);
+    stream_priorities_.erase(stream->priority_it);
+  }
+  stream->priority_it = stream_priorities_.emplace(
+      StreamPrioKey(priority, stream->bytes), packet.ssrc);
+
+  // |enqueue_time_ms| already has the pause time before the packet was pushed
+  // subtracted, so the packet counts the time spent in the queue and in the
+  // send attempt, as if it had never been removed.
+  packet.enqueue_time_it =
+      enqueue_times_.insert(packet.enqueue_time_ms + packet.sum_paused_ms);
+  queue_time_sum_ms_ +=
+      time_last_updated_ms_ - packet.enqueue_time_ms - pause_time_sum_ms_;
+  stream->packet_queue.push(packet);
+
+  size_packets_ += 1;
+  size_bytes_ += packet.bytes;
+}
+
 bool RoundRobinPacketQueue::Empty() const {
   RTC_CHECK((!stream_priorities_.empty() && size_packets_ > 0) ||
             (stream_priorities_.empty() && size_packets_ == 0));
@@ -47,7 +47,7 @@ class RoundRobinPacketQueue {
     uint16_t sequence_number;
     int64_t capture_time_ms;  // Absolute time of frame capture.
     int64_t enqueue_time_ms;  // Absolute time of pacer queue entry.
-    int64_t sum_paused_ms;
+    int64_t sum_paused_ms;  // Queue pause time before entry.
     size_t bytes;
     bool retransmission;
     uint64_t enqueue_order;
@@ -59,6 +59,9 @@ class RoundRobinPacketQueue {
   const Packet& BeginPop();
   void CancelPop(const Packet& packet);
   void FinalizePop(const Packet& packet);
+  // Puts back a packet that was removed with FinalizePop() but not sent,
+  // undoing the accounting done there. The packet keeps its time in the queue.
+  void Reinsert(const Packet& packet);
 
   bool Empty() const;
   size_t SizeInPackets() const;
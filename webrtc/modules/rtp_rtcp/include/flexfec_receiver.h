@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <memory>
 
+#include "modules/include/module_fec_types.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/include/ulpfec_receiver.h"
 #include "modules/rtp_rtcp/source/forward_error_correction.h"
@@ -34,6 +35,14 @@ class FlexfecReceiver {
                   uint32_t ssrc,
                   uint32_t protected_media_ssrc,
                   RecoveredPacketReceiver* recovered_packet_receiver);
+  // |scheme| is the erasure code that the receiver signaled support for.
+  // Packets coded with the XOR scheme are decoded in either case, as the
+  // sender is not required to use the Reed-Solomon scheme.
+  FlexfecReceiver(Clock* clock,
+                  uint32_t ssrc,
+                  uint32_t protected_media_ssrc,
+                  FlexfecScheme scheme,
+                  RecoveredPacketReceiver* recovered_packet_receiver);
   ~FlexfecReceiver();
 
   // Inserts a received packet (can be either media or FlexFEC) into the
@@ -52,6 +61,11 @@ class FlexfecReceiver {
       const ForwardErrorCorrection::ReceivedPacket& received_packet);
 
  private:
+  void DecodeAndReturnRecoveredPackets(
+      ForwardErrorCorrection* erasure_code,
+      const ForwardErrorCorrection::ReceivedPacket& received_packet,
+      ForwardErrorCorrection::RecoveredPacketList* recovered_packets);
+
   // Config.
   const uint32_t ssrc_;
   const uint32_t protected_media_ssrc_;
@@ -61,6 +75,11 @@ class FlexfecReceiver {
       RTC_GUARDED_BY(sequence_checker_);
   ForwardErrorCorrection::RecoveredPacketList recovered_packets_
       RTC_GUARDED_BY(sequence_checker_);
+  // Only set if the Reed-Solomon scheme is supported.
+  std::unique_ptr<ForwardErrorCorrection> reed_solomon_erasure_code_
+      RTC_GUARDED_BY(sequence_checker_);
+  ForwardErrorCorrection::RecoveredPacketList reed_solomon_recovered_packets_
+      RTC_GUARDED_BY(sequence_checker_);
   RecoveredPacketReceiver* const recovered_packet_receiver_;
 
   // Logging and stats.
@@ -17,6 +17,7 @@
 
 #include "api/array_view.h"
 #include "modules/include/module_common_types.h"
+#include "modules/include/module_fec_types.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtp_header_extension_size.h"
@@ -41,6 +42,16 @@ class FlexfecSender {
                 rtc::ArrayView<const RtpExtensionSize> extension_sizes,
                 const RtpState* rtp_state,
                 Clock* clock);
+  // |scheme| selects the erasure code, which the receiver must agree on.
+  FlexfecSender(int payload_type,
+                uint32_t ssrc,
+                uint32_t protected_media_ssrc,
+                const std::string& mid,
+                const std::vector<RtpExtension>& rtp_header_extensions,
+                rtc::ArrayView<const RtpExtensionSize> extension_sizes,
+                const RtpState* rtp_state,
+                Clock* clock,
+                FlexfecScheme scheme);
   ~FlexfecSender();
 
   uint32_t ssrc() const { return ssrc_; }
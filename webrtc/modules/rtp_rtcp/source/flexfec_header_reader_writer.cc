@@ -106,6 +106,12 @@ bool FlexfecHeaderReader::ReadFecHeader(
            "yet support this, thus discarding packet.";
     return false;
   }
+  if (!HasValidReservedBytes(*fec_packet->pkt)) {
+    RTC_LOG(LS_INFO)
+        << "FlexFEC packet with unexpected reserved bytes, which means that "
+           "it was made by another erasure code. Discarding packet.";
+    return false;
+  }
   uint32_t protected_ssrc =
       ByteReader<uint32_t>::ReadBigEndian(&fec_packet->pkt->data[12]);
   uint16_t seq_num_base =
@@ -203,6 +209,12 @@ bool FlexfecHeaderReader::ReadFecHeader(
   return true;
 }
 
+bool FlexfecHeaderReader::HasValidReservedBytes(
+    const ForwardErrorCorrection::Packet& fec_packet) const {
+  return ByteReader<uint32_t, 3>::ReadBigEndian(&fec_packet.data[9]) ==
+         kReservedBits;
+}
+
 FlexfecHeaderWriter::FlexfecHeaderWriter()
     : FecHeaderWriter(kMaxMediaPackets, kMaxFecPackets, kHeaderSizes[2]) {}
 
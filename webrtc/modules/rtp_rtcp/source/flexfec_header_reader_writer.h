@@ -63,6 +63,13 @@ class FlexfecHeaderReader : public FecHeaderReader {
 
   bool ReadFecHeader(
       ForwardErrorCorrection::ReceivedFecPacket* fec_packet) const override;
+
+ protected:
+  // Returns true if the reserved bytes of |fec_packet| hold what this reader
+  // expects. They must be zero according to the FlexFEC specification, so
+  // packets using them are discarded, as some other erasure code made them.
+  virtual bool HasValidReservedBytes(
+      const ForwardErrorCorrection::Packet& fec_packet) const;
 };
 
 class FlexfecHeaderWriter : public FecHeaderWriter {
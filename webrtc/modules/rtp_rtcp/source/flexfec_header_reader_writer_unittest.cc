@@ -324,6 +324,21 @@ TEST(FlexfecHeaderReaderTest, ReadShortPacketWithKBit2SetShouldFail) {
   EXPECT_FALSE(reader.ReadFecHeader(&read_packet));
 }
 
+TEST(FlexfecHeaderReaderTest, ReadPacketWithReservedBitsSetShouldFail) {
+  const size_t packet_mask_size = kUlpfecPacketMaskSizeLBitClear;
+  auto packet_mask = GeneratePacketMask(packet_mask_size, 0xabcd);
+  auto written_packet = WriteHeader(packet_mask.get(), packet_mask_size);
+
+  // Simulate a packet of another erasure code, which uses the reserved bytes.
+  ReceivedFecPacket read_packet;
+  read_packet.ssrc = kFlexfecSsrc;
+  read_packet.pkt = std::move(written_packet);
+  read_packet.pkt->data[10] = 0x01;
+
+  FlexfecHeaderReader reader;
+  EXPECT_FALSE(reader.ReadFecHeader(&read_packet));
+}
+
 TEST(FlexfecHeaderWriterTest, FinalizesHeaderWithKBit0Set) {
   constexpr size_t kExpectedPacketMaskSize = 2;
   constexpr uint8_t kFlexfecPacketMask[] = {0x88, 0x81};
@@ -14,6 +14,7 @@
 
 #include "api/array_view.h"
 #include "api/scoped_refptr.h"
+#include "modules/rtp_rtcp/source/reed_solomon_fec.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
@@ -46,10 +47,28 @@ FlexfecReceiver::FlexfecReceiver(
     uint32_t ssrc,
     uint32_t protected_media_ssrc,
     RecoveredPacketReceiver* recovered_packet_receiver)
+    : FlexfecReceiver(clock,
+                      ssrc,
+                      protected_media_ssrc,
+                      FlexfecScheme::kXor,
+                      recovered_packet_receiver) {}
+
+FlexfecReceiver::FlexfecReceiver(
+    Clock* clock,
+    uint32_t ssrc,
+    uint32_t protected_media_ssrc,
+    FlexfecScheme scheme,
+    RecoveredPacketReceiver* recovered_packet_receiver)
     : ssrc_(ssrc),
       protected_media_ssrc_(protected_media_ssrc),
       erasure_code_(
           ForwardErrorCorrection::CreateFlexfec(ssrc, protected_media_ssrc)),
+      reed_solomon_erasure_code_(
+          scheme == FlexfecScheme::kReedSolomon
+              ? ForwardErrorCorrection::CreateFlexfec(ssrc,
+                                                      protected_media_ssrc,
+                                                      scheme)
+              : nullptr),
       recovered_packet_receiver_(recovered_packet_receiver),
       clock_(clock),
       last_recovered_packet_ms_(-1) {
@@ -147,11 +166,40 @@ void FlexfecReceiver::ProcessReceivedPacket(
     const ReceivedPacket& received_packet) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequence_checker_);
 
+  if (!reed_solomon_erasure_code_) {
+    DecodeAndReturnRecoveredPackets(erasure_code_.get(), received_packet,
+                                    &recovered_packets_);
+    return;
+  }
+
+  // FEC packets go to the erasure code of their scheme. Media packets go to
+  // both, since the sender may switch schemes. A media packet that both
+  // recover is returned twice, which the media receiver ignores.
+  const bool is_reed_solomon_coded =
+      received_packet.is_fec &&
+      ReedSolomonFec::IsReedSolomonCoded(*received_packet.pkt);
+  if (!received_packet.is_fec || is_reed_solomon_coded) {
+    DecodeAndReturnRecoveredPackets(reed_solomon_erasure_code_.get(),
+                                    received_packet,
+                                    &reed_solomon_recovered_packets_);
+  }
+  if (!is_reed_solomon_coded) {
+    DecodeAndReturnRecoveredPackets(erasure_code_.get(), received_packet,
+                                    &recovered_packets_);
+  }
+}
+
+void FlexfecReceiver::DecodeAndReturnRecoveredPackets(
+    ForwardErrorCorrection* erasure_code,
+    const ReceivedPacket& received_packet,
+    ForwardErrorCorrection::RecoveredPacketList* recovered_packets) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequence_checker_);
+
   // Decode.
-  erasure_code_->DecodeFec(received_packet, &recovered_packets_);
+  erasure_code->DecodeFec(received_packet, recovered_packets);
 
   // Return recovered packets through callback.
-  for (const auto& recovered_packet : recovered_packets_) {
+  for (const auto& recovered_packet : *recovered_packets) {
     RTC_CHECK(recovered_packet);
     if (recovered_packet->returned) {
       continue;
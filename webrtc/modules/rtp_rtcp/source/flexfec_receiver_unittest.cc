@@ -646,4 +646,85 @@ TEST_F(FlexfecReceiverTest, CalculatesNumberOfPackets) {
   EXPECT_EQ(1U, packet_counter.num_recovered_packets);
 }
 
+TEST_F(FlexfecReceiverTest, RecoversReedSolomonCodedPackets) {
+  const size_t kNumMediaPackets = 3;
+  const size_t kNumFecPackets = 2;
+  FlexfecReceiver receiver(Clock::GetRealTimeClock(), kFlexfecSsrc, kMediaSsrc,
+                           FlexfecScheme::kReedSolomon,
+                           &recovered_packet_receiver_);
+  erasure_code_ = ForwardErrorCorrection::CreateFlexfec(
+      kFlexfecSsrc, kMediaSsrc, FlexfecScheme::kReedSolomon);
+
+  PacketList media_packets;
+  PacketizeFrame(kNumMediaPackets, 0, &media_packets);
+  std::list<Packet*> fec_packets = EncodeFec(media_packets, kNumFecPackets);
+
+  // Drop the first and the last media packet.
+  auto media_it = media_packets.begin();
+  EXPECT_CALL(recovered_packet_receiver_,
+              OnRecoveredPacket(_, (*media_it)->length))
+      .With(
+          Args<0, 1>(ElementsAreArray((*media_it)->data, (*media_it)->length)));
+  media_it++;
+  receiver.OnRtpPacket(ParsePacket(**media_it));
+  media_it++;
+  EXPECT_CALL(recovered_packet_receiver_,
+              OnRecoveredPacket(_, (*media_it)->length))
+      .With(
+          Args<0, 1>(ElementsAreArray((*media_it)->data, (*media_it)->length)));
+
+  // Both are recovered once the second FEC packet arrives.
+  for (const Packet* fec_packet : fec_packets) {
+    std::unique_ptr<Packet> packet_with_rtp_header =
+        packet_generator_.BuildFlexfecPacket(*fec_packet);
+    receiver.OnRtpPacket(ParsePacket(*packet_with_rtp_header));
+  }
+}
+
+TEST_F(FlexfecReceiverTest, ReedSolomonReceiverRecoversXorCodedPackets) {
+  const size_t kNumMediaPackets = 2;
+  const size_t kNumFecPackets = 1;
+  FlexfecReceiver receiver(Clock::GetRealTimeClock(), kFlexfecSsrc, kMediaSsrc,
+                           FlexfecScheme::kReedSolomon,
+                           &recovered_packet_receiver_);
+
+  PacketList media_packets;
+  PacketizeFrame(kNumMediaPackets, 0, &media_packets);
+  std::list<Packet*> fec_packets = EncodeFec(media_packets, kNumFecPackets);
+
+  // Receive first media packet but drop second.
+  auto media_it = media_packets.begin();
+  receiver.OnRtpPacket(ParsePacket(**media_it));
+
+  // Receive FEC packet and ensure recovery of lost media packet.
+  std::unique_ptr<Packet> packet_with_rtp_header =
+      packet_generator_.BuildFlexfecPacket(*fec_packets.front());
+  media_it++;
+  EXPECT_CALL(recovered_packet_receiver_,
+              OnRecoveredPacket(_, (*media_it)->length))
+      .With(
+          Args<0, 1>(ElementsAreArray((*media_it)->data, (*media_it)->length)));
+  receiver.OnRtpPacket(ParsePacket(*packet_with_rtp_header));
+}
+
+TEST_F(FlexfecReceiverTest, XorReceiverIgnoresReedSolomonCodedPackets) {
+  const size_t kNumMediaPackets = 2;
+  const size_t kNumFecPackets = 1;
+  erasure_code_ = ForwardErrorCorrection::CreateFlexfec(
+      kFlexfecSsrc, kMediaSsrc, FlexfecScheme::kReedSolomon);
+
+  PacketList media_packets;
+  PacketizeFrame(kNumMediaPackets, 0, &media_packets);
+  std::list<Packet*> fec_packets = EncodeFec(media_packets, kNumFecPackets);
+
+  // Receive first media packet but drop second.
+  receiver_.OnRtpPacket(ParsePacket(*media_packets.front()));
+
+  // Receive FEC packet. Do not expect call back.
+  std::unique_ptr<Packet> packet_with_rtp_header =
+      packet_generator_.BuildFlexfecPacket(*fec_packets.front());
+  receiver_.OnRtpPacket(ParsePacket(*packet_with_rtp_header));
+  EXPECT_EQ(1U, receiver_.GetPacketCounter().num_fec_packets);
+}
+
 }  // namespace webrtc
@@ -75,6 +75,26 @@ FlexfecSender::FlexfecSender(
     rtc::ArrayView<const RtpExtensionSize> extension_sizes,
     const RtpState* rtp_state,
     Clock* clock)
+    : FlexfecSender(payload_type,
+                    ssrc,
+                    protected_media_ssrc,
+                    mid,
+                    rtp_header_extensions,
+                    extension_sizes,
+                    rtp_state,
+                    clock,
+                    FlexfecScheme::kXor) {}
+
+FlexfecSender::FlexfecSender(
+    int payload_type,
+    uint32_t ssrc,
+    uint32_t protected_media_ssrc,
+    const std::string& mid,
+    const std::vector<RtpExtension>& rtp_header_extensions,
+    rtc::ArrayView<const RtpExtensionSize> extension_sizes,
+    const RtpState* rtp_state,
+    Clock* clock,
+    FlexfecScheme scheme)
     : clock_(clock),
       random_(clock_->TimeInMicroseconds()),
       last_generated_packet_ms_(-1),
@@ -89,8 +109,10 @@ FlexfecSender::FlexfecSender(
       mid_(mid),
       seq_num_(rtp_state ? rtp_state->sequence_number
                          : random_.Rand(1, kMaxInitRtpSeqNumber)),
-      ulpfec_generator_(
-          ForwardErrorCorrection::CreateFlexfec(ssrc, protected_media_ssrc)),
+      ulpfec_generator_(ForwardErrorCorrection::CreateFlexfec(
+          ssrc,
+          protected_media_ssrc,
+          scheme)),
       rtp_header_extension_map_(
           RegisterSupportedExtensions(rtp_header_extensions)),
       header_extensions_size_(
@@ -15,11 +15,14 @@
 #include <utility>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
 #include "modules/include/module_common_types_public.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
+#include "modules/rtp_rtcp/source/reed_solomon_fec.h"
 #include "modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -47,6 +50,10 @@ int32_t ForwardErrorCorrection::Packet::Release() {
   return ref_count;
 }
 
+bool ForwardErrorCorrection::Packet::HasOneRef() const {
+  return ref_count_ == 1;
+}
+
 // This comparator is used to compare std::unique_ptr's pointing to
 // subclasses of SortablePackets. It needs to be parametric since
 // the std::unique_ptr's are not covariant w.r.t. the types that
@@ -76,12 +83,12 @@ ForwardErrorCorrection::ForwardErrorCorrection(
     std::unique_ptr<FecHeaderWriter> fec_header_writer,
     uint32_t ssrc,
     uint32_t protected_media_ssrc)
-    : ssrc_(ssrc),
-      protected_media_ssrc_(protected_media_ssrc),
-      fec_header_reader_(std::move(fec_header_reader)),
+    : fec_header_reader_(std::move(fec_header_reader)),
       fec_header_writer_(std::move(fec_header_writer)),
       generated_fec_packets_(fec_header_writer_->MaxFecPackets()),
-      packet_mask_size_(0) {}
+      packet_mask_size_(0),
+      ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc) {}
 
 ForwardErrorCorrection::~ForwardErrorCorrection() = default;
 
@@ -103,6 +110,20 @@ std::unique_ptr<ForwardErrorCorrection> ForwardErrorCorrection::CreateFlexfec(
       protected_media_ssrc));
 }
 
+std::unique_ptr<ForwardErrorCorrection> ForwardErrorCorrection::CreateFlexfec(
+    uint32_t ssrc,
+    uint32_t protected_media_ssrc,
+    FlexfecScheme scheme) {
+  switch (scheme) {
+    case FlexfecScheme::kXor:
+      return CreateFlexfec(ssrc, protected_media_ssrc);
+    case FlexfecScheme::kReedSolomon:
+      return absl::make_unique<ReedSolomonFec>(ssrc, protected_media_ssrc);
+  }
+  RTC_NOTREACHED();
+  return nullptr;
+}
+
 int ForwardErrorCorrection::EncodeFec(const PacketList& media_packets,
                                       uint8_t protection_factor,
                                       int num_important_packets,
@@ -155,12 +176,8 @@ int ForwardErrorCorrection::EncodeFec(const PacketList& media_packets,
     fec_packets->push_back(&generated_fec_packets_[i]);
   }
 
-  internal::PacketMaskTable mask_table(fec_mask_type, num_media_packets);
-  packet_mask_size_ = internal::PacketMaskSize(num_media_packets);
-  memset(packet_masks_, 0, num_fec_packets * packet_mask_size_);
-  internal::GeneratePacketMasks(num_media_packets, num_fec_packets,
-                                num_important_packets, use_unequal_protection,
-                                &mask_table, packet_masks_);
+  GeneratePacketMasks(num_media_packets, num_fec_packets, num_important_packets,
+                      use_unequal_protection, fec_mask_type);
 
   // Adapt packet masks to missing media packets.
   int num_mask_bits = InsertZerosInPacketMasks(media_packets, num_fec_packets);
@@ -196,6 +213,20 @@ int ForwardErrorCorrection::NumFecPackets(int num_media_packets,
   return num_fec_packets;
 }
 
+void ForwardErrorCorrection::GeneratePacketMasks(
+    size_t num_media_packets,
+    size_t num_fec_packets,
+    int num_important_packets,
+    bool use_unequal_protection,
+    FecMaskType fec_mask_type) {
+  internal::PacketMaskTable mask_table(fec_mask_type, num_media_packets);
+  packet_mask_size_ = internal::PacketMaskSize(num_media_packets);
+  memset(packet_masks_, 0, num_fec_packets * packet_mask_size_);
+  internal::GeneratePacketMasks(num_media_packets, num_fec_packets,
+                                num_important_packets, use_unequal_protection,
+                                &mask_table, packet_masks_);
+}
+
 void ForwardErrorCorrection::GenerateFecPayloads(
     const PacketList& media_packets,
     size_t num_fec_packets) {
@@ -207,6 +238,9 @@ void ForwardErrorCorrection::GenerateFecPayloads(
         &packet_masks_[pkt_mask_idx], packet_mask_size_);
     const size_t fec_header_size =
         fec_header_writer_->FecHeaderSize(min_packet_mask_size);
+    // Payloads of all protected packets but the first, which is copied.
+    absl::InlinedVector<const uint8_t*, kUlpfecMaxMediaPackets> payloads;
+    absl::InlinedVector<size_t, kUlpfecMaxMediaPackets> payload_lengths;
 
     size_t media_pkt_idx = 0;
     auto media_packets_it = media_packets.cbegin();
@@ -239,9 +273,11 @@ void ForwardErrorCorrection::GenerateFecPayloads(
           memcpy(&fec_packet->data[fec_header_size],
                  &media_packet->data[kRtpHeaderSize], media_payload_length);
         } else {
+          RTC_DCHECK_LE(fec_header_size + media_payload_length,
+                        sizeof(fec_packet->data));
           XorHeaders(*media_packet, fec_packet);
-          XorPayloads(*media_packet, media_payload_length, fec_header_size,
-                      fec_packet);
+          payloads.push_back(&media_packet->data[kRtpHeaderSize]);
+          payload_lengths.push_back(media_payload_length);
         }
       }
       media_packets_it++;
@@ -253,6 +289,8 @@ void ForwardErrorCorrection::GenerateFecPayloads(
       pkt_mask_idx += media_pkt_idx / 8;
       media_pkt_idx %= 8;
     }
+    internal::XorBuffers(payloads.data(), payload_lengths.data(),
+                         payloads.size(), &fec_packet->data[fec_header_size]);
     RTC_DCHECK_GT(fec_packet->length, 0)
         << "Packet mask is wrong or poorly designed.";
   }
@@ -423,6 +461,16 @@ void ForwardErrorCorrection::InsertFecPacket(
   }
 
   // Parse packet mask from header and represent as protected packets.
+  size_t num_protected_packets = 0;
+  for (uint16_t byte_idx = 0; byte_idx < fec_packet->packet_mask_size;
+       ++byte_idx) {
+    for (uint8_t packet_mask =
+             fec_packet->pkt->data[fec_packet->packet_mask_offset + byte_idx];
+         packet_mask != 0; packet_mask &= packet_mask - 1) {
+      ++num_protected_packets;
+    }
+  }
+  fec_packet->protected_packets.reserve(num_protected_packets);
   for (uint16_t byte_idx = 0; byte_idx < fec_packet->packet_mask_size;
        ++byte_idx) {
     uint8_t packet_mask =
@@ -535,8 +583,7 @@ bool ForwardErrorCorrection::StartPacketRecovery(
     return false;
   }
   // Initialize recovered packet data.
-  recovered_packet->pkt = new Packet();
-  memset(recovered_packet->pkt->data, 0, IP_PACKET_SIZE);
+  recovered_packet->pkt = AllocateRecoveredPacket();
   recovered_packet->returned = false;
   recovered_packet->was_recovered = true;
   // Copy bytes corresponding to minimum RTP header size.
@@ -603,16 +650,26 @@ void ForwardErrorCorrection::XorHeaders(const Packet& src, Packet* dst) {
   // Skip the 9th to 12th bytes of the header.
 }
 
-void ForwardErrorCorrection::XorPayloads(const Packet& src,
-                                         size_t payload_length,
-                                         size_t dst_offset,
-                                         Packet* dst) {
-  // XOR the payload.
-  RTC_DCHECK_LE(kRtpHeaderSize + payload_length, sizeof(src.data));
-  RTC_DCHECK_LE(dst_offset + payload_length, sizeof(dst->data));
-  for (size_t i = 0; i < payload_length; ++i) {
-    dst->data[dst_offset + i] ^= src.data[kRtpHeaderSize + i];
+rtc::scoped_refptr<ForwardErrorCorrection::Packet>
+ForwardErrorCorrection::AllocateRecoveredPacket() {
+  rtc::scoped_refptr<Packet> packet;
+  for (const rtc::scoped_refptr<Packet>& pooled_packet :
+       recovered_packet_pool_) {
+    if (pooled_packet->HasOneRef()) {
+      packet = pooled_packet;
+      break;
+    }
   }
+  if (!packet) {
+    packet = new Packet();
+    // At most MaxMediaPackets() recovered packets are kept in the recovered
+    // packet list, more are only in use if the caller holds on to them.
+    if (recovered_packet_pool_.size() < fec_header_reader_->MaxMediaPackets())
+      recovered_packet_pool_.push_back(packet);
+  }
+  packet->length = 0;
+  memset(packet->data, 0, IP_PACKET_SIZE);
+  return packet;
 }
 
 bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
@@ -620,16 +677,23 @@ bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
   if (!StartPacketRecovery(fec_packet, recovered_packet)) {
     return false;
   }
+  absl::InlinedVector<const uint8_t*, kUlpfecMaxMediaPackets> payloads;
+  absl::InlinedVector<size_t, kUlpfecMaxMediaPackets> payload_lengths;
   for (const auto& protected_packet : fec_packet.protected_packets) {
     if (protected_packet->pkt == nullptr) {
       // This is the packet we're recovering.
       recovered_packet->seq_num = protected_packet->seq_num;
     } else {
-      XorHeaders(*protected_packet->pkt, recovered_packet->pkt);
-      XorPayloads(*protected_packet->pkt, protected_packet->pkt->length,
-                  kRtpHeaderSize, recovered_packet->pkt);
+      const Packet& src = *protected_packet->pkt;
+      RTC_DCHECK_LE(kRtpHeaderSize + src.length, sizeof(src.data));
+      XorHeaders(src, recovered_packet->pkt);
+      payloads.push_back(&src.data[kRtpHeaderSize]);
+      payload_lengths.push_back(src.length);
     }
   }
+  internal::XorBuffers(payloads.data(), payload_lengths.data(),
+                       payloads.size(),
+                       &recovered_packet->pkt->data[kRtpHeaderSize]);
   if (!FinishPacketRecovery(fec_packet, recovered_packet)) {
     return false;
   }
@@ -654,16 +718,7 @@ void ForwardErrorCorrection::AttemptRecovery(
         continue;
       }
 
-      auto* recovered_packet_ptr = recovered_packet.get();
-      // Add recovered packet to the list of recovered packets and update any
-      // FEC packets covering this packet with a pointer to the data.
-      // TODO(holmer): Consider replacing this with a binary search for the
-      // right position, and then just insert the new packet. Would get rid of
-      // the sort.
-      recovered_packets->push_back(std::move(recovered_packet));
-      recovered_packets->sort(SortablePacket::LessThan());
-      UpdateCoveringFecPackets(*recovered_packet_ptr);
-      DiscardOldRecoveredPackets(recovered_packets);
+      InsertRecoveredPacket(std::move(recovered_packet), recovered_packets);
       fec_packet_it = received_fec_packets_.erase(fec_packet_it);
 
       // A packet has been recovered. We need to check the FEC list again, as
@@ -680,6 +735,19 @@ void ForwardErrorCorrection::AttemptRecovery(
   }
 }
 
+void ForwardErrorCorrection::InsertRecoveredPacket(
+    std::unique_ptr<RecoveredPacket> recovered_packet,
+    RecoveredPacketList* recovered_packets) {
+  auto* recovered_packet_ptr = recovered_packet.get();
+  // TODO(holmer): Consider replacing this with a binary search for the
+  // right position, and then just insert the new packet. Would get rid of
+  // the sort.
+  recovered_packets->push_back(std::move(recovered_packet));
+  recovered_packets->sort(SortablePacket::LessThan());
+  UpdateCoveringFecPackets(*recovered_packet_ptr);
+  DiscardOldRecoveredPackets(recovered_packets);
+}
+
 int ForwardErrorCorrection::NumCoveredPacketsMissing(
     const ReceivedFecPacket& fec_packet) {
   int packets_missing = 0;
@@ -51,6 +51,9 @@ class ForwardErrorCorrection {
     // reaches zero.
     virtual int32_t Release();
 
+    // True if there is exactly one reference to the packet.
+    bool HasOneRef() const;
+
     size_t length;                 // Length of packet in bytes.
     uint8_t data[IP_PACKET_SIZE];  // Packet data.
 
@@ -114,7 +117,9 @@ class ForwardErrorCorrection {
     rtc::scoped_refptr<ForwardErrorCorrection::Packet> pkt;
   };
 
-  using ProtectedPacketList = std::list<std::unique_ptr<ProtectedPacket>>;
+  // Sorted by sequence number. A vector, since the list is built once per
+  // FEC packet and never has elements inserted or removed after that.
+  using ProtectedPacketList = std::vector<std::unique_ptr<ProtectedPacket>>;
 
   // Used for internal storage of received FEC packets in a list.
   //
@@ -143,13 +148,17 @@ class ForwardErrorCorrection {
   using RecoveredPacketList = std::list<std::unique_ptr<RecoveredPacket>>;
   using ReceivedFecPacketList = std::list<std::unique_ptr<ReceivedFecPacket>>;
 
-  ~ForwardErrorCorrection();
+  virtual ~ForwardErrorCorrection();
 
   // Creates a ForwardErrorCorrection tailored for a specific FEC scheme.
   static std::unique_ptr<ForwardErrorCorrection> CreateUlpfec(uint32_t ssrc);
   static std::unique_ptr<ForwardErrorCorrection> CreateFlexfec(
       uint32_t ssrc,
       uint32_t protected_media_ssrc);
+  static std::unique_ptr<ForwardErrorCorrection> CreateFlexfec(
+      uint32_t ssrc,
+      uint32_t protected_media_ssrc,
+      FlexfecScheme scheme);
 
   // Generates a list of FEC packets from supplied media packets.
   //
@@ -242,6 +251,58 @@ class ForwardErrorCorrection {
                          uint32_t ssrc,
                          uint32_t protected_media_ssrc);
 
+  // The steps below depend on the erasure code. The default implementations
+  // use XOR parity, as in RFC 5109.
+
+  // Writes one packet mask of |packet_mask_size_| bytes per FEC packet to
+  // |packet_masks_|, covering |num_media_packets| consecutive packets.
+  virtual void GeneratePacketMasks(size_t num_media_packets,
+                                   size_t num_fec_packets,
+                                   int num_important_packets,
+                                   bool use_unequal_protection,
+                                   FecMaskType fec_mask_type);
+
+  // Writes FEC payloads and some recovery fields in the FEC headers.
+  virtual void GenerateFecPayloads(const PacketList& media_packets,
+                                   size_t num_fec_packets);
+
+  // Writes the FEC header fields that are not written by GenerateFecPayloads.
+  // This includes writing the packet masks.
+  virtual void FinalizeFecHeaders(size_t num_fec_packets,
+                                  uint32_t media_ssrc,
+                                  uint16_t seq_num_base);
+
+  // Attempt to recover missing packets, using the internally stored
+  // received FEC packets.
+  virtual void AttemptRecovery(RecoveredPacketList* recovered_packets);
+
+  // Adds |recovered_packet| to |recovered_packets|, and updates any FEC
+  // packets covering it with a pointer to the data.
+  void InsertRecoveredPacket(std::unique_ptr<RecoveredPacket> recovered_packet,
+                             RecoveredPacketList* recovered_packets);
+
+  // Returns zeroed storage for a recovered packet. Packets in
+  // |recovered_packet_pool_| which are not referenced elsewhere any longer are
+  // reused, so recovery stops allocating once the pool has filled up.
+  rtc::scoped_refptr<Packet> AllocateRecoveredPacket();
+
+  // Finalizes recovery of packet by setting RTP header fields.
+  // This is not specific to the FEC scheme used.
+  static bool FinishPacketRecovery(const ReceivedFecPacket& fec_packet,
+                                   RecoveredPacket* recovered_packet);
+
+  std::unique_ptr<FecHeaderReader> fec_header_reader_;
+  std::unique_ptr<FecHeaderWriter> fec_header_writer_;
+
+  std::vector<Packet> generated_fec_packets_;
+  ReceivedFecPacketList received_fec_packets_;
+
+  // Arrays used to avoid dynamically allocating memory when generating
+  // the packet masks.
+  // (There are never more than |kUlpfecMaxMediaPackets| FEC packets generated.)
+  uint8_t packet_masks_[kUlpfecMaxMediaPackets * kUlpfecMaxPacketMaskSize];
+  size_t packet_mask_size_;
+
  private:
   // Analyzes |media_packets| for holes in the sequence and inserts zero columns
   // into the |packet_mask| where those holes are found. Zero columns means that
@@ -252,16 +313,6 @@ class ForwardErrorCorrection {
   int InsertZerosInPacketMasks(const PacketList& media_packets,
                                size_t num_fec_packets);
 
-  // Writes FEC payloads and some recovery fields in the FEC headers.
-  void GenerateFecPayloads(const PacketList& media_packets,
-                           size_t num_fec_packets);
-
-  // Writes the FEC header fields that are not written by GenerateFecPayloads.
-  // This includes writing the packet masks.
-  void FinalizeFecHeaders(size_t num_fec_packets,
-                          uint32_t media_ssrc,
-                          uint16_t seq_num_base);
-
   // Inserts the |received_packet| into the internal received FEC packet list
   // or into |recovered_packets|.
   void InsertPacket(const ReceivedPacket& received_packet,
@@ -287,36 +338,19 @@ class ForwardErrorCorrection {
       const RecoveredPacketList& recovered_packets,
       ReceivedFecPacket* fec_packet);
 
-  // Attempt to recover missing packets, using the internally stored
-  // received FEC packets.
-  void AttemptRecovery(RecoveredPacketList* recovered_packets);
-
   // Initializes headers and payload before the XOR operation
   // that recovers a packet.
-  static bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
-                                  RecoveredPacket* recovered_packet);
+  bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
+                           RecoveredPacket* recovered_packet);
 
   // Performs XOR between the first 8 bytes of |src| and |dst| and stores
   // the result in |dst|. The 3rd and 4th bytes are used for storing
   // the length recovery field.
   static void XorHeaders(const Packet& src, Packet* dst);
 
-  // Performs XOR between the payloads of |src| and |dst| and stores the result
-  // in |dst|. The parameter |dst_offset| determines at  what byte the
-  // XOR operation starts in |dst|. In total, |payload_length| bytes are XORed.
-  static void XorPayloads(const Packet& src,
-                          size_t payload_length,
-                          size_t dst_offset,
-                          Packet* dst);
-
-  // Finalizes recovery of packet by setting RTP header fields.
-  // This is not specific to the FEC scheme used.
-  static bool FinishPacketRecovery(const ReceivedFecPacket& fec_packet,
-                                   RecoveredPacket* recovered_packet);
-
   // Recover a missing packet.
-  static bool RecoverPacket(const ReceivedFecPacket& fec_packet,
-                            RecoveredPacket* recovered_packet);
+  bool RecoverPacket(const ReceivedFecPacket& fec_packet,
+                     RecoveredPacket* recovered_packet);
 
   // Get the number of missing media packets which are covered by |fec_packet|.
   // An FEC packet can recover at most one packet, and if zero packets are
@@ -332,18 +366,8 @@ class ForwardErrorCorrection {
   const uint32_t ssrc_;
   const uint32_t protected_media_ssrc_;
 
-  std::unique_ptr<FecHeaderReader> fec_header_reader_;
-  std::unique_ptr<FecHeaderWriter> fec_header_writer_;
-
-  std::vector<Packet> generated_fec_packets_;
-  ReceivedFecPacketList received_fec_packets_;
-
-  // Arrays used to avoid dynamically allocating memory when generating
-  // the packet masks.
-  // (There are never more than |kUlpfecMaxMediaPackets| FEC packets generated.)
-  uint8_t packet_masks_[kUlpfecMaxMediaPackets * kUlpfecMaxPacketMaskSize];
+  std::vector<rtc::scoped_refptr<Packet>> recovered_packet_pool_;
   uint8_t tmp_packet_masks_[kUlpfecMaxMediaPackets * kUlpfecMaxPacketMaskSize];
-  size_t packet_mask_size_;
 };
 
 // Classes derived from FecHeader{Reader,Writer} encapsulate the
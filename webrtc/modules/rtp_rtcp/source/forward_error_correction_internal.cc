@@ -10,12 +10,20 @@
 
 #include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
 
+#include "rtc_base/system/arch.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <string.h>
 #include <algorithm>
 
 #include "modules/rtp_rtcp/source/fec_private_tables_bursty.h"
 #include "modules/rtp_rtcp/source/fec_private_tables_random.h"
 #include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 
 namespace {
 // Allow for different modes of protection for packets in UEP case.
@@ -136,6 +144,90 @@ void ShiftFitSubMask(int num_mask_bytes,
   }
 }
 
+// Number of sources XORed into the destination per pass. Each pass loads and
+// stores the destination once.
+constexpr size_t kXorSourcesPerPass = 4;
+
+// XORs bytes [|begin|, |end|) of the |num_srcs| sources into |dst|, a word at a
+// time.
+void XorSourcesC(const uint8_t* const* srcs,
+                 size_t num_srcs,
+                 size_t begin,
+                 size_t end,
+                 uint8_t* dst) {
+  size_t i = begin;
+  for (; i + sizeof(uint64_t) <= end; i += sizeof(uint64_t)) {
+    // memcpy() compiles to plain loads and stores, without the alignment
+    // requirements of casting to uint64_t*.
+    uint64_t acc;
+    memcpy(&acc, dst + i, sizeof(acc));
+    for (size_t k = 0; k < num_srcs; ++k) {
+      uint64_t word;
+      memcpy(&word, srcs[k] + i, sizeof(word));
+      acc ^= word;
+    }
+    memcpy(dst + i, &acc, sizeof(acc));
+  }
+  for (; i < end; ++i) {
+    uint8_t acc = dst[i];
+    for (size_t k = 0; k < num_srcs; ++k)
+      acc ^= srcs[k][i];
+    dst[i] = acc;
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void XorSourcesSse2(const uint8_t* const* srcs,
+                    size_t num_srcs,
+                    size_t begin,
+                    size_t end,
+                    uint8_t* dst) {
+  size_t i = begin;
+  for (; i + sizeof(__m128i) <= end; i += sizeof(__m128i)) {
+    __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    for (size_t k = 0; k < num_srcs; ++k) {
+      acc = _mm_xor_si128(
+          acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcs[k] + i)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), acc);
+  }
+  XorSourcesC(srcs, num_srcs, i, end, dst);
+}
+#elif defined(WEBRTC_HAS_NEON)
+void XorSourcesNeon(const uint8_t* const* srcs,
+                    size_t num_srcs,
+                    size_t begin,
+                    size_t end,
+                    uint8_t* dst) {
+  size_t i = begin;
+  for (; i + sizeof(uint8x16_t) <= end; i += sizeof(uint8x16_t)) {
+    uint8x16_t acc = vld1q_u8(dst + i);
+    for (size_t k = 0; k < num_srcs; ++k)
+      acc = veorq_u8(acc, vld1q_u8(srcs[k] + i));
+    vst1q_u8(dst + i, acc);
+  }
+  XorSourcesC(srcs, num_srcs, i, end, dst);
+}
+#endif
+
+void XorSources(const uint8_t* const* srcs,
+                size_t num_srcs,
+                size_t begin,
+                size_t end,
+                uint8_t* dst) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static const bool use_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  if (use_sse2) {
+    XorSourcesSse2(srcs, num_srcs, begin, end, dst);
+    return;
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  XorSourcesNeon(srcs, num_srcs, begin, end, dst);
+  return;
+#endif
+  XorSourcesC(srcs, num_srcs, begin, end, dst);
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -514,5 +606,25 @@ void CopyColumn(uint8_t* new_mask,
   }
 }
 
+void XorBuffers(const uint8_t* const* srcs,
+                const size_t* lengths,
+                size_t num_srcs,
+                uint8_t* dst) {
+  for (size_t first = 0; first < num_srcs; first += kXorSourcesPerPass) {
+    const size_t num_pass_srcs = std::min(kXorSourcesPerPass, num_srcs - first);
+    const uint8_t* const* pass_srcs = srcs + first;
+    const size_t* pass_lengths = lengths + first;
+    // The range covered by all sources of the pass is XORed at once, the
+    // remainder of longer sources one source at a time.
+    const size_t common_length =
+        *std::min_element(pass_lengths, pass_lengths + num_pass_srcs);
+    XorSources(pass_srcs, num_pass_srcs, 0, common_length, dst);
+    for (size_t k = 0; k < num_pass_srcs; ++k) {
+      if (pass_lengths[k] > common_length)
+        XorSources(&pass_srcs[k], 1, common_length, pass_lengths[k], dst);
+    }
+  }
+}
+
 }  // namespace internal
 }  // namespace webrtc
@@ -115,6 +115,14 @@ void CopyColumn(uint8_t* new_mask,
                 int new_bit_index,
                 int old_bit_index);
 
+// XORs the first |lengths[i]| bytes of |srcs[i]| into |dst|, for each of the
+// |num_srcs| sources. Several sources are applied per pass over |dst|, using
+// SSE2 or NEON where available.
+void XorBuffers(const uint8_t* const* srcs,
+                const size_t* lengths,
+                size_t num_srcs,
+                uint8_t* dst);
+
 }  // namespace internal
 }  // namespace webrtc
 
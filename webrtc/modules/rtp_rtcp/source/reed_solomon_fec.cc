@@ -0,0 +1,470 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_fec.h"
+
+#include "rtc_base/system/arch.h"
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
+#include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+namespace {
+
+// Offsets of the fields stored in the reserved bytes of the FlexFEC header.
+constexpr size_t kSchemeOffset = 9;
+constexpr size_t kRowOffset = 10;
+constexpr size_t kFirstByteRecoveryOffset = 11;
+
+// Size of the recovery fields: P, X, CC, M, PT, length recovery and TS.
+constexpr size_t kRecoveryHeaderSize = 8;
+
+// Largest number of media packets, and of FEC packets, in one block.
+constexpr size_t kMaxBlockSize = kUlpfecMaxMediaPackets;
+
+// Arithmetic in GF(256), using the polynomial x^8 + x^4 + x^3 + x^2 + 1.
+// Products are looked up in a full multiplication table, so that multiplying
+// a buffer by a constant is one lookup per byte.
+class GaloisField {
+ public:
+  static const GaloisField& Get() {
+    static const GaloisField* const field = new GaloisField();
+    return *field;
+  }
+
+  uint8_t Multiply(uint8_t a, uint8_t b) const { return products_[a][b]; }
+  // The products of |a| with all elements.
+  const uint8_t* Products(uint8_t a) const { return products_[a]; }
+  uint8_t Inverse(uint8_t a) const {
+    RTC_DCHECK_NE(a, 0);
+    return inverses_[a];
+  }
+
+ private:
+  GaloisField() {
+    uint8_t exp[255];
+    uint8_t log[256] = {0};
+    int x = 1;
+    for (int i = 0; i < 255; ++i) {
+      exp[i] = static_cast<uint8_t>(x);
+      log[x] = static_cast<uint8_t>(i);
+      x <<= 1;
+      if (x & 0x100)
+        x ^= 0x11d;
+    }
+    for (int a = 0; a < 256; ++a) {
+      for (int b = 0; b < 256; ++b) {
+        products_[a][b] =
+            (a == 0 || b == 0) ? 0 : exp[(log[a] + log[b]) % 255];
+      }
+      inverses_[a] = a == 0 ? 0 : exp[(255 - log[a]) % 255];
+    }
+  }
+
+  uint8_t products_[256][256];
+  uint8_t inverses_[256];
+};
+
+// Element of the code's Cauchy matrix for an FEC packet and the media packet
+// at |column| in the packet mask. Every square submatrix of a Cauchy matrix is
+// invertible, which is what makes any set of FEC packets usable for recovery.
+uint8_t CodeCoefficient(size_t row, size_t column) {
+  RTC_DCHECK_LT(row, kMaxBlockSize);
+  RTC_DCHECK_LT(column, kMaxBlockSize);
+  return GaloisField::Get().Inverse(
+      static_cast<uint8_t>((kMaxBlockSize + row) ^ column));
+}
+
+#if defined(WEBRTC_HAS_NEON)
+// Same as MultiplyAdd(), 8 bytes at a time. Each byte is split in two nibbles,
+// whose products are looked up in two 16 entry tables. Returns the number of
+// bytes processed.
+size_t MultiplyAddNeon(uint8_t coefficient,
+                       const uint8_t* src,
+                       size_t length,
+                       uint8_t* dst) {
+  const GaloisField& field = GaloisField::Get();
+  uint8_t low_products[16];
+  uint8_t high_products[16];
+  for (int i = 0; i < 16; ++i) {
+    low_products[i] = field.Multiply(coefficient, i);
+    high_products[i] = field.Multiply(coefficient, i << 4);
+  }
+  const uint8x8x2_t low_table = {
+      {vld1_u8(low_products), vld1_u8(low_products + 8)}};
+  const uint8x8x2_t high_table = {
+      {vld1_u8(high_products), vld1_u8(high_products + 8)}};
+  const uint8x8_t low_mask = vdup_n_u8(0x0f);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const uint8x8_t value = vld1_u8(src + i);
+    const uint8x8_t product =
+        veor_u8(vtbl2_u8(low_table, vand_u8(value, low_mask)),
+                vtbl2_u8(high_table, vshr_n_u8(value, 4)));
+    vst1_u8(dst + i, veor_u8(vld1_u8(dst + i), product));
+  }
+  return i;
+}
+#endif
+
+// Adds |coefficient| times |src| to |dst|, i.e. dst[i] ^= coefficient * src[i]
+// for the first |length| bytes.
+void MultiplyAdd(uint8_t coefficient,
+                 const uint8_t* src,
+                 size_t length,
+                 uint8_t* dst) {
+  if (coefficient == 0)
+    return;
+  if (coefficient == 1) {
+    internal::XorBuffers(&src, &length, 1, dst);
+    return;
+  }
+  size_t i = 0;
+#if defined(WEBRTC_HAS_NEON)
+  i = MultiplyAddNeon(coefficient, src, length, dst);
+#endif
+  const uint8_t* products = GaloisField::Get().Products(coefficient);
+  for (; i < length; ++i)
+    dst[i] ^= products[src[i]];
+}
+
+// Inverts the |size| x |size| matrix |matrix| by Gauss-Jordan elimination.
+// |matrix| is destroyed. Returns false if the matrix is singular.
+bool InvertMatrix(size_t size,
+                  uint8_t matrix[kMaxBlockSize][kMaxBlockSize],
+                  uint8_t inverse[kMaxBlockSize][kMaxBlockSize]) {
+  const GaloisField& field = GaloisField::Get();
+  for (size_t row = 0; row < size; ++row) {
+    memset(inverse[row], 0, size);
+    inverse[row][row] = 1;
+  }
+  for (size_t column = 0; column < size; ++column) {
+    size_t pivot = column;
+    while (pivot < size && matrix[pivot][column] == 0)
+      ++pivot;
+    if (pivot == size)
+      return false;
+    if (pivot != column) {
+      std::swap_ranges(matrix[pivot], matrix[pivot] + size, matrix[column]);
+      std::swap_ranges(inverse[pivot], inverse[pivot] + size, inverse[column]);
+    }
+    const uint8_t scale = field.Inverse(matrix[column][column]);
+    for (size_t i = 0; i < size; ++i) {
+      matrix[column][i] = field.Multiply(scale, matrix[column][i]);
+      inverse[column][i] = field.Multiply(scale, inverse[column][i]);
+    }
+    for (size_t row = 0; row < size; ++row) {
+      const uint8_t factor = matrix[row][column];
+      if (row == column || factor == 0)
+        continue;
+      MultiplyAdd(factor, matrix[column], size, matrix[row]);
+      MultiplyAdd(factor, inverse[column], size, inverse[row]);
+    }
+  }
+  return true;
+}
+
+// Reads the recovery fields of a media packet, with the payload length in
+// place of the sequence number.
+void ReadRecoveryHeader(const ForwardErrorCorrection::Packet& media_packet,
+                        uint8_t* header) {
+  memcpy(header, media_packet.data, kRecoveryHeaderSize);
+  ByteWriter<uint16_t>::WriteBigEndian(&header[2],
+                                       media_packet.length - kRtpHeaderSize);
+}
+
+// Reads the recovery fields of an FEC packet.
+void ReadRecoveryHeader(
+    const ForwardErrorCorrection::ReceivedFecPacket& fec_packet,
+    uint8_t* header) {
+  memcpy(header, fec_packet.pkt->data, kRecoveryHeaderSize);
+  header[0] = fec_packet.pkt->data[kFirstByteRecoveryOffset];
+}
+
+// Reads the FlexFEC header of Reed-Solomon coded packets, whose reserved
+// bytes hold the scheme and the row of the code.
+class ReedSolomonHeaderReader : public FlexfecHeaderReader {
+ protected:
+  bool HasValidReservedBytes(
+      const ForwardErrorCorrection::Packet& fec_packet) const override {
+    return ReedSolomonFec::IsReedSolomonCoded(fec_packet);
+  }
+};
+
+// True if all media packets protected by |fec_packet| have a column of the
+// code. A 14 byte FlexFEC packet mask can cover up to 109 media packets, and
+// is also used by blocks of 47 and 48 packets, so its size alone doesn't tell.
+bool ProtectsOnlyBlockColumns(
+    const ForwardErrorCorrection::ReceivedFecPacket& fec_packet) {
+  return std::all_of(
+      fec_packet.protected_packets.begin(), fec_packet.protected_packets.end(),
+      [&fec_packet](
+          const std::unique_ptr<ForwardErrorCorrection::ProtectedPacket>&
+              protected_packet) {
+        return static_cast<uint16_t>(protected_packet->seq_num -
+                                     fec_packet.seq_num_base) < kMaxBlockSize;
+      });
+}
+
+// True if the two FEC packets were generated from the same media packets.
+bool InSameBlock(const ForwardErrorCorrection::ReceivedFecPacket& first,
+                 const ForwardErrorCorrection::ReceivedFecPacket& second) {
+  return first.seq_num_base == second.seq_num_base &&
+         first.packet_mask_size == second.packet_mask_size &&
+         first.protection_length == second.protection_length &&
+         memcmp(&first.pkt->data[first.packet_mask_offset],
+                &second.pkt->data[second.packet_mask_offset],
+                first.packet_mask_size) == 0;
+}
+
+size_t NumMissingPackets(
+    const ForwardErrorCorrection::ReceivedFecPacket& fec_packet) {
+  return std::count_if(
+      fec_packet.protected_packets.begin(), fec_packet.protected_packets.end(),
+      [](const std::unique_ptr<ForwardErrorCorrection::ProtectedPacket>&
+             protected_packet) { return protected_packet->pkt == nullptr; });
+}
+
+}  // namespace
+
+constexpr uint8_t ReedSolomonFec::kReedSolomonScheme;
+
+ReedSolomonFec::ReedSolomonFec(uint32_t ssrc, uint32_t protected_media_ssrc)
+    : ForwardErrorCorrection(absl::make_unique<ReedSolomonHeaderReader>(),
+                             absl::make_unique<FlexfecHeaderWriter>(),
+                             ssrc,
+                             protected_media_ssrc) {
+  RTC_DCHECK_LE(fec_header_writer_->MaxMediaPackets(), kMaxBlockSize);
+  RTC_DCHECK_LE(fec_header_writer_->MaxFecPackets(), kMaxBlockSize);
+}
+
+ReedSolomonFec::~ReedSolomonFec() = default;
+
+bool ReedSolomonFec::IsReedSolomonCoded(const Packet& fec_packet) {
+  return fec_packet.data[kSchemeOffset] == kReedSolomonScheme &&
+         fec_packet.data[kRowOffset] < kMaxBlockSize;
+}
+
+void ReedSolomonFec::GeneratePacketMasks(size_t num_media_packets,
+                                         size_t num_fec_packets,
+                                         int num_important_packets,
+                                         bool use_unequal_protection,
+                                         FecMaskType fec_mask_type) {
+  // Every FEC packet protects all media packets.
+  packet_mask_size_ = internal::PacketMaskSize(num_media_packets);
+  memset(packet_masks_, 0, num_fec_packets * packet_mask_size_);
+  for (size_t row = 0; row < num_fec_packets; ++row) {
+    uint8_t* const packet_mask = &packet_masks_[row * packet_mask_size_];
+    for (size_t column = 0; column < num_media_packets; ++column)
+      packet_mask[column / 8] |= 1 << (7 - column % 8);
+  }
+}
+
+void ReedSolomonFec::GenerateFecPayloads(const PacketList& media_packets,
+                                         size_t num_fec_packets) {
+  RTC_DCHECK(!media_packets.empty());
+  // The packet masks are all the same, and so are the header sizes.
+  const size_t fec_header_size = fec_header_writer_->FecHeaderSize(
+      fec_header_writer_->MinPacketMaskSize(packet_masks_, packet_mask_size_));
+  const uint16_t seq_num_base =
+      ParseSequenceNumber(media_packets.front()->data);
+  size_t max_payload_length = 0;
+  for (const auto& media_packet : media_packets) {
+    const size_t column = static_cast<uint16_t>(
+        ParseSequenceNumber(media_packet->data) - seq_num_base);
+    const size_t payload_length = media_packet->length - kRtpHeaderSize;
+    RTC_DCHECK_LT(column, kMaxBlockSize);
+    RTC_DCHECK_LE(fec_header_size + payload_length, IP_PACKET_SIZE);
+    max_payload_length = std::max(max_payload_length, payload_length);
+    uint8_t header[kRecoveryHeaderSize];
+    ReadRecoveryHeader(*media_packet, header);
+    for (size_t row = 0; row < num_fec_packets; ++row) {
+      Packet* const fec_packet = &generated_fec_packets_[row];
+      const uint8_t coefficient = CodeCoefficient(row, column);
+      // The first byte is moved to the reserved bytes in FinalizeFecHeaders.
+      MultiplyAdd(coefficient, header, kRecoveryHeaderSize, fec_packet->data);
+      MultiplyAdd(coefficient, &media_packet->data[kRtpHeaderSize],
+                  payload_length, &fec_packet->data[fec_header_size]);
+    }
+  }
+  // Shorter media packets are implicitly padded with zeros.
+  for (size_t row = 0; row < num_fec_packets; ++row)
+    generated_fec_packets_[row].length = fec_header_size + max_payload_length;
+}
+
+void ReedSolomonFec::FinalizeFecHeaders(size_t num_fec_packets,
+                                        uint32_t media_ssrc,
+                                        uint16_t seq_num_base) {
+  for (size_t row = 0; row < num_fec_packets; ++row) {
+    Packet* const fec_packet = &generated_fec_packets_[row];
+    const uint8_t first_byte_recovery = fec_packet->data[0];
+    fec_packet->data[0] = 0;
+    fec_header_writer_->FinalizeFecHeader(
+        media_ssrc, seq_num_base, &packet_masks_[row * packet_mask_size_],
+        packet_mask_size_, fec_packet);
+    fec_packet->data[kSchemeOffset] = kReedSolomonScheme;
+    fec_packet->data[kRowOffset] = static_cast<uint8_t>(row);
+    fec_packet->data[kFirstByteRecoveryOffset] = first_byte_recovery;
+  }
+}
+
+void ReedSolomonFec::AttemptRecovery(RecoveredPacketList* recovered_packets) {
+  auto fec_packet_it = received_fec_packets_.begin();
+  while (fec_packet_it != received_fec_packets_.end()) {
+    const ReceivedFecPacket& fec_packet = **fec_packet_it;
+    if (!ProtectsOnlyBlockColumns(fec_packet)) {
+      RTC_LOG(LS_WARNING) << "Received Reed-Solomon FEC packet protects more "
+                             "media packets than a block holds; dropping.";
+      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+      continue;
+    }
+    const size_t packets_missing = NumMissingPackets(fec_packet);
+    if (packets_missing == 0) {
+      // Either all protected packets arrived or have been recovered. We can
+      // discard this FEC packet.
+      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+      continue;
+    }
+
+    // Any FEC packets of the block can be used, as long as there are as many
+    // of them as there are packets missing.
+    std::vector<const ReceivedFecPacket*> block;
+    for (const auto& other_fec_packet : received_fec_packets_) {
+      if (InSameBlock(fec_packet, *other_fec_packet))
+        block.push_back(other_fec_packet.get());
+    }
+    if (block.size() < packets_missing) {
+      ++fec_packet_it;
+      continue;
+    }
+    if (!RecoverPackets(block, packets_missing, recovered_packets)) {
+      // Can't recover using this packet, drop it.
+      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+      continue;
+    }
+    // Nothing is missing from the block any longer, so its FEC packets are
+    // discarded as they are visited. Restart, since recovered packets may
+    // also be protected by other blocks.
+    fec_packet_it = received_fec_packets_.begin();
+  }
+}
+
+bool ReedSolomonFec::RecoverPackets(
+    const std::vector<const ReceivedFecPacket*>& fec_packets,
+    size_t num_missing,
+    RecoveredPacketList* recovered_packets) {
+  RTC_DCHECK_GE(fec_packets.size(), num_missing);
+  const ReceivedFecPacket& first_fec_packet = *fec_packets.front();
+  const size_t protection_length = first_fec_packet.protection_length;
+  if (protection_length >
+      sizeof(first_fec_packet.pkt->data) -
+          std::max<size_t>(kRtpHeaderSize, first_fec_packet.fec_header_size)) {
+    RTC_LOG(LS_WARNING) << "Incorrect protection length, dropping FEC packet.";
+    return false;
+  }
+
+  std::vector<size_t> missing_columns;
+  std::vector<uint16_t> missing_seq_nums;
+  std::vector<std::pair<size_t, const Packet*>> received_columns;
+  for (const auto& protected_packet : first_fec_packet.protected_packets) {
+    const size_t column = static_cast<uint16_t>(
+        protected_packet->seq_num - first_fec_packet.seq_num_base);
+    // Checked by ProtectsOnlyBlockColumns() in AttemptRecovery().
+    RTC_DCHECK_LT(column, kMaxBlockSize);
+    if (protected_packet->pkt == nullptr) {
+      missing_columns.push_back(column);
+      missing_seq_nums.push_back(protected_packet->seq_num);
+    } else if (protected_packet->pkt->length - kRtpHeaderSize >
+               protection_length) {
+      RTC_LOG(LS_WARNING) << "Media packet is longer than the FEC packets "
+                             "protecting it, dropping FEC packet.";
+      return false;
+    } else {
+      received_columns.emplace_back(column, protected_packet->pkt.get());
+    }
+  }
+  RTC_DCHECK_EQ(missing_columns.size(), num_missing);
+
+  // The FEC packets are the received media packets and the missing ones
+  // multiplied by their rows of the code. Solve for the missing packets using
+  // the first |num_missing| FEC packets.
+  uint8_t code[kMaxBlockSize][kMaxBlockSize];
+  uint8_t decode[kMaxBlockSize][kMaxBlockSize];
+  for (size_t i = 0; i < num_missing; ++i) {
+    const size_t row = fec_packets[i]->pkt->data[kRowOffset];
+    for (size_t j = 0; j < num_missing; ++j)
+      code[i][j] = CodeCoefficient(row, missing_columns[j]);
+  }
+  if (!InvertMatrix(num_missing, code, decode)) {
+    RTC_LOG(LS_WARNING) << "FEC packets can't be combined, dropping.";
+    return false;
+  }
+
+  const GaloisField& field = GaloisField::Get();
+  std::vector<std::unique_ptr<RecoveredPacket>> new_packets;
+  for (size_t i = 0; i < num_missing; ++i) {
+    std::unique_ptr<RecoveredPacket> recovered_packet(new RecoveredPacket());
+    recovered_packet->pkt = AllocateRecoveredPacket();
+    recovered_packet->returned = false;
+    recovered_packet->was_recovered = true;
+    recovered_packet->seq_num = missing_seq_nums[i];
+    uint8_t* const payload = &recovered_packet->pkt->data[kRtpHeaderSize];
+    uint8_t header[kRecoveryHeaderSize] = {0};
+    uint8_t source_header[kRecoveryHeaderSize];
+    for (size_t k = 0; k < num_missing; ++k) {
+      const ReceivedFecPacket& fec_packet = *fec_packets[k];
+      ReadRecoveryHeader(fec_packet, source_header);
+      MultiplyAdd(decode[i][k], source_header, kRecoveryHeaderSize, header);
+      MultiplyAdd(decode[i][k],
+                  &fec_packet.pkt->data[fec_packet.fec_header_size],
+                  protection_length, payload);
+    }
+    // Subtracting the received packets' share of the FEC packets is, in
+    // GF(256), the same as adding it.
+    for (const auto& received : received_columns) {
+      uint8_t coefficient = 0;
+      for (size_t k = 0; k < num_missing; ++k) {
+        coefficient ^= field.Multiply(
+            decode[i][k],
+            CodeCoefficient(fec_packets[k]->pkt->data[kRowOffset],
+                            received.first));
+      }
+      const Packet& media_packet = *received.second;
+      ReadRecoveryHeader(media_packet, source_header);
+      MultiplyAdd(coefficient, source_header, kRecoveryHeaderSize, header);
+      MultiplyAdd(coefficient, &media_packet.data[kRtpHeaderSize],
+                  media_packet.length - kRtpHeaderSize, payload);
+    }
+    memcpy(recovered_packet->pkt->data, header, kRecoveryHeaderSize);
+    if (!FinishPacketRecovery(first_fec_packet, recovered_packet.get()))
+      return false;
+    new_packets.push_back(std::move(recovered_packet));
+  }
+
+  for (auto& recovered_packet : new_packets)
+    InsertRecoveredPacket(std::move(recovered_packet), recovered_packets);
+  return true;
+}
+
+}  // namespace webrtc
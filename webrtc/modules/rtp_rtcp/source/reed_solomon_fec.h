@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_FEC_H_
+#define MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_FEC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/forward_error_correction.h"
+
+namespace webrtc {
+
+// Erasure code for FlexFEC based on a systematic Reed-Solomon code over
+// GF(256), built from a Cauchy matrix. Every FEC packet protects all media
+// packets of the frame, and any |n| FEC packets recover any |n| lost media
+// packets, so a burst loss of up to as many packets as were sent as FEC is
+// always recoverable. XOR parity, in contrast, recovers only the loss patterns
+// its packet masks were designed for.
+//
+// The packets use the FlexFEC header. The recovery fields hold code symbols
+// instead of XOR parity, except for the one of the first RTP header byte,
+// which is moved to the reserved bytes since it shares its byte with the R and
+// F bits:
+//
+//   Byte 9:  Scheme, kReedSolomonScheme.
+//   Byte 10: Index of the FEC packet, which selects its row of the code.
+//   Byte 11: Recovery field for the P, X and CC fields.
+//
+// This is not part of the FlexFEC specification, so it may only be sent to
+// receivers that signaled support for it. XOR coded packets keep the reserved
+// bytes zero, which tells the two schemes apart. The number of FEC packets
+// follows the protection factor, as for the XOR schemes.
+class ReedSolomonFec : public ForwardErrorCorrection {
+ public:
+  static constexpr uint8_t kReedSolomonScheme = 1;
+
+  ReedSolomonFec(uint32_t ssrc, uint32_t protected_media_ssrc);
+  ~ReedSolomonFec() override;
+
+  // Returns true if the FlexFEC packet |fec_packet| is coded with this scheme.
+  // The packet must be at least as long as the FlexFEC base header.
+  static bool IsReedSolomonCoded(const Packet& fec_packet);
+
+ protected:
+  void GeneratePacketMasks(size_t num_media_packets,
+                           size_t num_fec_packets,
+                           int num_important_packets,
+                           bool use_unequal_protection,
+                           FecMaskType fec_mask_type) override;
+  void GenerateFecPayloads(const PacketList& media_packets,
+                           size_t num_fec_packets) override;
+  void FinalizeFecHeaders(size_t num_fec_packets,
+                          uint32_t media_ssrc,
+                          uint16_t seq_num_base) override;
+  void AttemptRecovery(RecoveredPacketList* recovered_packets) override;
+
+ private:
+  // Recovers the |num_missing| packets which are missing from the protected
+  // packets of |fec_packets|, all of which belong to the same block.
+  bool RecoverPackets(
+      const std::vector<const ReceivedFecPacket*>& fec_packets,
+      size_t num_missing,
+      RecoveredPacketList* recovered_packets);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_FEC_H_
@@ -0,0 +1,269 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_fec.h"
+
+#include <string.h>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/fec_test_helper.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+using Packet = ForwardErrorCorrection::Packet;
+using ReceivedPacket = ForwardErrorCorrection::ReceivedPacket;
+using RecoveredPacket = ForwardErrorCorrection::RecoveredPacket;
+
+// Transport header size in bytes. Assume UDP/IPv4 as a reasonable minimum.
+constexpr size_t kTransportOverhead = 28;
+
+constexpr uint32_t kMediaSsrc = 83542;
+constexpr uint32_t kFlexfecSsrc = 43245;
+constexpr uint16_t kFirstFecSeqNum = 1000;
+
+constexpr int kNumImportantPackets = 0;
+constexpr bool kUseUnequalProtection = false;
+
+// Protection factor giving |num_fec_packets| FEC packets for
+// |num_media_packets| media packets.
+uint8_t ProtectionFactor(int num_fec_packets, int num_media_packets) {
+  return static_cast<uint8_t>(256 * num_fec_packets / num_media_packets - 1);
+}
+
+class ReedSolomonFecTest : public ::testing::Test {
+ protected:
+  ReedSolomonFecTest()
+      : fec_(ForwardErrorCorrection::CreateFlexfec(
+            kFlexfecSsrc,
+            kMediaSsrc,
+            FlexfecScheme::kReedSolomon)),
+        random_(0x5eed5eed),
+        media_packet_generator_(kRtpHeaderSize,
+                                IP_PACKET_SIZE - kRtpHeaderSize -
+                                    kTransportOverhead -
+                                    fec_->MaxPacketOverhead(),
+                                kMediaSsrc,
+                                &random_) {}
+
+  void EncodeFec(int num_media_packets, int num_fec_packets) {
+    media_packets_ =
+        media_packet_generator_.ConstructMediaPackets(num_media_packets);
+    fec_packets_.clear();
+    ASSERT_EQ(0, fec_->EncodeFec(
+                     media_packets_,
+                     ProtectionFactor(num_fec_packets, num_media_packets),
+                     kNumImportantPackets, kUseUnequalProtection,
+                     kFecMaskRandom, &fec_packets_));
+    ASSERT_EQ(static_cast<size_t>(num_fec_packets), fec_packets_.size());
+  }
+
+  // Decodes all packets except the media and FEC packets at the indices in
+  // |lost_media| and |lost_fec|.
+  void Decode(const std::vector<size_t>& lost_media,
+              const std::vector<size_t>& lost_fec) {
+    fec_->ResetState(&recovered_packets_);
+    size_t index = 0;
+    for (const auto& media_packet : media_packets_) {
+      if (!absl::c_linear_search(lost_media, index++)) {
+        const uint16_t seq_num =
+            ByteReader<uint16_t>::ReadBigEndian(&media_packet->data[2]);
+        DecodePacket(*media_packet, kMediaSsrc, seq_num, false);
+      }
+    }
+    index = 0;
+    for (const Packet* fec_packet : fec_packets_) {
+      const uint16_t seq_num = kFirstFecSeqNum + index;
+      if (!absl::c_linear_search(lost_fec, index++))
+        DecodePacket(*fec_packet, kFlexfecSsrc, seq_num, true);
+    }
+  }
+
+  void DecodePacket(const Packet& packet,
+                    uint32_t ssrc,
+                    uint16_t seq_num,
+                    bool is_fec) {
+    ReceivedPacket received_packet;
+    received_packet.pkt = new Packet();
+    received_packet.pkt->length = packet.length;
+    memcpy(received_packet.pkt->data, packet.data, packet.length);
+    received_packet.ssrc = ssrc;
+    received_packet.seq_num = seq_num;
+    received_packet.is_fec = is_fec;
+    fec_->DecodeFec(received_packet, &recovered_packets_);
+  }
+
+  bool IsRecoveryComplete() const {
+    return absl::c_equal(
+        media_packets_, recovered_packets_,
+        [](const std::unique_ptr<Packet>& media_packet,
+           const std::unique_ptr<RecoveredPacket>& recovered_packet) {
+          return media_packet->length == recovered_packet->pkt->length &&
+                 memcmp(media_packet->data, recovered_packet->pkt->data,
+                        media_packet->length) == 0;
+        });
+  }
+
+  size_t NumRecoveredPackets() const {
+    return absl::c_count_if(
+        recovered_packets_,
+        [](const std::unique_ptr<RecoveredPacket>& recovered_packet) {
+          return recovered_packet->was_recovered;
+        });
+  }
+
+  std::unique_ptr<ForwardErrorCorrection> fec_;
+  Random random_;
+  test::fec::MediaPacketGenerator media_packet_generator_;
+  ForwardErrorCorrection::PacketList media_packets_;
+  std::list<Packet*> fec_packets_;
+  ForwardErrorCorrection::RecoveredPacketList recovered_packets_;
+};
+
+}  // namespace
+
+TEST_F(ReedSolomonFecTest, WritesSchemeAndRowToReservedBytes) {
+  EncodeFec(10, 3);
+  uint8_t row = 0;
+  for (const Packet* fec_packet : fec_packets_) {
+    EXPECT_EQ(0, fec_packet->data[0] & 0xc0);  // R and F bits.
+    EXPECT_EQ(ReedSolomonFec::kReedSolomonScheme, fec_packet->data[9]);
+    EXPECT_EQ(row++, fec_packet->data[10]);
+    EXPECT_TRUE(ReedSolomonFec::IsReedSolomonCoded(*fec_packet));
+  }
+}
+
+TEST_F(ReedSolomonFecTest, RecoversBurstLoss) {
+  EncodeFec(10, 4);
+  Decode({3, 4, 5, 6}, {});
+  EXPECT_TRUE(IsRecoveryComplete());
+  EXPECT_EQ(4u, NumRecoveredPackets());
+}
+
+TEST_F(ReedSolomonFecTest, RecoversAnyLossOfAsManyPacketsAsFecPackets) {
+  constexpr uint32_t kNumMediaPackets = 12;
+  constexpr uint32_t kNumFecPackets = 6;
+  EncodeFec(kNumMediaPackets, kNumFecPackets);
+  for (int i = 0; i < 50; ++i) {
+    std::vector<size_t> media_indices(kNumMediaPackets);
+    std::vector<size_t> fec_indices(kNumFecPackets);
+    for (size_t j = 0; j < media_indices.size(); ++j)
+      media_indices[j] = j;
+    for (size_t j = 0; j < fec_indices.size(); ++j)
+      fec_indices[j] = j;
+    for (uint32_t j = kNumMediaPackets - 1; j > 0; --j)
+      std::swap(media_indices[j], media_indices[random_.Rand(0u, j)]);
+    for (uint32_t j = kNumFecPackets - 1; j > 0; --j)
+      std::swap(fec_indices[j], fec_indices[random_.Rand(0u, j)]);
+    // Lose |num_lost_media| media packets, and as many FEC packets as can be
+    // lost with those still being recoverable.
+    const uint32_t num_lost_media = random_.Rand(1u, kNumFecPackets);
+    media_indices.resize(num_lost_media);
+    fec_indices.resize(kNumFecPackets - num_lost_media);
+    Decode(media_indices, fec_indices);
+    EXPECT_TRUE(IsRecoveryComplete());
+    EXPECT_EQ(size_t{num_lost_media}, NumRecoveredPackets());
+  }
+}
+
+TEST_F(ReedSolomonFecTest, RecoversWithGapInSequenceNumbers) {
+  EncodeFec(8, 1);
+  // Encode again, with the third media packet missing from the frame.
+  media_packets_.erase(std::next(media_packets_.begin(), 2));
+  fec_packets_.clear();
+  ASSERT_EQ(0, fec_->EncodeFec(media_packets_, ProtectionFactor(3, 7),
+                               kNumImportantPackets, kUseUnequalProtection,
+                               kFecMaskRandom, &fec_packets_));
+  ASSERT_EQ(3u, fec_packets_.size());
+  Decode({0, 4, 6}, {});
+  EXPECT_TRUE(IsRecoveryComplete());
+}
+
+TEST_F(ReedSolomonFecTest, RecoversBlockOfMaxSize) {
+  // 47 or more media packets need the 14 byte FlexFEC packet mask.
+  EncodeFec(48, 2);
+  Decode({0, 47}, {});
+  EXPECT_TRUE(IsRecoveryComplete());
+  EXPECT_EQ(2u, NumRecoveredPackets());
+}
+
+TEST_F(ReedSolomonFecTest, DropsPacketsProtectingMoreThanMaxBlockSize) {
+  media_packets_ = media_packet_generator_.ConstructMediaPackets(10);
+  const uint16_t seq_num_base =
+      ByteReader<uint16_t>::ReadBigEndian(&media_packets_.front()->data[2]);
+  // A full size packet with a 14 byte mask protecting the first media packet
+  // and the one 100 sequence numbers later, which is never received.
+  Packet fec_packet;
+  memset(fec_packet.data, 0, IP_PACKET_SIZE);
+  fec_packet.length = IP_PACKET_SIZE;
+  fec_packet.data[8] = 1;  // SSRCCount.
+  fec_packet.data[9] = ReedSolomonFec::kReedSolomonScheme;
+  fec_packet.data[10] = 0;  // Row.
+  ByteWriter<uint32_t>::WriteBigEndian(&fec_packet.data[12], kMediaSsrc);
+  ByteWriter<uint16_t>::WriteBigEndian(&fec_packet.data[16], seq_num_base);
+  fec_packet.data[18] = 0x40;  // Column 0, K-bit 0 clear.
+  fec_packet.data[24] = 0x80;  // K-bit 2 set.
+  fec_packet.data[30] = 0x01;  // Column 100.
+
+  fec_->ResetState(&recovered_packets_);
+  for (const auto& media_packet : media_packets_) {
+    const uint16_t seq_num =
+        ByteReader<uint16_t>::ReadBigEndian(&media_packet->data[2]);
+    DecodePacket(*media_packet, kMediaSsrc, seq_num, false);
+  }
+  DecodePacket(fec_packet, kFlexfecSsrc, kFirstFecSeqNum, true);
+  EXPECT_EQ(media_packets_.size(), recovered_packets_.size());
+  EXPECT_EQ(0u, NumRecoveredPackets());
+}
+
+TEST_F(ReedSolomonFecTest, DoesNotRecoverMoreLossesThanFecPackets) {
+  EncodeFec(8, 2);
+  Decode({1, 2, 3}, {});
+  EXPECT_FALSE(IsRecoveryComplete());
+  EXPECT_EQ(0u, NumRecoveredPackets());
+
+  Decode({1, 2}, {0});
+  EXPECT_FALSE(IsRecoveryComplete());
+  EXPECT_EQ(0u, NumRecoveredPackets());
+}
+
+TEST_F(ReedSolomonFecTest, IgnoresXorCodedPackets) {
+  std::unique_ptr<ForwardErrorCorrection> xor_fec =
+      ForwardErrorCorrection::CreateFlexfec(kFlexfecSsrc, kMediaSsrc);
+  media_packets_ = media_packet_generator_.ConstructMediaPackets(4);
+  ASSERT_EQ(0, xor_fec->EncodeFec(media_packets_, ProtectionFactor(1, 4),
+                                  kNumImportantPackets, kUseUnequalProtection,
+                                  kFecMaskRandom, &fec_packets_));
+  ASSERT_EQ(1u, fec_packets_.size());
+  Decode({2}, {});
+  EXPECT_EQ(0u, NumRecoveredPackets());
+  for (const Packet* fec_packet : fec_packets_)
+    EXPECT_FALSE(ReedSolomonFec::IsReedSolomonCoded(*fec_packet));
+}
+
+TEST_F(ReedSolomonFecTest, IsIgnoredByXorDecoder) {
+  EncodeFec(4, 1);
+  // The encoder owns the FEC packets, so it's kept alive.
+  std::unique_ptr<ForwardErrorCorrection> reed_solomon_fec = std::move(fec_);
+  fec_ = ForwardErrorCorrection::CreateFlexfec(kFlexfecSsrc, kMediaSsrc);
+  Decode({2}, {});
+  EXPECT_EQ(0u, NumRecoveredPackets());
+}
+
+}  // namespace webrtc
@@ -12,12 +12,15 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "api/video/video_bitrate_allocator.h"
@@ -62,11 +65,35 @@ const int64_t kRtcpMinFrameLengthMs = 17;
 // Maximum number of received RRTRs that will be stored.
 const size_t kMaxNumberOfStoredRrtrs = 200;
 
+// Per remote ssrc state is stored in vectors of entries with an |ssrc| member.
+template <typename T>
+T* FindBySsrc(std::vector<T>* entries, uint32_t ssrc) {
+  auto it = absl::c_find_if(
+      *entries, [ssrc](const T& entry) { return entry.ssrc == ssrc; });
+  return it != entries->end() ? &*it : nullptr;
+}
+
+template <typename T>
+const T* FindBySsrc(const std::vector<T>& entries, uint32_t ssrc) {
+  auto it = absl::c_find_if(
+      entries, [ssrc](const T& entry) { return entry.ssrc == ssrc; });
+  return it != entries.end() ? &*it : nullptr;
+}
+
+template <typename T>
+void EraseBySsrc(std::vector<T>* entries, uint32_t ssrc) {
+  entries->erase(
+      std::remove_if(entries->begin(), entries->end(),
+                     [ssrc](const T& entry) { return entry.ssrc == ssrc; }),
+      entries->end());
+}
+
 }  // namespace
 
 struct RTCPReceiver::PacketInformation {
   uint32_t packet_type_flags = 0;  // RTCPPacketTypeFlags bit field.
 
+  uint32_t local_ssrc = 0;
   uint32_t remote_ssrc = 0;
   std::vector<uint16_t> nack_sequence_numbers;
   ReportBlockList report_blocks;
@@ -84,6 +111,10 @@ struct RTCPReceiver::TmmbrInformation {
     int64_t last_updated_ms;
   };
 
+  explicit TmmbrInformation(uint32_t ssrc) : ssrc(ssrc) {}
+
+  uint32_t ssrc;
+
   int64_t last_time_received_ms = 0;
 
   bool ready_for_delete = false;
@@ -119,12 +150,20 @@ struct RTCPReceiver::ReportBlockWithRtt {
 };
 
 struct RTCPReceiver::LastFirStatus {
-  LastFirStatus(int64_t now_ms, uint8_t sequence_number)
-      : request_ms(now_ms), sequence_number(sequence_number) {}
+  LastFirStatus(uint32_t ssrc, int64_t now_ms, uint8_t sequence_number)
+      : ssrc(ssrc), request_ms(now_ms), sequence_number(sequence_number) {}
+  uint32_t ssrc;
   int64_t request_ms;
   uint8_t sequence_number;
 };
 
+struct RTCPReceiver::CnameInformation {
+  CnameInformation(uint32_t ssrc, const std::string& cname)
+      : ssrc(ssrc), cname(cname) {}
+  uint32_t ssrc;
+  std::string cname;
+};
+
 RTCPReceiver::RTCPReceiver(
     Clock* clock,
     bool receiver_only,
@@ -149,6 +188,7 @@ RTCPReceiver::RTCPReceiver(
       xr_rrtr_status_(false),
       xr_rr_rtt_ms_(0),
       oldest_tmmbr_info_ms_(0),
+      report_blocks_main_ssrc_(0),
       last_received_rb_ms_(0),
       last_increased_sequence_number_ms_(0),
       stats_callback_(nullptr),
@@ -173,7 +213,7 @@ void RTCPReceiver::IncomingPacket(const uint8_t* packet, size_t packet_size) {
 }
 
 int64_t RTCPReceiver::LastReceivedReportBlockMs() const {
-  rtc::CritScope lock(&rtcp_receiver_lock_);
+  rtc::CritScope lock(&report_blocks_lock_);
   return last_received_rb_ms_;
 }
 
@@ -193,7 +233,10 @@ void RTCPReceiver::SetSsrcs(uint32_t main_ssrc,
                             const std::set<uint32_t>& registered_ssrcs) {
   rtc::CritScope lock(&rtcp_receiver_lock_);
   main_ssrc_ = main_ssrc;
-  registered_ssrcs_ = registered_ssrcs;
+  // std::set iterates in sorted order.
+  registered_ssrcs_.assign(registered_ssrcs.begin(), registered_ssrcs.end());
+  rtc::CritScope report_blocks_lock(&report_blocks_lock_);
+  report_blocks_main_ssrc_ = main_ssrc;
 }
 
 int32_t RTCPReceiver::RTT(uint32_t remote_ssrc,
@@ -201,17 +244,18 @@ int32_t RTCPReceiver::RTT(uint32_t remote_ssrc,
                           int64_t* avg_rtt_ms,
                           int64_t* min_rtt_ms,
                           int64_t* max_rtt_ms) const {
-  rtc::CritScope lock(&rtcp_receiver_lock_);
-
-  auto it = received_report_blocks_.find(main_ssrc_);
+  rtc::CritScope lock(&report_blocks_lock_);
+
+  auto it = absl::c_find_if(
+      received_report_blocks_, [&](const ReportBlockWithRtt& report_block) {
+        return report_block.report_block.source_ssrc ==
+                   report_blocks_main_ssrc_ &&
+               report_block.report_block.sender_ssrc == remote_ssrc;
+      });
   if (it == received_report_blocks_.end())
     return -1;
 
-  auto it_info = it->second.find(remote_ssrc);
-  if (it_info == it->second.end())
-    return -1;
-
-  const ReportBlockWithRtt* report_block = &it_info->second;
+  const ReportBlockWithRtt* report_block = &*it;
 
   if (report_block->num_rtts == 0)
     return -1;
@@ -288,12 +332,12 @@ RTCPReceiver::ConsumeReceivedXrReferenceTimeInfo() {
       CompactNtp(TimeMicrosToNtp(clock_->TimeInMicroseconds()));
 
   for (size_t i = 0; i < last_xr_rtis_size; ++i) {
-    RrtrInformation& rrtr = received_rrtrs_.front();
+    const RrtrInformation& rrtr = received_rrtrs_[i];
     last_xr_rtis.emplace_back(rrtr.ssrc, rrtr.received_remote_mid_ntp_time,
                               now_ntp - rrtr.local_receive_mid_ntp_time);
-    received_rrtrs_ssrc_it_.erase(rrtr.ssrc);
-    received_rrtrs_.pop_front();
   }
+  received_rrtrs_.erase(received_rrtrs_.begin(),
+                        received_rrtrs_.begin() + last_xr_rtis_size);
 
   return last_xr_rtis;
 }
@@ -302,18 +346,24 @@ RTCPReceiver::ConsumeReceivedXrReferenceTimeInfo() {
 int32_t RTCPReceiver::StatisticsReceived(
     std::vector<RTCPReportBlock>* receive_blocks) const {
   RTC_DCHECK(receive_blocks);
-  rtc::CritScope lock(&rtcp_receiver_lock_);
-  for (const auto& reports_per_receiver : received_report_blocks_)
-    for (const auto& report : reports_per_receiver.second)
-      receive_blocks->push_back(report.second.report_block);
+  rtc::CritScope lock(&report_blocks_lock_);
+  for (const ReportBlockWithRtt& report : received_report_blocks_)
+    receive_blocks->push_back(report.report_block);
   return 0;
 }
 
+bool RTCPReceiver::IsRegisteredSsrc(uint32_t ssrc) const {
+  return std::binary_search(registered_ssrcs_.begin(), registered_ssrcs_.end(),
+                            ssrc);
+}
+
 bool RTCPReceiver::ParseCompoundPacket(const uint8_t* packet_begin,
                                        const uint8_t* packet_end,
                                        PacketInformation* packet_information) {
   rtc::CritScope lock(&rtcp_receiver_lock_);
 
+  packet_information->local_ssrc = main_ssrc_;
+
   CommonHeader rtcp_block;
   for (const uint8_t* next_block = packet_begin; next_block != packet_end;
        next_block = rtcp_block.NextPacket()) {
@@ -476,13 +526,20 @@ void RTCPReceiver::HandleReportBlock(const ReportBlock& report_block,
   // which the information in this reception report block pertains.
 
   // Filter out all report blocks that are not for us.
-  if (registered_ssrcs_.count(report_block.source_ssrc()) == 0)
+  if (!IsRegisteredSsrc(report_block.source_ssrc()))
     return;
 
+  rtc::CritScope lock(&report_blocks_lock_);
   last_received_rb_ms_ = clock_->TimeInMilliseconds();
 
-  ReportBlockWithRtt* report_block_info =
-      &received_report_blocks_[report_block.source_ssrc()][remote_ssrc];
+  auto it = absl::c_find_if(
+      received_report_blocks_, [&](const ReportBlockWithRtt& info) {
+        return info.report_block.source_ssrc == report_block.source_ssrc() &&
+               info.report_block.sender_ssrc == remote_ssrc;
+      });
+  if (it == received_report_blocks_.end())
+    it = received_report_blocks_.emplace(received_report_blocks_.end());
+  ReportBlockWithRtt* report_block_info = &*it;
   report_block_info->report_block.sender_ssrc = remote_ssrc;
   report_block_info->report_block.source_ssrc = report_block.source_ssrc();
   report_block_info->report_block.fraction_lost = report_block.fraction_lost();
@@ -545,28 +602,29 @@ void RTCPReceiver::HandleReportBlock(const ReportBlock& report_block,
 RTCPReceiver::TmmbrInformation* RTCPReceiver::FindOrCreateTmmbrInfo(
     uint32_t remote_ssrc) {
   // Create or find receive information.
-  TmmbrInformation* tmmbr_info = &tmmbr_infos_[remote_ssrc];
+  TmmbrInformation* tmmbr_info = FindBySsrc(&tmmbr_infos_, remote_ssrc);
+  if (!tmmbr_info) {
+    tmmbr_infos_.emplace_back(remote_ssrc);
+    tmmbr_info = &tmmbr_infos_.back();
+  }
   // Update that this remote is alive.
   tmmbr_info->last_time_received_ms = clock_->TimeInMilliseconds();
   return tmmbr_info;
 }
 
 void RTCPReceiver::UpdateTmmbrRemoteIsAlive(uint32_t remote_ssrc) {
-  auto tmmbr_it = tmmbr_infos_.find(remote_ssrc);
-  if (tmmbr_it != tmmbr_infos_.end())
-    tmmbr_it->second.last_time_received_ms = clock_->TimeInMilliseconds();
+  TmmbrInformation* tmmbr_info = FindBySsrc(&tmmbr_infos_, remote_ssrc);
+  if (tmmbr_info)
+    tmmbr_info->last_time_received_ms = clock_->TimeInMilliseconds();
 }
 
 RTCPReceiver::TmmbrInformation* RTCPReceiver::GetTmmbrInformation(
     uint32_t remote_ssrc) {
-  auto it = tmmbr_infos_.find(remote_ssrc);
-  if (it == tmmbr_infos_.end())
-    return nullptr;
-  return &it->second;
+  return FindBySsrc(&tmmbr_infos_, remote_ssrc);
 }
 
 bool RTCPReceiver::RtcpRrTimeout() {
-  rtc::CritScope lock(&rtcp_receiver_lock_);
+  rtc::CritScope lock(&report_blocks_lock_);
   if (last_received_rb_ms_ == 0)
     return false;
 
@@ -606,7 +664,7 @@ bool RTCPReceiver::UpdateTmmbrTimers() {
   bool update_bounding_set = false;
   oldest_tmmbr_info_ms_ = -1;
   for (auto tmmbr_it = tmmbr_infos_.begin(); tmmbr_it != tmmbr_infos_.end();) {
-    TmmbrInformation* tmmbr_info = &tmmbr_it->second;
+    TmmbrInformation* tmmbr_info = &*tmmbr_it;
     if (tmmbr_info->last_time_received_ms > 0) {
       if (tmmbr_info->last_time_received_ms < timeout_ms) {
         // No rtcp packet for the last 5 regular intervals, reset limitations.
@@ -622,7 +680,7 @@ bool RTCPReceiver::UpdateTmmbrTimers() {
       ++tmmbr_it;
     } else if (tmmbr_info->ready_for_delete) {
       // When we dont have a last_time_received_ms and the object is marked
-      // ready_for_delete it's removed from the map.
+      // ready_for_delete it's removed.
       tmmbr_it = tmmbr_infos_.erase(tmmbr_it);
     } else {
       ++tmmbr_it;
@@ -650,7 +708,11 @@ void RTCPReceiver::HandleSdes(const CommonHeader& rtcp_block,
   }
 
   for (const rtcp::Sdes::Chunk& chunk : sdes.chunks()) {
-    received_cnames_[chunk.ssrc] = chunk.cname;
+    CnameInformation* cname_info = FindBySsrc(&received_cnames_, chunk.ssrc);
+    if (cname_info)
+      cname_info->cname = chunk.cname;
+    else
+      received_cnames_.emplace_back(chunk.ssrc, chunk.cname);
     {
       rtc::CritScope lock(&feedbacks_lock_);
       if (stats_callback_)
@@ -693,20 +755,25 @@ void RTCPReceiver::HandleBye(const CommonHeader& rtcp_block) {
   }
 
   // Clear our lists.
-  for (auto& reports_per_receiver : received_report_blocks_)
-    reports_per_receiver.second.erase(bye.sender_ssrc());
+  {
+    rtc::CritScope lock(&report_blocks_lock_);
+    received_report_blocks_.erase(
+        std::remove_if(received_report_blocks_.begin(),
+                       received_report_blocks_.end(),
+                       [&bye](const ReportBlockWithRtt& info) {
+                         return info.report_block.sender_ssrc ==
+                                bye.sender_ssrc();
+                       }),
+        received_report_blocks_.end());
+  }
 
   TmmbrInformation* tmmbr_info = GetTmmbrInformation(bye.sender_ssrc());
   if (tmmbr_info)
     tmmbr_info->ready_for_delete = true;
 
-  last_fir_.erase(bye.sender_ssrc());
-  received_cnames_.erase(bye.sender_ssrc());
-  auto it = received_rrtrs_ssrc_it_.find(bye.sender_ssrc());
-  if (it != received_rrtrs_ssrc_it_.end()) {
-    received_rrtrs_.erase(it->second);
-    received_rrtrs_ssrc_it_.erase(it);
-  }
+  EraseBySsrc(&last_fir_, bye.sender_ssrc());
+  EraseBySsrc(&received_cnames_, bye.sender_ssrc());
+  EraseBySsrc(&received_rrtrs_, bye.sender_ssrc());
   xr_rr_rtt_ms_ = 0;
 }
 
@@ -736,15 +803,14 @@ void RTCPReceiver::HandleXrReceiveReferenceTime(uint32_t sender_ssrc,
   uint32_t local_receive_mid_ntp_time =
       CompactNtp(TimeMicrosToNtp(clock_->TimeInMicroseconds()));
 
-  auto it = received_rrtrs_ssrc_it_.find(sender_ssrc);
-  if (it != received_rrtrs_ssrc_it_.end()) {
-    it->second->received_remote_mid_ntp_time = received_remote_mid_ntp_time;
-    it->second->local_receive_mid_ntp_time = local_receive_mid_ntp_time;
+  RrtrInformation* rrtr_info = FindBySsrc(&received_rrtrs_, sender_ssrc);
+  if (rrtr_info) {
+    rrtr_info->received_remote_mid_ntp_time = received_remote_mid_ntp_time;
+    rrtr_info->local_receive_mid_ntp_time = local_receive_mid_ntp_time;
   } else {
     if (received_rrtrs_.size() < kMaxNumberOfStoredRrtrs) {
       received_rrtrs_.emplace_back(sender_ssrc, received_remote_mid_ntp_time,
                                    local_receive_mid_ntp_time);
-      received_rrtrs_ssrc_it_[sender_ssrc] = std::prev(received_rrtrs_.end());
     } else {
       RTC_LOG(LS_WARNING) << "Discarding received RRTR for ssrc " << sender_ssrc
                           << ", reached maximum number of stored RRTRs.";
@@ -753,7 +819,7 @@ void RTCPReceiver::HandleXrReceiveReferenceTime(uint32_t sender_ssrc,
 }
 
 void RTCPReceiver::HandleXrDlrrReportBlock(const rtcp::ReceiveTimeInfo& rti) {
-  if (registered_ssrcs_.count(rti.ssrc) == 0)  // Not to us.
+  if (!IsRegisteredSsrc(rti.ssrc))  // Not to us.
     return;
 
   // Caller should explicitly enable rtt calculation using extended reports.
@@ -911,11 +977,10 @@ void RTCPReceiver::HandleFir(const CommonHeader& rtcp_block,
     ++packet_type_counter_.fir_packets;
 
     int64_t now_ms = clock_->TimeInMilliseconds();
-    auto inserted = last_fir_.insert(std::make_pair(
-        fir.sender_ssrc(), LastFirStatus(now_ms, fir_request.seq_nr)));
-    if (!inserted.second) {  // There was already an entry.
-      LastFirStatus* last_fir = &inserted.first->second;
-
+    LastFirStatus* last_fir = FindBySsrc(&last_fir_, fir.sender_ssrc());
+    if (!last_fir) {
+      last_fir_.emplace_back(fir.sender_ssrc(), now_ms, fir_request.seq_nr);
+    } else {
       // Check if we have reported this FIRSequenceNumber before.
       if (fir_request.seq_nr == last_fir->sequence_number)
         continue;
@@ -942,6 +1007,10 @@ void RTCPReceiver::HandleTransportFeedback(
     return;
   }
 
+  const uint32_t media_source_ssrc = transport_feedback->media_ssrc();
+  if (media_source_ssrc != main_ssrc_ && !IsRegisteredSsrc(media_source_ssrc))
+    return;  // Not to us.
+
   packet_information->packet_type_flags |= kRtcpTransportFeedback;
   packet_information->transport_feedback = std::move(transport_feedback);
 }
@@ -982,14 +1051,8 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
     // Might trigger a OnReceivedBandwidthEstimateUpdate.
     NotifyTmmbrUpdated();
   }
-  uint32_t local_ssrc;
-  std::set<uint32_t> registered_ssrcs;
-  {
-    // We don't want to hold this critsect when triggering the callbacks below.
-    rtc::CritScope lock(&rtcp_receiver_lock_);
-    local_ssrc = main_ssrc_;
-    registered_ssrcs = registered_ssrcs_;
-  }
+  // Everything below was extracted while the packet was parsed, so no lock
+  // is taken again.
   if (!receiver_only_ && (packet_information.packet_type_flags & kRtcpSrReq)) {
     rtp_rtcp_->OnRequestSendReport();
   }
@@ -1016,7 +1079,8 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
         RTC_LOG(LS_VERBOSE)
             << "Incoming FIR from SSRC " << packet_information.remote_ssrc;
       }
-      rtcp_intra_frame_observer_->OnReceivedIntraFrameRequest(local_ssrc);
+      rtcp_intra_frame_observer_->OnReceivedIntraFrameRequest(
+          packet_information.local_ssrc);
     }
   }
   if (rtcp_bandwidth_observer_) {
@@ -1052,13 +1116,8 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
 
   if (transport_feedback_observer_ &&
       (packet_information.packet_type_flags & kRtcpTransportFeedback)) {
-    uint32_t media_source_ssrc =
-        packet_information.transport_feedback->media_ssrc();
-    if (media_source_ssrc == local_ssrc ||
-        registered_ssrcs.find(media_source_ssrc) != registered_ssrcs.end()) {
-      transport_feedback_observer_->OnTransportFeedback(
-          *packet_information.transport_feedback);
-    }
+    transport_feedback_observer_->OnTransportFeedback(
+        *packet_information.transport_feedback);
   }
 
   if (bitrate_allocation_observer_ &&
@@ -1089,11 +1148,12 @@ int32_t RTCPReceiver::CNAME(uint32_t remoteSSRC,
   RTC_DCHECK(cName);
 
   rtc::CritScope lock(&rtcp_receiver_lock_);
-  auto received_cname_it = received_cnames_.find(remoteSSRC);
-  if (received_cname_it == received_cnames_.end())
+  const CnameInformation* cname_info =
+      FindBySsrc(received_cnames_, remoteSSRC);
+  if (!cname_info)
     return -1;
 
-  size_t length = received_cname_it->second.copy(cName, RTCP_CNAME_SIZE - 1);
+  size_t length = cname_info->cname.copy(cName, RTCP_CNAME_SIZE - 1);
   cName[length] = 0;
   return 0;
 }
@@ -1105,11 +1165,11 @@ std::vector<rtcp::TmmbItem> RTCPReceiver::TmmbrReceived() {
   int64_t now_ms = clock_->TimeInMilliseconds();
   int64_t timeout_ms = now_ms - kTmmbrTimeoutIntervalMs;
 
-  for (auto& kv : tmmbr_infos_) {
-    for (auto it = kv.second.tmmbr.begin(); it != kv.second.tmmbr.end();) {
+  for (TmmbrInformation& tmmbr_info : tmmbr_infos_) {
+    for (auto it = tmmbr_info.tmmbr.begin(); it != tmmbr_info.tmmbr.end();) {
       if (it->second.last_updated_ms < timeout_ms) {
         // Erase timeout entries.
-        it = kv.second.tmmbr.erase(it);
+        it = tmmbr_info.tmmbr.erase(it);
       } else {
         candidates.push_back(it->second.tmmbr_item);
         ++it;
@@ -11,10 +11,7 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_H_
 #define MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_H_
 
-#include <list>
-#include <map>
 #include <set>
-#include <string>
 #include <vector>
 
 #include "modules/rtp_rtcp/include/rtcp_statistics.h"
@@ -120,10 +117,7 @@ class RTCPReceiver {
   struct RrtrInformation;
   struct ReportBlockWithRtt;
   struct LastFirStatus;
-  // RTCP report blocks mapped by remote SSRC.
-  using ReportBlockInfoMap = std::map<uint32_t, ReportBlockWithRtt>;
-  // RTCP report blocks map mapped by source SSRC.
-  using ReportBlockMap = std::map<uint32_t, ReportBlockInfoMap>;
+  struct CnameInformation;
 
   bool ParseCompoundPacket(const uint8_t* packet_begin,
                            const uint8_t* packet_end,
@@ -132,6 +126,9 @@ class RTCPReceiver {
   void TriggerCallbacksFromRtcpPacket(
       const PacketInformation& packet_information);
 
+  bool IsRegisteredSsrc(uint32_t ssrc) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
+
   TmmbrInformation* FindOrCreateTmmbrInfo(uint32_t remote_ssrc)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
   // Update TmmbrInformation (if present) is alive.
@@ -219,10 +216,14 @@ class RTCPReceiver {
   VideoBitrateAllocationObserver* const bitrate_allocation_observer_;
   const int report_interval_ms_;
 
+  // Held while a compound packet is parsed. Per remote SSRC state is kept in
+  // small vectors searched linearly, which beats a tree of maps for the tens
+  // of SSRCs a transport carries.
   rtc::CriticalSection rtcp_receiver_lock_;
   uint32_t main_ssrc_ RTC_GUARDED_BY(rtcp_receiver_lock_);
   uint32_t remote_ssrc_ RTC_GUARDED_BY(rtcp_receiver_lock_);
-  std::set<uint32_t> registered_ssrcs_ RTC_GUARDED_BY(rtcp_receiver_lock_);
+  // Sorted.
+  std::vector<uint32_t> registered_ssrcs_ RTC_GUARDED_BY(rtcp_receiver_lock_);
 
   // Received sender report.
   NtpTime remote_sender_ntp_time_ RTC_GUARDED_BY(rtcp_receiver_lock_);
@@ -230,30 +231,34 @@ class RTCPReceiver {
   // When did we receive the last send report.
   NtpTime last_received_sr_ntp_ RTC_GUARDED_BY(rtcp_receiver_lock_);
 
-  // Received RRTR information in ascending receive time order.
-  std::list<RrtrInformation> received_rrtrs_
+  // Received RRTR information in ascending receive time order, at most one
+  // per remote ssrc.
+  std::vector<RrtrInformation> received_rrtrs_
       RTC_GUARDED_BY(rtcp_receiver_lock_);
-  // Received RRTR information mapped by remote ssrc.
-  std::map<uint32_t, std::list<RrtrInformation>::iterator>
-      received_rrtrs_ssrc_it_ RTC_GUARDED_BY(rtcp_receiver_lock_);
 
   // Estimated rtt, zero when there is no valid estimate.
   bool xr_rrtr_status_ RTC_GUARDED_BY(rtcp_receiver_lock_);
   int64_t xr_rr_rtt_ms_;
 
   int64_t oldest_tmmbr_info_ms_ RTC_GUARDED_BY(rtcp_receiver_lock_);
-  // Mapped by remote ssrc.
-  std::map<uint32_t, TmmbrInformation> tmmbr_infos_
-      RTC_GUARDED_BY(rtcp_receiver_lock_);
-
-  ReportBlockMap received_report_blocks_ RTC_GUARDED_BY(rtcp_receiver_lock_);
-  std::map<uint32_t, LastFirStatus> last_fir_
+  // One per remote ssrc.
+  std::vector<TmmbrInformation> tmmbr_infos_
       RTC_GUARDED_BY(rtcp_receiver_lock_);
-  std::map<uint32_t, std::string> received_cnames_
+  std::vector<LastFirStatus> last_fir_ RTC_GUARDED_BY(rtcp_receiver_lock_);
+  std::vector<CnameInformation> received_cnames_
       RTC_GUARDED_BY(rtcp_receiver_lock_);
 
+  // Report blocks are read by stats and RTT queries on other threads. They
+  // have their own lock, so that those readers don't wait for the parsing of
+  // whole compound packets.
+  rtc::CriticalSection report_blocks_lock_;
+  // Copy of |main_ssrc_| for RTT().
+  uint32_t report_blocks_main_ssrc_ RTC_GUARDED_BY(report_blocks_lock_);
+  // One per pair of source and remote ssrc.
+  std::vector<ReportBlockWithRtt> received_report_blocks_
+      RTC_GUARDED_BY(report_blocks_lock_);
   // The last time we received an RTCP Report block for this module.
-  int64_t last_received_rb_ms_ RTC_GUARDED_BY(rtcp_receiver_lock_);
+  int64_t last_received_rb_ms_ RTC_GUARDED_BY(report_blocks_lock_);
 
   // The time we last received an RTCP RR telling we have successfully
   // delivered RTP packet to the remote side.
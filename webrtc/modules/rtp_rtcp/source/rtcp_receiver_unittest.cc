@@ -626,6 +626,40 @@ TEST_F(RtcpReceiverTest, InjectByePacket_RemovesReportBlocks) {
   EXPECT_EQ(2u, received_blocks.size());
 }
 
+TEST_F(RtcpReceiverTest, InjectByePacket_KeepsReportBlocksOfOtherSenders) {
+  const uint32_t kSenderSsrcs[] = {kSenderSsrc, 0x20304, 0x30405};
+  for (uint32_t sender_ssrc : kSenderSsrcs) {
+    rtcp::ReportBlock rb;
+    rb.SetMediaSsrc(kReceiverMainSsrc);
+    rb.SetLastSr(0x1234);
+    rb.SetDelayLastSr(0x222);
+    rtcp::ReceiverReport rr;
+    rr.SetSenderSsrc(sender_ssrc);
+    rr.AddReportBlock(rb);
+
+    EXPECT_CALL(rtp_rtcp_impl_, OnReceivedRtcpReportBlocks(SizeIs(1)));
+    EXPECT_CALL(bandwidth_observer_, OnReceivedRtcpReceiverReport(_, _, _));
+    InjectRtcpPacket(rr);
+  }
+
+  rtcp::Bye bye;
+  bye.SetSenderSsrc(kSenderSsrcs[1]);
+  InjectRtcpPacket(bye);
+
+  EXPECT_EQ(0, rtcp_receiver_.RTT(kSenderSsrcs[0], nullptr, nullptr, nullptr,
+                                  nullptr));
+  EXPECT_EQ(-1, rtcp_receiver_.RTT(kSenderSsrcs[1], nullptr, nullptr, nullptr,
+                                   nullptr));
+  EXPECT_EQ(0, rtcp_receiver_.RTT(kSenderSsrcs[2], nullptr, nullptr, nullptr,
+                                  nullptr));
+  std::vector<RTCPReportBlock> received_blocks;
+  rtcp_receiver_.StatisticsReceived(&received_blocks);
+  EXPECT_THAT(received_blocks,
+              UnorderedElementsAre(
+                  Field(&RTCPReportBlock::sender_ssrc, kSenderSsrcs[0]),
+                  Field(&RTCPReportBlock::sender_ssrc, kSenderSsrcs[2])));
+}
+
 TEST_F(RtcpReceiverTest, InjectByePacketRemovesReferenceTimeInfo) {
   rtcp::ExtendedReports xr;
   xr.SetSenderSsrc(kSenderSsrc);
@@ -1181,6 +1215,17 @@ TEST_F(RtcpReceiverTest, ReceivesTransportFeedback) {
   InjectRtcpPacket(packet);
 }
 
+TEST_F(RtcpReceiverTest, TransportFeedbackNotToUsIgnored) {
+  rtcp::TransportFeedback packet;
+  packet.SetMediaSsrc(kNotToUsSsrc);
+  packet.SetSenderSsrc(kSenderSsrc);
+  packet.SetBase(1, 1000);
+  packet.AddReceivedPacket(1, 1000);
+
+  EXPECT_CALL(transport_feedback_observer_, OnTransportFeedback(_)).Times(0);
+  InjectRtcpPacket(packet);
+}
+
 TEST_F(RtcpReceiverTest, ReceivesRemb) {
   const uint32_t kBitrateBps = 500000;
   rtcp::Remb remb;
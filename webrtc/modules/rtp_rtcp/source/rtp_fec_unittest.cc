@@ -10,12 +10,14 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "absl/algorithm/container.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/fec_test_helper.h"
 #include "modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "modules/rtp_rtcp/source/forward_error_correction.h"
+#include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
 #include "modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
 #include "rtc_base/random.h"
 #include "test/gtest.h"
@@ -333,6 +335,74 @@ TYPED_TEST(RtpFecTest, FecRecoveryWithLoss) {
   EXPECT_FALSE(this->IsRecoveryComplete());
 }
 
+// FEC packets protecting many media packets of different lengths, so that
+// the payloads are XORed in several passes with partial tails.
+TYPED_TEST(RtpFecTest, FecRecoveryWithLossManyMediaPackets) {
+  constexpr int kNumImportantPackets = 0;
+  constexpr bool kUseUnequalProtection = false;
+  constexpr int kNumMediaPackets = 48;
+  constexpr uint8_t kProtectionFactor = 30;
+
+  this->media_packets_ =
+      this->media_packet_generator_.ConstructMediaPackets(kNumMediaPackets);
+
+  EXPECT_EQ(
+      0, this->fec_.EncodeFec(this->media_packets_, kProtectionFactor,
+                              kNumImportantPackets, kUseUnequalProtection,
+                              kFecMaskRandom, &this->generated_fec_packets_));
+
+  // Expect 6 FEC packets.
+  EXPECT_EQ(6u, this->generated_fec_packets_.size());
+
+  // 1 media packet lost.
+  memset(this->media_loss_mask_, 0, sizeof(this->media_loss_mask_));
+  memset(this->fec_loss_mask_, 0, sizeof(this->fec_loss_mask_));
+  this->media_loss_mask_[kNumMediaPackets / 2] = 1;
+  this->NetworkReceivedPackets(this->media_loss_mask_, this->fec_loss_mask_);
+
+  for (const auto& received_packet : this->received_packets_) {
+    this->fec_.DecodeFec(*received_packet, &this->recovered_packets_);
+  }
+
+  // One packet lost, all FEC packets received, expect complete recovery.
+  EXPECT_TRUE(this->IsRecoveryComplete());
+}
+
+TYPED_TEST(RtpFecTest, ReusesRecoveredPacketStorage) {
+  constexpr int kNumImportantPackets = 0;
+  constexpr bool kUseUnequalProtection = false;
+  constexpr int kNumMediaPackets = 4;
+  constexpr uint8_t kProtectionFactor = 60;
+
+  this->media_packets_ =
+      this->media_packet_generator_.ConstructMediaPackets(kNumMediaPackets);
+  EXPECT_EQ(
+      0, this->fec_.EncodeFec(this->media_packets_, kProtectionFactor,
+                              kNumImportantPackets, kUseUnequalProtection,
+                              kFecMaskBursty, &this->generated_fec_packets_));
+
+  memset(this->media_loss_mask_, 0, sizeof(this->media_loss_mask_));
+  memset(this->fec_loss_mask_, 0, sizeof(this->fec_loss_mask_));
+  this->media_loss_mask_[3] = 1;
+  const ForwardErrorCorrection::Packet* recovered_storage[2] = {nullptr,
+                                                                nullptr};
+  for (const ForwardErrorCorrection::Packet*& storage : recovered_storage) {
+    this->NetworkReceivedPackets(this->media_loss_mask_, this->fec_loss_mask_);
+    for (const auto& received_packet : this->received_packets_) {
+      this->fec_.DecodeFec(*received_packet, &this->recovered_packets_);
+    }
+    EXPECT_TRUE(this->IsRecoveryComplete());
+    for (const auto& recovered_packet : this->recovered_packets_) {
+      if (recovered_packet->was_recovered)
+        storage = recovered_packet->pkt.get();
+    }
+    this->fec_.ResetState(&this->recovered_packets_);
+  }
+
+  ASSERT_NE(nullptr, recovered_storage[0]);
+  EXPECT_EQ(recovered_storage[0], recovered_storage[1]);
+}
+
 // Verify that we don't use an old FEC packet for FEC decoding.
 TYPED_TEST(RtpFecTest, NoFecRecoveryWithOldFecPacket) {
   constexpr int kNumImportantPackets = 0;
@@ -1125,4 +1195,33 @@ TYPED_TEST(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(this->IsRecoveryComplete());
 }
 
+TEST(FecXorTest, XorBuffersMatchesBytewiseXor) {
+  Random random(0x5eed);
+  for (size_t num_srcs = 0; num_srcs <= 9; ++num_srcs) {
+    std::vector<std::vector<uint8_t>> buffers(num_srcs);
+    std::vector<const uint8_t*> srcs;
+    std::vector<size_t> lengths;
+    for (std::vector<uint8_t>& buffer : buffers) {
+      // Lengths which are not multiples of the vector or word size.
+      buffer.resize(random.Rand(0, 300));
+      for (uint8_t& byte : buffer)
+        byte = random.Rand<uint8_t>();
+      srcs.push_back(buffer.data());
+      lengths.push_back(buffer.size());
+    }
+    uint8_t expected[300];
+    for (uint8_t& byte : expected)
+      byte = random.Rand<uint8_t>();
+    uint8_t dst[300];
+    memcpy(dst, expected, sizeof(dst));
+    for (size_t k = 0; k < num_srcs; ++k) {
+      for (size_t i = 0; i < lengths[k]; ++i)
+        expected[i] ^= srcs[k][i];
+    }
+
+    internal::XorBuffers(srcs.data(), lengths.data(), num_srcs, dst);
+    EXPECT_EQ(0, memcmp(expected, dst, sizeof(dst))) << num_srcs << " sources";
+  }
+}
+
 }  // namespace webrtc
@@ -16,14 +16,19 @@
 #include <string.h>
 #include <time.h>
 
+#include <iterator>
 #include <list>
+#include <memory>
+#include <vector>
 
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/forward_error_correction.h"
 #include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
 #include "rtc_base/random.h"
+#include "rtc_base/time_utils.h"
 #include "test/gtest.h"
 #include "test/testsupport/file_utils.h"
+#include "test/testsupport/perf_test.h"
 
 // #define VERBOSE_OUTPUT
 
@@ -465,6 +470,115 @@ void RunTest(bool use_flexfec) {
       << "Recovered packet list is not empty";
 }
 
+std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> CreateReceivedPacket(
+    const ForwardErrorCorrection::Packet& packet,
+    uint32_t ssrc,
+    uint16_t seq_num,
+    bool is_fec) {
+  std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> received_packet(
+      new ForwardErrorCorrection::ReceivedPacket());
+  received_packet->pkt = new ForwardErrorCorrection::Packet();
+  received_packet->pkt->length = packet.length;
+  memcpy(received_packet->pkt->data, packet.data, packet.length);
+  received_packet->ssrc = ssrc;
+  received_packet->seq_num = seq_num;
+  received_packet->is_fec = is_fec;
+  return received_packet;
+}
+
+// Repeatedly encodes one frame and recovers one lost media packet of it, and
+// returns the throughput in Mbps of media.
+void MeasureThroughput(bool use_flexfec,
+                       FecMaskType fec_mask_type,
+                       double* encode_mbps,
+                       double* decode_mbps) {
+  // Largest frame the bursty mask table covers.
+  const uint16_t kNumMediaPackets = 12;
+  // Half as many FEC packets as media packets.
+  const uint8_t kProtectionFactor = 128;
+  const int kNumRuns = 5000;
+
+  Random random(0xfec);
+  const uint32_t media_ssrc = random.Rand(1u, 0xfffffffe);
+  const uint32_t fec_ssrc =
+      use_flexfec ? random.Rand(1u, 0xfffffffe) : media_ssrc;
+  std::unique_ptr<ForwardErrorCorrection> fec =
+      use_flexfec ? ForwardErrorCorrection::CreateFlexfec(fec_ssrc, media_ssrc)
+                  : ForwardErrorCorrection::CreateUlpfec(fec_ssrc);
+
+  // Full sized packets, as for a video key frame.
+  const uint32_t timestamp = random.Rand<uint32_t>();
+  ForwardErrorCorrection::PacketList media_packet_list;
+  size_t media_bytes = 0;
+  for (uint16_t seq_num = 0; seq_num < kNumMediaPackets; ++seq_num) {
+    std::unique_ptr<ForwardErrorCorrection::Packet> media_packet(
+        new ForwardErrorCorrection::Packet());
+    media_packet->length = IP_PACKET_SIZE - 12 - 28 - fec->MaxPacketOverhead();
+    // Version 2, without the marker bit.
+    media_packet->data[0] = 0x80;
+    media_packet->data[1] = 0;
+    ByteWriter<uint16_t>::WriteBigEndian(&media_packet->data[2], seq_num);
+    ByteWriter<uint32_t>::WriteBigEndian(&media_packet->data[4], timestamp);
+    ByteWriter<uint32_t>::WriteBigEndian(&media_packet->data[8], media_ssrc);
+    for (size_t j = 12; j < media_packet->length; ++j) {
+      media_packet->data[j] = random.Rand<uint8_t>();
+    }
+    media_bytes += media_packet->length;
+    media_packet_list.push_back(std::move(media_packet));
+  }
+  media_packet_list.back()->data[1] |= 0x80;
+
+  std::list<ForwardErrorCorrection::Packet*> fec_packet_list;
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumRuns; ++i) {
+    fec_packet_list.clear();
+    ASSERT_EQ(0, fec->EncodeFec(media_packet_list, kProtectionFactor, 0, false,
+                                fec_mask_type, &fec_packet_list));
+  }
+  const int64_t encode_time_us = rtc::TimeMicros() - start_us;
+
+  // All packets but the first media packet are received, which is recovered
+  // with both mask types. The received packets are copied for every run, as
+  // the FEC headers are parsed in place.
+  ForwardErrorCorrection::RecoveredPacketList recovered_packet_list;
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumRuns; ++i) {
+    fec->ResetState(&recovered_packet_list);
+    for (auto it = std::next(media_packet_list.begin());
+         it != media_packet_list.end(); ++it) {
+      fec->DecodeFec(
+          *CreateReceivedPacket(**it, media_ssrc,
+                                ByteReader<uint16_t>::ReadBigEndian(
+                                    &(*it)->data[2]),
+                                false),
+          &recovered_packet_list);
+    }
+    uint16_t fec_seq_num = kNumMediaPackets;
+    for (const auto* fec_packet : fec_packet_list) {
+      fec->DecodeFec(
+          *CreateReceivedPacket(*fec_packet, fec_ssrc, fec_seq_num++, true),
+          &recovered_packet_list);
+    }
+  }
+  const int64_t decode_time_us = rtc::TimeMicros() - start_us;
+
+  ASSERT_EQ(kNumMediaPackets, recovered_packet_list.size());
+  const ForwardErrorCorrection::Packet& lost_packet =
+      *media_packet_list.front();
+  const ForwardErrorCorrection::Packet& recovered_packet =
+      *recovered_packet_list.front()->pkt;
+  ASSERT_EQ(lost_packet.length, recovered_packet.length);
+  ASSERT_EQ(0, memcmp(lost_packet.data, recovered_packet.data,
+                      lost_packet.length));
+  fec->ResetState(&recovered_packet_list);
+
+  ASSERT_GT(encode_time_us, 0);
+  ASSERT_GT(decode_time_us, 0);
+  const double media_bits = 8.0 * media_bytes * kNumRuns;
+  *encode_mbps = media_bits / encode_time_us;
+  *decode_mbps = media_bits / decode_time_us;
+}
+
 TEST(FecTest, UlpfecTest) {
   RunTest(false);
 }
@@ -473,5 +587,49 @@ TEST(FecTest, FlexfecTest) {
   RunTest(true);
 }
 
+TEST(FecTest, DISABLED_UlpfecThroughputRandomMask) {
+  double encode_mbps = 0;
+  double decode_mbps = 0;
+  ASSERT_NO_FATAL_FAILURE(
+      MeasureThroughput(false, kFecMaskRandom, &encode_mbps, &decode_mbps));
+  PrintResult("fec_encode", "", "ulpfec_random_mask", encode_mbps, "Mbps",
+              false);
+  PrintResult("fec_decode", "", "ulpfec_random_mask", decode_mbps, "Mbps",
+              false);
+}
+
+TEST(FecTest, DISABLED_UlpfecThroughputBurstyMask) {
+  double encode_mbps = 0;
+  double decode_mbps = 0;
+  ASSERT_NO_FATAL_FAILURE(
+      MeasureThroughput(false, kFecMaskBursty, &encode_mbps, &decode_mbps));
+  PrintResult("fec_encode", "", "ulpfec_bursty_mask", encode_mbps, "Mbps",
+              false);
+  PrintResult("fec_decode", "", "ulpfec_bursty_mask", decode_mbps, "Mbps",
+              false);
+}
+
+TEST(FecTest, DISABLED_FlexfecThroughputRandomMask) {
+  double encode_mbps = 0;
+  double decode_mbps = 0;
+  ASSERT_NO_FATAL_FAILURE(
+      MeasureThroughput(true, kFecMaskRandom, &encode_mbps, &decode_mbps));
+  PrintResult("fec_encode", "", "flexfec_random_mask", encode_mbps, "Mbps",
+              false);
+  PrintResult("fec_decode", "", "flexfec_random_mask", decode_mbps, "Mbps",
+              false);
+}
+
+TEST(FecTest, DISABLED_FlexfecThroughputBurstyMask) {
+  double encode_mbps = 0;
+  double decode_mbps = 0;
+  ASSERT_NO_FATAL_FAILURE(
+      MeasureThroughput(true, kFecMaskBursty, &encode_mbps, &decode_mbps));
+  PrintResult("fec_encode", "", "flexfec_bursty_mask", encode_mbps, "Mbps",
+              false);
+  PrintResult("fec_decode", "", "flexfec_bursty_mask", decode_mbps, "Mbps",
+              false);
+}
+
 }  // namespace test
 }  // namespace webrtc
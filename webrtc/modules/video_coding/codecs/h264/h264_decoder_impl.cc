@@ -27,8 +27,10 @@ extern "C" {
 #include "modules/video_coding/codecs/h264/h264_color_space.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/critical_section.h"
+#include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "rtc_base/logging.h"
+#include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
 
 namespace webrtc {
@@ -41,6 +43,12 @@ const size_t kYPlaneIndex = 0;
 const size_t kUPlaneIndex = 1;
 const size_t kVPlaneIndex = 2;
 
+const char kMultithreadedDecodingFieldTrial[] =
+    "WebRTC-H264-MultithreadedDecoding";
+constexpr int kMaxDecoderThreads = 16;
+
+enum class ThreadingMode { kSlice, kFrame };
+
 // Used by histograms. Values of entries should not be changed.
 enum H264DecoderImplEvent {
   kH264DecoderEventInit = 0,
@@ -95,8 +103,11 @@ int H264DecoderImpl::AVGetBuffer2(
   // http://crbug.com/390941. Our pool is set up to zero-initialize new buffers.
   // TODO(nisse): Delete that feature from the video pool, instead add
   // an explicit call to InitializeData here.
-  rtc::scoped_refptr<I420Buffer> frame_buffer =
-      decoder->pool_.CreateBuffer(width, height);
+  rtc::scoped_refptr<I420Buffer> frame_buffer;
+  {
+    rtc::CritScope lock(&decoder->pool_lock_);
+    frame_buffer = decoder->pool_.CreateBuffer(width, height);
+  }
 
   int y_size = width * height;
   int uv_size = frame_buffer->ChromaWidth() * frame_buffer->ChromaHeight();
@@ -142,11 +153,13 @@ void H264DecoderImpl::AVFreeBuffer2(void* opaque, uint8_t* data) {
   delete video_frame;
 }
 
-H264DecoderImpl::H264DecoderImpl() : pool_(true),
-                                     decoded_image_callback_(nullptr),
-                                     has_reported_init_(false),
-                                     has_reported_error_(false) {
-}
+H264DecoderImpl::H264DecoderImpl()
+    : pool_(true),
+      decoded_image_callback_(nullptr),
+      next_frame_id_(0),
+      frame_threading_(false),
+      has_reported_init_(false),
+      has_reported_error_(false) {}
 
 H264DecoderImpl::~H264DecoderImpl() {
   Release();
@@ -182,10 +195,7 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
   av_context_->extradata = nullptr;
   av_context_->extradata_size = 0;
 
-  // If this is ever increased, look at |av_context_->thread_safe_callbacks| and
-  // make it possible to disable the thread checker in the frame buffer pool.
-  av_context_->thread_count = 1;
-  av_context_->thread_type = FF_THREAD_SLICE;
+  ConfigureThreading(number_of_cores);
 
   // Function used by FFmpeg to get buffers to store decoded frames in.
   av_context_->get_buffer2 = AVGetBuffer2;
@@ -217,9 +227,39 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
 int32_t H264DecoderImpl::Release() {
   av_context_.reset();
   av_frame_.reset();
+  pending_frames_.clear();
+  frame_threading_ = false;
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void H264DecoderImpl::ConfigureThreading(int number_of_cores) {
+  FieldTrialFlag enabled("Enabled");
+  FieldTrialParameter<int> threads("threads", 0);
+  FieldTrialEnum<ThreadingMode> mode(
+      "mode", ThreadingMode::kSlice,
+      {{"slice", ThreadingMode::kSlice}, {"frame", ThreadingMode::kFrame}});
+  FieldTrialParameter<int> max_delay("max_delay", 1);
+  ParseFieldTrial({&enabled, &threads, &mode, &max_delay},
+                  field_trial::FindFullName(kMultithreadedDecodingFieldTrial));
+
+  int thread_count = 1;
+  if (enabled) {
+    thread_count = threads.Get() > 0 ? threads.Get() : number_of_cores;
+    thread_count = std::min(std::max(thread_count, 1), kMaxDecoderThreads);
+    if (mode.Get() == ThreadingMode::kFrame) {
+      // Frame threading holds back up to |thread_count| - 1 frames.
+      thread_count = std::min(thread_count, 1 + std::max(max_delay.Get(), 0));
+    }
+  }
+  frame_threading_ = thread_count > 1 && mode.Get() == ThreadingMode::kFrame;
+  av_context_->thread_count = thread_count;
+  av_context_->thread_type =
+      frame_threading_ ? FF_THREAD_FRAME : FF_THREAD_SLICE;
+  // |AVGetBuffer2| locks the buffer pool, so it may be called from the
+  // decoder threads directly.
+  av_context_->thread_safe_callbacks = thread_count > 1 ? 1 : 0;
+}
+
 int32_t H264DecoderImpl::RegisterDecodeCompleteCallback(
     DecodedImageCallback* callback) {
   decoded_image_callback_ = callback;
@@ -260,88 +300,120 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   packet.size = static_cast<int>(input_image.size());
-  int64_t frame_timestamp_us = input_image.ntp_time_ms_ * 1000;  // ms -> μs
-  av_context_->reordered_opaque = frame_timestamp_us;
+  const int64_t frame_id = next_frame_id_++;
+  av_context_->reordered_opaque = frame_id;
+
+  PendingFrame pending_frame;
+  pending_frame.id = frame_id;
+  pending_frame.rtp_timestamp = input_image.Timestamp();
+  // Pass on color space from input frame if explicitly specified.
+  if (input_image.ColorSpace())
+    pending_frame.color_space = *input_image.ColorSpace();
+  // TODO(sakal): Maybe it is possible to get QP directly from FFmpeg.
+  h264_bitstream_parser_.ParseBitstream(input_image.data(), input_image.size());
+  int qp_int;
+  if (h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
+    pending_frame.qp.emplace(qp_int);
+  }
+  pending_frames_.push_back(pending_frame);
 
   int result = avcodec_send_packet(av_context_.get(), &packet);
   if (result < 0) {
     RTC_LOG(LS_ERROR) << "avcodec_send_packet error: " << result;
+    pending_frames_.pop_back();
     ReportError();
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
 
-  result = avcodec_receive_frame(av_context_.get(), av_frame_.get());
-  if (result < 0) {
+  result = DeliverDecodedFrames();
+  // With frame threading, output lags behind input and a call may not produce
+  // a frame. Otherwise every packet is expected to produce one.
+  if (result < 0 || (result == 0 && !frame_threading_)) {
     RTC_LOG(LS_ERROR) << "avcodec_receive_frame error: " << result;
     ReportError();
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
 
-  // We don't expect reordering. Decoded frame tamestamp should match
-  // the input one.
-  RTC_DCHECK_EQ(av_frame_->reordered_opaque, frame_timestamp_us);
-
-  // Obtain the |video_frame| containing the decoded image.
-  VideoFrame* input_frame =
-      static_cast<VideoFrame*>(av_buffer_get_opaque(av_frame_->buf[0]));
-  RTC_DCHECK(input_frame);
-  rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer =
-      input_frame->video_frame_buffer()->GetI420();
-  RTC_CHECK_EQ(av_frame_->data[kYPlaneIndex], i420_buffer->DataY());
-  RTC_CHECK_EQ(av_frame_->data[kUPlaneIndex], i420_buffer->DataU());
-  RTC_CHECK_EQ(av_frame_->data[kVPlaneIndex], i420_buffer->DataV());
-
-  // Pass on color space from input frame if explicitly specified.
-  const ColorSpace& color_space =
-      input_image.ColorSpace() ? *input_image.ColorSpace()
-                               : ExtractH264ColorSpace(av_context_.get());
-  VideoFrame decoded_frame =
-      VideoFrame::Builder()
-          .set_video_frame_buffer(input_frame->video_frame_buffer())
-          .set_timestamp_us(input_frame->timestamp_us())
-          .set_timestamp_rtp(input_image.Timestamp())
-          .set_rotation(input_frame->rotation())
-          .set_color_space(color_space)
-          .build();
-
-  absl::optional<uint8_t> qp;
-  // TODO(sakal): Maybe it is possible to get QP directly from FFmpeg.
-  h264_bitstream_parser_.ParseBitstream(input_image.data(), input_image.size());
-  int qp_int;
-  if (h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
-    qp.emplace(qp_int);
-  }
-
-  // The decoded image may be larger than what is supposed to be visible, see
-  // |AVGetBuffer2|'s use of |avcodec_align_dimensions|. This crops the image
-  // without copying the underlying buffer.
-  if (av_frame_->width != i420_buffer->width() ||
-      av_frame_->height != i420_buffer->height()) {
-    rtc::scoped_refptr<VideoFrameBuffer> cropped_buf = WrapI420Buffer(
-        av_frame_->width, av_frame_->height, i420_buffer->DataY(),
-        i420_buffer->StrideY(), i420_buffer->DataU(), i420_buffer->StrideU(),
-        i420_buffer->DataV(), i420_buffer->StrideV(),
-        rtc::KeepRefUntilDone(i420_buffer));
-    VideoFrame cropped_frame =
+int H264DecoderImpl::DeliverDecodedFrames() {
+  int num_delivered_frames = 0;
+  while (true) {
+    int result = avcodec_receive_frame(av_context_.get(), av_frame_.get());
+    if (result == AVERROR(EAGAIN))
+      break;
+    if (result < 0)
+      return result;
+
+    // Frames come out in decode order; entries of frames that FFmpeg dropped
+    // are skipped.
+    while (!pending_frames_.empty() &&
+           pending_frames_.front().id != av_frame_->reordered_opaque) {
+      pending_frames_.pop_front();
+    }
+    RTC_DCHECK(!pending_frames_.empty());
+    if (pending_frames_.empty()) {
+      av_frame_unref(av_frame_.get());
+      continue;
+    }
+    const PendingFrame pending_frame = pending_frames_.front();
+    pending_frames_.pop_front();
+
+    // Obtain the |video_frame| containing the decoded image.
+    VideoFrame* input_frame =
+        static_cast<VideoFrame*>(av_buffer_get_opaque(av_frame_->buf[0]));
+    RTC_DCHECK(input_frame);
+    rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer =
+        input_frame->video_frame_buffer()->GetI420();
+    RTC_CHECK_EQ(av_frame_->data[kYPlaneIndex], i420_buffer->DataY());
+    RTC_CHECK_EQ(av_frame_->data[kUPlaneIndex], i420_buffer->DataU());
+    RTC_CHECK_EQ(av_frame_->data[kVPlaneIndex], i420_buffer->DataV());
+
+    const ColorSpace color_space =
+        pending_frame.color_space ? *pending_frame.color_space
+                                  : ExtractH264ColorSpace(av_context_.get());
+    VideoFrame decoded_frame =
         VideoFrame::Builder()
-            .set_video_frame_buffer(cropped_buf)
-            .set_timestamp_ms(decoded_frame.render_time_ms())
-            .set_timestamp_rtp(decoded_frame.timestamp())
-            .set_rotation(decoded_frame.rotation())
+            .set_video_frame_buffer(input_frame->video_frame_buffer())
+            .set_timestamp_us(input_frame->timestamp_us())
+            .set_timestamp_rtp(pending_frame.rtp_timestamp)
+            .set_rotation(input_frame->rotation())
             .set_color_space(color_space)
             .build();
-    // TODO(nisse): Timestamp and rotation are all zero here. Change decoder
-    // interface to pass a VideoFrameBuffer instead of a VideoFrame?
-    decoded_image_callback_->Decoded(cropped_frame, absl::nullopt, qp);
-  } else {
-    // Return decoded frame.
-    decoded_image_callback_->Decoded(decoded_frame, absl::nullopt, qp);
-  }
-  // Stop referencing it, possibly freeing |input_frame|.
-  av_frame_unref(av_frame_.get());
-  input_frame = nullptr;
 
-  return WEBRTC_VIDEO_CODEC_OK;
+    // The decoded image may be larger than what is supposed to be visible, see
+    // |AVGetBuffer2|'s use of |avcodec_align_dimensions|. This crops the image
+    // without copying the underlying buffer.
+    if (av_frame_->width != i420_buffer->width() ||
+        av_frame_->height != i420_buffer->height()) {
+      rtc::scoped_refptr<VideoFrameBuffer> cropped_buf = WrapI420Buffer(
+          av_frame_->width, av_frame_->height, i420_buffer->DataY(),
+          i420_buffer->StrideY(), i420_buffer->DataU(), i420_buffer->StrideU(),
+          i420_buffer->DataV(), i420_buffer->StrideV(),
+          rtc::KeepRefUntilDone(i420_buffer));
+      VideoFrame cropped_frame =
+          VideoFrame::Builder()
+              .set_video_frame_buffer(cropped_buf)
+              .set_timestamp_ms(decoded_frame.render_time_ms())
+              .set_timestamp_rtp(decoded_frame.timestamp())
+              .set_rotation(decoded_frame.rotation())
+              .set_color_space(color_space)
+              .build();
+      // TODO(nisse): Timestamp and rotation are all zero here. Change decoder
+      // interface to pass a VideoFrameBuffer instead of a VideoFrame?
+      decoded_image_callback_->Decoded(cropped_frame, absl::nullopt,
+                                       pending_frame.qp);
+    } else {
+      // Return decoded frame.
+      decoded_image_callback_->Decoded(decoded_frame, absl::nullopt,
+                                       pending_frame.qp);
+    }
+    // Stop referencing it, possibly freeing |input_frame|.
+    av_frame_unref(av_frame_.get());
+    input_frame = nullptr;
+    ++num_delivered_frames;
+  }
+  return num_delivered_frames;
 }
 
 const char* H264DecoderImpl::ImplementationName() const {
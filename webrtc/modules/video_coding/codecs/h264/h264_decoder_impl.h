@@ -12,6 +12,7 @@
 #ifndef MODULES_VIDEO_CODING_CODECS_H264_H264_DECODER_IMPL_H_
 #define MODULES_VIDEO_CODING_CODECS_H264_H264_DECODER_IMPL_H_
 
+#include <deque>
 #include <memory>
 
 #include "modules/video_coding/codecs/h264/include/h264.h"
@@ -34,8 +35,12 @@ extern "C" {
 #include "third_party/ffmpeg/libavcodec/avcodec.h"
 }  // extern "C"
 
+#include "absl/types/optional.h"
+#include "api/video/color_space.h"
 #include "common_video/h264/h264_bitstream_parser.h"
 #include "common_video/include/i420_buffer_pool.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
@@ -46,6 +51,16 @@ struct AVFrameDeleter {
   void operator()(AVFrame* ptr) const { av_frame_free(&ptr); }
 };
 
+// By default frames are decoded on the calling thread. The
+// "WebRTC-H264-MultithreadedDecoding" field trial enables FFmpeg's threading,
+// e.g. "Enabled,threads:4,mode:frame,max_delay:1":
+//   threads   - number of decoder threads; 0 picks one per core.
+//   mode      - "slice" decodes the slices of a frame in parallel and adds no
+//               delay, but only helps if the stream has several slices per
+//               frame. "frame" decodes consecutive frames in parallel.
+//   max_delay - upper bound on the number of frames that frame threading may
+//               hold back; limits the thread count in frame mode.
+// Output order is always decode order.
 class H264DecoderImpl : public H264Decoder {
  public:
   H264DecoderImpl();
@@ -80,16 +95,38 @@ class H264DecoderImpl : public H264Decoder {
 
   bool IsInitialized() const;
 
+  // Sets up |av_context_| threading from the field trial.
+  void ConfigureThreading(int number_of_cores);
+
+  // Delivers all frames FFmpeg has finished decoding. Returns the number of
+  // delivered frames, or a negative FFmpeg error code.
+  int DeliverDecodedFrames();
+
   // Reports statistics with histograms.
   void ReportInit();
   void ReportError();
 
-  I420BufferPool pool_;
+  // Only accessed from |AVGetBuffer2|, which FFmpeg may call from its decoder
+  // threads when threading is enabled.
+  rtc::CriticalSection pool_lock_;
+  I420BufferPool pool_ RTC_GUARDED_BY(pool_lock_);
   std::unique_ptr<AVCodecContext, AVCodecContextDeleter> av_context_;
   std::unique_ptr<AVFrame, AVFrameDeleter> av_frame_;
 
   DecodedImageCallback* decoded_image_callback_;
 
+  // Information about frames passed to FFmpeg that have not been output yet.
+  // Frames are matched through |AVFrame::reordered_opaque|.
+  struct PendingFrame {
+    int64_t id;
+    uint32_t rtp_timestamp;
+    absl::optional<ColorSpace> color_space;
+    absl::optional<uint8_t> qp;
+  };
+  std::deque<PendingFrame> pending_frames_;
+  int64_t next_frame_id_;
+  bool frame_threading_;
+
   bool has_reported_init_;
   bool has_reported_error_;
 
@@ -11,6 +11,7 @@
 
 #include "modules/video_coding/codecs/h264/h264_encoder_impl.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -167,7 +168,9 @@ H264EncoderImpl::H264EncoderImpl(const cricket::VideoCodec& codec)
       has_reported_init_(false),
       has_reported_error_(false),
       num_temporal_layers_(1),
-      tl0sync_limit_(0) {
+      tl0sync_limit_(0),
+      complexity_settings_(
+          EncoderComplexityController::GetSettingsFromFieldTrial()) {
   RTC_CHECK(absl::EqualsIgnoreCase(codec.name, cricket::kH264CodecName));
   std::string packetization_mode_string;
   if (codec.GetParam(cricket::kH264FmtpPacketizationMode,
@@ -291,6 +294,13 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* inst,
     int video_format = EVideoFormatType::videoFormatI420;
     openh264_encoder->SetOption(ENCODER_OPTION_DATAFORMAT, &video_format);
 
+    if (complexity_settings_) {
+      initial_complexity_modes_.push_back(encoder_params.iComplexityMode);
+      complexity_controllers_.emplace_back(
+          *complexity_settings_,
+          encoder_params.iComplexityMode - LOW_COMPLEXITY + 1);
+    }
+
     // Initialize encoded image. Default buffer size: size of unencoded data.
 
     const size_t new_capacity =
@@ -322,6 +332,8 @@ int32_t H264EncoderImpl::Release() {
   configurations_.clear();
   encoded_images_.clear();
   pictures_.clear();
+  complexity_controllers_.clear();
+  initial_complexity_modes_.clear();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -479,6 +491,7 @@ int32_t H264EncoderImpl::Encode(
     memset(&info, 0, sizeof(SFrameBSInfo));
 
     // Encode!
+    const int64_t encode_start_ms = rtc::TimeMillis();
     int enc_ret = encoders_[i]->EncodeFrame(&pictures_[i], &info);
     if (enc_ret != 0) {
       RTC_LOG(LS_ERROR)
@@ -487,6 +500,12 @@ int32_t H264EncoderImpl::Encode(
       ReportError();
       return WEBRTC_VIDEO_CODEC_ERROR;
     }
+    if (!complexity_controllers_.empty() &&
+        complexity_controllers_[i].OnFrameEncoded(
+            rtc::TimeMillis() - encode_start_ms,
+            configurations_[i].max_frame_rate)) {
+      SetComplexityLevel(i);
+    }
 
     encoded_images_[i]._encodedWidth = configurations_[i].width;
     encoded_images_[i]._encodedHeight = configurations_[i].height;
@@ -580,6 +599,10 @@ SEncParamExt H264EncoderImpl::CreateEncoderParams(size_t i) const {
   // >1: number of threads
   encoder_params.iMultipleThreadIdc = NumberOfThreads(
       encoder_params.iPicWidth, encoder_params.iPicHeight, number_of_cores_);
+  // OpenH264 defaults to its lowest complexity mode, which would leave the
+  // complexity controller nothing to reduce. Start one mode higher instead.
+  if (complexity_settings_)
+    encoder_params.iComplexityMode = MEDIUM_COMPLEXITY;
   // The base spatial layer 0 is the only one we use.
   encoder_params.sSpatialLayers[0].iVideoWidth = encoder_params.iPicWidth;
   encoder_params.sSpatialLayers[0].iVideoHeight = encoder_params.iPicHeight;
@@ -618,6 +641,22 @@ SEncParamExt H264EncoderImpl::CreateEncoderParams(size_t i) const {
   return encoder_params;
 }
 
+void H264EncoderImpl::SetComplexityLevel(size_t i) {
+  RTC_DCHECK_LT(i, complexity_controllers_.size());
+  int complexity_mode =
+      initial_complexity_modes_[i] - complexity_controllers_[i].level();
+  RTC_LOG(LS_INFO) << "OpenH264 encoder " << i << " complexity mode "
+                   << complexity_mode;
+  encoders_[i]->SetOption(ENCODER_OPTION_COMPLEXITY, &complexity_mode);
+}
+
+std::vector<int> H264EncoderImpl::NumComplexityLevelsForTesting() const {
+  std::vector<int> num_levels;
+  for (const EncoderComplexityController& controller : complexity_controllers_)
+    num_levels.push_back(controller.num_levels());
+  return num_levels;
+}
+
 void H264EncoderImpl::ReportInit() {
   if (has_reported_init_)
     return;
@@ -641,6 +680,11 @@ VideoEncoder::EncoderInfo H264EncoderImpl::GetEncoderInfo() const {
   info.scaling_settings =
       VideoEncoder::ScalingSettings(kLowH264QpThreshold, kHighH264QpThreshold);
   info.is_hardware_accelerated = false;
+  info.can_reduce_complexity = std::any_of(
+      complexity_controllers_.begin(), complexity_controllers_.end(),
+      [](const EncoderComplexityController& controller) {
+        return controller.CanReduceEffort();
+      });
   info.has_internal_source = false;
   return info;
 }
@@ -18,6 +18,7 @@
 #include "api/video/i420_buffer.h"
 #include "common_video/h264/h264_bitstream_parser.h"
 #include "modules/video_coding/codecs/h264/include/h264.h"
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
 #include "modules/video_coding/utility/quality_scaler.h"
 
 #include "third_party/openh264/src/codec/api/svc/codec_app_def.h"
@@ -75,9 +76,15 @@ class H264EncoderImpl : public H264Encoder {
   H264PacketizationMode PacketizationModeForTesting() const {
     return packetization_mode_;
   }
+  // Number of complexity levels per encoder, empty if the complexity
+  // controller is disabled.
+  std::vector<int> NumComplexityLevelsForTesting() const;
 
  private:
   SEncParamExt CreateEncoderParams(size_t i) const;
+  // Sets the complexity mode of |encoders_[i]| from the level of its
+  // complexity controller.
+  void SetComplexityLevel(size_t i);
 
   webrtc::H264BitstreamParser h264_bitstream_parser_;
   // Reports statistics with histograms.
@@ -101,6 +108,14 @@ class H264EncoderImpl : public H264Encoder {
 
   int num_temporal_layers_;
   uint8_t tl0sync_limit_;
+
+  // Adapts the complexity mode of each encoder to its encode time, when
+  // enabled by field trial. Level 0 is the mode the encoder was initialized
+  // with and each level above it one mode lower. Same indexing as |encoders_|.
+  const absl::optional<EncoderComplexityController::Settings>
+      complexity_settings_;
+  std::vector<EncoderComplexityController> complexity_controllers_;
+  std::vector<ECOMPLEXITY_MODE> initial_complexity_modes_;
 };
 
 }  // namespace webrtc
@@ -11,6 +11,9 @@
 
 #include "modules/video_coding/codecs/h264/h264_encoder_impl.h"
 
+#include <vector>
+
+#include "test/field_trial.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -78,6 +81,30 @@ TEST(H264EncoderImplTest, CanInitializeWithRemovedParameter) {
             encoder.PacketizationModeForTesting());
 }
 
+TEST(H264EncoderImplTest, StartsAboveLowestComplexityWithController) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-EncoderComplexityController/Enabled/");
+  H264EncoderImpl encoder(cricket::VideoCodec("H264"));
+  VideoCodec codec_settings;
+  SetDefaultSettings(&codec_settings);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, kNumCores, kMaxPayloadSize));
+  const std::vector<int> num_levels = encoder.NumComplexityLevelsForTesting();
+  ASSERT_EQ(1u, num_levels.size());
+  EXPECT_GT(num_levels[0], 1);
+  EXPECT_TRUE(encoder.GetEncoderInfo().can_reduce_complexity);
+}
+
+TEST(H264EncoderImplTest, HasNoComplexityLevelsWithoutController) {
+  H264EncoderImpl encoder(cricket::VideoCodec("H264"));
+  VideoCodec codec_settings;
+  SetDefaultSettings(&codec_settings);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, kNumCores, kMaxPayloadSize));
+  EXPECT_TRUE(encoder.NumComplexityLevelsForTesting().empty());
+  EXPECT_FALSE(encoder.GetEncoderInfo().can_reduce_complexity);
+}
+
 }  // anonymous namespace
 
 }  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <memory>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "api/video/color_space.h"
@@ -26,6 +27,7 @@
 #include "modules/video_coding/codecs/test/video_codec_unittest.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "modules/video_coding/include/video_error_codes.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 #include "test/video_codec_settings.h"
 
@@ -53,6 +55,7 @@ class TestH264Impl : public VideoCodecUnitTest {
   EncodedColorSpaceEqualsInputColorSpace
 #define MAYBE_DecodedColorSpaceEqualsEncodedColorSpace \
   DecodedColorSpaceEqualsEncodedColorSpace
+#define MAYBE_FrameThreadedDecodeKeepsOrder FrameThreadedDecodeKeepsOrder
 #else
 #define MAYBE_EncodeDecode DISABLED_EncodeDecode
 #define MAYBE_DecodedQpEqualsEncodedQp DISABLED_DecodedQpEqualsEncodedQp
@@ -60,6 +63,8 @@ class TestH264Impl : public VideoCodecUnitTest {
   DISABLED_EncodedColorSpaceEqualsInputColorSpace
 #define MAYBE_DecodedColorSpaceEqualsEncodedColorSpace \
   DISABLED_DecodedColorSpaceEqualsEncodedColorSpace
+#define MAYBE_FrameThreadedDecodeKeepsOrder \
+  DISABLED_FrameThreadedDecodeKeepsOrder
 #endif
 
 TEST_F(TestH264Impl, MAYBE_EncodeDecode) {
@@ -149,4 +154,55 @@ TEST_F(TestH264Impl, MAYBE_DecodedColorSpaceEqualsEncodedColorSpace) {
   EXPECT_EQ(color_space, *decoded_frame->color_space());
 }
 
+TEST_F(TestH264Impl, MAYBE_FrameThreadedDecodeKeepsOrder) {
+  class TimestampCollector : public DecodedImageCallback {
+   public:
+    int32_t Decoded(VideoFrame& frame) override {
+      timestamps.push_back(frame.timestamp());
+      return 0;
+    }
+    int32_t Decoded(VideoFrame& frame, int64_t decode_time_ms) override {
+      return Decoded(frame);
+    }
+    void Decoded(VideoFrame& frame,
+                 absl::optional<int32_t> decode_time_ms,
+                 absl::optional<uint8_t> qp) override {
+      Decoded(frame);
+    }
+    std::vector<uint32_t> timestamps;
+  };
+
+  const int kNumFrames = 10;
+  const int kMaxDelayFrames = 1;
+  std::vector<EncodedImage> encoded_frames;
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(*NextInputFrame(), nullptr));
+    EncodedImage encoded_frame;
+    CodecSpecificInfo codec_specific_info;
+    ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+    encoded_frame.Retain();
+    encoded_frames.push_back(encoded_frame);
+  }
+  encoded_frames[0]._frameType = VideoFrameType::kVideoFrameKey;
+
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-H264-MultithreadedDecoding/"
+      "Enabled,threads:4,mode:frame,max_delay:1/");
+  std::unique_ptr<VideoDecoder> decoder = H264Decoder::Create();
+  TimestampCollector collector;
+  decoder->RegisterDecodeCompleteCallback(&collector);
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder->InitDecode(&codec_settings_, 4));
+  for (const EncodedImage& encoded_frame : encoded_frames) {
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              decoder->Decode(encoded_frame, false, nullptr, 0));
+  }
+
+  // All but the frames still in the pipeline are output, in decode order.
+  ASSERT_GE(collector.timestamps.size(),
+            static_cast<size_t>(kNumFrames - kMaxDelayFrames));
+  for (size_t i = 0; i < collector.timestamps.size(); ++i)
+    EXPECT_EQ(encoded_frames[i].Timestamp(), collector.timestamps[i]);
+}
+
 }  // namespace webrtc
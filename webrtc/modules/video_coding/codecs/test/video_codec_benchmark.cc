@@ -0,0 +1,252 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Offline codec benchmark. Runs a YUV or Y4M clip through the encoder and
+// decoder with VideoProcessor and writes the results as JSON: encode and
+// decode speed, per-frame latency percentiles, PSNR/SSIM and how far the
+// produced bitrate and framerate deviate from the targets.
+//
+// Example:
+//   video_codec_benchmark --input=foreman_cif.yuv --width=352 --height=288
+//       --codec=VP8 --bitrate_kbps=500 --cores=4 --output=result.json
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "api/test/create_videocodec_test_fixture.h"
+#include "api/test/videocodec_test_fixture.h"
+#include "api/test/videocodec_test_stats.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/numerics/samples_stats_counter.h"
+#include "rtc_base/strings/json.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/field_trial.h"
+#include "test/testsupport/frame_reader.h"
+
+// Define command line flags.
+WEBRTC_DEFINE_string(input, "", "Input clip, raw I420 (.yuv) or Y4M (.y4m).");
+WEBRTC_DEFINE_int(width, 0, "Width of the input clip.");
+WEBRTC_DEFINE_int(height, 0, "Height of the input clip.");
+WEBRTC_DEFINE_int(num_frames,
+                  0,
+                  "Number of frames to process; 0 to process the whole clip.");
+WEBRTC_DEFINE_string(codec, "VP8", "Codec name: VP8, VP9 or H264.");
+WEBRTC_DEFINE_int(bitrate_kbps, 500, "Target bitrate.");
+WEBRTC_DEFINE_int(framerate, 30, "Input framerate.");
+WEBRTC_DEFINE_int(simulcast_streams, 1, "Number of simulcast streams (VP8).");
+WEBRTC_DEFINE_int(spatial_layers, 1, "Number of spatial layers (VP9).");
+WEBRTC_DEFINE_int(temporal_layers, 1, "Number of temporal layers.");
+WEBRTC_DEFINE_int(cores,
+                  0,
+                  "Number of cores given to the codecs; 0 to use all cores.");
+WEBRTC_DEFINE_bool(decode, true, "Decode the encoded frames.");
+WEBRTC_DEFINE_bool(denoising, false, "Enable the encoder denoiser.");
+WEBRTC_DEFINE_bool(frame_dropper, true, "Enable encoder frame dropping.");
+WEBRTC_DEFINE_bool(realtime,
+                   false,
+                   "Feed frames at the input framerate instead of as fast as "
+                   "possible. SSIM is not computed in this mode.");
+WEBRTC_DEFINE_string(force_fieldtrials,
+                     "",
+                     "Field trials to run with, e.g. "
+                     "\"WebRTC-Foo/Enabled/WebRTC-Bar/Disabled/\".");
+WEBRTC_DEFINE_string(output, "", "JSON output file; stdout if empty.");
+WEBRTC_DEFINE_bool(help, false, "Print this message.");
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const double kLatencyPercentiles[] = {0.5, 0.9, 0.95, 0.99};
+
+int CountFrames(const std::string& path, int width, int height) {
+  std::unique_ptr<FrameReader> reader;
+  if (absl::EndsWith(path, ".y4m")) {
+    reader.reset(new Y4mFrameReaderImpl(path, width, height));
+  } else {
+    reader.reset(new YuvFrameReaderImpl(path, width, height));
+  }
+  if (!reader->Init())
+    return 0;
+  const int num_frames = reader->NumberOfFrames();
+  reader->Close();
+  return num_frames;
+}
+
+Json::Value LatencyToJson(SamplesStatsCounter* latency_ms) {
+  Json::Value json(Json::objectValue);
+  if (latency_ms->IsEmpty())
+    return json;
+  json["avg"] = latency_ms->GetAverage();
+  for (double percentile : kLatencyPercentiles) {
+    json["p" + std::to_string(static_cast<int>(percentile * 100 + 0.5))] =
+        latency_ms->GetPercentile(percentile);
+  }
+  json["max"] = latency_ms->GetMax();
+  return json;
+}
+
+Json::Value LayerToJson(const VideoCodecTestStats::VideoStatistics& stat) {
+  Json::Value json(Json::objectValue);
+  json["spatial_idx"] = static_cast<Json::UInt>(stat.spatial_idx);
+  json["temporal_idx"] = static_cast<Json::UInt>(stat.temporal_idx);
+  json["width"] = static_cast<Json::UInt>(stat.width);
+  json["height"] = static_cast<Json::UInt>(stat.height);
+  json["target_bitrate_kbps"] =
+      static_cast<Json::UInt>(stat.target_bitrate_kbps);
+  json["bitrate_kbps"] = static_cast<Json::UInt>(stat.bitrate_kbps);
+  json["bitrate_deviation_percent"] =
+      stat.target_bitrate_kbps > 0
+          ? 100.0 *
+                (static_cast<double>(stat.bitrate_kbps) -
+                 stat.target_bitrate_kbps) /
+                stat.target_bitrate_kbps
+          : 0.0;
+  json["input_framerate_fps"] = stat.input_framerate_fps;
+  json["framerate_fps"] = stat.framerate_fps;
+  json["framerate_deviation_percent"] =
+      stat.input_framerate_fps > 0
+          ? 100.0 * (stat.framerate_fps - stat.input_framerate_fps) /
+                stat.input_framerate_fps
+          : 0.0;
+  json["time_to_reach_target_bitrate_sec"] =
+      stat.time_to_reach_target_bitrate_sec;
+  json["avg_delay_sec"] = stat.avg_delay_sec;
+  json["enc_speed_fps"] = stat.enc_speed_fps;
+  json["dec_speed_fps"] = stat.dec_speed_fps;
+  json["avg_key_frame_size_bytes"] = stat.avg_key_frame_size_bytes;
+  json["avg_delta_frame_size_bytes"] = stat.avg_delta_frame_size_bytes;
+  json["avg_qp"] = stat.avg_qp;
+  json["avg_psnr"] = stat.avg_psnr;
+  json["avg_psnr_y"] = stat.avg_psnr_y;
+  json["avg_psnr_u"] = stat.avg_psnr_u;
+  json["avg_psnr_v"] = stat.avg_psnr_v;
+  json["min_psnr"] = stat.min_psnr;
+  json["avg_ssim"] = stat.avg_ssim;
+  json["min_ssim"] = stat.min_ssim;
+  json["num_input_frames"] = static_cast<Json::UInt>(stat.num_input_frames);
+  json["num_encoded_frames"] = static_cast<Json::UInt>(stat.num_encoded_frames);
+  json["num_decoded_frames"] = static_cast<Json::UInt>(stat.num_decoded_frames);
+  json["num_key_frames"] = static_cast<Json::UInt>(stat.num_key_frames);
+  json["num_spatial_resizes"] =
+      static_cast<Json::UInt>(stat.num_spatial_resizes);
+  return json;
+}
+
+int RunBenchmark() {
+  const std::string input = static_cast<std::string>(FLAG_input);
+  if (input.empty() || FLAG_width <= 0 || FLAG_height <= 0) {
+    fprintf(stderr, "--input, --width and --height are required.\n");
+    return 1;
+  }
+  if (FLAG_bitrate_kbps <= 0 || FLAG_framerate <= 0) {
+    fprintf(stderr, "--bitrate_kbps and --framerate must be positive.\n");
+    return 1;
+  }
+  const int num_frames_in_clip = CountFrames(input, FLAG_width, FLAG_height);
+  if (num_frames_in_clip <= 0) {
+    fprintf(stderr, "Failed to read frames from %s.\n", input.c_str());
+    return 1;
+  }
+  const int num_frames = FLAG_num_frames > 0
+                             ? std::min(FLAG_num_frames, num_frames_in_clip)
+                             : num_frames_in_clip;
+
+  VideoCodecTestFixture::Config config;
+  config.test_name = "video_codec_benchmark";
+  config.filename = input;
+  config.filepath = input;
+  config.num_frames = num_frames;
+  config.decode = FLAG_decode;
+  config.num_cores = FLAG_cores > 0 ? FLAG_cores : 0;
+  config.encode_in_real_time = FLAG_realtime;
+  config.SetCodecSettings(static_cast<std::string>(FLAG_codec),
+                          FLAG_simulcast_streams, FLAG_spatial_layers,
+                          FLAG_temporal_layers, FLAG_denoising,
+                          FLAG_frame_dropper, /*spatial_resize_on=*/false,
+                          FLAG_width, FLAG_height);
+
+  std::unique_ptr<VideoCodecTestFixture> fixture =
+      CreateVideoCodecTestFixture(config);
+  const std::vector<RateProfile> rate_profiles = {
+      {static_cast<size_t>(FLAG_bitrate_kbps),
+       static_cast<size_t>(FLAG_framerate), 0}};
+  fixture->RunTest(rate_profiles, nullptr, nullptr, nullptr);
+
+  VideoCodecTestStats& stats = fixture->GetStats();
+  SamplesStatsCounter encode_latency_ms;
+  SamplesStatsCounter decode_latency_ms;
+  for (const auto& frame_stat : stats.GetFrameStatistics()) {
+    if (frame_stat.encoding_successful)
+      encode_latency_ms.AddSample(frame_stat.encode_time_us / 1000.0);
+    if (frame_stat.decoding_successful)
+      decode_latency_ms.AddSample(frame_stat.decode_time_us / 1000.0);
+  }
+
+  Json::Value result(Json::objectValue);
+  Json::Value& json_config = result["config"];
+  json_config["input"] = input;
+  json_config["codec"] = config.CodecName();
+  json_config["width"] = FLAG_width;
+  json_config["height"] = FLAG_height;
+  json_config["num_frames"] = num_frames;
+  json_config["bitrate_kbps"] = FLAG_bitrate_kbps;
+  json_config["framerate"] = FLAG_framerate;
+  json_config["simulcast_streams"] = FLAG_simulcast_streams;
+  json_config["spatial_layers"] = FLAG_spatial_layers;
+  json_config["temporal_layers"] = FLAG_temporal_layers;
+  json_config["num_cores"] = static_cast<Json::UInt>(config.NumberOfCores());
+  json_config["realtime"] = FLAG_realtime;
+  json_config["field_trials"] =
+      static_cast<std::string>(FLAG_force_fieldtrials);
+  result["encode_latency_ms"] = LatencyToJson(&encode_latency_ms);
+  result["decode_latency_ms"] = LatencyToJson(&decode_latency_ms);
+  Json::Value& layers = result["layers"];
+  layers = Json::Value(Json::arrayValue);
+  for (const auto& layer_stat :
+       stats.SliceAndCalcLayerVideoStatistic(0, num_frames - 1)) {
+    layers.append(LayerToJson(layer_stat));
+  }
+
+  const std::string json = Json::StyledWriter().write(result);
+  const std::string output = static_cast<std::string>(FLAG_output);
+  if (output.empty()) {
+    printf("%s", json.c_str());
+    return 0;
+  }
+  FILE* output_file = fopen(output.c_str(), "w");
+  if (!output_file) {
+    fprintf(stderr, "Failed to open %s for writing.\n", output.c_str());
+    return 1;
+  }
+  fwrite(json.data(), 1, json.size(), output_file);
+  fclose(output_file);
+  return 0;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) != 0 ||
+      FLAG_help) {
+    rtc::FlagList::Print(nullptr, false);
+    return FLAG_help ? 0 : 1;
+  }
+  webrtc::test::ValidateFieldTrialsStringOrDie(FLAG_force_fieldtrials);
+  webrtc::field_trial::InitFieldTrialsFromString(FLAG_force_fieldtrials);
+  return webrtc::test::RunBenchmark();
+}
@@ -39,6 +39,14 @@ TEST(Config, NumberOfCoresWithoutUseSingleCore) {
   EXPECT_GE(config.NumberOfCores(), 1u);
 }
 
+TEST(Config, NumberOfCoresWithNumCores) {
+  Config config;
+  config.num_cores = 3;
+  EXPECT_EQ(3u, config.NumberOfCores());
+  config.use_single_core = true;
+  EXPECT_EQ(1u, config.NumberOfCores());
+}
+
 TEST(Config, NumberOfTemporalLayersIsOne) {
   Config config;
   webrtc::test::CodecSettings(kVideoCodecH264, &config.codec_settings);
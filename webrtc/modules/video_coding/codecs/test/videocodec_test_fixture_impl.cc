@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/match.h"
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "api/video/video_bitrate_allocation.h"
@@ -223,7 +224,9 @@ void VideoCodecTestFixtureImpl::Config::SetCodecSettings(
 }
 
 size_t VideoCodecTestFixtureImpl::Config::NumberOfCores() const {
-  return use_single_core ? 1 : CpuInfo::DetectNumberOfCores();
+  if (use_single_core)
+    return 1;
+  return num_cores > 0 ? num_cores : CpuInfo::DetectNumberOfCores();
 }
 
 size_t VideoCodecTestFixtureImpl::Config::NumberOfTemporalLayers() const {
@@ -638,9 +641,15 @@ void VideoCodecTestFixtureImpl::SetUpAndInitObjects(
   config_.codec_settings.maxFramerate = initial_framerate_fps;
 
   // Create file objects for quality analysis.
-  source_frame_reader_.reset(
-      new YuvFrameReaderImpl(config_.filepath, config_.codec_settings.width,
-                             config_.codec_settings.height));
+  if (absl::EndsWith(config_.filepath, ".y4m")) {
+    source_frame_reader_.reset(
+        new Y4mFrameReaderImpl(config_.filepath, config_.codec_settings.width,
+                               config_.codec_settings.height));
+  } else {
+    source_frame_reader_.reset(
+        new YuvFrameReaderImpl(config_.filepath, config_.codec_settings.width,
+                               config_.codec_settings.height));
+  }
   EXPECT_TRUE(source_frame_reader_->Init());
 
   RTC_DCHECK(encoded_frame_writers_.empty());
@@ -8,12 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string>
 #include <vector>
 
 #include "absl/memory/memory.h"
 #include "api/test/create_videocodec_test_fixture.h"
 #include "media/base/media_constants.h"
 #include "modules/video_coding/codecs/test/videocodec_test_fixture_impl.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 #include "test/testsupport/file_utils.h"
 
@@ -35,6 +37,24 @@ VideoCodecTestFixture::Config CreateConfig() {
   config.use_single_core = true;
   return config;
 }
+
+// Decodes an HD stream using all cores. Run with the decoder threading modes
+// of the "WebRTC-H264-MultithreadedDecoding" field trial and compare the
+// reported dec_speed.
+void RunHdDecodeSpeedTest(const std::string& test_name) {
+  auto config = CreateConfig();
+  config.test_name = test_name;
+  config.filename = "ConferenceMotion_1280_720_50";
+  config.filepath = ResourcePath(config.filename, "yuv");
+  config.use_single_core = false;
+  config.SetCodecSettings(cricket::kH264CodecName, 1, 1, 1, false, true, false,
+                          1280, 720);
+  auto fixture = CreateVideoCodecTestFixture(config);
+
+  std::vector<RateProfile> rate_profiles = {{2500, 30, 0}};
+
+  fixture->RunTest(rate_profiles, nullptr, nullptr, nullptr);
+}
 }  // namespace
 
 TEST(VideoCodecTestOpenH264, ConstantHighBitrate) {
@@ -83,5 +103,21 @@ TEST(VideoCodecTestOpenH264, SingleNalUnit) {
                    &bs_thresholds);
 }
 
+TEST(VideoCodecTestOpenH264, DISABLED_HdDecodeSpeedSingleThread) {
+  RunHdDecodeSpeedTest("h264_hd_decode_single_thread");
+}
+
+TEST(VideoCodecTestOpenH264, DISABLED_HdDecodeSpeedSliceThreads) {
+  ScopedFieldTrials field_trials(
+      "WebRTC-H264-MultithreadedDecoding/Enabled,mode:slice/");
+  RunHdDecodeSpeedTest("h264_hd_decode_slice_threads");
+}
+
+TEST(VideoCodecTestOpenH264, DISABLED_HdDecodeSpeedFrameThreads) {
+  ScopedFieldTrials field_trials(
+      "WebRTC-H264-MultithreadedDecoding/Enabled,mode:frame,max_delay:3/");
+  RunHdDecodeSpeedTest("h264_hd_decode_frame_threads");
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -36,6 +36,9 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/experiments/field_trial_units.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
 #include "system_wrappers/include/field_trial.h"
 #include "third_party/libyuv/include/libyuv/scale.h"
@@ -57,9 +60,24 @@ constexpr int kHighVp8QpThreshold = 95;
 constexpr int kTokenPartitions = VP8_ONE_TOKENPARTITION;
 constexpr uint32_t kVp832ByteAlign = 32u;
 
+const char kVp8ParallelEncodingFieldTrial[] =
+    "WebRTC-VP8-ParallelSimulcastEncoding";
+
 constexpr int kRtpTicksPerSecond = 90000;
 constexpr int kRtpTicksPerMs = kRtpTicksPerSecond / 1000;
 
+// Complexity levels step through the realtime cpu_speed settings down to the
+// fastest one. The last level also raises the static threshold to the one
+// used for screenshare, skipping the encoding of more unchanged blocks.
+constexpr int kMinCpuSpeed = -16;
+constexpr int kCpuSpeedStep = 2;
+constexpr unsigned int kScreenshareStaticThreshold = 100;
+constexpr unsigned int kDefaultStaticThreshold = 1;
+
+int NumComplexityLevels(int cpu_speed) {
+  return std::max(0, (cpu_speed - kMinCpuSpeed) / kCpuSpeedStep) + 2;
+}
+
 // VP8 denoiser states.
 enum denoiserState : uint32_t {
   kDenoiserOff,
@@ -204,6 +222,11 @@ LibvpxVp8Encoder::LibvpxVp8Encoder(
       frame_buffer_controller_factory_(
           std::move(frame_buffer_controller_factory)),
       key_frame_request_(kMaxSimulcastStreams, false),
+      parallel_encoding_enabled_(
+          field_trial::IsEnabled(kVp8ParallelEncodingFieldTrial)),
+      parallel_encoding_(false),
+      complexity_settings_(
+          EncoderComplexityController::GetSettingsFromFieldTrial()),
       variable_framerate_experiment_(ParseVariableFramerateConfig(
           "WebRTC-VP8VariableFramerateScreenshare")),
       framerate_controller_(variable_framerate_experiment_.framerate_limit),
@@ -215,6 +238,8 @@ LibvpxVp8Encoder::LibvpxVp8Encoder(
   encoders_.reserve(kMaxSimulcastStreams);
   configurations_.reserve(kMaxSimulcastStreams);
   downsampling_factors_.reserve(kMaxSimulcastStreams);
+  encode_start_ms_.reserve(kMaxSimulcastStreams);
+  encode_finish_ms_.reserve(kMaxSimulcastStreams);
 }
 
 LibvpxVp8Encoder::~LibvpxVp8Encoder() {
@@ -225,6 +250,10 @@ int LibvpxVp8Encoder::Release() {
   int ret_val = WEBRTC_VIDEO_CODEC_OK;
 
   encoded_images_.clear();
+  buffer_pools_.clear();
+  // Workers must be gone before the encoders they may reference.
+  encoder_workers_.clear();
+  parallel_encoding_ = false;
 
   while (!encoders_.empty()) {
     vpx_codec_ctx_t& encoder = encoders_.back();
@@ -243,6 +272,7 @@ int LibvpxVp8Encoder::Release() {
     raw_images_.pop_back();
   }
   frame_buffer_controller_.reset();
+  complexity_controllers_.clear();
   inited_ = false;
   return ret_val;
 }
@@ -398,8 +428,19 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   send_stream_.resize(number_of_streams);
   send_stream_[0] = true;  // For non-simulcast case.
   cpu_speed_.resize(number_of_streams);
+  encode_start_ms_.assign(number_of_streams, 0);
+  encode_finish_ms_.assign(number_of_streams, 0);
   std::fill(key_frame_request_.begin(), key_frame_request_.end(), false);
 
+  parallel_encoding_ = parallel_encoding_enabled_ && number_of_streams > 1 &&
+                       number_of_cores > 1;
+  if (parallel_encoding_) {
+    for (int i = 1; i < number_of_streams; ++i) {
+      encoder_workers_.push_back(
+          absl::make_unique<rtc::TaskQueue>("VP8SimulcastEncoder"));
+    }
+  }
+
   int idx = number_of_streams - 1;
   for (int i = 0; i < (number_of_streams - 1); ++i, --idx) {
     int gcd = GCD(inst->simulcastStream[idx].width,
@@ -414,10 +455,11 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
     downsampling_factors_[number_of_streams - 1].den = 1;
   }
   for (int i = 0; i < number_of_streams; ++i) {
-    // allocate memory for encoded image
-    size_t frame_capacity =
-        CalcBufferSize(VideoType::kI420, codec_.width, codec_.height);
-    encoded_images_[i].Allocate(frame_capacity);
+    // Buffers for the encoded images are taken from the pool for every frame.
+    const SimulcastStream& stream =
+        codec_.simulcastStream[number_of_streams - 1 - i];
+    buffer_pools_.emplace_back(
+        CalcBufferSize(VideoType::kI420, stream.width, stream.height));
     encoded_images_[i]._completeFrame = true;
   }
   // populate encoder configuration with default values
@@ -487,6 +529,12 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
         GetCpuSpeed(inst->simulcastStream[number_of_streams - 1 - i].width,
                     inst->simulcastStream[number_of_streams - 1 - i].height);
   }
+  if (complexity_settings_) {
+    for (int i = 0; i < number_of_streams; ++i) {
+      complexity_controllers_.emplace_back(*complexity_settings_,
+                                           NumComplexityLevels(cpu_speed_[i]));
+    }
+  }
   configurations_[0].g_w = inst->width;
   configurations_[0].g_h = inst->height;
 
@@ -531,8 +579,13 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
     configurations_[i].g_w = inst->simulcastStream[stream_idx].width;
     configurations_[i].g_h = inst->simulcastStream[stream_idx].height;
 
-    // Use 1 thread for lower resolutions.
-    configurations_[i].g_threads = 1;
+    // Use 1 thread for lower resolutions, unless they are encoded in
+    // parallel, in which case they get threads based on their own size.
+    configurations_[i].g_threads =
+        parallel_encoding_
+            ? NumberOfThreads(configurations_[i].g_w, configurations_[i].g_h,
+                              number_of_cores)
+            : 1;
 
     configurations_[i].rc_dropframe_thresh = FrameDropThreshold(stream_idx);
 
@@ -641,7 +694,16 @@ int LibvpxVp8Encoder::InitAndSetControlSettings() {
   vpx_codec_flags_t flags = 0;
   flags |= VPX_CODEC_USE_OUTPUT_PARTITION;
 
-  if (encoders_.size() > 1) {
+  if (parallel_encoding_) {
+    // Independent encoders; the lower streams do not reuse the mode decisions
+    // of the higher ones, but can be encoded at the same time.
+    for (size_t i = 0; i < encoders_.size(); ++i) {
+      if (libvpx_->codec_enc_init(&encoders_[i], vpx_codec_vp8_cx(),
+                                  &configurations_[i], flags)) {
+        return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+      }
+    }
+  } else if (encoders_.size() > 1) {
     int error = libvpx_->codec_enc_init_multi(
         &encoders_[0], vpx_codec_vp8_cx(), &configurations_[0],
         encoders_.size(), flags, &downsampling_factors_[0]);
@@ -678,9 +740,10 @@ int LibvpxVp8Encoder::InitAndSetControlSettings() {
   }
   for (size_t i = 0; i < encoders_.size(); ++i) {
     // Allow more screen content to be detected as static.
-    libvpx_->codec_control(
-        &(encoders_[i]), VP8E_SET_STATIC_THRESHOLD,
-        codec_.mode == VideoCodecMode::kScreensharing ? 100u : 1u);
+    libvpx_->codec_control(&(encoders_[i]), VP8E_SET_STATIC_THRESHOLD,
+                           codec_.mode == VideoCodecMode::kScreensharing
+                               ? kScreenshareStaticThreshold
+                               : kDefaultStaticThreshold);
     libvpx_->codec_control(&(encoders_[i]), VP8E_SET_CPUUSED, cpu_speed_[i]);
     libvpx_->codec_control(
         &(encoders_[i]), VP8E_SET_TOKEN_PARTITIONS,
@@ -817,8 +880,9 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
   raw_images_[0].stride[VPX_PLANE_U] = input_image->StrideU();
   raw_images_[0].stride[VPX_PLANE_V] = input_image->StrideV();
 
+  // Build the resolution pyramid, each level from the one above it. The box
+  // filter averages all source pixels of a block and has SIMD row kernels.
   for (size_t i = 1; i < encoders_.size(); ++i) {
-    // Scale the image down a number of times by downsampling factor
     libyuv::I420Scale(
         raw_images_[i - 1].planes[VPX_PLANE_Y],
         raw_images_[i - 1].stride[VPX_PLANE_Y],
@@ -830,7 +894,7 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
         raw_images_[i].stride[VPX_PLANE_Y], raw_images_[i].planes[VPX_PLANE_U],
         raw_images_[i].stride[VPX_PLANE_U], raw_images_[i].planes[VPX_PLANE_V],
         raw_images_[i].stride[VPX_PLANE_V], raw_images_[i].d_w,
-        raw_images_[i].d_h, libyuv::kFilterBilinear);
+        raw_images_[i].d_h, libyuv::kFilterBox);
   }
 
   vpx_enc_frame_flags_t flags[kMaxSimulcastStreams];
@@ -907,8 +971,7 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     // Note we must pass 0 for |flags| field in encode call below since they are
     // set above in |libvpx_interface_->vpx_codec_control_| function for each
     // encoder/spatial layer.
-    error = libvpx_->codec_encode(&encoders_[0], &raw_images_[0], timestamp_,
-                                  duration, 0, VPX_DL_REALTIME);
+    error = EncodeStreams(duration);
     // Reset specific intra frame thresholds, following the key frame.
     if (send_key_frame) {
       libvpx_->codec_control(&(encoders_[0]), VP8E_SET_MAX_INTRA_BITRATE_PCT,
@@ -917,13 +980,54 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     if (error)
       return WEBRTC_VIDEO_CODEC_ERROR;
     // Examines frame timestamps only.
-    error = GetEncodedPartitions(frame);
+    error = GetEncodedPartitions(frame, send_key_frame);
   }
+  if (error == WEBRTC_VIDEO_CODEC_OK && !complexity_controllers_.empty())
+    UpdateComplexity();
   // TODO(sprang): Shouldn't we use the frame timestamp instead?
   timestamp_ += duration;
   return error;
 }
 
+int LibvpxVp8Encoder::EncodeStreams(uint32_t duration) {
+  if (!parallel_encoding_) {
+    // The multi-resolution encoder encodes all streams in one call.
+    const int64_t start_ms = rtc::TimeMillis();
+    int error = libvpx_->codec_encode(&encoders_[0], &raw_images_[0],
+                                      timestamp_, duration, 0, VPX_DL_REALTIME);
+    const int64_t finish_ms = rtc::TimeMillis();
+    std::fill(encode_start_ms_.begin(), encode_start_ms_.end(), start_ms);
+    std::fill(encode_finish_ms_.begin(), encode_finish_ms_.end(), finish_ms);
+    return error;
+  }
+
+  RTC_DCHECK_EQ(encoder_workers_.size() + 1, encoders_.size());
+  const int64_t timestamp = timestamp_;
+  std::vector<int> errors(encoders_.size(), 0);
+  std::vector<rtc::Event> done(encoder_workers_.size());
+  auto encode = [this, timestamp, duration, &errors](size_t i) {
+    encode_start_ms_[i] = rtc::TimeMillis();
+    errors[i] = libvpx_->codec_encode(&encoders_[i], &raw_images_[i], timestamp,
+                                      duration, 0, VPX_DL_REALTIME);
+    encode_finish_ms_[i] = rtc::TimeMillis();
+  };
+  for (size_t i = 1; i < encoders_.size(); ++i) {
+    encoder_workers_[i - 1]->PostTask([&encode, &done, i] {
+      encode(i);
+      done[i - 1].Set();
+    });
+  }
+  encode(0);
+  for (rtc::Event& event : done)
+    event.Wait(rtc::Event::kForever);
+
+  for (int error : errors) {
+    if (error)
+      return error;
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
 void LibvpxVp8Encoder::PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                                              const vpx_codec_cx_pkt_t& pkt,
                                              int stream_idx,
@@ -943,13 +1047,15 @@ void LibvpxVp8Encoder::PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
       (pkt.data.frame.flags & VPX_FRAME_IS_KEY) != 0, qp, codec_specific);
 }
 
-int LibvpxVp8Encoder::GetEncodedPartitions(const VideoFrame& input_image) {
+int LibvpxVp8Encoder::GetEncodedPartitions(const VideoFrame& input_image,
+                                           bool key_frame) {
   int stream_idx = static_cast<int>(encoders_.size()) - 1;
   int result = WEBRTC_VIDEO_CODEC_OK;
   for (size_t encoder_idx = 0; encoder_idx < encoders_.size();
        ++encoder_idx, --stream_idx) {
     vpx_codec_iter_t iter = NULL;
-    encoded_images_[encoder_idx].set_size(0);
+    buffer_pools_[encoder_idx].AcquireBuffer(&encoded_images_[encoder_idx],
+                                             key_frame);
     encoded_images_[encoder_idx]._frameType = VideoFrameType::kVideoFrameDelta;
     CodecSpecificInfo codec_specific;
     const vpx_codec_cx_pkt_t* pkt = NULL;
@@ -1024,10 +1130,47 @@ int LibvpxVp8Encoder::GetEncodedPartitions(const VideoFrame& input_image) {
         }
       }
     }
+    buffer_pools_[encoder_idx].ReturnBuffer(encoded_images_[encoder_idx]);
   }
   return result;
 }
 
+void LibvpxVp8Encoder::UpdateComplexity() {
+  RTC_DCHECK_EQ(complexity_controllers_.size(), encoders_.size());
+  size_t stream_idx = encoders_.size() - 1;
+  for (size_t i = 0; i < encoders_.size(); ++i, --stream_idx) {
+    if (!send_stream_[stream_idx])
+      continue;
+    // Without parallel encoding all streams are encoded in one call, so they
+    // share the encode time and change levels together.
+    if (complexity_controllers_[i].OnFrameEncoded(
+            encode_finish_ms_[i] - encode_start_ms_[i], codec_.maxFramerate)) {
+      SetComplexityLevel(i);
+    }
+  }
+}
+
+void LibvpxVp8Encoder::SetComplexityLevel(size_t encoder_idx) {
+  const EncoderComplexityController& controller =
+      complexity_controllers_[encoder_idx];
+  const int speed_level =
+      std::min(controller.level(), controller.num_levels() - 2);
+  const int cpu_speed = std::max(
+      kMinCpuSpeed, cpu_speed_[encoder_idx] - speed_level * kCpuSpeedStep);
+  unsigned int static_threshold =
+      codec_.mode == VideoCodecMode::kScreensharing
+          ? kScreenshareStaticThreshold
+          : kDefaultStaticThreshold;
+  if (!controller.CanReduceEffort())
+    static_threshold = kScreenshareStaticThreshold;
+  RTC_LOG(LS_INFO) << "VP8 encoder " << encoder_idx << " complexity level "
+                   << controller.level() << ", cpu_speed " << cpu_speed
+                   << ", static threshold " << static_threshold;
+  libvpx_->codec_control(&encoders_[encoder_idx], VP8E_SET_CPUUSED, cpu_speed);
+  libvpx_->codec_control(&encoders_[encoder_idx], VP8E_SET_STATIC_THRESHOLD,
+                         static_threshold);
+}
+
 VideoEncoder::EncoderInfo LibvpxVp8Encoder::GetEncoderInfo() const {
   EncoderInfo info;
   info.supports_native_handle = false;
@@ -1035,6 +1178,11 @@ VideoEncoder::EncoderInfo LibvpxVp8Encoder::GetEncoderInfo() const {
   info.has_trusted_rate_controller =
       rate_control_settings_.LibvpxVp8TrustedRateController();
   info.is_hardware_accelerated = false;
+  info.can_reduce_complexity = std::any_of(
+      complexity_controllers_.begin(), complexity_controllers_.end(),
+      [](const EncoderComplexityController& controller) {
+        return controller.CanReduceEffort();
+      });
   info.has_internal_source = false;
 
   const bool enable_scaling = encoders_.size() == 1 &&
@@ -23,9 +23,12 @@
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "modules/video_coding/codecs/vp8/libvpx_interface.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "modules/video_coding/utility/encoded_image_buffer_pool.h"
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
 #include "modules/video_coding/utility/framerate_controller.h"
 #include "rtc_base/experiments/cpu_speed_experiment.h"
 #include "rtc_base/experiments/rate_control_settings.h"
+#include "rtc_base/task_queue.h"
 
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
@@ -75,13 +78,24 @@ class LibvpxVp8Encoder : public VideoEncoder {
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings();
 
+  // Encodes |raw_images_| with every encoder. Lower resolution streams are
+  // encoded on |encoder_workers_| when parallel encoding is used.
+  int EncodeStreams(uint32_t duration);
+
   void PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                              const vpx_codec_cx_pkt& pkt,
                              int stream_idx,
                              int encoder_idx,
                              uint32_t timestamp);
 
-  int GetEncodedPartitions(const VideoFrame& input_image);
+  int GetEncodedPartitions(const VideoFrame& input_image, bool key_frame);
+
+  // Feeds the encode time of the last frame to |complexity_controllers_| and
+  // applies any changed levels.
+  void UpdateComplexity();
+  // Sets cpu_speed and static threshold of |encoders_[encoder_idx]| from the
+  // level of its complexity controller.
+  void SetComplexityLevel(size_t encoder_idx);
 
   // Set the stream state for stream |stream_idx|.
   void SetStreamState(bool send_stream, int stream_idx);
@@ -114,10 +128,29 @@ class LibvpxVp8Encoder : public VideoEncoder {
   std::vector<int> cpu_speed_;
   std::vector<vpx_image_t> raw_images_;
   std::vector<EncodedImage> encoded_images_;
+  // Output buffers of |encoded_images_|, same indexing.
+  std::vector<EncodedImageBufferPool> buffer_pools_;
   std::vector<vpx_codec_ctx_t> encoders_;
   std::vector<vpx_codec_enc_cfg_t> configurations_;
   std::vector<vpx_rational_t> downsampling_factors_;
 
+  // When enabled, every stream gets its own libvpx encoder instead of a
+  // single multi-resolution encoder, so that the lower resolution streams can
+  // be encoded concurrently with the top stream.
+  const bool parallel_encoding_enabled_;
+  bool parallel_encoding_;
+  // Worker queues for encoders_[1..n-1], i.e. all but the top stream.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> encoder_workers_;
+  // Per-encoder encode start and finish time of the last frame, in ms.
+  std::vector<int64_t> encode_start_ms_;
+  std::vector<int64_t> encode_finish_ms_;
+
+  // Adapts the effort of each encoder to its encode time, when enabled by
+  // field trial. Same indexing as |encoders_|.
+  const absl::optional<EncoderComplexityController::Settings>
+      complexity_settings_;
+  std::vector<EncoderComplexityController> complexity_controllers_;
+
   // Variable frame-rate screencast related fields and methods.
   const struct VariableFramerateExperiment {
     bool enabled = false;
@@ -22,12 +22,15 @@
 #include "modules/video_coding/codecs/vp8/libvpx_vp8_encoder.h"
 #include "modules/video_coding/codecs/vp8/test/mock_libvpx_interface.h"
 #include "modules/video_coding/utility/vp8_header_parser.h"
+#include "rtc_base/fake_clock.h"
 #include "rtc_base/time_utils.h"
+#include "test/field_trial.h"
 #include "test/video_codec_settings.h"
 
 namespace webrtc {
 
 using testing::_;
+using testing::An;
 using testing::ElementsAreArray;
 using testing::Invoke;
 using testing::NiceMock;
@@ -586,4 +589,135 @@ TEST_F(TestVp8Impl, GetEncoderInfoFpsAllocationSimulcastVideo) {
               ::testing::ElementsAreArray(expected_fps_allocation));
 }
 
+TEST_F(TestVp8Impl, UsesSingleThreadForLowerSimulcastStreams) {
+  auto* const vpx = new NiceMock<MockLibvpxVp8Interface>();
+  LibvpxVp8Encoder encoder((std::unique_ptr<LibvpxInterface>(vpx)));
+
+  codec_settings_.width = 1920;
+  codec_settings_.height = 1080;
+  codec_settings_.numberOfSimulcastStreams = 2;
+  codec_settings_.simulcastStream[0] = {960,  540,  kFramerateFps, 1, 4000,
+                                        3000, 2000, 80};
+  codec_settings_.simulcastStream[1] = {1920, 1080, kFramerateFps, 1, 4000,
+                                        3000, 2000, 80};
+
+  std::vector<unsigned int> threads;
+  EXPECT_CALL(*vpx, codec_enc_init_multi(_, _, _, 2, _, _))
+      .WillOnce(Invoke([&threads](vpx_codec_ctx_t*, vpx_codec_iface_t*,
+                                  vpx_codec_enc_cfg_t* cfg, int num_enc,
+                                  vpx_codec_flags_t, vpx_rational_t*) {
+        for (int i = 0; i < num_enc; ++i)
+          threads.push_back(cfg[i].g_threads);
+        return VPX_CODEC_OK;
+      }));
+  encoder.InitEncode(&codec_settings_, 8, 1000);
+  ASSERT_EQ(2u, threads.size());
+  EXPECT_GT(threads[0], 1u);
+  EXPECT_EQ(1u, threads[1]);
+}
+
+TEST_F(TestVp8Impl, EncodesSimulcastStreamsInParallel) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-VP8-ParallelSimulcastEncoding/Enabled/");
+  std::unique_ptr<VideoEncoder> encoder = VP8Encoder::Create();
+
+  const int kNumStreams = 3;
+  codec_settings_.numberOfSimulcastStreams = kNumStreams;
+  for (int i = 0; i < kNumStreams; ++i) {
+    codec_settings_.simulcastStream[i] = {kWidth >> (kNumStreams - i - 1),
+                                          kHeight >> (kNumStreams - i - 1),
+                                          kFramerateFps,
+                                          1,
+                                          4000,
+                                          3000,
+                                          2000,
+                                          80};
+  }
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_settings_, 2, kMaxPayloadSize));
+  VideoBitrateAllocation bitrate_allocation;
+  for (int i = 0; i < kNumStreams; ++i)
+    bitrate_allocation.SetBitrate(i, 0, 300000);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->SetRateAllocation(bitrate_allocation,
+                                       codec_settings_.maxFramerate));
+
+  // Output is delivered on the encode thread before Encode() returns.
+  MockEncodedImageCallback callback;
+  encoder->RegisterEncodeCompleteCallback(&callback);
+  std::vector<EncodedImage> encoded_frames;
+  EXPECT_CALL(callback, OnEncodedImage(_, _, _))
+      .Times(kNumStreams)
+      .WillRepeatedly(Invoke([&encoded_frames](const EncodedImage& image,
+                                               const CodecSpecificInfo*,
+                                               const RTPFragmentationHeader*) {
+        encoded_frames.push_back(image);
+        return EncodedImageCallback::Result(EncodedImageCallback::Result::OK);
+      }));
+  std::vector<VideoFrameType> frame_types(kNumStreams,
+                                          VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->Encode(*NextInputFrame(), &frame_types));
+  ASSERT_EQ(static_cast<size_t>(kNumStreams), encoded_frames.size());
+
+  // Frames are delivered from the highest to the lowest resolution.
+  for (int i = 0; i < kNumStreams; ++i) {
+    const EncodedImage& frame = encoded_frames[i];
+    EXPECT_EQ(kNumStreams - 1 - i, frame.SpatialIndex());
+    EXPECT_EQ(VideoFrameType::kVideoFrameKey, frame._frameType);
+    EXPECT_GT(frame.size(), 0u);
+  }
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+}
+
+TEST_F(TestVp8Impl, IncreasesCpuSpeedOnSlowEncodes) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-EncoderComplexityController/Enabled,frames:10/");
+  rtc::ScopedFakeClock clock;
+  auto* const vpx = new NiceMock<MockLibvpxVp8Interface>();
+  LibvpxVp8Encoder encoder((std::unique_ptr<LibvpxInterface>(vpx)));
+
+  std::vector<int> cpu_speeds;
+  ON_CALL(*vpx, codec_control(_, VP8E_SET_CPUUSED, An<int>()))
+      .WillByDefault(Invoke(
+          [&cpu_speeds](vpx_codec_ctx_t*, vp8e_enc_control_id, int speed) {
+            cpu_speeds.push_back(speed);
+            return VPX_CODEC_OK;
+          }));
+  ON_CALL(*vpx, img_wrap(_, _, _, _, _, _))
+      .WillByDefault(Invoke([](vpx_image_t* img, vpx_img_fmt_t fmt,
+                               unsigned int d_w, unsigned int d_h,
+                               unsigned int stride_align,
+                               unsigned char* img_data) {
+        img->fmt = fmt;
+        img->d_w = d_w;
+        img->d_h = d_h;
+        img->img_data = img_data;
+        return img;
+      }));
+  // Every frame takes 30 ms to encode, 90% of the frame interval.
+  ON_CALL(*vpx, codec_encode(_, _, _, _, _, _))
+      .WillByDefault(Invoke([&clock](vpx_codec_ctx_t*, const vpx_image_t*,
+                                     vpx_codec_pts_t, uint64_t,
+                                     vpx_enc_frame_flags_t, uint64_t) {
+        clock.AdvanceTime(TimeDelta::ms(30));
+        return VPX_CODEC_OK;
+      }));
+
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_, 1, 1000));
+  MockEncodedImageCallback callback;
+  encoder.RegisterEncodeCompleteCallback(&callback);
+  ASSERT_EQ(1u, cpu_speeds.size());
+  const int initial_cpu_speed = cpu_speeds[0];
+  EXPECT_TRUE(encoder.GetEncoderInfo().can_reduce_complexity);
+
+  auto delta_frame =
+      std::vector<VideoFrameType>{VideoFrameType::kVideoFrameDelta};
+  for (int i = 0; i < 10; ++i)
+    encoder.Encode(*NextInputFrame(), &delta_frame);
+  ASSERT_EQ(2u, cpu_speeds.size());
+  EXPECT_EQ(initial_cpu_speed - 2, cpu_speeds[1]);
+}
+
 }  // namespace webrtc
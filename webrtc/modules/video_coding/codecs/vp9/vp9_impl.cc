@@ -191,6 +191,7 @@ int VP9EncoderImpl::Release() {
   int ret_val = WEBRTC_VIDEO_CODEC_OK;
 
   encoded_image_.Allocate(0);
+  buffer_pool_.reset();
   if (encoder_ != nullptr) {
     if (inited_) {
       if (vpx_codec_destroy(encoder_)) {
@@ -391,10 +392,10 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
 
   is_svc_ = (num_spatial_layers_ > 1 || num_temporal_layers_ > 1);
 
-  // Allocate memory for encoded image
-  size_t frame_capacity =
-      CalcBufferSize(VideoType::kI420, codec_.width, codec_.height);
-  encoded_image_.Allocate(frame_capacity);
+  // Buffers for the encoded image are taken from the pool for every layer
+  // frame.
+  buffer_pool_ = absl::make_unique<EncodedImageBufferPool>(
+      CalcBufferSize(VideoType::kI420, codec_.width, codec_.height));
   encoded_image_._completeFrame = true;
   // Populate encoder configuration with default values.
   if (vpx_codec_enc_config_default(vpx_codec_vp9_cx(), config_, 0)) {
@@ -1312,14 +1313,15 @@ int VP9EncoderImpl::GetEncodedLayerFrame(const vpx_codec_cx_pkt* pkt) {
     DeliverBufferedFrame(end_of_picture);
   }
 
+  const bool is_key_frame =
+      (pkt->data.frame.flags & VPX_FRAME_IS_KEY) ? true : false;
+
+  buffer_pool_->AcquireBuffer(&encoded_image_, is_key_frame);
   if (pkt->data.frame.sz > encoded_image_.capacity()) {
     encoded_image_.Allocate(pkt->data.frame.sz);
   }
   memcpy(encoded_image_.data(), pkt->data.frame.buf, pkt->data.frame.sz);
   encoded_image_.set_size(pkt->data.frame.sz);
-
-  const bool is_key_frame =
-      (pkt->data.frame.flags & VPX_FRAME_IS_KEY) ? true : false;
   // Ensure encoder issued key frame on request.
   RTC_DCHECK(is_key_frame || !force_key_frame_);
 
@@ -1380,6 +1382,7 @@ void VP9EncoderImpl::DeliverBufferedFrame(bool end_of_picture) {
 
     encoded_complete_callback_->OnEncodedImage(encoded_image_, &codec_specific_,
                                                &frag_info);
+    buffer_pool_->ReturnBuffer(encoded_image_);
 
     if (codec_.mode == VideoCodecMode::kScreensharing) {
       const uint8_t spatial_idx = encoded_image_.SpatialIndex().value_or(0);
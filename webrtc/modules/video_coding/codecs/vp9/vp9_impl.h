@@ -23,6 +23,7 @@
 
 #include "media/base/vp9_profile.h"
 #include "modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
+#include "modules/video_coding/utility/encoded_image_buffer_pool.h"
 #include "modules/video_coding/utility/framerate_controller.h"
 
 #include "vpx/vp8cx.h"
@@ -98,6 +99,8 @@ class VP9EncoderImpl : public VP9Encoder {
   size_t SteadyStateSize(int sid, int tid);
 
   EncodedImage encoded_image_;
+  // Output buffers of |encoded_image_|.
+  std::unique_ptr<EncodedImageBufferPool> buffer_pool_;
   CodecSpecificInfo codec_specific_;
   EncodedImageCallback* encoded_complete_callback_;
   VideoCodec codec_;
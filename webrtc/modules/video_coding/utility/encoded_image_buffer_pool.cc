@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoded_image_buffer_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+// Enough for the frame being encoded plus a few held downstream.
+constexpr size_t kMaxNumberOfBuffers = 4;
+// Margin over the expected frame size, so that a frame somewhat larger than
+// the recent ones does not need to grow the buffer.
+constexpr float kSizeHeadroom = 1.5f;
+// Per delta frame decay of the delta frame peak size; about 5 seconds to
+// halve at 30 fps.
+constexpr float kPeakDecay = 0.995f;
+constexpr size_t kMinBufferSize = 4096;
+}  // namespace
+
+EncodedImageBufferPool::EncodedImageBufferPool(size_t max_frame_size)
+    : max_frame_size_(std::max(max_frame_size, kMinBufferSize)),
+      key_frame_size_(0),
+      delta_frame_peak_size_(0.0f) {}
+
+EncodedImageBufferPool::~EncodedImageBufferPool() = default;
+
+void EncodedImageBufferPool::AcquireBuffer(EncodedImage* image,
+                                           bool is_key_frame) {
+  // Drop the reference of the image first, so that its previous buffer can be
+  // picked if nobody else holds it.
+  image->SetEncodedData(rtc::CopyOnWriteBuffer());
+  image->SetEncodedData(CreateBuffer(is_key_frame));
+  image->set_size(0);
+}
+
+void EncodedImageBufferPool::ReturnBuffer(const EncodedImage& image) {
+  ReturnBuffer(image.GetEncodedData(), image.size(),
+               image._frameType == VideoFrameType::kVideoFrameKey);
+}
+
+rtc::CopyOnWriteBuffer EncodedImageBufferPool::CreateBuffer(
+    bool is_key_frame) {
+  const size_t size = EstimatedFrameSize(is_key_frame);
+  for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+    if (!it->HasOneRef())
+      continue;
+    rtc::CopyOnWriteBuffer buffer = std::move(*it);
+    buffers_.erase(it);
+    if (buffer.capacity() < size) {
+      // Growing would copy the stale contents; allocate a new one instead.
+      break;
+    }
+    buffer.SetSize(size);
+    return buffer;
+  }
+  return rtc::CopyOnWriteBuffer(size);
+}
+
+void EncodedImageBufferPool::ReturnBuffer(const rtc::CopyOnWriteBuffer& buffer,
+                                          size_t encoded_size,
+                                          bool is_key_frame) {
+  if (is_key_frame) {
+    key_frame_size_ = encoded_size;
+  } else {
+    delta_frame_peak_size_ = std::max(static_cast<float>(encoded_size),
+                                      delta_frame_peak_size_ * kPeakDecay);
+  }
+  if (buffer.capacity() == 0)
+    return;
+  buffers_.push_back(buffer);
+  if (buffers_.size() > kMaxNumberOfBuffers)
+    buffers_.pop_front();
+}
+
+size_t EncodedImageBufferPool::EstimatedFrameSize(bool is_key_frame) const {
+  if (key_frame_size_ == 0) {
+    // No history yet, make sure the first frame fits.
+    return max_frame_size_;
+  }
+  float expected_size = delta_frame_peak_size_;
+  if (is_key_frame || expected_size == 0.0f) {
+    expected_size =
+        std::max(expected_size, static_cast<float>(key_frame_size_));
+  }
+  const size_t size = static_cast<size_t>(expected_size * kSizeHeadroom);
+  return std::min(std::max(size, kMinBufferSize), max_frame_size_);
+}
+
+void EncodedImageBufferPool::Release() {
+  buffers_.clear();
+  key_frame_size_ = 0;
+  delta_frame_peak_size_ = 0.0f;
+}
+
+}  // namespace webrtc
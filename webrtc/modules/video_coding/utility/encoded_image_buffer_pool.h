@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_ENCODED_IMAGE_BUFFER_POOL_H_
+#define MODULES_VIDEO_CODING_UTILITY_ENCODED_IMAGE_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+#include <list>
+
+#include "api/video/encoded_image.h"
+#include "rtc_base/copy_on_write_buffer.h"
+
+namespace webrtc {
+
+// Recycles the buffers that an encoder writes its output to, so that encoding
+// a frame neither allocates nor copies the previous frame when the previous
+// image is still referenced downstream. New buffers are sized from the recent
+// encoded frame sizes rather than from the raw frame size. Not thread safe.
+class EncodedImageBufferPool {
+ public:
+  // |max_frame_size| bounds the size of handed out buffers; typically the
+  // size of an uncompressed frame.
+  explicit EncodedImageBufferPool(size_t max_frame_size);
+  ~EncodedImageBufferPool();
+
+  // Replaces the buffer of |image| with an unshared one that is expected to
+  // fit the next key or delta frame, and sets the image size to zero.
+  void AcquireBuffer(EncodedImage* image, bool is_key_frame);
+  // Call once |image| has been delivered. Records its size, and keeps its
+  // buffer for reuse once the buffer is no longer referenced elsewhere.
+  void ReturnBuffer(const EncodedImage& image);
+
+  // Lower level versions of the above. The size of a created buffer is its
+  // usable capacity.
+  rtc::CopyOnWriteBuffer CreateBuffer(bool is_key_frame);
+  void ReturnBuffer(const rtc::CopyOnWriteBuffer& buffer,
+                    size_t encoded_size,
+                    bool is_key_frame);
+
+  // Expected buffer size needed for the next frame.
+  size_t EstimatedFrameSize(bool is_key_frame) const;
+
+  // Drops all pooled buffers and the frame size history.
+  void Release();
+
+ private:
+  const size_t max_frame_size_;
+  std::list<rtc::CopyOnWriteBuffer> buffers_;
+  // Size of the last key frame, and a slowly decaying peak of the delta
+  // frame sizes. Zero until the first frame of each kind.
+  size_t key_frame_size_;
+  float delta_frame_peak_size_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_ENCODED_IMAGE_BUFFER_POOL_H_
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoded_image_buffer_pool.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+constexpr size_t kMaxFrameSize = 640 * 480 * 3 / 2;
+}  // namespace
+
+TEST(EncodedImageBufferPool, FirstBufferFitsAnUncompressedFrame) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  EXPECT_EQ(kMaxFrameSize, pool.CreateBuffer(true).size());
+}
+
+TEST(EncodedImageBufferPool, ReusesBufferNotReferencedElsewhere) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  rtc::CopyOnWriteBuffer buffer = pool.CreateBuffer(true);
+  const uint8_t* data = buffer.cdata();
+  pool.ReturnBuffer(buffer, 10000, true);
+  buffer = rtc::CopyOnWriteBuffer();
+
+  rtc::CopyOnWriteBuffer reused = pool.CreateBuffer(false);
+  EXPECT_EQ(data, reused.cdata());
+  EXPECT_TRUE(reused.HasOneRef());
+}
+
+TEST(EncodedImageBufferPool, DoesNotReuseBufferReferencedElsewhere) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  rtc::CopyOnWriteBuffer held_downstream = pool.CreateBuffer(true);
+  pool.ReturnBuffer(held_downstream, 10000, true);
+
+  rtc::CopyOnWriteBuffer buffer = pool.CreateBuffer(false);
+  EXPECT_NE(held_downstream.cdata(), buffer.cdata());
+  EXPECT_TRUE(buffer.HasOneRef());
+}
+
+TEST(EncodedImageBufferPool, ReusesBufferOfPreviousImage) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  EncodedImage image;
+  pool.AcquireBuffer(&image, true);
+  EXPECT_EQ(0u, image.size());
+  EXPECT_EQ(kMaxFrameSize, image.capacity());
+  const uint8_t* data = image.data();
+  image.set_size(10000);
+  image._frameType = VideoFrameType::kVideoFrameKey;
+  pool.ReturnBuffer(image);
+
+  pool.AcquireBuffer(&image, false);
+  EXPECT_EQ(data, image.data());
+  EXPECT_EQ(pool.EstimatedFrameSize(false), image.capacity());
+}
+
+TEST(EncodedImageBufferPool, DoesNotReuseBufferOfImageHeldDownstream) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  EncodedImage image;
+  pool.AcquireBuffer(&image, true);
+  image.set_size(10000);
+  pool.ReturnBuffer(image);
+  const EncodedImage held_downstream = image;
+
+  pool.AcquireBuffer(&image, false);
+  EXPECT_NE(held_downstream.data(), image.data());
+  EXPECT_EQ(10000u, held_downstream.size());
+}
+
+TEST(EncodedImageBufferPool, SizesBuffersFromFrameHistory) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  pool.ReturnBuffer(pool.CreateBuffer(true), 40000, true);
+  for (int i = 0; i < 10; ++i)
+    pool.ReturnBuffer(pool.CreateBuffer(false), 8000, false);
+
+  const size_t delta_size = pool.EstimatedFrameSize(false);
+  const size_t key_size = pool.EstimatedFrameSize(true);
+  EXPECT_GE(delta_size, 8000u);
+  EXPECT_LT(delta_size, 40000u);
+  EXPECT_GE(key_size, 40000u);
+  EXPECT_LT(key_size, kMaxFrameSize);
+  EXPECT_EQ(delta_size, pool.CreateBuffer(false).size());
+}
+
+TEST(EncodedImageBufferPool, NeverExceedsMaxFrameSize) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  pool.ReturnBuffer(pool.CreateBuffer(true), kMaxFrameSize, true);
+  EXPECT_EQ(kMaxFrameSize, pool.EstimatedFrameSize(true));
+}
+
+TEST(EncodedImageBufferPool, ReleaseForgetsHistory) {
+  EncodedImageBufferPool pool(kMaxFrameSize);
+  pool.ReturnBuffer(pool.CreateBuffer(true), 10000, true);
+  pool.Release();
+  EXPECT_EQ(kMaxFrameSize, pool.EstimatedFrameSize(false));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/experiments/field_trial_parser.h"
+#include "rtc_base/logging.h"
+#include "system_wrappers/include/field_trial.h"
+
+namespace webrtc {
+namespace {
+const char kFieldTrialName[] = "WebRTC-EncoderComplexityController";
+// Weight of the previous utilization estimate for each new frame.
+constexpr float kUtilizationAlpha = 0.9f;
+}  // namespace
+
+// static
+absl::optional<EncoderComplexityController::Settings>
+EncoderComplexityController::GetSettingsFromFieldTrial() {
+  FieldTrialFlag enabled("Enabled");
+  FieldTrialParameter<double> high_utilization("high", 0.8);
+  FieldTrialParameter<double> low_utilization("low", 0.4);
+  FieldTrialParameter<int> min_frames_between_changes("frames", 30);
+  ParseFieldTrial({&enabled, &high_utilization, &low_utilization,
+                   &min_frames_between_changes},
+                  field_trial::FindFullName(kFieldTrialName));
+  if (!enabled.Get())
+    return absl::nullopt;
+  if (low_utilization.Get() <= 0 ||
+      low_utilization.Get() >= high_utilization.Get()) {
+    RTC_LOG(LS_WARNING) << "Invalid utilization thresholds for "
+                        << kFieldTrialName << ", ignoring.";
+    return absl::nullopt;
+  }
+  Settings settings;
+  settings.high_utilization = high_utilization.Get();
+  settings.low_utilization = low_utilization.Get();
+  settings.min_frames_between_changes =
+      std::max(1, min_frames_between_changes.Get());
+  return settings;
+}
+
+EncoderComplexityController::EncoderComplexityController(
+    const Settings& settings,
+    int num_levels)
+    : settings_(settings),
+      num_levels_(num_levels),
+      level_(0),
+      frames_since_change_(0),
+      utilization_(kUtilizationAlpha) {
+  RTC_DCHECK_GT(num_levels_, 0);
+  RTC_DCHECK_LT(settings_.low_utilization, settings_.high_utilization);
+}
+
+bool EncoderComplexityController::OnFrameEncoded(int64_t encode_time_ms,
+                                                 double framerate_fps) {
+  if (framerate_fps <= 0 || encode_time_ms < 0)
+    return false;
+  const double frame_interval_ms = 1000.0 / framerate_fps;
+  utilization_.Apply(1.0f, encode_time_ms / frame_interval_ms);
+
+  if (++frames_since_change_ < settings_.min_frames_between_changes)
+    return false;
+  const double utilization = utilization_.filtered();
+  if (utilization > settings_.high_utilization && level_ < num_levels_ - 1) {
+    ++level_;
+  } else if (utilization < settings_.low_utilization && level_ > 0) {
+    --level_;
+  } else {
+    return false;
+  }
+  frames_since_change_ = 0;
+  return true;
+}
+
+double EncoderComplexityController::utilization() const {
+  const float filtered = utilization_.filtered();
+  return filtered == rtc::ExpFilter::kValueUndefined ? 0.0 : filtered;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_ENCODER_COMPLEXITY_CONTROLLER_H_
+#define MODULES_VIDEO_CODING_UTILITY_ENCODER_COMPLEXITY_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "rtc_base/numerics/exp_filter.h"
+
+namespace webrtc {
+
+// Closed loop control of the effort an encoder spends per frame, driven by
+// measured encode times. When encoding takes too large a share of the frame
+// interval the controller steps to a lower effort level, and when there is
+// plenty of headroom it steps back up.
+//
+// Levels range from 0, the effort the encoder is configured with, to
+// |num_levels| - 1, the lowest effort the encoder offers. How a level maps to
+// codec settings is up to the encoder. One controller is used per stream.
+class EncoderComplexityController {
+ public:
+  struct Settings {
+    // Smoothed encode time relative to the frame interval above which effort
+    // is reduced, and below which it is increased again.
+    double high_utilization = 0.8;
+    double low_utilization = 0.4;
+    // Minimum number of encoded frames between two level changes, so that
+    // the effect of a change is measured before the next one.
+    int min_frames_between_changes = 30;
+  };
+
+  // Returns the settings if the controller is enabled by field trial.
+  static absl::optional<Settings> GetSettingsFromFieldTrial();
+
+  EncoderComplexityController(const Settings& settings, int num_levels);
+
+  // Reports the encode time of a frame of a stream running at
+  // |framerate_fps|. Returns true if the level changed.
+  bool OnFrameEncoded(int64_t encode_time_ms, double framerate_fps);
+
+  int level() const { return level_; }
+  int num_levels() const { return num_levels_; }
+
+  // True while the encoder has a lower effort level left. Encoders report
+  // this as EncoderInfo::can_reduce_complexity, so that CPU adaptation can
+  // prefer it over lowering the resolution.
+  bool CanReduceEffort() const { return level_ < num_levels_ - 1; }
+
+  // Smoothed encode time relative to the frame interval.
+  double utilization() const;
+
+ private:
+  const Settings settings_;
+  const int num_levels_;
+  int level_;
+  int frames_since_change_;
+  rtc::ExpFilter utilization_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_ENCODER_COMPLEXITY_CONTROLLER_H_
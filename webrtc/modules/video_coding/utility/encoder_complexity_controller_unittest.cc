@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
+
+#include "test/field_trial.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+constexpr double kFramerateFps = 30;
+// Encode times relative to the 33 ms frame interval.
+constexpr int64_t kOveruseEncodeTimeMs = 30;
+constexpr int64_t kUnderuseEncodeTimeMs = 5;
+constexpr int64_t kNormalEncodeTimeMs = 20;
+constexpr int kNumLevels = 3;
+
+EncoderComplexityController::Settings DefaultSettings() {
+  return EncoderComplexityController::Settings();
+}
+
+// Reports |num_frames| frames and returns the number of level changes.
+int EncodeFrames(EncoderComplexityController* controller,
+                 int num_frames,
+                 int64_t encode_time_ms) {
+  int num_changes = 0;
+  for (int i = 0; i < num_frames; ++i) {
+    if (controller->OnFrameEncoded(encode_time_ms, kFramerateFps))
+      ++num_changes;
+  }
+  return num_changes;
+}
+}  // namespace
+
+TEST(EncoderComplexityControllerTest, DisabledByDefault) {
+  EXPECT_FALSE(EncoderComplexityController::GetSettingsFromFieldTrial());
+}
+
+TEST(EncoderComplexityControllerTest, ParsesFieldTrial) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-EncoderComplexityController/"
+      "Enabled,high:0.9,low:0.3,frames:10/");
+  auto settings = EncoderComplexityController::GetSettingsFromFieldTrial();
+  ASSERT_TRUE(settings);
+  EXPECT_EQ(0.9, settings->high_utilization);
+  EXPECT_EQ(0.3, settings->low_utilization);
+  EXPECT_EQ(10, settings->min_frames_between_changes);
+}
+
+TEST(EncoderComplexityControllerTest, IgnoresInvalidThresholds) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-EncoderComplexityController/Enabled,high:0.3,low:0.5/");
+  EXPECT_FALSE(EncoderComplexityController::GetSettingsFromFieldTrial());
+}
+
+TEST(EncoderComplexityControllerTest, ReducesEffortOnOveruse) {
+  EncoderComplexityController controller(DefaultSettings(), kNumLevels);
+  const int min_frames = DefaultSettings().min_frames_between_changes;
+  EXPECT_EQ(0, EncodeFrames(&controller, min_frames - 1,
+                            kOveruseEncodeTimeMs));
+  EXPECT_EQ(0, controller.level());
+  EXPECT_EQ(1, EncodeFrames(&controller, 1, kOveruseEncodeTimeMs));
+  EXPECT_EQ(1, controller.level());
+  EXPECT_TRUE(controller.CanReduceEffort());
+
+  EXPECT_EQ(1, EncodeFrames(&controller, min_frames, kOveruseEncodeTimeMs));
+  EXPECT_EQ(2, controller.level());
+  EXPECT_FALSE(controller.CanReduceEffort());
+
+  // Already at the lowest effort.
+  EXPECT_EQ(0, EncodeFrames(&controller, 10 * min_frames,
+                            kOveruseEncodeTimeMs));
+  EXPECT_EQ(2, controller.level());
+}
+
+TEST(EncoderComplexityControllerTest, RestoresEffortOnUnderuse) {
+  EncoderComplexityController controller(DefaultSettings(), kNumLevels);
+  const int min_frames = DefaultSettings().min_frames_between_changes;
+  EncodeFrames(&controller, 2 * min_frames, kOveruseEncodeTimeMs);
+  EXPECT_EQ(2, controller.level());
+
+  EncodeFrames(&controller, 10 * min_frames, kUnderuseEncodeTimeMs);
+  EXPECT_EQ(0, controller.level());
+  EXPECT_LT(controller.utilization(), DefaultSettings().low_utilization);
+}
+
+TEST(EncoderComplexityControllerTest, KeepsLevelWithinThresholds) {
+  EncoderComplexityController controller(DefaultSettings(), kNumLevels);
+  const int min_frames = DefaultSettings().min_frames_between_changes;
+  EncodeFrames(&controller, min_frames, kOveruseEncodeTimeMs);
+  EXPECT_EQ(1, controller.level());
+  EXPECT_EQ(0, EncodeFrames(&controller, 10 * min_frames,
+                            kNormalEncodeTimeMs));
+  EXPECT_EQ(1, controller.level());
+}
+
+TEST(EncoderComplexityControllerTest, SingleLevelNeverChanges) {
+  EncoderComplexityController controller(DefaultSettings(), 1);
+  EXPECT_FALSE(controller.CanReduceEffort());
+  EXPECT_EQ(0, EncodeFrames(&controller, 100, kOveruseEncodeTimeMs));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,305 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/frame_quality_metrics.h"
+
+#include "rtc_base/system/arch.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+
+#include "api/video/i420_buffer.h"
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "third_party/libyuv/include/libyuv/compare.h"
+
+#if defined(WEBRTC_FRAME_QUALITY_AVX2)
+#include "modules/video_coding/utility/frame_quality_metrics_avx2.h"
+#include "third_party/libyuv/include/libyuv/cpu_id.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+constexpr int kWindowSize = 8;
+constexpr int kWindowStep = 4;
+// (0.01 * 255)^2 and (0.03 * 255)^2.
+constexpr double kSsimC1 = 6.5025;
+constexpr double kSsimC2 = 58.5225;
+
+// Sums over one window of the samples, squared samples and cross products of
+// the two planes.
+struct WindowSums {
+  uint32_t sum_a = 0;
+  uint32_t sum_b = 0;
+  uint32_t sum_sq_a = 0;
+  uint32_t sum_sq_b = 0;
+  uint32_t sum_ab = 0;
+};
+
+WindowSums CalculateWindowSums(const uint8_t* a,
+                               int stride_a,
+                               const uint8_t* b,
+                               int stride_b,
+                               int width,
+                               int height) {
+  WindowSums sums;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      const uint32_t sample_a = a[x];
+      const uint32_t sample_b = b[x];
+      sums.sum_a += sample_a;
+      sums.sum_b += sample_b;
+      sums.sum_sq_a += sample_a * sample_a;
+      sums.sum_sq_b += sample_b * sample_b;
+      sums.sum_ab += sample_a * sample_b;
+    }
+    a += stride_a;
+    b += stride_b;
+  }
+  return sums;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+uint32_t HorizontalSumSse2(__m128i v) {
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+}
+
+// Same as CalculateWindowSums() for an 8x8 window. Two rows are processed per
+// iteration.
+WindowSums CalculateWindowSums8x8Sse2(const uint8_t* a,
+                                      int stride_a,
+                                      const uint8_t* b,
+                                      int stride_b) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum_a = zero;
+  __m128i sum_b = zero;
+  __m128i sum_sq_a = zero;
+  __m128i sum_sq_b = zero;
+  __m128i sum_ab = zero;
+  for (int y = 0; y < kWindowSize; y += 2) {
+    const __m128i rows_a = _mm_unpacklo_epi64(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a)),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + stride_a)));
+    const __m128i rows_b = _mm_unpacklo_epi64(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b)),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + stride_b)));
+    // The sum of absolute differences against zero is the sum of the samples.
+    sum_a = _mm_add_epi32(sum_a, _mm_sad_epu8(rows_a, zero));
+    sum_b = _mm_add_epi32(sum_b, _mm_sad_epu8(rows_b, zero));
+    const __m128i row0_a = _mm_unpacklo_epi8(rows_a, zero);
+    const __m128i row1_a = _mm_unpackhi_epi8(rows_a, zero);
+    const __m128i row0_b = _mm_unpacklo_epi8(rows_b, zero);
+    const __m128i row1_b = _mm_unpackhi_epi8(rows_b, zero);
+    sum_sq_a = _mm_add_epi32(sum_sq_a, _mm_madd_epi16(row0_a, row0_a));
+    sum_sq_a = _mm_add_epi32(sum_sq_a, _mm_madd_epi16(row1_a, row1_a));
+    sum_sq_b = _mm_add_epi32(sum_sq_b, _mm_madd_epi16(row0_b, row0_b));
+    sum_sq_b = _mm_add_epi32(sum_sq_b, _mm_madd_epi16(row1_b, row1_b));
+    sum_ab = _mm_add_epi32(sum_ab, _mm_madd_epi16(row0_a, row0_b));
+    sum_ab = _mm_add_epi32(sum_ab, _mm_madd_epi16(row1_a, row1_b));
+    a += 2 * stride_a;
+    b += 2 * stride_b;
+  }
+  WindowSums sums;
+  sums.sum_a = HorizontalSumSse2(sum_a);
+  sums.sum_b = HorizontalSumSse2(sum_b);
+  sums.sum_sq_a = HorizontalSumSse2(sum_sq_a);
+  sums.sum_sq_b = HorizontalSumSse2(sum_sq_b);
+  sums.sum_ab = HorizontalSumSse2(sum_ab);
+  return sums;
+}
+#endif
+
+#if defined(WEBRTC_FRAME_QUALITY_AVX2)
+WindowSums CalculateWindowSums8x8WithAvx2(const uint8_t* a,
+                                          int stride_a,
+                                          const uint8_t* b,
+                                          int stride_b) {
+  uint32_t values[5];
+  CalculateWindowSums8x8Avx2(a, stride_a, b, stride_b, values);
+  WindowSums sums;
+  sums.sum_a = values[0];
+  sums.sum_b = values[1];
+  sums.sum_sq_a = values[2];
+  sums.sum_sq_b = values[3];
+  sums.sum_ab = values[4];
+  return sums;
+}
+#endif
+
+double SsimFromWindowSums(const WindowSums& sums, int num_samples) {
+  const double mean_a = static_cast<double>(sums.sum_a) / num_samples;
+  const double mean_b = static_cast<double>(sums.sum_b) / num_samples;
+  const double variance_a =
+      static_cast<double>(sums.sum_sq_a) / num_samples - mean_a * mean_a;
+  const double variance_b =
+      static_cast<double>(sums.sum_sq_b) / num_samples - mean_b * mean_b;
+  const double covariance =
+      static_cast<double>(sums.sum_ab) / num_samples - mean_a * mean_b;
+  return (2 * mean_a * mean_b + kSsimC1) * (2 * covariance + kSsimC2) /
+         ((mean_a * mean_a + mean_b * mean_b + kSsimC1) *
+          (variance_a + variance_b + kSsimC2));
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+bool UseSse2() {
+  static const bool use_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  return use_sse2;
+}
+#endif
+
+#if defined(WEBRTC_FRAME_QUALITY_AVX2)
+bool UseAvx2() {
+  static const bool use_avx2 = libyuv::TestCpuFlag(libyuv::kCpuHasAVX2) != 0;
+  return use_avx2;
+}
+#endif
+
+}  // namespace
+
+double CalculatePlaneSsim(const uint8_t* reference,
+                          int reference_stride,
+                          const uint8_t* test,
+                          int test_stride,
+                          int width,
+                          int height) {
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+  if (width < kWindowSize || height < kWindowSize) {
+    // Too small for a full window, use the whole plane as the only window.
+    return SsimFromWindowSums(CalculateWindowSums(reference, reference_stride,
+                                                  test, test_stride, width,
+                                                  height),
+                              width * height);
+  }
+
+#if defined(WEBRTC_FRAME_QUALITY_AVX2)
+  const bool use_avx2 = UseAvx2();
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const bool use_sse2 = UseSse2();
+#endif
+  double ssim_sum = 0.0;
+  int num_windows = 0;
+  for (int y = 0; y + kWindowSize <= height; y += kWindowStep) {
+    const uint8_t* reference_row = reference + y * reference_stride;
+    const uint8_t* test_row = test + y * test_stride;
+    for (int x = 0; x + kWindowSize <= width; x += kWindowStep) {
+      WindowSums sums;
+#if defined(WEBRTC_FRAME_QUALITY_AVX2)
+      if (use_avx2) {
+        sums = CalculateWindowSums8x8WithAvx2(reference_row + x,
+                                              reference_stride, test_row + x,
+                                              test_stride);
+      } else
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      if (use_sse2) {
+        sums = CalculateWindowSums8x8Sse2(reference_row + x, reference_stride,
+                                          test_row + x, test_stride);
+      } else
+#endif
+      {
+        sums =
+            CalculateWindowSums(reference_row + x, reference_stride,
+                                test_row + x, test_stride, kWindowSize,
+                                kWindowSize);
+      }
+      ssim_sum += SsimFromWindowSums(sums, kWindowSize * kWindowSize);
+      ++num_windows;
+    }
+  }
+  return ssim_sum / num_windows;
+}
+
+FrameQuality CalculateFrameQuality(const I420BufferInterface& reference,
+                                   const I420BufferInterface& test,
+                                   bool calculate_ssim) {
+  RTC_CHECK_EQ(reference.width(), test.width());
+  RTC_CHECK_EQ(reference.height(), test.height());
+  const int width = reference.width();
+  const int height = reference.height();
+  const int chroma_width = reference.ChromaWidth();
+  const int chroma_height = reference.ChromaHeight();
+
+  const uint64_t sse_y = libyuv::ComputeSumSquareErrorPlane(
+      reference.DataY(), reference.StrideY(), test.DataY(), test.StrideY(),
+      width, height);
+  const uint64_t sse_u = libyuv::ComputeSumSquareErrorPlane(
+      reference.DataU(), reference.StrideU(), test.DataU(), test.StrideU(),
+      chroma_width, chroma_height);
+  const uint64_t sse_v = libyuv::ComputeSumSquareErrorPlane(
+      reference.DataV(), reference.StrideV(), test.DataV(), test.StrideV(),
+      chroma_width, chroma_height);
+  const uint64_t num_y_samples = static_cast<uint64_t>(width) * height;
+  const uint64_t num_uv_samples =
+      static_cast<uint64_t>(chroma_width) * chroma_height;
+
+  FrameQuality quality;
+  quality.psnr_y = libyuv::SumSquareErrorToPsnr(sse_y, num_y_samples);
+  quality.psnr_u = libyuv::SumSquareErrorToPsnr(sse_u, num_uv_samples);
+  quality.psnr_v = libyuv::SumSquareErrorToPsnr(sse_v, num_uv_samples);
+  quality.psnr = libyuv::SumSquareErrorToPsnr(
+      sse_y + sse_u + sse_v, num_y_samples + 2 * num_uv_samples);
+
+  if (calculate_ssim) {
+    quality.ssim_y = CalculatePlaneSsim(reference.DataY(), reference.StrideY(),
+                                        test.DataY(), test.StrideY(), width,
+                                        height);
+    quality.ssim_u = CalculatePlaneSsim(reference.DataU(), reference.StrideU(),
+                                        test.DataU(), test.StrideU(),
+                                        chroma_width, chroma_height);
+    quality.ssim_v = CalculatePlaneSsim(reference.DataV(), reference.StrideV(),
+                                        test.DataV(), test.StrideV(),
+                                        chroma_width, chroma_height);
+    quality.ssim = 0.8 * *quality.ssim_y +
+                   0.1 * (*quality.ssim_u + *quality.ssim_v);
+  }
+  return quality;
+}
+
+FrameQualitySampler::FrameQualitySampler(const Config& config)
+    : config_(config), frames_until_sample_(0) {
+  RTC_DCHECK_GT(config_.sample_interval, 0);
+  RTC_DCHECK_GT(config_.downscale_factor, 0);
+}
+
+bool FrameQualitySampler::SampleFrame() {
+  if (frames_until_sample_ > 0) {
+    --frames_until_sample_;
+    return false;
+  }
+  frames_until_sample_ = config_.sample_interval - 1;
+  return true;
+}
+
+FrameQuality FrameQualitySampler::Measure(
+    const I420BufferInterface& reference,
+    const I420BufferInterface& test) const {
+  const int width = reference.width() / config_.downscale_factor;
+  const int height = reference.height() / config_.downscale_factor;
+  if (config_.downscale_factor == 1 || width < 2 || height < 2)
+    return CalculateFrameQuality(reference, test, config_.calculate_ssim);
+
+  rtc::scoped_refptr<I420Buffer> scaled_reference =
+      I420Buffer::Create(width, height);
+  scaled_reference->ScaleFrom(reference);
+  rtc::scoped_refptr<I420Buffer> scaled_test =
+      I420Buffer::Create(width, height);
+  scaled_test->ScaleFrom(test);
+  return CalculateFrameQuality(*scaled_reference, *scaled_test,
+                               config_.calculate_ssim);
+}
+
+}  // namespace webrtc
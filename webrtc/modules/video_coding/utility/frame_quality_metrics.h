@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_METRICS_H_
+#define MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_METRICS_H_
+
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "api/video/video_frame_buffer.h"
+
+namespace webrtc {
+
+// Quality of a frame relative to a reference frame.
+struct FrameQuality {
+  double psnr_y = 0.0;
+  double psnr_u = 0.0;
+  double psnr_v = 0.0;
+  // 10 * log10(255^2 / mse) over the samples of all three planes.
+  double psnr = 0.0;
+  // SSIM is only set if it was asked for.
+  absl::optional<double> ssim_y;
+  absl::optional<double> ssim_u;
+  absl::optional<double> ssim_v;
+  // 0.8 * ssim_y + 0.1 * (ssim_u + ssim_v).
+  absl::optional<double> ssim;
+};
+
+// Mean SSIM of two planes, over 8x8 windows spaced 4 samples apart. Uses the
+// same windows as libyuv::CalcFrameSsim, but vectorized where supported.
+double CalculatePlaneSsim(const uint8_t* reference,
+                          int reference_stride,
+                          const uint8_t* test,
+                          int test_stride,
+                          int width,
+                          int height);
+
+// Returns the quality of |test| relative to |reference|, which must have the
+// same size. PSNR uses the vectorized sum of squared errors of libyuv.
+FrameQuality CalculateFrameQuality(const I420BufferInterface& reference,
+                                   const I420BufferInterface& test,
+                                   bool calculate_ssim);
+
+// Measures the quality of every Nth frame, optionally on downscaled copies of
+// the frames to bound the cost. Used by FrameQualitySamplingEncoder to measure
+// the quality of encoder output while running.
+class FrameQualitySampler {
+ public:
+  struct Config {
+    // Measure one frame out of this many.
+    int sample_interval = 30;
+    // Downscale both frames by this factor in each dimension before measuring.
+    int downscale_factor = 1;
+    bool calculate_ssim = true;
+  };
+
+  explicit FrameQualitySampler(const Config& config);
+
+  // Called once per frame. Returns true if the frame should be measured.
+  bool SampleFrame();
+
+  FrameQuality Measure(const I420BufferInterface& reference,
+                       const I420BufferInterface& test) const;
+
+  const Config& config() const { return config_; }
+
+ private:
+  const Config config_;
+  int frames_until_sample_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_METRICS_H_
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/frame_quality_metrics_avx2.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+namespace {
+
+uint32_t HorizontalSumAvx2(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+}
+
+// Loads four rows of 8 samples, rows 0 and 1 into the low lane and rows 2 and
+// 3 into the high lane.
+__m256i LoadFourRows(const uint8_t* p, int stride) {
+  const __m128i rows01 = _mm_unpacklo_epi64(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)),
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + stride)));
+  const __m128i rows23 = _mm_unpacklo_epi64(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 2 * stride)),
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 3 * stride)));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(rows01), rows23, 1);
+}
+
+}  // namespace
+
+void CalculateWindowSums8x8Avx2(const uint8_t* a,
+                                int stride_a,
+                                const uint8_t* b,
+                                int stride_b,
+                                uint32_t sums[5]) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i sum_a = zero;
+  __m256i sum_b = zero;
+  __m256i sum_sq_a = zero;
+  __m256i sum_sq_b = zero;
+  __m256i sum_ab = zero;
+  // Four rows per iteration.
+  for (int y = 0; y < 8; y += 4) {
+    const __m256i rows_a = LoadFourRows(a, stride_a);
+    const __m256i rows_b = LoadFourRows(b, stride_b);
+    // The sum of absolute differences against zero is the sum of the samples.
+    sum_a = _mm256_add_epi32(sum_a, _mm256_sad_epu8(rows_a, zero));
+    sum_b = _mm256_add_epi32(sum_b, _mm256_sad_epu8(rows_b, zero));
+    // Unpacking works within each lane, so this gives rows 0 and 2, and rows
+    // 1 and 3.
+    const __m256i even_a = _mm256_unpacklo_epi8(rows_a, zero);
+    const __m256i odd_a = _mm256_unpackhi_epi8(rows_a, zero);
+    const __m256i even_b = _mm256_unpacklo_epi8(rows_b, zero);
+    const __m256i odd_b = _mm256_unpackhi_epi8(rows_b, zero);
+    sum_sq_a = _mm256_add_epi32(sum_sq_a, _mm256_madd_epi16(even_a, even_a));
+    sum_sq_a = _mm256_add_epi32(sum_sq_a, _mm256_madd_epi16(odd_a, odd_a));
+    sum_sq_b = _mm256_add_epi32(sum_sq_b, _mm256_madd_epi16(even_b, even_b));
+    sum_sq_b = _mm256_add_epi32(sum_sq_b, _mm256_madd_epi16(odd_b, odd_b));
+    sum_ab = _mm256_add_epi32(sum_ab, _mm256_madd_epi16(even_a, even_b));
+    sum_ab = _mm256_add_epi32(sum_ab, _mm256_madd_epi16(odd_a, odd_b));
+    a += 4 * stride_a;
+    b += 4 * stride_b;
+  }
+  sums[0] = HorizontalSumAvx2(sum_a);
+  sums[1] = HorizontalSumAvx2(sum_b);
+  sums[2] = HorizontalSumAvx2(sum_sq_a);
+  sums[3] = HorizontalSumAvx2(sum_sq_b);
+  sums[4] = HorizontalSumAvx2(sum_ab);
+}
+
+}  // namespace webrtc
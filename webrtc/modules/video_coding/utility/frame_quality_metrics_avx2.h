@@ -0,0 +1,30 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_METRICS_AVX2_H_
+#define MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_METRICS_AVX2_H_
+
+#include <stdint.h>
+
+namespace webrtc {
+
+// AVX2 version of the sums over one 8x8 window used by CalculatePlaneSsim().
+// Stores the sums of the samples of |a| and |b|, of their squares and of their
+// products in |sums|, in that order. Must only be called after checking for
+// AVX2 support at runtime.
+void CalculateWindowSums8x8Avx2(const uint8_t* a,
+                                int stride_a,
+                                const uint8_t* b,
+                                int stride_b,
+                                uint32_t sums[5]);
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_METRICS_AVX2_H_
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/frame_quality_metrics.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "api/video/i420_buffer.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+#include "third_party/libyuv/include/libyuv/compare.h"
+
+namespace webrtc {
+namespace {
+// Sizes where the last row and column of windows are the same as those of
+// libyuv::CalcFrameSsim.
+constexpr int kWidth = 66;
+constexpr int kHeight = 50;
+
+rtc::scoped_refptr<I420Buffer> CreateRandomBuffer(Random* random) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(kWidth, kHeight);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      buffer->MutableDataY()[y * buffer->StrideY() + x] =
+          random->Rand<uint8_t>();
+    }
+  }
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    for (int x = 0; x < buffer->ChromaWidth(); ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] =
+          random->Rand<uint8_t>();
+      buffer->MutableDataV()[y * buffer->StrideV() + x] =
+          random->Rand<uint8_t>();
+    }
+  }
+  return buffer;
+}
+
+rtc::scoped_refptr<I420Buffer> AddNoise(const I420BufferInterface& source,
+                                        int amplitude,
+                                        Random* random) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Copy(source);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      uint8_t* sample = &buffer->MutableDataY()[y * buffer->StrideY() + x];
+      *sample = static_cast<uint8_t>(std::min(
+          255, std::max(0, *sample + random->Rand(-amplitude, amplitude))));
+    }
+  }
+  return buffer;
+}
+}  // namespace
+
+TEST(FrameQualityMetrics, IdenticalFramesHaveMaxQuality) {
+  Random random(1);
+  rtc::scoped_refptr<I420Buffer> frame = CreateRandomBuffer(&random);
+  const FrameQuality quality = CalculateFrameQuality(*frame, *frame, true);
+  EXPECT_EQ(libyuv::kMaxPsnr, quality.psnr);
+  EXPECT_EQ(libyuv::kMaxPsnr, quality.psnr_y);
+  ASSERT_TRUE(quality.ssim);
+  EXPECT_DOUBLE_EQ(1.0, *quality.ssim);
+}
+
+TEST(FrameQualityMetrics, SsimOnlyCalculatedWhenAskedFor) {
+  Random random(1);
+  rtc::scoped_refptr<I420Buffer> frame = CreateRandomBuffer(&random);
+  const FrameQuality quality = CalculateFrameQuality(*frame, *frame, false);
+  EXPECT_FALSE(quality.ssim);
+  EXPECT_FALSE(quality.ssim_y);
+}
+
+TEST(FrameQualityMetrics, PlaneSsimMatchesLibyuv) {
+  Random random(2);
+  rtc::scoped_refptr<I420Buffer> reference = CreateRandomBuffer(&random);
+  rtc::scoped_refptr<I420Buffer> test = AddNoise(*reference, 20, &random);
+  const double expected =
+      libyuv::CalcFrameSsim(reference->DataY(), reference->StrideY(),
+                            test->DataY(), test->StrideY(), kWidth, kHeight);
+  EXPECT_NEAR(expected,
+              CalculatePlaneSsim(reference->DataY(), reference->StrideY(),
+                                 test->DataY(), test->StrideY(), kWidth,
+                                 kHeight),
+              1e-4);
+}
+
+TEST(FrameQualityMetrics, QualityDecreasesWithNoise) {
+  Random random(3);
+  rtc::scoped_refptr<I420Buffer> reference = CreateRandomBuffer(&random);
+  const FrameQuality low_noise = CalculateFrameQuality(
+      *reference, *AddNoise(*reference, 4, &random), true);
+  const FrameQuality high_noise = CalculateFrameQuality(
+      *reference, *AddNoise(*reference, 40, &random), true);
+  EXPECT_GT(low_noise.psnr_y, high_noise.psnr_y);
+  EXPECT_GT(*low_noise.ssim_y, *high_noise.ssim_y);
+  // Chroma is untouched.
+  EXPECT_EQ(libyuv::kMaxPsnr, high_noise.psnr_u);
+  EXPECT_DOUBLE_EQ(1.0, *high_noise.ssim_v);
+}
+
+TEST(FrameQualityMetrics, PlaneSmallerThanWindow) {
+  const uint8_t plane[4 * 4] = {0};
+  EXPECT_DOUBLE_EQ(1.0, CalculatePlaneSsim(plane, 4, plane, 4, 4, 4));
+}
+
+TEST(FrameQualitySampler, SamplesEveryNthFrame) {
+  FrameQualitySampler::Config config;
+  config.sample_interval = 3;
+  FrameQualitySampler sampler(config);
+  EXPECT_TRUE(sampler.SampleFrame());
+  EXPECT_FALSE(sampler.SampleFrame());
+  EXPECT_FALSE(sampler.SampleFrame());
+  EXPECT_TRUE(sampler.SampleFrame());
+  EXPECT_FALSE(sampler.SampleFrame());
+}
+
+TEST(FrameQualitySampler, MeasuresDownscaledFrames) {
+  Random random(4);
+  rtc::scoped_refptr<I420Buffer> reference = CreateRandomBuffer(&random);
+  rtc::scoped_refptr<I420Buffer> test = AddNoise(*reference, 20, &random);
+  FrameQualitySampler::Config config;
+  config.downscale_factor = 2;
+  FrameQualitySampler sampler(config);
+
+  EXPECT_EQ(libyuv::kMaxPsnr, sampler.Measure(*reference, *reference).psnr);
+  const FrameQuality quality = sampler.Measure(*reference, *test);
+  EXPECT_LT(quality.psnr, libyuv::kMaxPsnr);
+  ASSERT_TRUE(quality.ssim);
+  EXPECT_LT(*quality.ssim, 1.0);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/frame_quality_sampling_encoder.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "api/video/i420_buffer.h"
+#include "api/video_codecs/sdp_video_format.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+// Sampled frames are at least |sample_interval| frames apart, so only a few
+// can wait for their decoded output at any time.
+constexpr size_t kMaxReferences = 4;
+}  // namespace
+
+FrameQualitySamplingEncoder::DecodedFrameComparer::DecodedFrameComparer(
+    FrameQualitySamplingEncoder* parent,
+    int stream_index)
+    : parent_(parent), stream_index_(stream_index) {}
+
+int32_t FrameQualitySamplingEncoder::DecodedFrameComparer::Decoded(
+    VideoFrame& frame) {
+  parent_->OnDecodedFrame(stream_index_, frame);
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+FrameQualitySamplingEncoder::FrameQualitySamplingEncoder(
+    std::unique_ptr<VideoEncoder> encoder,
+    VideoDecoderFactory* decoder_factory,
+    const FrameQualitySampler::Config& config,
+    Observer* observer)
+    : encoder_(std::move(encoder)),
+      decoder_factory_(decoder_factory),
+      observer_(observer),
+      sampler_(config),
+      callback_(nullptr) {
+  RTC_DCHECK(encoder_);
+  RTC_DCHECK(decoder_factory_);
+  RTC_DCHECK(observer_);
+}
+
+FrameQualitySamplingEncoder::~FrameQualitySamplingEncoder() {
+  ReleaseDecoders();
+}
+
+int FrameQualitySamplingEncoder::InitEncode(const VideoCodec* codec_settings,
+                                            int number_of_cores,
+                                            size_t max_payload_size) {
+  ReleaseDecoders();
+  int ret =
+      encoder_->InitEncode(codec_settings, number_of_cores, max_payload_size);
+  if (ret != WEBRTC_VIDEO_CODEC_OK)
+    return ret;
+
+  if (codec_settings->codecType == kVideoCodecVP9 &&
+      codec_settings->VP9().numberOfSpatialLayers > 1) {
+    RTC_LOG(LS_WARNING) << "Frame quality of VP9 SVC is not measured.";
+    return ret;
+  }
+
+  const SdpVideoFormat format(
+      CodecTypeToPayloadString(codec_settings->codecType));
+  const int num_streams =
+      std::max<int>(1, codec_settings->numberOfSimulcastStreams);
+  for (int i = 0; i < num_streams; ++i) {
+    VideoCodec decoder_settings = *codec_settings;
+    if (num_streams > 1) {
+      decoder_settings.width = codec_settings->simulcastStream[i].width;
+      decoder_settings.height = codec_settings->simulcastStream[i].height;
+    }
+    std::unique_ptr<VideoDecoder> decoder =
+        decoder_factory_->CreateVideoDecoder(format);
+    if (!decoder ||
+        decoder->InitDecode(&decoder_settings, 1) != WEBRTC_VIDEO_CODEC_OK) {
+      RTC_LOG(LS_WARNING) << "No decoder for " << format.name
+                          << ", frame quality is not measured.";
+      ReleaseDecoders();
+      return ret;
+    }
+    comparers_.push_back(absl::make_unique<DecodedFrameComparer>(this, i));
+    decoder->RegisterDecodeCompleteCallback(comparers_.back().get());
+    decoders_.push_back(std::move(decoder));
+  }
+  return ret;
+}
+
+int FrameQualitySamplingEncoder::RegisterEncodeCompleteCallback(
+    EncodedImageCallback* callback) {
+  callback_ = callback;
+  return encoder_->RegisterEncodeCompleteCallback(this);
+}
+
+int FrameQualitySamplingEncoder::Release() {
+  ReleaseDecoders();
+  return encoder_->Release();
+}
+
+int FrameQualitySamplingEncoder::Encode(
+    const VideoFrame& frame,
+    const std::vector<VideoFrameType>* frame_types) {
+  if (!decoders_.empty() && sampler_.SampleFrame()) {
+    rtc::CritScope lock(&crit_);
+    references_.emplace_back(frame.timestamp(), frame.video_frame_buffer());
+    if (references_.size() > kMaxReferences)
+      references_.pop_front();
+  }
+  return encoder_->Encode(frame, frame_types);
+}
+
+int FrameQualitySamplingEncoder::SetRateAllocation(
+    const VideoBitrateAllocation& allocation,
+    uint32_t framerate) {
+  return encoder_->SetRateAllocation(allocation, framerate);
+}
+
+VideoEncoder::EncoderInfo FrameQualitySamplingEncoder::GetEncoderInfo() const {
+  return encoder_->GetEncoderInfo();
+}
+
+EncodedImageCallback::Result FrameQualitySamplingEncoder::OnEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const RTPFragmentationHeader* fragmentation) {
+  RTC_DCHECK(callback_);
+  const Result result = callback_->OnEncodedImage(
+      encoded_image, codec_specific_info, fragmentation);
+  const size_t stream_index = encoded_image.SpatialIndex().value_or(0);
+  if (stream_index < decoders_.size()) {
+    decoders_[stream_index]->Decode(encoded_image, /*missing_frames=*/false,
+                                    codec_specific_info,
+                                    encoded_image.capture_time_ms_);
+  }
+  return result;
+}
+
+void FrameQualitySamplingEncoder::OnDroppedFrame(DropReason reason) {
+  RTC_DCHECK(callback_);
+  callback_->OnDroppedFrame(reason);
+}
+
+void FrameQualitySamplingEncoder::OnDecodedFrame(int stream_index,
+                                                 const VideoFrame& frame) {
+  rtc::scoped_refptr<VideoFrameBuffer> reference;
+  {
+    rtc::CritScope lock(&crit_);
+    auto it = std::find_if(
+        references_.begin(), references_.end(),
+        [&frame](const std::pair<uint32_t,
+                                 rtc::scoped_refptr<VideoFrameBuffer>>& entry) {
+          return entry.first == frame.timestamp();
+        });
+    if (it == references_.end())
+      return;
+    // Kept for the other simulcast streams of the same frame.
+    reference = it->second;
+  }
+
+  rtc::scoped_refptr<I420BufferInterface> decoded =
+      frame.video_frame_buffer()->ToI420();
+  rtc::scoped_refptr<I420BufferInterface> scaled_reference =
+      reference->ToI420();
+  if (scaled_reference->width() != decoded->width() ||
+      scaled_reference->height() != decoded->height()) {
+    rtc::scoped_refptr<I420Buffer> scaled =
+        I420Buffer::Create(decoded->width(), decoded->height());
+    scaled->ScaleFrom(*scaled_reference);
+    scaled_reference = scaled;
+  }
+  observer_->OnFrameQuality(stream_index, frame.timestamp(),
+                            sampler_.Measure(*scaled_reference, *decoded));
+}
+
+void FrameQualitySamplingEncoder::ReleaseDecoders() {
+  for (auto& decoder : decoders_)
+    decoder->Release();
+  decoders_.clear();
+  comparers_.clear();
+  rtc::CritScope lock(&crit_);
+  references_.clear();
+}
+
+}  // namespace webrtc
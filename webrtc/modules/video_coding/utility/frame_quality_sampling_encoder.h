@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_SAMPLING_ENCODER_H_
+#define MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_SAMPLING_ENCODER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/scoped_refptr.h"
+#include "api/video/video_bitrate_allocation.h"
+#include "api/video/video_frame.h"
+#include "api/video/video_frame_buffer.h"
+#include "api/video_codecs/video_codec.h"
+#include "api/video_codecs/video_decoder.h"
+#include "api/video_codecs/video_decoder_factory.h"
+#include "api/video_codecs/video_encoder.h"
+#include "modules/video_coding/utility/frame_quality_metrics.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Wraps an encoder and measures the quality of every Nth input frame after
+// encoding. The output of each simulcast stream is decoded with a decoder
+// from |decoder_factory| and compared against the input, scaled to the size
+// of the stream. All frames have to be decoded to keep the decoders in sync,
+// only the comparison is limited to the sampled frames.
+//
+// VP9 with more than one spatial layer is not measured, as its spatial layers
+// depend on each other and can't be decoded on their own.
+class FrameQualitySamplingEncoder : public VideoEncoder,
+                                    private EncodedImageCallback {
+ public:
+  class Observer {
+   public:
+    virtual ~Observer() = default;
+    // Called with the quality of a sampled frame of the simulcast stream
+    // |stream_index|. May be called on the decoder thread.
+    virtual void OnFrameQuality(int stream_index,
+                                uint32_t rtp_timestamp,
+                                const FrameQuality& quality) = 0;
+  };
+
+  FrameQualitySamplingEncoder(std::unique_ptr<VideoEncoder> encoder,
+                              VideoDecoderFactory* decoder_factory,
+                              const FrameQualitySampler::Config& config,
+                              Observer* observer);
+  ~FrameQualitySamplingEncoder() override;
+
+  // Implements VideoEncoder.
+  int InitEncode(const VideoCodec* codec_settings,
+                 int number_of_cores,
+                 size_t max_payload_size) override;
+  int RegisterEncodeCompleteCallback(EncodedImageCallback* callback) override;
+  int Release() override;
+  int Encode(const VideoFrame& frame,
+             const std::vector<VideoFrameType>* frame_types) override;
+  int SetRateAllocation(const VideoBitrateAllocation& allocation,
+                        uint32_t framerate) override;
+  EncoderInfo GetEncoderInfo() const override;
+
+ private:
+  class DecodedFrameComparer : public DecodedImageCallback {
+   public:
+    DecodedFrameComparer(FrameQualitySamplingEncoder* parent,
+                         int stream_index);
+
+    int32_t Decoded(VideoFrame& frame) override;
+
+   private:
+    FrameQualitySamplingEncoder* const parent_;
+    const int stream_index_;
+  };
+
+  // Implements EncodedImageCallback.
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override;
+  void OnDroppedFrame(DropReason reason) override;
+
+  void OnDecodedFrame(int stream_index, const VideoFrame& frame);
+  void ReleaseDecoders();
+
+  const std::unique_ptr<VideoEncoder> encoder_;
+  VideoDecoderFactory* const decoder_factory_;
+  Observer* const observer_;
+  FrameQualitySampler sampler_;
+  EncodedImageCallback* callback_;
+
+  // Same indexing as the simulcast streams. Empty if the output can't be
+  // measured.
+  std::vector<std::unique_ptr<VideoDecoder>> decoders_;
+  std::vector<std::unique_ptr<DecodedFrameComparer>> comparers_;
+
+  rtc::CriticalSection crit_;
+  // Input of the sampled frames that may still be decoded, oldest first.
+  std::deque<std::pair<uint32_t, rtc::scoped_refptr<VideoFrameBuffer>>>
+      references_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_FRAME_QUALITY_SAMPLING_ENCODER_H_
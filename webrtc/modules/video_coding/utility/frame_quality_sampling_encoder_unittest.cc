@@ -0,0 +1,257 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/frame_quality_sampling_encoder.h"
+
+#include <string.h>
+
+#include <cmath>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "api/video/i420_buffer.h"
+#include "api/video_codecs/sdp_video_format.h"
+#include "modules/video_coding/include/video_codec_interface.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kWidth = 320;
+constexpr int kHeight = 180;
+constexpr uint8_t kInputLuma = 128;
+// Every decoded luma sample is off by 2, which makes the luma PSNR
+// 10 * log10(255^2 / 4).
+constexpr uint8_t kDecodedLuma = 130;
+constexpr uint8_t kChroma = 128;
+
+rtc::scoped_refptr<I420Buffer> CreateBuffer(int width,
+                                            int height,
+                                            uint8_t luma) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  for (int y = 0; y < height; ++y)
+    memset(buffer->MutableDataY() + y * buffer->StrideY(), luma, width);
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    memset(buffer->MutableDataU() + y * buffer->StrideU(), kChroma,
+           buffer->ChromaWidth());
+    memset(buffer->MutableDataV() + y * buffer->StrideV(), kChroma,
+           buffer->ChromaWidth());
+  }
+  return buffer;
+}
+
+// Outputs one image per simulcast stream, tagged with the stream index.
+class FakeEncoder : public VideoEncoder {
+ public:
+  int InitEncode(const VideoCodec* codec_settings,
+                 int number_of_cores,
+                 size_t max_payload_size) override {
+    codec_ = *codec_settings;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int RegisterEncodeCompleteCallback(EncodedImageCallback* callback) override {
+    callback_ = callback;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int Release() override { return WEBRTC_VIDEO_CODEC_OK; }
+  int Encode(const VideoFrame& frame,
+             const std::vector<VideoFrameType>* frame_types) override {
+    for (int i = 0; i < codec_.numberOfSimulcastStreams; ++i) {
+      EncodedImage image(payload_, sizeof(payload_), sizeof(payload_));
+      image._encodedWidth = codec_.simulcastStream[i].width;
+      image._encodedHeight = codec_.simulcastStream[i].height;
+      image.SetTimestamp(frame.timestamp());
+      image.SetSpatialIndex(i);
+      CodecSpecificInfo codec_specific_info;
+      callback_->OnEncodedImage(image, &codec_specific_info, nullptr);
+    }
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+ private:
+  VideoCodec codec_;
+  EncodedImageCallback* callback_ = nullptr;
+  uint8_t payload_[1] = {0};
+};
+
+// Outputs a frame of the encoded size with an offset luma.
+class FakeDecoder : public VideoDecoder {
+ public:
+  int32_t InitDecode(const VideoCodec* codec_settings,
+                     int32_t number_of_cores) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Decode(const EncodedImage& input_image,
+                 bool missing_frames,
+                 const CodecSpecificInfo* codec_specific_info,
+                 int64_t render_time_ms) override {
+    VideoFrame frame =
+        VideoFrame::Builder()
+            .set_video_frame_buffer(CreateBuffer(input_image._encodedWidth,
+                                                 input_image._encodedHeight,
+                                                 kDecodedLuma))
+            .set_timestamp_rtp(input_image.Timestamp())
+            .build();
+    callback_->Decoded(frame);
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t RegisterDecodeCompleteCallback(
+      DecodedImageCallback* callback) override {
+    callback_ = callback;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Release() override { return WEBRTC_VIDEO_CODEC_OK; }
+
+ private:
+  DecodedImageCallback* callback_ = nullptr;
+};
+
+class FakeDecoderFactory : public VideoDecoderFactory {
+ public:
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    return {SdpVideoFormat("VP8")};
+  }
+  std::unique_ptr<VideoDecoder> CreateVideoDecoder(
+      const SdpVideoFormat& format) override {
+    ++num_decoders;
+    return absl::make_unique<FakeDecoder>();
+  }
+
+  int num_decoders = 0;
+};
+
+class CountingEncodedImageCallback : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    ++num_images;
+    return Result(Result::OK);
+  }
+
+  int num_images = 0;
+};
+
+class QualityRecorder : public FrameQualitySamplingEncoder::Observer {
+ public:
+  struct Measurement {
+    int stream_index;
+    uint32_t rtp_timestamp;
+    FrameQuality quality;
+  };
+
+  void OnFrameQuality(int stream_index,
+                      uint32_t rtp_timestamp,
+                      const FrameQuality& quality) override {
+    measurements.push_back({stream_index, rtp_timestamp, quality});
+  }
+
+  std::vector<Measurement> measurements;
+};
+
+VideoCodec CreateCodecSettings(int num_streams) {
+  VideoCodec codec_settings;
+  codec_settings.codecType = kVideoCodecVP8;
+  codec_settings.width = kWidth;
+  codec_settings.height = kHeight;
+  codec_settings.numberOfSimulcastStreams = num_streams;
+  for (int i = 0; i < num_streams; ++i) {
+    const int shift = num_streams - 1 - i;
+    codec_settings.simulcastStream[i].width = kWidth >> shift;
+    codec_settings.simulcastStream[i].height = kHeight >> shift;
+  }
+  return codec_settings;
+}
+
+VideoFrame CreateInputFrame(uint32_t rtp_timestamp) {
+  return VideoFrame::Builder()
+      .set_video_frame_buffer(CreateBuffer(kWidth, kHeight, kInputLuma))
+      .set_timestamp_rtp(rtp_timestamp)
+      .build();
+}
+
+}  // namespace
+
+TEST(FrameQualitySamplingEncoderTest, MeasuresSampledFrames) {
+  FakeDecoderFactory decoder_factory;
+  QualityRecorder recorder;
+  FrameQualitySampler::Config config;
+  config.sample_interval = 2;
+  FrameQualitySamplingEncoder encoder(absl::make_unique<FakeEncoder>(),
+                                      &decoder_factory, config, &recorder);
+  CountingEncodedImageCallback callback;
+  encoder.RegisterEncodeCompleteCallback(&callback);
+  const VideoCodec codec_settings = CreateCodecSettings(1);
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, 1, 1200));
+  EXPECT_EQ(1, decoder_factory.num_decoders);
+
+  for (uint32_t i = 0; i < 3; ++i)
+    encoder.Encode(CreateInputFrame(3000 * i), nullptr);
+  EXPECT_EQ(3, callback.num_images);
+
+  ASSERT_EQ(2u, recorder.measurements.size());
+  EXPECT_EQ(0u, recorder.measurements[0].rtp_timestamp);
+  EXPECT_EQ(6000u, recorder.measurements[1].rtp_timestamp);
+  for (const auto& measurement : recorder.measurements) {
+    EXPECT_EQ(0, measurement.stream_index);
+    EXPECT_NEAR(10 * std::log10(255.0 * 255.0 / 4), measurement.quality.psnr_y,
+                0.01);
+    ASSERT_TRUE(measurement.quality.ssim);
+    EXPECT_GT(*measurement.quality.ssim, 0.9);
+  }
+}
+
+TEST(FrameQualitySamplingEncoderTest, ComparesEachStreamAtItsOwnSize) {
+  FakeDecoderFactory decoder_factory;
+  QualityRecorder recorder;
+  FrameQualitySampler::Config config;
+  config.sample_interval = 1;
+  FrameQualitySamplingEncoder encoder(absl::make_unique<FakeEncoder>(),
+                                      &decoder_factory, config, &recorder);
+  CountingEncodedImageCallback callback;
+  encoder.RegisterEncodeCompleteCallback(&callback);
+  const VideoCodec codec_settings = CreateCodecSettings(3);
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, 1, 1200));
+  EXPECT_EQ(3, decoder_factory.num_decoders);
+
+  encoder.Encode(CreateInputFrame(0), nullptr);
+  EXPECT_EQ(3, callback.num_images);
+  ASSERT_EQ(3u, recorder.measurements.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i, recorder.measurements[i].stream_index);
+    EXPECT_NEAR(10 * std::log10(255.0 * 255.0 / 4),
+                recorder.measurements[i].quality.psnr_y, 0.01);
+  }
+}
+
+TEST(FrameQualitySamplingEncoderTest, DoesNotMeasureVp9Svc) {
+  FakeDecoderFactory decoder_factory;
+  QualityRecorder recorder;
+  FrameQualitySamplingEncoder encoder(absl::make_unique<FakeEncoder>(),
+                                      &decoder_factory,
+                                      FrameQualitySampler::Config(), &recorder);
+  CountingEncodedImageCallback callback;
+  encoder.RegisterEncodeCompleteCallback(&callback);
+  VideoCodec codec_settings = CreateCodecSettings(1);
+  codec_settings.codecType = kVideoCodecVP9;
+  codec_settings.VP9()->numberOfSpatialLayers = 2;
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, 1, 1200));
+  EXPECT_EQ(0, decoder_factory.num_decoders);
+
+  encoder.Encode(CreateInputFrame(0), nullptr);
+  EXPECT_EQ(1, callback.num_images);
+  EXPECT_TRUE(recorder.measurements.empty());
+}
+
+}  // namespace webrtc
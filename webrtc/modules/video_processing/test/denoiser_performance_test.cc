@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "api/scoped_refptr.h"
+#include "api/video/video_frame_buffer.h"
+#include "modules/video_processing/video_denoiser.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/frame_utils.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kWidth = 1280;
+const int kHeight = 720;
+const size_t kQuickNumFrames = 10;
+
+// Reads the 720p clip into memory, so that only the denoising is timed.
+std::vector<rtc::scoped_refptr<I420BufferInterface>> ReadFrames() {
+  std::vector<rtc::scoped_refptr<I420BufferInterface>> frames;
+  const std::string video_file =
+      webrtc::test::ResourcePath("ConferenceMotion_1280_720_50", "yuv");
+  FILE* source_file = fopen(video_file.c_str(), "rb");
+  EXPECT_TRUE(source_file != nullptr)
+      << "Cannot open source file: " << video_file;
+  if (!source_file)
+    return frames;
+
+  const size_t max_frames = field_trial::IsEnabled("WebRTC-QuickPerfTest")
+                                ? kQuickNumFrames
+                                : SIZE_MAX;
+  while (frames.size() < max_frames) {
+    rtc::scoped_refptr<I420BufferInterface> video_frame_buffer(
+        test::ReadI420Buffer(kWidth, kHeight, source_file));
+    if (!video_frame_buffer)
+      break;
+    frames.push_back(video_frame_buffer);
+  }
+  fclose(source_file);
+  return frames;
+}
+
+// Returns the number of frames denoised per second, with noise estimation
+// enabled.
+double MeasureDenoiseFps(
+    const std::vector<rtc::scoped_refptr<I420BufferInterface>>& frames,
+    VideoDenoiser* denoiser) {
+  // The first frame only initializes the denoiser.
+  denoiser->DenoiseFrame(frames[0], true);
+  const int64_t start_us = rtc::TimeMicros();
+  for (size_t i = 1; i < frames.size(); ++i)
+    denoiser->DenoiseFrame(frames[i], true);
+  const int64_t runtime_us = rtc::TimeMicros() - start_us;
+  return runtime_us > 0 ? (frames.size() - 1) * 1e6 / runtime_us : 0;
+}
+
+}  // namespace
+
+TEST(VideoDenoiserPerformanceTest, DISABLED_DenoiseC) {
+  const std::vector<rtc::scoped_refptr<I420BufferInterface>> frames =
+      ReadFrames();
+  ASSERT_GT(frames.size(), 1u);
+  VideoDenoiser denoiser(false);
+  webrtc::test::PrintResult("denoise_speed", "", "c_720p",
+                            MeasureDenoiseFps(frames, &denoiser), "fps",
+                            false);
+}
+
+TEST(VideoDenoiserPerformanceTest, DISABLED_DenoiseSimd) {
+  const std::vector<rtc::scoped_refptr<I420BufferInterface>> frames =
+      ReadFrames();
+  ASSERT_GT(frames.size(), 1u);
+  VideoDenoiser denoiser(true);
+  webrtc::test::PrintResult("denoise_speed", "", "simd_720p",
+                            MeasureDenoiseFps(frames, &denoiser), "fps",
+                            false);
+}
+
+TEST(VideoDenoiserPerformanceTest, DISABLED_DenoiseSimd4Threads) {
+  const std::vector<rtc::scoped_refptr<I420BufferInterface>> frames =
+      ReadFrames();
+  ASSERT_GT(frames.size(), 1u);
+  VideoDenoiser denoiser(true, 4);
+  webrtc::test::PrintResult("denoise_speed", "", "simd_4_threads_720p",
+                            MeasureDenoiseFps(frames, &denoiser), "fps",
+                            false);
+}
+
+}  // namespace webrtc
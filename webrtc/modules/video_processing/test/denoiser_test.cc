@@ -70,6 +70,27 @@ TEST(VideoDenoiserTest, Variance) {
   EXPECT_EQ(var, df_sse_neon->Variance16x8(src, 16, dst, 16, &sse));
 }
 
+TEST(VideoDenoiserTest, Sum8x8) {
+  std::unique_ptr<DenoiserFilter> df_c(DenoiserFilter::Create(false, nullptr));
+  std::unique_ptr<DenoiserFilter> df_sse_neon(
+      DenoiserFilter::Create(true, nullptr));
+  uint8_t src[16 * 16];
+  uint32_t sum = 0;
+  for (int i = 0; i < 16; ++i) {
+    for (int j = 0; j < 16; ++j) {
+      src[i * 16 + j] = 255 - i * 7 - j;
+    }
+  }
+  // Sum of the center 8x8 samples.
+  for (int i = 4; i < 12; ++i) {
+    for (int j = 4; j < 12; ++j) {
+      sum += 255 - i * 7 - j;
+    }
+  }
+  EXPECT_EQ(sum, df_c->Sum8x8(src + 4 * 16 + 4, 16));
+  EXPECT_EQ(sum, df_sse_neon->Sum8x8(src + 4 * 16 + 4, 16));
+}
+
 TEST(VideoDenoiserTest, MbDenoise) {
   std::unique_ptr<DenoiserFilter> df_c(DenoiserFilter::Create(false, nullptr));
   std::unique_ptr<DenoiserFilter> df_sse_neon(
@@ -164,4 +185,41 @@ TEST(VideoDenoiserTest, Denoiser) {
   ASSERT_NE(0, feof(source_file)) << "Error reading source file";
 }
 
+TEST(VideoDenoiserTest, MultiThreadedDenoiser) {
+  const int kWidth = 352;
+  const int kHeight = 288;
+
+  const std::string video_file =
+      webrtc::test::ResourcePath("foreman_cif", "yuv");
+  FILE* source_file = fopen(video_file.c_str(), "rb");
+  ASSERT_TRUE(source_file != nullptr)
+      << "Cannot open source file: " << video_file;
+
+  VideoDenoiser denoiser(true);
+  // More threads than the 18 macroblock rows of the frame.
+  VideoDenoiser denoiser_3_threads(true, 3);
+  VideoDenoiser denoiser_20_threads(true, 20);
+
+  for (;;) {
+    rtc::scoped_refptr<I420BufferInterface> video_frame_buffer(
+        test::ReadI420Buffer(kWidth, kHeight, source_file));
+    if (!video_frame_buffer)
+      break;
+
+    rtc::scoped_refptr<I420BufferInterface> denoised_frame(
+        denoiser.DenoiseFrame(video_frame_buffer, true));
+    rtc::scoped_refptr<I420BufferInterface> denoised_frame_3_threads(
+        denoiser_3_threads.DenoiseFrame(video_frame_buffer, true));
+    rtc::scoped_refptr<I420BufferInterface> denoised_frame_20_threads(
+        denoiser_20_threads.DenoiseFrame(video_frame_buffer, true));
+
+    // Denoising in bands should not change the result, including the noise
+    // estimation that is fed back into the following frames.
+    ASSERT_TRUE(test::FrameBufsEqual(denoised_frame, denoised_frame_3_threads));
+    ASSERT_TRUE(
+        test::FrameBufsEqual(denoised_frame, denoised_frame_20_threads));
+  }
+  ASSERT_NE(0, feof(source_file)) << "Error reading source file";
+}
+
 }  // namespace webrtc
@@ -39,6 +39,8 @@ class DenoiserFilter {
                                 const uint8_t* b,
                                 int b_stride,
                                 unsigned int* sse) = 0;
+  // Sum of the 8x8 block at |src|.
+  virtual uint32_t Sum8x8(const uint8_t* src, int src_stride) = 0;
   virtual DenoiserDecision MbDenoise(const uint8_t* mc_running_avg_y,
                                      int mc_avg_y_stride,
                                      uint8_t* running_avg_y,
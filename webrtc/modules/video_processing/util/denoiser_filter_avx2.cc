@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_processing/util/denoiser_filter_avx2.h"
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+namespace webrtc {
+
+// Loads 16 pixels of two rows, the first row in the low lane.
+static __m256i LoadRows(const uint8_t* src, int stride) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + stride)), 1);
+}
+
+static void StoreRows(__m256i rows, uint8_t* dst, int stride) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   _mm256_castsi256_si128(rows));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + stride),
+                   _mm256_extracti128_si256(rows, 1));
+}
+
+static int32_t HorizontalSum(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+uint32_t DenoiserFilterAVX2::Variance16x8(const uint8_t* src,
+                                          int src_stride,
+                                          const uint8_t* ref,
+                                          int ref_stride,
+                                          uint32_t* sse) {
+  // Same as the SSE2 version, every other row of the 16x16 block is used.
+  src_stride <<= 1;
+  ref_stride <<= 1;
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i vsum = _mm256_setzero_si256();
+  __m256i vsse = _mm256_setzero_si256();
+  for (int i = 0; i < 8; i += 2) {
+    const __m256i src_rows = LoadRows(src + i * src_stride, src_stride);
+    const __m256i ref_rows = LoadRows(ref + i * ref_stride, ref_stride);
+    const __m256i diff_lo = _mm256_sub_epi16(
+        _mm256_unpacklo_epi8(src_rows, zero),
+        _mm256_unpacklo_epi8(ref_rows, zero));
+    const __m256i diff_hi = _mm256_sub_epi16(
+        _mm256_unpackhi_epi8(src_rows, zero),
+        _mm256_unpackhi_epi8(ref_rows, zero));
+
+    // Each 16-bit element sums at most 8 differences, which can't overflow.
+    vsum = _mm256_add_epi16(vsum, diff_lo);
+    vsum = _mm256_add_epi16(vsum, diff_hi);
+    vsse = _mm256_add_epi32(vsse, _mm256_madd_epi16(diff_lo, diff_lo));
+    vsse = _mm256_add_epi32(vsse, _mm256_madd_epi16(diff_hi, diff_hi));
+  }
+
+  const int64_t sum =
+      HorizontalSum(_mm256_madd_epi16(vsum, _mm256_set1_epi16(1)));
+  *sse = HorizontalSum(vsse);
+  return *sse - ((sum * sum) >> 7);
+}
+
+DenoiserDecision DenoiserFilterAVX2::MbDenoise(const uint8_t* mc_running_avg_y,
+                                               int mc_avg_y_stride,
+                                               uint8_t* running_avg_y,
+                                               int avg_y_stride,
+                                               const uint8_t* sig,
+                                               int sig_stride,
+                                               uint8_t motion_magnitude,
+                                               int increase_denoising) {
+  int shift_inc =
+      (increase_denoising && motion_magnitude <= kMotionMagnitudeThreshold) ? 1
+                                                                            : 0;
+  __m256i acc_diff = _mm256_setzero_si256();
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  const __m256i k_8 = _mm256_set1_epi8(8);
+  const __m256i k_16 = _mm256_set1_epi8(16);
+  // Modify each level's adjustment according to motion_magnitude.
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= kMotionMagnitudeThreshold) ? 7 + shift_inc : 6);
+  // Difference between level 3 and level 2 is 2.
+  const __m256i l32 = _mm256_set1_epi8(2);
+  // Difference between level 2 and level 1 is 1.
+  const __m256i l21 = _mm256_set1_epi8(1);
+
+  for (int r = 0; r < 16; r += 2) {
+    // Calculate differences, see the SSE2 version for details.
+    const __m256i v_sig = LoadRows(sig, sig_stride);
+    const __m256i v_mc_running_avg_y =
+        LoadRows(mc_running_avg_y, mc_avg_y_stride);
+    const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+    const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+    const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+    const __m256i clamped_absdiff =
+        _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_16);
+    const __m256i mask2 = _mm256_cmpgt_epi8(k_16, clamped_absdiff);
+    const __m256i mask1 = _mm256_cmpgt_epi8(k_8, clamped_absdiff);
+    const __m256i mask0 = _mm256_cmpgt_epi8(k_4, clamped_absdiff);
+    const __m256i adj2 = _mm256_add_epi8(_mm256_and_si256(mask2, l32),
+                                         _mm256_and_si256(mask1, l21));
+    const __m256i adj0 = _mm256_and_si256(mask0, clamped_absdiff);
+    const __m256i adj = _mm256_or_si256(
+        _mm256_andnot_si256(mask0, _mm256_sub_epi8(l3, adj2)), adj0);
+    const __m256i padj = _mm256_andnot_si256(diff_sign, adj);
+    const __m256i nadj = _mm256_and_si256(diff_sign, adj);
+
+    StoreRows(_mm256_subs_epu8(_mm256_adds_epu8(v_sig, padj), nadj),
+              running_avg_y, avg_y_stride);
+
+    // Each lane accumulates 8 rows of adjustments <= 8, which fit in a signed
+    // char.
+    acc_diff = _mm256_adds_epi8(acc_diff, padj);
+    acc_diff = _mm256_subs_epi8(acc_diff, nadj);
+
+    sig += 2 * sig_stride;
+    mc_running_avg_y += 2 * mc_avg_y_stride;
+    running_avg_y += 2 * avg_y_stride;
+  }
+
+  // Combine the two lanes, saturating like the SSE2 version, and compute the
+  // sum of all pixel differences of this MB.
+  const __m128i acc_diff_16x1 = _mm_adds_epi8(
+      _mm256_castsi256_si128(acc_diff), _mm256_extracti128_si256(acc_diff, 1));
+  const unsigned int abs_sum_diff = abs(HorizontalSum(_mm256_madd_epi16(
+      _mm256_cvtepi8_epi16(acc_diff_16x1), _mm256_set1_epi16(1))));
+  const unsigned int sum_diff_thresh =
+      increase_denoising ? kSumDiffThresholdHigh : kSumDiffThreshold;
+  return abs_sum_diff > sum_diff_thresh ? COPY_BLOCK : FILTER_BLOCK;
+}
+
+}  // namespace webrtc
@@ -49,6 +49,16 @@ uint32_t DenoiserFilterC::Variance16x8(const uint8_t* a,
   return *sse - ((static_cast<int64_t>(sum) * sum) >> 7);
 }
 
+uint32_t DenoiserFilterC::Sum8x8(const uint8_t* src, int src_stride) {
+  uint32_t sum = 0;
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 8; j++)
+      sum += src[j];
+    src += src_stride;
+  }
+  return sum;
+}
+
 DenoiserDecision DenoiserFilterC::MbDenoise(const uint8_t* mc_running_avg_y,
                                             int mc_avg_y_stride,
                                             uint8_t* running_avg_y,
@@ -87,6 +87,16 @@ uint32_t DenoiserFilterNEON::Variance16x8(const uint8_t* a,
   return *sse - ((sum * sum) >> 7);
 }
 
+uint32_t DenoiserFilterNEON::Sum8x8(const uint8_t* src, int src_stride) {
+  uint16x8_t v_sum = vdupq_n_u16(0);
+  for (int i = 0; i < 8; ++i) {
+    v_sum = vaddw_u8(v_sum, vld1_u8(src));
+    src += src_stride;
+  }
+  const uint64x2_t b = vpaddlq_u32(vpaddlq_u16(v_sum));
+  return static_cast<uint32_t>(vgetq_lane_u64(b, 0) + vgetq_lane_u64(b, 1));
+}
+
 DenoiserDecision DenoiserFilterNEON::MbDenoise(const uint8_t* mc_running_avg_y,
                                                int mc_running_avg_y_stride,
                                                uint8_t* running_avg_y,
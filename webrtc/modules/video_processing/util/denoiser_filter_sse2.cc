@@ -122,6 +122,20 @@ uint32_t DenoiserFilterSSE2::Variance16x8(const uint8_t* src,
   return *sse - ((sum * sum) >> 7);
 }
 
+uint32_t DenoiserFilterSSE2::Sum8x8(const uint8_t* src, int src_stride) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i vsum = _mm_setzero_si128();
+  for (int i = 0; i < 8; i += 2) {
+    const __m128i rows = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i*)(src + i * src_stride)),
+        _mm_loadl_epi64((const __m128i*)(src + (i + 1) * src_stride)));
+    // Sum of absolute differences against zero gives two partial sums.
+    vsum = _mm_add_epi32(vsum, _mm_sad_epu8(rows, zero));
+  }
+  vsum = _mm_add_epi32(vsum, _mm_srli_si128(vsum, 8));
+  return _mm_cvtsi128_si32(vsum);
+}
+
 DenoiserDecision DenoiserFilterSSE2::MbDenoise(const uint8_t* mc_running_avg_y,
                                                int mc_avg_y_stride,
                                                uint8_t* running_avg_y,
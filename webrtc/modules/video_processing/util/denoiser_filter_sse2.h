@@ -29,6 +29,7 @@ class DenoiserFilterSSE2 : public DenoiserFilter {
                         const uint8_t* b,
                         int b_stride,
                         unsigned int* sse) override;
+  uint32_t Sum8x8(const uint8_t* src, int src_stride) override;
   DenoiserDecision MbDenoise(const uint8_t* mc_running_avg_y,
                              int mc_avg_y_stride,
                              uint8_t* running_avg_y,
@@ -13,7 +13,13 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <algorithm>
+#include <string>
+
+#include "absl/memory/memory.h"
 #include "api/video/i420_buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "third_party/libyuv/include/libyuv/planar_functions.h"
 
 namespace webrtc {
@@ -75,10 +81,25 @@ static void ShowRect(const std::unique_ptr<DenoiserFilter>& filter,
 #endif
 
 VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection)
+    : VideoDenoiser(runtime_cpu_detection, 1) {}
+
+VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection, int num_threads)
     : width_(0),
       height_(0),
       filter_(DenoiserFilter::Create(runtime_cpu_detection, &cpu_type_)),
-      ne_(new NoiseEstimation()) {}
+      ne_(new NoiseEstimation()),
+      num_threads_(num_threads) {
+  RTC_DCHECK_GT(num_threads_, 0);
+  for (int i = 1; i < num_threads_; ++i) {
+    workers_.push_back(absl::make_unique<rtc::TaskQueue>(
+        ("DenoiserWorker" + std::to_string(i)).c_str()));
+  }
+}
+
+VideoDenoiser::~VideoDenoiser() {
+  // Stop the workers before the state they use is destroyed.
+  workers_.clear();
+}
 
 void VideoDenoiser::DenoiserReset(
     rtc::scoped_refptr<I420BufferInterface> frame) {
@@ -94,6 +115,10 @@ void VideoDenoiser::DenoiserReset(
   x_density_.reset(new uint8_t[mb_cols_]);
   y_density_.reset(new uint8_t[mb_rows_]);
   moving_object_.reset(new uint8_t[mb_cols_ * mb_rows_]);
+  noise_samples_.reset(
+      new NoiseSample[(mb_cols_ * mb_rows_ + NOISE_SUBSAMPLE_INTERVAL - 1) /
+                      NOISE_SUBSAMPLE_INTERVAL]);
+  band_x_density_.reset(new uint8_t[(num_threads_ - 1) * mb_cols_]);
 }
 
 int VideoDenoiser::PositionCheck(int mb_row, int mb_col, int noise_level) {
@@ -220,42 +245,24 @@ void VideoDenoiser::CopyLumaOnMargin(const uint8_t* y_src,
   }
 }
 
-rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
-    rtc::scoped_refptr<I420BufferInterface> frame,
-    bool noise_estimation_enabled) {
-  // If previous width and height are different from current frame's, need to
-  // reallocate the buffers and no denoising for the current frame.
-  if (!prev_buffer_ || width_ != frame->width() || height_ != frame->height()) {
-    DenoiserReset(frame);
-    prev_buffer_ = frame;
-    return frame;
-  }
-
-  // Set buffer pointers.
-  const uint8_t* y_src = frame->DataY();
-  int stride_y_src = frame->StrideY();
-  rtc::scoped_refptr<I420Buffer> dst =
-      buffer_pool_.CreateBuffer(width_, height_);
-
-  uint8_t* y_dst = dst->MutableDataY();
-  int stride_y_dst = dst->StrideY();
-
-  const uint8_t* y_dst_prev = prev_buffer_->DataY();
-  int stride_prev = prev_buffer_->StrideY();
-
-  memset(x_density_.get(), 0, mb_cols_);
-  memset(y_density_.get(), 0, mb_rows_);
-  memset(moving_object_.get(), 1, mb_cols_ * mb_rows_);
-
-  uint8_t noise_level = noise_estimation_enabled ? ne_->GetNoiseLevel() : 0;
+void VideoDenoiser::DenoiseRows(int first_mb_row,
+                                int last_mb_row,
+                                const uint8_t* y_src,
+                                int stride_src,
+                                uint8_t* y_dst,
+                                int stride_dst,
+                                const uint8_t* y_prev,
+                                int stride_prev,
+                                uint8_t noise_level,
+                                uint8_t* x_density) {
   int thr_var_base = 16 * 16 * 2;
   // Loop over blocks to accumulate/extract noise level and update x/y_density
   // factors for moving object detection.
-  for (int mb_row = 0; mb_row < mb_rows_; ++mb_row) {
+  for (int mb_row = first_mb_row; mb_row < last_mb_row; ++mb_row) {
     const int mb_index_base = mb_row * mb_cols_;
-    const uint8_t* mb_src_base = y_src + (mb_row << 4) * stride_y_src;
-    uint8_t* mb_dst_base = y_dst + (mb_row << 4) * stride_y_dst;
-    const uint8_t* mb_dst_prev_base = y_dst_prev + (mb_row << 4) * stride_prev;
+    const uint8_t* mb_src_base = y_src + (mb_row << 4) * stride_src;
+    uint8_t* mb_dst_base = y_dst + (mb_row << 4) * stride_dst;
+    const uint8_t* mb_dst_prev_base = y_prev + (mb_row << 4) * stride_prev;
     for (int mb_col = 0; mb_col < mb_cols_; ++mb_col) {
       const int mb_index = mb_index_base + mb_col;
       const bool ne_enable = (mb_index % NOISE_SUBSAMPLE_INTERVAL == 0);
@@ -265,21 +272,21 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
       const uint8_t* mb_src = mb_src_base + offset_col;
       uint8_t* mb_dst = mb_dst_base + offset_col;
       const uint8_t* mb_dst_prev = mb_dst_prev_base + offset_col;
+      NoiseSample* noise_sample =
+          ne_enable ? &noise_samples_[mb_index / NOISE_SUBSAMPLE_INTERVAL]
+                    : nullptr;
 
-      // TODO(jackychen): Need SSE2/NEON opt.
-      int luma = 0;
+      // Sum of the center 8x8 luma samples.
+      uint32_t luma = 0;
       if (ne_enable) {
-        for (int i = 4; i < 12; ++i) {
-          for (int j = 4; j < 12; ++j) {
-            luma += mb_src[i * stride_y_src + j];
-          }
-        }
+        luma = filter_->Sum8x8(mb_src + 4 * stride_src + 4, stride_src);
+        noise_sample->type = kNoSample;
       }
 
       // Get the filtered block and filter_decision.
       mb_filter_decision_[mb_index] =
-          filter_->MbDenoise(mb_dst_prev, stride_prev, mb_dst, stride_y_dst,
-                             mb_src, stride_y_src, 0, noise_level);
+          filter_->MbDenoise(mb_dst_prev, stride_prev, mb_dst, stride_dst,
+                             mb_src, stride_src, 0, noise_level);
 
       // If filter decision is FILTER_BLOCK, no need to check moving edge.
       // It is unlikely for a moving edge block to be filtered in current
@@ -290,8 +297,8 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
           // The variance used in noise estimation is based on the src block in
           // time t (mb_src) and filtered block in time t-1 (mb_dist_prev).
           uint32_t noise_var = filter_->Variance16x8(
-              mb_dst_prev, stride_y_dst, mb_src, stride_y_src, &sse_t);
-          ne_->GetNoise(mb_index, noise_var, luma);
+              mb_dst_prev, stride_dst, mb_src, stride_src, &sse_t);
+          *noise_sample = {kStaticBlock, noise_var, luma};
         }
         moving_edge_[mb_index] = 0;  // Not a moving edge block.
       } else {
@@ -299,13 +306,13 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
         // The variance used in MOD is based on the filtered blocks in time
         // T (mb_dst) and T-1 (mb_dst_prev).
         uint32_t noise_var = filter_->Variance16x8(
-            mb_dst_prev, stride_prev, mb_dst, stride_y_dst, &sse_t);
+            mb_dst_prev, stride_prev, mb_dst, stride_dst, &sse_t);
         if (noise_var > thr_var_adp) {  // Moving edge checking.
           if (ne_enable) {
-            ne_->ResetConsecLowVar(mb_index);
+            noise_sample->type = kMovingEdge;
           }
           moving_edge_[mb_index] = 1;  // Mark as moving edge block.
-          x_density_[mb_col] += (pos_factor < 3);
+          x_density[mb_col] += (pos_factor < 3);
           y_density_[mb_row] += (pos_factor < 3);
         } else {
           moving_edge_[mb_index] = 0;
@@ -313,13 +320,91 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
             // The variance used in noise estimation is based on the src block
             // in time t (mb_src) and filtered block in time t-1 (mb_dist_prev).
             uint32_t noise_var = filter_->Variance16x8(
-                mb_dst_prev, stride_prev, mb_src, stride_y_src, &sse_t);
-            ne_->GetNoise(mb_index, noise_var, luma);
+                mb_dst_prev, stride_prev, mb_src, stride_src, &sse_t);
+            *noise_sample = {kStaticBlock, noise_var, luma};
           }
         }
       }
     }  // End of for loop
   }    // End of for loop
+}
+
+void VideoDenoiser::DenoiseBands(const uint8_t* y_src,
+                                 int stride_src,
+                                 uint8_t* y_dst,
+                                 int stride_dst,
+                                 const uint8_t* y_prev,
+                                 int stride_prev,
+                                 uint8_t noise_level) {
+  const int num_bands = std::max(1, std::min(num_threads_, mb_rows_));
+  // Bands only write their own rows of the destination and the per block
+  // state, the previous frame is shared read only.
+  std::vector<rtc::Event> done(num_bands - 1);
+  for (int band = 1; band < num_bands; ++band) {
+    uint8_t* x_density = &band_x_density_[(band - 1) * mb_cols_];
+    memset(x_density, 0, mb_cols_);
+    const int first_mb_row = band * mb_rows_ / num_bands;
+    const int last_mb_row = (band + 1) * mb_rows_ / num_bands;
+    rtc::Event* band_done = &done[band - 1];
+    workers_[band - 1]->PostTask([=] {
+      DenoiseRows(first_mb_row, last_mb_row, y_src, stride_src, y_dst,
+                  stride_dst, y_prev, stride_prev, noise_level, x_density);
+      band_done->Set();
+    });
+  }
+  DenoiseRows(0, mb_rows_ / num_bands, y_src, stride_src, y_dst, stride_dst,
+              y_prev, stride_prev, noise_level, x_density_.get());
+  for (rtc::Event& band_done : done)
+    band_done.Wait(rtc::Event::kForever);
+
+  for (int band = 1; band < num_bands; ++band) {
+    const uint8_t* x_density = &band_x_density_[(band - 1) * mb_cols_];
+    for (int mb_col = 0; mb_col < mb_cols_; ++mb_col)
+      x_density_[mb_col] += x_density[mb_col];
+  }
+
+  // Feed the noise estimator in block order, the same as without bands.
+  for (int mb_index = 0; mb_index < mb_rows_ * mb_cols_;
+       mb_index += NOISE_SUBSAMPLE_INTERVAL) {
+    const NoiseSample& sample =
+        noise_samples_[mb_index / NOISE_SUBSAMPLE_INTERVAL];
+    if (sample.type == kStaticBlock)
+      ne_->GetNoise(mb_index, sample.var, sample.luma);
+    else if (sample.type == kMovingEdge)
+      ne_->ResetConsecLowVar(mb_index);
+  }
+}
+
+rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
+    rtc::scoped_refptr<I420BufferInterface> frame,
+    bool noise_estimation_enabled) {
+  // If previous width and height are different from current frame's, need to
+  // reallocate the buffers and no denoising for the current frame.
+  if (!prev_buffer_ || width_ != frame->width() || height_ != frame->height()) {
+    DenoiserReset(frame);
+    prev_buffer_ = frame;
+    return frame;
+  }
+
+  // Set buffer pointers.
+  const uint8_t* y_src = frame->DataY();
+  int stride_y_src = frame->StrideY();
+  rtc::scoped_refptr<I420Buffer> dst =
+      buffer_pool_.CreateBuffer(width_, height_);
+
+  uint8_t* y_dst = dst->MutableDataY();
+  int stride_y_dst = dst->StrideY();
+
+  const uint8_t* y_dst_prev = prev_buffer_->DataY();
+  int stride_prev = prev_buffer_->StrideY();
+
+  memset(x_density_.get(), 0, mb_cols_);
+  memset(y_density_.get(), 0, mb_rows_);
+  memset(moving_object_.get(), 1, mb_cols_ * mb_rows_);
+
+  uint8_t noise_level = noise_estimation_enabled ? ne_->GetNoiseLevel() : 0;
+  DenoiseBands(y_src, stride_y_src, y_dst, stride_y_dst, y_dst_prev,
+               stride_prev, noise_level);
 
   ReduceFalseDetection(moving_edge_, &moving_object_, noise_level);
 
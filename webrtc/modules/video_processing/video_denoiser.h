@@ -12,6 +12,7 @@
 #define MODULES_VIDEO_PROCESSING_VIDEO_DENOISER_H_
 
 #include <memory>
+#include <vector>
 
 #include "api/scoped_refptr.h"
 #include "api/video/video_frame_buffer.h"
@@ -19,20 +20,57 @@
 #include "modules/video_processing/util/denoiser_filter.h"
 #include "modules/video_processing/util/noise_estimation.h"
 #include "modules/video_processing/util/skin_detection.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
 class VideoDenoiser {
  public:
   explicit VideoDenoiser(bool runtime_cpu_detection);
+  // Denoises each frame in up to |num_threads| bands of macroblock rows in
+  // parallel. The result is identical to denoising with a single thread.
+  VideoDenoiser(bool runtime_cpu_detection, int num_threads);
+  ~VideoDenoiser();
 
   rtc::scoped_refptr<I420BufferInterface> DenoiseFrame(
       rtc::scoped_refptr<I420BufferInterface> frame,
       bool noise_estimation_enabled);
 
  private:
+  // Noise estimation input of a subsampled block. Bands record these and
+  // they are applied to |ne_| in block order once all bands are done.
+  enum NoiseSampleType : uint8_t { kNoSample, kStaticBlock, kMovingEdge };
+  struct NoiseSample {
+    NoiseSampleType type;
+    uint32_t var;
+    uint32_t luma;
+  };
+
   void DenoiserReset(rtc::scoped_refptr<I420BufferInterface> frame);
 
+  // Denoises the blocks of macroblock rows [first_mb_row, last_mb_row) and
+  // updates the moving edge detection state of these rows. Moving edge
+  // blocks are counted per column in |x_density|.
+  void DenoiseRows(int first_mb_row,
+                   int last_mb_row,
+                   const uint8_t* y_src,
+                   int stride_src,
+                   uint8_t* y_dst,
+                   int stride_dst,
+                   const uint8_t* y_prev,
+                   int stride_prev,
+                   uint8_t noise_level,
+                   uint8_t* x_density);
+
+  // Runs DenoiseRows() on all bands and merges their results.
+  void DenoiseBands(const uint8_t* y_src,
+                    int stride_src,
+                    uint8_t* y_dst,
+                    int stride_dst,
+                    const uint8_t* y_prev,
+                    int stride_prev,
+                    uint8_t noise_level);
+
   // Check the mb position, return 1: close to the frame center (between 1/8
   // and 7/8 of width/height), 3: close to the border (out of 1/16 and 15/16
   // of width/height), 2: in between.
@@ -77,6 +115,14 @@ class VideoDenoiser {
   std::unique_ptr<uint8_t[]> y_density_;
   // Save the return values by MbDenoise for each block.
   std::unique_ptr<DenoiserDecision[]> mb_filter_decision_;
+  // One entry per block subsampled for noise estimation.
+  std::unique_ptr<NoiseSample[]> noise_samples_;
+  // Per band column counts of moving edge blocks, for all but the first band
+  // which uses |x_density_| directly.
+  std::unique_ptr<uint8_t[]> band_x_density_;
+  const int num_threads_;
+  // Runs all but the first band, which is denoised on the calling thread.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> workers_;
   I420BufferPool buffer_pool_;
   rtc::scoped_refptr<I420BufferInterface> prev_buffer_;
 };
@@ -114,6 +114,13 @@ class CopyOnWriteBuffer {
     return buffer_ ? buffer_->capacity() : 0;
   }
 
+  // Returns true if no other CopyOnWriteBuffer shares the underlying data, in
+  // which case writing to it will not cause a copy.
+  bool HasOneRef() const {
+    RTC_DCHECK(IsConsistent());
+    return !buffer_ || buffer_->HasOneRef();
+  }
+
   CopyOnWriteBuffer& operator=(const CopyOnWriteBuffer& buf) {
     RTC_DCHECK(IsConsistent());
     RTC_DCHECK(buf.IsConsistent());
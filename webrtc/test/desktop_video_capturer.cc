@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "test/desktop_video_capturer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "api/video/video_rotation.h"
+#include "modules/desktop_capture/desktop_capturer_differ_wrapper.h"
+#include "modules/desktop_capture/desktop_geometry.h"
+#include "modules/desktop_capture/desktop_region.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
+#include "third_party/libyuv/include/libyuv/convert.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+
+namespace webrtc {
+namespace test {
+
+DesktopVideoCapturer::DesktopVideoCapturer(
+    std::unique_ptr<DesktopCapturer> capturer)
+    : capturer_(absl::make_unique<DesktopCapturerDifferWrapper>(
+          std::move(capturer))) {
+  capturer_->Start(this);
+}
+
+DesktopVideoCapturer::~DesktopVideoCapturer() = default;
+
+void DesktopVideoCapturer::CaptureFrame() {
+  capturer_->CaptureFrame();
+}
+
+rtc::scoped_refptr<DesktopVideoCapturer::RefCountedI420Buffer>
+DesktopVideoCapturer::GetWritableBuffer() {
+  if (buffer_->HasOneRef())
+    return buffer_;
+  // A sink still holds on to the previous frame, continue in a copy of it.
+  rtc::scoped_refptr<RefCountedI420Buffer> buffer(
+      new RefCountedI420Buffer(buffer_->width(), buffer_->height()));
+  libyuv::I420Copy(buffer_->DataY(), buffer_->StrideY(), buffer_->DataU(),
+                   buffer_->StrideU(), buffer_->DataV(), buffer_->StrideV(),
+                   buffer->MutableDataY(), buffer->StrideY(),
+                   buffer->MutableDataU(), buffer->StrideU(),
+                   buffer->MutableDataV(), buffer->StrideV(), buffer->width(),
+                   buffer->height());
+  return buffer;
+}
+
+void DesktopVideoCapturer::OnCaptureResult(
+    DesktopCapturer::Result result,
+    std::unique_ptr<DesktopFrame> frame) {
+  if (result != DesktopCapturer::Result::SUCCESS)
+    return;
+  RTC_DCHECK(frame);
+  const int width = frame->size().width();
+  const int height = frame->size().height();
+
+  DesktopRegion updated_region = frame->updated_region();
+  if (!buffer_ || buffer_->width() != width || buffer_->height() != height) {
+    buffer_ = new RefCountedI420Buffer(width, height);
+    updated_region.SetRect(DesktopRect::MakeSize(frame->size()));
+  } else {
+    updated_region.IntersectWith(DesktopRect::MakeSize(frame->size()));
+  }
+
+  VideoFrame::UpdateRect update_rect = {0, 0, 0, 0};
+  if (!updated_region.is_empty()) {
+    rtc::scoped_refptr<RefCountedI420Buffer> buffer = GetWritableBuffer();
+    for (DesktopRegion::Iterator it(updated_region); !it.IsAtEnd();
+         it.Advance()) {
+      // Align to 2x2 blocks, chroma samples are shared by those.
+      const int left = it.rect().left() & ~1;
+      const int top = it.rect().top() & ~1;
+      const int right = std::min(width, (it.rect().right() + 1) & ~1);
+      const int bottom = std::min(height, (it.rect().bottom() + 1) & ~1);
+      libyuv::ARGBToI420(
+          frame->GetFrameDataAtPos(DesktopVector(left, top)), frame->stride(),
+          buffer->MutableDataY() + top * buffer->StrideY() + left,
+          buffer->StrideY(),
+          buffer->MutableDataU() + top / 2 * buffer->StrideU() + left / 2,
+          buffer->StrideU(),
+          buffer->MutableDataV() + top / 2 * buffer->StrideV() + left / 2,
+          buffer->StrideV(), right - left, bottom - top);
+      converted_pixels_ += (right - left) * (bottom - top);
+      update_rect.Union(
+          VideoFrame::UpdateRect{left, top, right - left, bottom - top});
+    }
+    buffer_ = buffer;
+  }
+
+  TestVideoCapturer::OnFrame(VideoFrame::Builder()
+                                 .set_video_frame_buffer(buffer_)
+                                 .set_rotation(kVideoRotation_0)
+                                 .set_timestamp_us(rtc::TimeMicros())
+                                 .set_update_rect(update_rect)
+                                 .build());
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef TEST_DESKTOP_VIDEO_CAPTURER_H_
+#define TEST_DESKTOP_VIDEO_CAPTURER_H_
+
+#include <memory>
+
+#include "api/scoped_refptr.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "modules/desktop_capture/desktop_capturer.h"
+#include "modules/desktop_capture/desktop_frame.h"
+#include "rtc_base/ref_counted_object.h"
+#include "test/test_video_capturer.h"
+
+namespace webrtc {
+namespace test {
+
+// Video source for screen sharing, fed by a DesktopCapturer. Captures are
+// compared with the previous one, and only the updated region is converted
+// from ARGB to I420 into a copy of the previous frame. The region is passed
+// on as the update rect of the frame, so that encoders and simulcast layers
+// can skip work on unchanged content. Captures without changes are delivered
+// as repeats of the previous frame with an empty update rect.
+class DesktopVideoCapturer : public TestVideoCapturer,
+                             public DesktopCapturer::Callback {
+ public:
+  explicit DesktopVideoCapturer(std::unique_ptr<DesktopCapturer> capturer);
+  ~DesktopVideoCapturer() override;
+
+  // Captures a frame and delivers it to the sinks, on the calling thread.
+  void CaptureFrame();
+
+  // Number of samples converted to I420 so far.
+  int64_t converted_pixels() const { return converted_pixels_; }
+
+ private:
+  using RefCountedI420Buffer = rtc::RefCountedObject<I420Buffer>;
+
+  // DesktopCapturer::Callback implementation.
+  void OnCaptureResult(DesktopCapturer::Result result,
+                       std::unique_ptr<DesktopFrame> frame) override;
+
+  // Returns a buffer with the content of the previous frame that is not
+  // referenced by any sink.
+  rtc::scoped_refptr<RefCountedI420Buffer> GetWritableBuffer();
+
+  const std::unique_ptr<DesktopCapturer> capturer_;
+  rtc::scoped_refptr<RefCountedI420Buffer> buffer_;
+  int64_t converted_pixels_ = 0;
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_DESKTOP_VIDEO_CAPTURER_H_
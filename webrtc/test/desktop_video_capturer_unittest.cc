@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "test/desktop_video_capturer.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/types/optional.h"
+#include "api/video/video_frame_buffer.h"
+#include "api/video/video_sink_interface.h"
+#include "modules/desktop_capture/desktop_frame_generator.h"
+#include "modules/desktop_capture/desktop_geometry.h"
+#include "modules/desktop_capture/fake_desktop_capturer.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+constexpr int kWidth = 640;
+constexpr int kHeight = 480;
+
+class FrameRecorder : public rtc::VideoSinkInterface<VideoFrame> {
+ public:
+  void OnFrame(const VideoFrame& frame) override {
+    ++num_frames;
+    last_frame = frame;
+  }
+
+  int num_frames = 0;
+  absl::optional<VideoFrame> last_frame;
+};
+
+uint8_t LumaAt(const VideoFrame& frame, int x, int y) {
+  rtc::scoped_refptr<I420BufferInterface> buffer =
+      frame.video_frame_buffer()->ToI420();
+  return buffer->DataY()[y * buffer->StrideY() + x];
+}
+
+class DesktopVideoCapturerTest : public ::testing::Test {
+ protected:
+  DesktopVideoCapturerTest() {
+    generator_.size()->set(kWidth, kHeight);
+    generator_.set_provide_updated_region_hints(true);
+    generator_.set_desktop_frame_painter(&painter_);
+    auto fake_capturer = absl::make_unique<FakeDesktopCapturer>();
+    fake_capturer->set_frame_generator(&generator_);
+    capturer_ =
+        absl::make_unique<DesktopVideoCapturer>(std::move(fake_capturer));
+    capturer_->AddOrUpdateSink(&recorder_, rtc::VideoSinkWants());
+  }
+
+  ~DesktopVideoCapturerTest() override { capturer_->RemoveSink(&recorder_); }
+
+  BlackWhiteDesktopFramePainter painter_;
+  PainterDesktopFrameGenerator generator_;
+  FrameRecorder recorder_;
+  std::unique_ptr<DesktopVideoCapturer> capturer_;
+};
+}  // namespace
+
+TEST_F(DesktopVideoCapturerTest, ConvertsWholeFirstFrame) {
+  capturer_->CaptureFrame();
+  ASSERT_EQ(1, recorder_.num_frames);
+  const VideoFrame::UpdateRect update_rect =
+      recorder_.last_frame->update_rect();
+  EXPECT_EQ(0, update_rect.offset_x);
+  EXPECT_EQ(0, update_rect.offset_y);
+  EXPECT_EQ(kWidth, update_rect.width);
+  EXPECT_EQ(kHeight, update_rect.height);
+  EXPECT_EQ(kWidth * kHeight, capturer_->converted_pixels());
+}
+
+TEST_F(DesktopVideoCapturerTest, RepeatsUnchangedFrameWithoutConversion) {
+  capturer_->CaptureFrame();
+  ASSERT_EQ(1, recorder_.num_frames);
+  const VideoFrameBuffer* first_buffer =
+      recorder_.last_frame->video_frame_buffer().get();
+
+  capturer_->CaptureFrame();
+  ASSERT_EQ(2, recorder_.num_frames);
+  EXPECT_TRUE(recorder_.last_frame->update_rect().IsEmpty());
+  EXPECT_EQ(first_buffer, recorder_.last_frame->video_frame_buffer().get());
+  EXPECT_EQ(kWidth * kHeight, capturer_->converted_pixels());
+}
+
+TEST_F(DesktopVideoCapturerTest, ConvertsOnlyUpdatedRegion) {
+  capturer_->CaptureFrame();
+  ASSERT_TRUE(recorder_.last_frame);
+  const VideoFrame first_frame = *recorder_.last_frame;
+
+  painter_.updated_region()->AddRect(DesktopRect::MakeXYWH(100, 100, 40, 40));
+  capturer_->CaptureFrame();
+  ASSERT_EQ(2, recorder_.num_frames);
+  const VideoFrame::UpdateRect update_rect =
+      recorder_.last_frame->update_rect();
+  EXPECT_LE(update_rect.offset_x, 100);
+  EXPECT_LE(update_rect.offset_y, 100);
+  EXPECT_GE(update_rect.offset_x + update_rect.width, 140);
+  EXPECT_GE(update_rect.offset_y + update_rect.height, 140);
+  EXPECT_LT(capturer_->converted_pixels() - kWidth * kHeight,
+            kWidth * kHeight / 10);
+
+  // The painted square is white on black.
+  EXPECT_GT(LumaAt(*recorder_.last_frame, 110, 110), 200);
+  EXPECT_LT(LumaAt(*recorder_.last_frame, 10, 10), 30);
+  // The frame still held by the sink is not modified.
+  EXPECT_LT(LumaAt(first_frame, 110, 110), 30);
+}
+
+}  // namespace test
+}  // namespace webrtc
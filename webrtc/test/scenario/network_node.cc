@@ -47,7 +47,8 @@ std::unique_ptr<SimulationNode> SimulationNode::Create(
     NetworkNodeConfig config) {
   RTC_DCHECK(config.mode == NetworkNodeConfig::TrafficMode::kSimulation);
   SimulatedNetwork::Config sim_config = CreateSimulationConfig(config);
-  auto network = absl::make_unique<SimulatedNetwork>(sim_config);
+  auto network = absl::make_unique<SimulatedNetwork>(
+      sim_config, config.simulation.random_seed);
   SimulatedNetwork* simulation_ptr = network.get();
   return std::unique_ptr<SimulationNode>(new SimulationNode(
       clock, task_queue, config, std::move(network), simulation_ptr));
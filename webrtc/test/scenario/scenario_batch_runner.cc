@@ -0,0 +1,338 @@
+/*
+ *  Copyright 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "test/scenario/scenario_batch_runner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+
+#if defined(WEBRTC_POSIX)
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/logging.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "test/scenario/scenario.h"
+#include "test/statistics.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+constexpr TimeDelta kTargetRateSampleInterval = TimeDelta::Millis<100>();
+constexpr size_t kFreezeDetectionWindow = 30;
+constexpr double kMinFreezeIncreaseMs = 150;
+
+static_assert(std::is_trivially_copyable<ScenarioQoeMetrics>::value,
+              "ScenarioQoeMetrics is copied between processes as bytes.");
+
+// Collects rendered frame statistics. Frames are reported on the analyzer
+// task queue, while the scenario runs on its own.
+class RenderedFrameCollector {
+ public:
+  void OnFrame(const VideoFrameQualityInfo& info) {
+    rtc::CritScope lock(&crit_);
+    if (info.render_time.IsInfinite())
+      return;
+    ++rendered_frames_;
+    latency_ms_.AddSample(
+        (info.render_time - info.received_capture_time).ms<double>());
+    if (last_render_time_.IsFinite()) {
+      const double interval_ms =
+          (info.render_time - last_render_time_).ms<double>();
+      if (!render_intervals_ms_.empty()) {
+        const double mean_ms = render_interval_sum_ms_ /
+                               render_intervals_ms_.size();
+        if (interval_ms >
+            std::max(3 * mean_ms, mean_ms + kMinFreezeIncreaseMs)) {
+          ++freeze_count_;
+          total_freeze_duration_ms_ += interval_ms;
+          last_render_time_ = info.render_time;
+          return;
+        }
+      }
+      render_intervals_ms_.push_back(interval_ms);
+      render_interval_sum_ms_ += interval_ms;
+      if (render_intervals_ms_.size() > kFreezeDetectionWindow) {
+        render_interval_sum_ms_ -= render_intervals_ms_.front();
+        render_intervals_ms_.pop_front();
+      }
+    }
+    last_render_time_ = info.render_time;
+  }
+
+  void GetMetrics(ScenarioQoeMetrics* metrics) {
+    rtc::CritScope lock(&crit_);
+    metrics->rendered_frames = rendered_frames_;
+    metrics->freeze_count = freeze_count_;
+    metrics->total_freeze_duration_ms = total_freeze_duration_ms_;
+    if (rendered_frames_ > 0) {
+      metrics->mean_latency_ms = latency_ms_.Mean();
+      metrics->max_latency_ms = latency_ms_.Max();
+    }
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  int rendered_frames_ RTC_GUARDED_BY(crit_) = 0;
+  int freeze_count_ RTC_GUARDED_BY(crit_) = 0;
+  double total_freeze_duration_ms_ RTC_GUARDED_BY(crit_) = 0;
+  Statistics latency_ms_ RTC_GUARDED_BY(crit_);
+  Timestamp last_render_time_ RTC_GUARDED_BY(crit_) =
+      Timestamp::MinusInfinity();
+  std::deque<double> render_intervals_ms_ RTC_GUARDED_BY(crit_);
+  double render_interval_sum_ms_ RTC_GUARDED_BY(crit_) = 0;
+};
+
+#if defined(WEBRTC_POSIX)
+struct ChildProcess {
+  pid_t pid;
+  int result_fd;
+  size_t config_index;
+};
+
+bool ReadResult(int fd, ScenarioQoeMetrics* metrics) {
+  char* data = reinterpret_cast<char*>(metrics);
+  size_t read_bytes = 0;
+  while (read_bytes < sizeof(*metrics)) {
+    ssize_t result = read(fd, data + read_bytes, sizeof(*metrics) - read_bytes);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return false;
+    read_bytes += result;
+  }
+  return true;
+}
+
+void WriteResult(int fd, const ScenarioQoeMetrics& metrics) {
+  const char* data = reinterpret_cast<const char*>(&metrics);
+  size_t written_bytes = 0;
+  while (written_bytes < sizeof(metrics)) {
+    ssize_t result =
+        write(fd, data + written_bytes, sizeof(metrics) - written_bytes);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return;
+    written_bytes += result;
+  }
+}
+#endif  // defined(WEBRTC_POSIX)
+
+void WriteJsonString(std::ostringstream* json, const std::string& value) {
+  *json << '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\')
+      *json << '\\';
+    *json << c;
+  }
+  *json << '"';
+}
+
+void WriteMetricsFields(std::ostringstream* json,
+                        double rendered_frames,
+                        double freeze_count,
+                        const ScenarioQoeMetrics& metrics) {
+  *json << R"("rendered_frames":)" << rendered_frames << ',';
+  *json << R"("freeze_count":)" << freeze_count << ',';
+  *json << R"("total_freeze_duration_ms":)"
+        << metrics.total_freeze_duration_ms << ',';
+  *json << R"("mean_latency_ms":)" << metrics.mean_latency_ms << ',';
+  *json << R"("max_latency_ms":)" << metrics.max_latency_ms << ',';
+  *json << R"("mean_target_rate_kbps":)" << metrics.mean_target_rate_kbps
+        << ',';
+  *json << R"("mean_target_rate_ratio":)" << metrics.mean_target_rate_ratio
+        << ',';
+  *json << R"("mean_target_rate_abs_error":)"
+        << metrics.mean_target_rate_abs_error;
+}
+}  // namespace
+
+BatchScenarioConfig::BatchScenarioConfig() = default;
+BatchScenarioConfig::BatchScenarioConfig(const BatchScenarioConfig&) = default;
+BatchScenarioConfig::~BatchScenarioConfig() = default;
+
+ScenarioBatchRunner::ScenarioBatchRunner(int max_parallel_runs)
+    : max_parallel_runs_(max_parallel_runs > 0
+                             ? max_parallel_runs
+                             : CpuInfo::DetectNumberOfCores()) {
+  RTC_DCHECK_GT(max_parallel_runs_, 0);
+}
+
+std::vector<ScenarioQoeMetrics> ScenarioBatchRunner::Run(
+    const std::vector<BatchScenarioConfig>& configs) const {
+  std::vector<ScenarioQoeMetrics> results(configs.size());
+#if defined(WEBRTC_POSIX)
+  std::vector<ChildProcess> children;
+  size_t next_config = 0;
+  while (next_config < configs.size() || !children.empty()) {
+    while (next_config < configs.size() &&
+           children.size() < max_parallel_runs_) {
+      int fds[2];
+      RTC_CHECK_EQ(0, pipe(fds));
+      pid_t pid = fork();
+      RTC_CHECK_GE(pid, 0);
+      if (pid == 0) {
+        close(fds[0]);
+        WriteResult(fds[1], RunScenario(configs[next_config]));
+        _exit(0);
+      }
+      close(fds[1]);
+      children.push_back({pid, fds[0], next_config++});
+    }
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      RTC_CHECK_EQ(EINTR, errno);
+      continue;
+    }
+    auto child = std::find_if(
+        children.begin(), children.end(),
+        [pid](const ChildProcess& child) { return child.pid == pid; });
+    if (child == children.end())
+      continue;
+    ScenarioQoeMetrics metrics;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+        ReadResult(child->result_fd, &metrics)) {
+      results[child->config_index] = metrics;
+    } else {
+      RTC_LOG(LS_WARNING) << "Scenario " << configs[child->config_index].name
+                          << " did not complete.";
+    }
+    close(child->result_fd);
+    children.erase(child);
+  }
+#else
+  for (size_t i = 0; i < configs.size(); ++i)
+    results[i] = RunScenario(configs[i]);
+#endif
+  return results;
+}
+
+ScenarioQoeMetrics ScenarioBatchRunner::RunScenario(
+    const BatchScenarioConfig& config) {
+  RenderedFrameCollector frames;
+  int num_rate_samples = 0;
+  double target_rate_kbps_sum = 0;
+  double target_rate_ratio_sum = 0;
+  double target_rate_abs_error_sum = 0;
+  {
+    Scenario s(std::unique_ptr<LogWriterFactoryInterface>(),
+               /*real_time=*/false);
+    CallClient* caller = s.CreateClient("caller", config.caller);
+    CallClient* callee = s.CreateClient("callee", CallClientConfig());
+    SimulationNode* send_node = s.CreateSimulationNode(config.send_link);
+    SimulationNode* return_node = s.CreateSimulationNode(config.return_link);
+    CallClientPair* route =
+        s.CreateRoutes(caller, {send_node}, callee, {return_node});
+
+    VideoStreamConfig video = config.video;
+    video.analyzer.frame_quality_handler =
+        [&frames](const VideoFrameQualityInfo& info) { frames.OnFrame(info); };
+    s.CreateVideoStream(route->forward(), video);
+    if (config.cross_traffic)
+      s.CreateCrossTraffic({send_node}, *config.cross_traffic);
+
+    DataRate capacity = config.send_link.simulation.bandwidth;
+    for (const auto& change : config.send_capacity_trace) {
+      const DataRate new_capacity = change.second;
+      s.At(change.first, [send_node, new_capacity, &capacity] {
+        send_node->UpdateConfig([new_capacity](NetworkNodeConfig* config) {
+          config->simulation.bandwidth = new_capacity;
+        });
+        capacity = new_capacity;
+      });
+    }
+    s.Every(kTargetRateSampleInterval, [&] {
+      if (capacity.IsInfinite() || capacity.IsZero())
+        return;
+      const DataRate target_rate = caller->send_bandwidth();
+      const double ratio = target_rate / capacity;
+      ++num_rate_samples;
+      target_rate_kbps_sum += target_rate.kbps<double>();
+      target_rate_ratio_sum += ratio;
+      target_rate_abs_error_sum += std::abs(1 - ratio);
+    });
+    s.RunFor(config.duration);
+  }
+
+  ScenarioQoeMetrics metrics;
+  metrics.completed = true;
+  frames.GetMetrics(&metrics);
+  if (num_rate_samples > 0) {
+    metrics.mean_target_rate_kbps = target_rate_kbps_sum / num_rate_samples;
+    metrics.mean_target_rate_ratio = target_rate_ratio_sum / num_rate_samples;
+    metrics.mean_target_rate_abs_error =
+        target_rate_abs_error_sum / num_rate_samples;
+  }
+  return metrics;
+}
+
+std::string ScenarioBatchRunner::ToJson(
+    const std::vector<BatchScenarioConfig>& configs,
+    const std::vector<ScenarioQoeMetrics>& metrics) {
+  RTC_DCHECK_EQ(configs.size(), metrics.size());
+  std::ostringstream json;
+  json << R"({"runs":[)";
+  int num_completed = 0;
+  double rendered_frames_sum = 0;
+  double freeze_count_sum = 0;
+  ScenarioQoeMetrics sum;
+  for (size_t i = 0; i < metrics.size(); ++i) {
+    const ScenarioQoeMetrics& run = metrics[i];
+    if (i > 0)
+      json << ',';
+    json << R"({"name":)";
+    WriteJsonString(&json, configs[i].name);
+    json << R"(,"completed":)" << (run.completed ? "true" : "false");
+    if (run.completed) {
+      json << ',';
+      WriteMetricsFields(&json, run.rendered_frames, run.freeze_count, run);
+      ++num_completed;
+      rendered_frames_sum += run.rendered_frames;
+      freeze_count_sum += run.freeze_count;
+      sum.total_freeze_duration_ms += run.total_freeze_duration_ms;
+      sum.mean_latency_ms += run.mean_latency_ms;
+      sum.max_latency_ms += run.max_latency_ms;
+      sum.mean_target_rate_kbps += run.mean_target_rate_kbps;
+      sum.mean_target_rate_ratio += run.mean_target_rate_ratio;
+      sum.mean_target_rate_abs_error += run.mean_target_rate_abs_error;
+    }
+    json << '}';
+  }
+  json << R"(],"mean":{"completed_runs":)" << num_completed;
+  if (num_completed > 0) {
+    ScenarioQoeMetrics mean;
+    mean.total_freeze_duration_ms =
+        sum.total_freeze_duration_ms / num_completed;
+    mean.mean_latency_ms = sum.mean_latency_ms / num_completed;
+    mean.max_latency_ms = sum.max_latency_ms / num_completed;
+    mean.mean_target_rate_kbps = sum.mean_target_rate_kbps / num_completed;
+    mean.mean_target_rate_ratio = sum.mean_target_rate_ratio / num_completed;
+    mean.mean_target_rate_abs_error =
+        sum.mean_target_rate_abs_error / num_completed;
+    json << ',';
+    WriteMetricsFields(&json, rendered_frames_sum / num_completed,
+                       freeze_count_sum / num_completed, mean);
+  }
+  json << "}}";
+  return json.str();
+}
+
+}  // namespace test
+}  // namespace webrtc
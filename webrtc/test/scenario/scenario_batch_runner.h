@@ -0,0 +1,89 @@
+/*
+ *  Copyright 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef TEST_SCENARIO_SCENARIO_BATCH_RUNNER_H_
+#define TEST_SCENARIO_SCENARIO_BATCH_RUNNER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "test/scenario/scenario_config.h"
+
+namespace webrtc {
+namespace test {
+
+// Configuration of one call in a batch: a video stream from a caller to a
+// callee over a simulated link, optionally shared with cross traffic.
+struct BatchScenarioConfig {
+  BatchScenarioConfig();
+  BatchScenarioConfig(const BatchScenarioConfig&);
+  ~BatchScenarioConfig();
+  std::string name;
+  TimeDelta duration = TimeDelta::seconds(30);
+  CallClientConfig caller;
+  VideoStreamConfig video;
+  NetworkNodeConfig send_link;
+  NetworkNodeConfig return_link;
+  // Capacity of |send_link| from the given time since start.
+  std::vector<std::pair<TimeDelta, DataRate>> send_capacity_trace;
+  absl::optional<CrossTrafficConfig> cross_traffic;
+};
+
+// Quality of experience of one call. Plain data so that it can be passed
+// between processes as is.
+struct ScenarioQoeMetrics {
+  // False if the run did not finish, e.g. because it crashed.
+  bool completed = false;
+  int rendered_frames = 0;
+  // Freezes are detected as in the receive statistics: a render interval
+  // longer than max(3 * average, average + 150 ms).
+  int freeze_count = 0;
+  double total_freeze_duration_ms = 0;
+  // Capture to render delay.
+  double mean_latency_ms = 0;
+  double max_latency_ms = 0;
+  // Target send rate relative to the capacity of the send link, sampled
+  // every 100 ms while the capacity is finite.
+  double mean_target_rate_kbps = 0;
+  double mean_target_rate_ratio = 0;
+  double mean_target_rate_abs_error = 0;
+};
+
+// Runs batches of scenarios in simulated time, one process per scenario so
+// that runs don't share the global clock and field trials. Each run is
+// deterministic, and results are returned in the order of the configs
+// regardless of which finishes first. Runs are sequential on platforms
+// without fork().
+class ScenarioBatchRunner {
+ public:
+  // Uses one process per core if |max_parallel_runs| is 0.
+  explicit ScenarioBatchRunner(int max_parallel_runs);
+
+  std::vector<ScenarioQoeMetrics> Run(
+      const std::vector<BatchScenarioConfig>& configs) const;
+
+  // Runs |config| in the calling process.
+  static ScenarioQoeMetrics RunScenario(const BatchScenarioConfig& config);
+
+  // Per run metrics and their mean over the completed runs.
+  static std::string ToJson(const std::vector<BatchScenarioConfig>& configs,
+                            const std::vector<ScenarioQoeMetrics>& metrics);
+
+ private:
+  const size_t max_parallel_runs_;
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_SCENARIO_SCENARIO_BATCH_RUNNER_H_
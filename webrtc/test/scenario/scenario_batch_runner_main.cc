@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Runs a video call scenario for every combination of the given link
+// capacities, delays and loss rates, in simulated time and in parallel, and
+// writes the quality of experience metrics of each run and their mean as
+// JSON.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/string_encode.h"
+#include "rtc_base/string_to_number.h"
+#include "rtc_base/strings/string_builder.h"
+#include "test/scenario/scenario_batch_runner.h"
+
+WEBRTC_DEFINE_string(capacities_kbps,
+                     "300,1000,2500",
+                     "Comma separated capacities of the send link in kbps.");
+WEBRTC_DEFINE_string(delays_ms,
+                     "20,100",
+                     "Comma separated one way delays of the send link.");
+WEBRTC_DEFINE_string(loss_rates,
+                     "0,0.02",
+                     "Comma separated random loss rates of the send link.");
+WEBRTC_DEFINE_bool(capacity_drop,
+                   false,
+                   "Also run every link with its capacity halved during the "
+                   "middle third of the run.");
+WEBRTC_DEFINE_bool(cross_traffic,
+                   false,
+                   "Also run every link shared with random walk cross "
+                   "traffic.");
+WEBRTC_DEFINE_int(seeds, 1, "Number of random seeds to run every link with.");
+WEBRTC_DEFINE_int(duration_s, 30, "Simulated duration of every run.");
+WEBRTC_DEFINE_int(parallel_runs,
+                  0,
+                  "Maximum number of concurrent runs. One per core if 0.");
+WEBRTC_DEFINE_string(output, "", "JSON output file. Defaults to stdout.");
+WEBRTC_DEFINE_bool(help, false, "Print this message.");
+
+namespace webrtc {
+namespace test {
+namespace {
+
+template <typename T>
+std::vector<T> ParseList(const char* flag_value) {
+  std::vector<std::string> fields;
+  rtc::split(flag_value, ',', &fields);
+  std::vector<T> values;
+  for (const std::string& field : fields) {
+    absl::optional<T> value = rtc::StringToNumber<T>(field);
+    RTC_CHECK(value) << "Invalid value: " << field;
+    values.push_back(*value);
+  }
+  RTC_CHECK(!values.empty());
+  return values;
+}
+
+std::vector<BatchScenarioConfig> CreateConfigs() {
+  const TimeDelta duration = TimeDelta::seconds(FLAG_duration_s);
+  std::vector<BatchScenarioConfig> configs;
+  for (int capacity_kbps : ParseList<int>(FLAG_capacities_kbps)) {
+    for (int delay_ms : ParseList<int>(FLAG_delays_ms)) {
+      for (double loss_rate : ParseList<double>(FLAG_loss_rates)) {
+        for (bool capacity_drop : {false, true}) {
+          if (capacity_drop && !FLAG_capacity_drop)
+            continue;
+          for (bool cross_traffic : {false, true}) {
+            if (cross_traffic && !FLAG_cross_traffic)
+              continue;
+            for (int seed = 1; seed <= FLAG_seeds; ++seed) {
+              BatchScenarioConfig config;
+              char name[128];
+              rtc::SimpleStringBuilder sb(name);
+              sb << "capacity_" << capacity_kbps << "kbps_delay_" << delay_ms
+                 << "ms_loss_" << loss_rate;
+              if (capacity_drop)
+                sb << "_drop";
+              if (cross_traffic)
+                sb << "_cross";
+              sb << "_seed_" << seed;
+              config.name = sb.str();
+              config.duration = duration;
+              config.send_link.simulation.bandwidth =
+                  DataRate::kbps(capacity_kbps);
+              config.send_link.simulation.delay = TimeDelta::ms(delay_ms);
+              config.send_link.simulation.loss_rate = loss_rate;
+              config.send_link.simulation.random_seed = seed;
+              config.return_link.simulation.delay = TimeDelta::ms(delay_ms);
+              if (capacity_drop) {
+                config.send_capacity_trace = {
+                    {duration / 3, DataRate::kbps(capacity_kbps / 2)},
+                    {duration * 2 / 3, DataRate::kbps(capacity_kbps)}};
+              }
+              if (cross_traffic) {
+                config.cross_traffic.emplace();
+                config.cross_traffic->random_seed = seed;
+                config.cross_traffic->peak_rate =
+                    DataRate::kbps(capacity_kbps / 2);
+              }
+              configs.push_back(config);
+            }
+          }
+        }
+      }
+    }
+  }
+  return configs;
+}
+
+int Run() {
+  const std::vector<BatchScenarioConfig> configs = CreateConfigs();
+  const std::vector<ScenarioQoeMetrics> metrics =
+      ScenarioBatchRunner(FLAG_parallel_runs).Run(configs);
+  const std::string json = ScenarioBatchRunner::ToJson(configs, metrics);
+
+  FILE* output = strlen(FLAG_output) > 0 ? fopen(FLAG_output, "w") : stdout;
+  if (!output) {
+    fprintf(stderr, "Could not open %s\n", FLAG_output);
+    return 1;
+  }
+  fprintf(output, "%s\n", json.c_str());
+  if (output != stdout)
+    fclose(output);
+  return 0;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) || FLAG_help ||
+      argc != 1) {
+    printf("Usage: %s [options]\n", argv[0]);
+    rtc::FlagList::Print(nullptr, false);
+    return FLAG_help ? 0 : 1;
+  }
+  RTC_CHECK_GT(FLAG_duration_s, 0);
+  RTC_CHECK_GT(FLAG_seeds, 0);
+  RTC_CHECK_GE(FLAG_parallel_runs, 0);
+  return webrtc::test::Run();
+}
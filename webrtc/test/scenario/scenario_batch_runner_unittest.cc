@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "test/scenario/scenario_batch_runner.h"
+
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+using ::testing::HasSubstr;
+
+BatchScenarioConfig CreateConfig(std::string name, DataRate capacity) {
+  BatchScenarioConfig config;
+  config.name = name;
+  config.duration = TimeDelta::seconds(5);
+  config.send_link.simulation.bandwidth = capacity;
+  config.send_link.simulation.delay = TimeDelta::ms(50);
+  return config;
+}
+}  // namespace
+
+TEST(ScenarioBatchRunnerTest, ParallelRunsMatchRunsInProcess) {
+  const std::vector<BatchScenarioConfig> configs = {
+      CreateConfig("low", DataRate::kbps(300)),
+      CreateConfig("high", DataRate::kbps(1000))};
+  const std::vector<ScenarioQoeMetrics> metrics =
+      ScenarioBatchRunner(2).Run(configs);
+  ASSERT_EQ(2u, metrics.size());
+  for (size_t i = 0; i < configs.size(); ++i) {
+    const ScenarioQoeMetrics expected =
+        ScenarioBatchRunner::RunScenario(configs[i]);
+    EXPECT_TRUE(metrics[i].completed);
+    EXPECT_GT(metrics[i].rendered_frames, 0);
+    EXPECT_EQ(expected.rendered_frames, metrics[i].rendered_frames);
+    EXPECT_EQ(expected.mean_target_rate_kbps,
+              metrics[i].mean_target_rate_kbps);
+  }
+  EXPECT_LT(metrics[0].mean_target_rate_kbps,
+            metrics[1].mean_target_rate_kbps);
+}
+
+TEST(ScenarioBatchRunnerTest, WritesRunsAndMeanAsJson) {
+  const std::vector<BatchScenarioConfig> configs = {
+      CreateConfig("first", DataRate::kbps(300)),
+      CreateConfig("second", DataRate::kbps(300))};
+  std::vector<ScenarioQoeMetrics> metrics(2);
+  metrics[0].completed = true;
+  metrics[0].freeze_count = 4;
+  metrics[0].mean_latency_ms = 100;
+
+  const std::string json = ScenarioBatchRunner::ToJson(configs, metrics);
+  EXPECT_THAT(json, HasSubstr(R"({"name":"first","completed":true,)"));
+  EXPECT_THAT(json, HasSubstr(R"({"name":"second","completed":false})"));
+  EXPECT_THAT(json, HasSubstr(R"("mean":{"completed_runs":1,)"));
+  EXPECT_THAT(json, HasSubstr(R"("freeze_count":4,)"));
+  EXPECT_THAT(json, HasSubstr(R"("mean_latency_ms":100,)"));
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -11,6 +11,7 @@
 #define TEST_SCENARIO_SCENARIO_CONFIG_H_
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string>
 
 #include "absl/types/optional.h"
@@ -246,6 +247,8 @@ struct NetworkNodeConfig {
     TimeDelta delay_std_dev = TimeDelta::Zero();
     double loss_rate = 0;
     bool codel_active_queue_management = false;
+    // Seed for the random loss and delay variation.
+    uint64_t random_seed = 1;
   } simulation;
   DataSize packet_overhead = DataSize::Zero();
   TimeDelta update_frequency = TimeDelta::ms(1);